@@ -13,8 +13,13 @@
  */
 
 #include <CLI/CLI.hpp>
+#include <fcntl.h>
+#include <unistd.h>
 #include <algorithm>
 #include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -25,17 +30,23 @@
 #include <thread>
 #include <vector>
 
+#include "baseline.h"
+#include "burnin_tester.h"
 #include "camera_tester.h"
 #include "cpu_tester.h"
 #include "display_tester.h"
 #include "form_factor_tester.h"
 #include "gpio_tester.h"
 #include "gpu_tester.h"
+#include "health_daemon.h"
 #include "logger.h"
 #include "memory_tester.h"
 #include "networking_tester.h"
 #include "power_tester.h"
 #include "storage_tester.h"
+#include "telemetry_reader.h"
+#include "telemetry_recorder.h"
+#include "test_watchdog.h"
 #include "usb_tester.h"
 
 using namespace imx93_peripheral_test;
@@ -49,24 +60,41 @@ using namespace imx93_peripheral_test;
 using TesterFactory = std::function<std::unique_ptr<PeripheralTester>()>;
 
 /**
- * @brief Registry mapping peripheral names to their factory functions.
+ * @struct TesterEntry
+ * @brief How to check for a peripheral and how to create its tester.
+ */
+struct TesterEntry {
+  std::function<bool()> probe;  /**< Cheap availability check; constructs nothing */
+  TesterFactory         create; /**< Creates the tester; call prepare() before testing */
+};
+
+/**
+ * @brief Returns the registry entry for a tester class.
+ */
+template <typename Tester>
+TesterEntry tester_entry() {
+  return {&Tester::probe, []() { return std::make_unique<Tester>(); }};
+}
+
+/**
+ * @brief Registry mapping peripheral names to their probes and factories.
  *
  * Global map that associates string identifiers with factory functions for
  * creating instances of specific peripheral testers. This enables dynamic
  * instantiation of testers based on command-line arguments.
  */
-std::map<std::string, TesterFactory> tester_registry = {
-    {"cpu", []() { return std::make_unique<CPUTester>(); }},
-    {"gpio", []() { return std::make_unique<GPIOTester>(); }},
-    {"camera", []() { return std::make_unique<CameraTester>(); }},
-    {"gpu", []() { return std::make_unique<GPUTester>(); }},
-    {"memory", []() { return std::make_unique<MemoryTester>(); }},
-    {"storage", []() { return std::make_unique<StorageTester>(); }},
-    {"display", []() { return std::make_unique<DisplayTester>(); }},
-    {"usb", []() { return std::make_unique<USBTester>(); }},
-    {"networking", []() { return std::make_unique<NetworkingTester>(); }},
-    {"power", []() { return std::make_unique<PowerTester>(); }},
-    {"form_factor", []() { return std::make_unique<FormFactorTester>(); }}};
+std::map<std::string, TesterEntry> tester_registry = {
+    {"cpu", tester_entry<CPUTester>()},
+    {"gpio", tester_entry<GPIOTester>()},
+    {"camera", tester_entry<CameraTester>()},
+    {"gpu", tester_entry<GPUTester>()},
+    {"memory", tester_entry<MemoryTester>()},
+    {"storage", tester_entry<StorageTester>()},
+    {"display", tester_entry<DisplayTester>()},
+    {"usb", tester_entry<USBTester>()},
+    {"networking", tester_entry<NetworkingTester>()},
+    {"power", tester_entry<PowerTester>()},
+    {"form_factor", tester_entry<FormFactorTester>()}};
 
 /**
  * @brief Lists all available peripherals and their status.
@@ -74,19 +102,76 @@ std::map<std::string, TesterFactory> tester_registry = {
  * Iterates through the tester registry and displays each peripheral's name
  * along with its availability status on the current system.
  *
- * @note This function creates temporary tester instances to check availability,
- *       which may involve system calls or hardware detection.
+ * @note Only the static probes run, so no tester is constructed and no
+ *       external tool is started.
  */
 void list_peripherals() {
   std::cout << "Available Peripherals:\n";
   std::cout << "=====================\n";
   for (const auto& pair : tester_registry) {
-    auto tester = pair.second();
-    std::cout << pair.first << ": " << (tester->is_available() ? "Available" : "Not Available")
+    std::cout << pair.first << ": " << (pair.second.probe() ? "Available" : "Not Available")
               << "\n";
   }
 }
 
+/**
+ * @brief Parses a --brownout-rail value.
+ * @param spec RAIL=VOLTS, e.g. regulator/VDD_SOC=0.75.
+ * @param rail Receives the rail name.
+ * @param volts Receives the threshold.
+ * @return true if the name is not empty and the threshold is a positive number.
+ */
+bool parse_rail_threshold(const std::string& spec, std::string& rail, double& volts) {
+  size_t separator = spec.rfind('=');
+  if (separator == std::string::npos || separator == 0 || separator + 1 == spec.size()) {
+    return false;
+  }
+  const char* value = spec.c_str() + separator + 1;
+  char*       end   = nullptr;
+  volts             = std::strtod(value, &end);
+  rail              = spec.substr(0, separator);
+  return *end == '\0' && volts > 0.0;
+}
+
+/**
+ * @brief Makes an energy workload of one tester's short_test() pass.
+ *
+ * The tester is constructed and discovered here, once, so the meter only
+ * sees the passes. Each pass counts the checks it completed successfully.
+ *
+ * @return The workload, or an empty one if the peripheral is not available.
+ */
+template <typename Tester>
+EnergyMeter::Workload make_workload_pass() {
+  auto tester = std::make_shared<Tester>();
+  if (!tester->prepare()) {
+    return EnergyMeter::Workload();
+  }
+  return [tester]() {
+    TestReport report = tester->short_test();
+    return static_cast<uint64_t>(
+        std::count_if(report.checks.begin(), report.checks.end(), [](const SubTestResult& check) {
+          return check.result == TestResult::SUCCESS;
+        }));
+  };
+}
+
+/**
+ * @brief Watchdog that SIGINT and SIGTERM stop, set while tests run.
+ */
+TestWatchdog* g_watchdog = nullptr;
+
+/**
+ * @brief Stops the running test so the partial report is still written.
+ *
+ * Installed with SA_RESETHAND, so a second signal terminates the tool.
+ */
+void handle_interrupt(int) {
+  if (g_watchdog != nullptr) {
+    g_watchdog->interrupt();
+  }
+}
+
 /**
  * @brief Main application entry point.
  *
@@ -105,20 +190,44 @@ int main(int argc, char* argv[]) {
   CLI::App app{"NXP FRDM-IMX93 Hardware Peripheral Verification Tool"};
 
   bool        json_output = false;
+  bool        async_log   = false;
   std::string output_file;
   app.add_flag("--json", json_output, "Output results in JSON format");
   app.add_option("--output", output_file, "Write output to file");
+  app.add_flag("--async-log", async_log,
+               "Write log messages from a background thread; drops them if it falls behind");
+  int test_timeout = 600;
+  app.add_option("--timeout", test_timeout,
+                 "Seconds a test may run beyond its requested duration before it is stopped "
+                 "and reported as TIMEOUT (0 = no limit)")
+      ->default_val(600);
+  std::string              save_baseline;
+  std::string              compare_baseline;
+  std::vector<std::string> baseline_tolerances;
+  app.add_option("--save-baseline", save_baseline,
+                 "Save every metric of this run, one sample per repeat, as a baseline file");
+  app.add_option("--compare-baseline", compare_baseline,
+                 "Compare the metrics of this run against a saved baseline and fail on "
+                 "regressions");
+  app.add_option("--tolerance", baseline_tolerances,
+                 "Allowed change of a metric's median in percent, PERCENT or "
+                 "PERIPHERAL/METRIC-PREFIX=PERCENT (repeatable, default: 5)");
 
   // List subcommand
   auto list_cmd = app.add_subcommand("list", "List all available peripherals");
 
   // Test subcommand
   auto                     test_cmd = app.add_subcommand("test", "Run short tests");
-  bool                     test_all = false;
+  bool                     test_all    = false;
+  int                      test_repeat = 1;
   std::vector<std::string> test_peripherals;
   test_cmd->add_flag("--all", test_all, "Run short tests for all peripherals");
   test_cmd->add_option("peripherals", test_peripherals, "Specific peripherals to test")
       ->expected(0, -1);
+  test_cmd->add_option("--repeat", test_repeat,
+                       "Run every test this many times, round-robin, for baseline statistics")
+      ->default_val(1)
+      ->check(CLI::PositiveNumber);
 
   // Monitor subcommand
   auto                     monitor_cmd      = app.add_subcommand("monitor", "Run monitoring tests");
@@ -130,6 +239,263 @@ int main(int argc, char* argv[]) {
       ->default_val(10);
   monitor_cmd->add_option("peripherals", monitor_peripherals, "Specific peripherals to monitor")
       ->expected(0, -1);
+  int         monitor_sample_ms = 100;
+  bool        monitor_load      = false;
+  std::string monitor_load_host = "127.0.0.1";
+  std::string monitor_series_output;
+  monitor_cmd->add_option("--sample-ms", monitor_sample_ms, "Network sampling interval in ms")
+      ->default_val(100);
+  monitor_cmd->add_flag("--load", monitor_load, "Run a TCP load while monitoring networking");
+  monitor_cmd->add_option("--load-host", monitor_load_host,
+                          "Throughput server for --load (127.0.0.1 = in-process loopback)")
+      ->default_val("127.0.0.1");
+  monitor_cmd->add_option("--series-output", monitor_series_output,
+                          "Write the last 256 network samples per interface to a CSV file");
+  std::string monitor_record;
+  monitor_cmd->add_option("--record", monitor_record,
+                          "Record every raw sample to a binary telemetry file (see replay/export)");
+  double                   monitor_brownout_fraction = 0.9;
+  std::vector<std::string> monitor_brownout_rails;
+  monitor_cmd->add_option("--brownout-fraction", monitor_brownout_fraction,
+                          "Power rail dip threshold as a fraction of its mean voltage")
+      ->default_val(0.9);
+  monitor_cmd
+      ->add_option("--brownout-rail", monitor_brownout_rails,
+                   "Absolute dip threshold for one rail, RAIL=VOLTS (repeatable)")
+      ->check(CLI::Validator(
+          [](std::string& spec) {
+            std::string rail;
+            double      volts = 0.0;
+            return parse_rail_threshold(spec, rail, volts)
+                       ? std::string()
+                       : "expected RAIL=VOLTS with a positive voltage, got " + spec;
+          },
+          "RAIL=VOLTS"));
+
+  // Throughput subcommand
+  auto throughput_cmd =
+      app.add_subcommand("throughput", "Run an iperf-like TCP/UDP throughput test");
+  bool        throughput_server   = false;
+  bool        throughput_udp      = false;
+  std::string throughput_host     = "127.0.0.1";
+  int         throughput_port     = 5201;
+  int         throughput_streams  = 1;
+  int         throughput_duration = 10;
+  double      throughput_bitrate  = 0.0;
+  throughput_cmd->add_flag("--server", throughput_server, "Run as throughput server");
+  throughput_cmd->add_flag("--udp", throughput_udp, "Use UDP instead of TCP");
+  throughput_cmd->add_option("--host", throughput_host, "Server address (client) or bind address")
+      ->default_val("127.0.0.1");
+  throughput_cmd->add_option("--port", throughput_port, "TCP/UDP port")->default_val(5201);
+  throughput_cmd->add_option("--streams", throughput_streams, "Parallel client streams")
+      ->default_val(1);
+  throughput_cmd->add_option("--duration", throughput_duration,
+                             "Test duration in seconds (server: 0 runs until killed)")
+      ->default_val(10);
+  throughput_cmd->add_option("--bitrate", throughput_bitrate,
+                             "Per-stream UDP bitrate in Mbps (0 = unlimited)")
+      ->default_val(0.0);
+
+  // DNS benchmark subcommand
+  auto dns_cmd = app.add_subcommand("dns", "Benchmark DNS resolvers with parallel raw UDP queries");
+  std::vector<std::string> dns_servers;
+  std::vector<std::string> dns_names;
+  int                      dns_port       = 53;
+  int                      dns_repeat     = 1;
+  int                      dns_timeout_ms = 1000;
+  bool                     dns_stub       = false;
+  dns_cmd->add_option("--server", dns_servers, "Nameserver address (default: /etc/resolv.conf)");
+  dns_cmd->add_option("--name", dns_names, "Name to resolve (repeatable)");
+  dns_cmd->add_option("--port", dns_port, "Nameserver UDP port")->default_val(53);
+  dns_cmd->add_option("--repeat", dns_repeat, "Queries per name and server")->default_val(1);
+  dns_cmd->add_option("--timeout-ms", dns_timeout_ms, "Per-query timeout in ms")
+      ->default_val(1000);
+  dns_cmd->add_flag("--stub", dns_stub, "Benchmark an in-process stub resolver on 127.0.0.1");
+
+  // Ethtool subcommand
+  auto ethtool_cmd =
+      app.add_subcommand("ethtool", "Verify Ethernet link, NIC counters and offloads via ethtool");
+  std::string              ethtool_interface;
+  std::string              ethtool_host;
+  int                      ethtool_port     = 5201;
+  int                      ethtool_duration = 5;
+  bool                     ethtool_ab       = false;
+  std::vector<std::string> ethtool_features;
+  ethtool_cmd->add_option("--interface", ethtool_interface,
+                          "Interface to test (default: first Ethernet interface that is up)");
+  ethtool_cmd->add_option("--host", ethtool_host,
+                          "Throughput server on a peer; the load and --ab need one");
+  ethtool_cmd->add_option("--port", ethtool_port, "Throughput server port")->default_val(5201);
+  ethtool_cmd->add_option("--duration", ethtool_duration, "Seconds per load run")->default_val(5);
+  ethtool_cmd->add_flag("--ab", ethtool_ab, "A/B-measure throughput with each offload toggled");
+  ethtool_cmd->add_option("--feature", ethtool_features,
+                          "Offload to A/B test (repeatable, default: TSO, GRO, checksums)");
+
+  // PTP subcommand
+  auto ptp_cmd = app.add_subcommand("ptp", "Measure PHC offset and packet timestamp jitter");
+  std::string ptp_interface = "lo";
+  std::string ptp_rx_interface;
+  std::string ptp_device;
+  int         ptp_samples       = 50;
+  int         ptp_packets       = 100;
+  bool        ptp_hardware_only = false;
+  ptp_cmd->add_option("--interface", ptp_interface, "Transmit interface")->default_val("lo");
+  ptp_cmd->add_option("--rx-interface", ptp_rx_interface,
+                      "Receive interface, e.g. the peer of a veth pair (default: same)");
+  ptp_cmd->add_option("--ptp-device", ptp_device,
+                      "PTP clock device (default: PHC reported by the interface)");
+  ptp_cmd->add_option("--samples", ptp_samples, "PHC offset readings")->default_val(50);
+  ptp_cmd->add_option("--packets", ptp_packets, "Timestamped frames to exchange")
+      ->default_val(100);
+  ptp_cmd->add_flag("--no-software-fallback", ptp_hardware_only,
+                    "Fail instead of using software timestamps");
+
+  // Packet rate subcommand
+  auto pps_cmd =
+      app.add_subcommand("pps", "Small-frame packet rate stress over AF_XDP/TPACKET_V3 rings");
+  std::string pps_interface;
+  std::string pps_rx_interface;
+  std::string pps_backend    = "auto";
+  int         pps_frame_size = 64;
+  int         pps_duration   = 2;
+  int         pps_tx_cpu     = -1;
+  int         pps_rx_cpu     = -1;
+  pps_cmd->add_option("--interface", pps_interface,
+                      "Transmit interface (default: first veth pair found, else lo)");
+  pps_cmd->add_option("--rx-interface", pps_rx_interface, "Receive interface (default: same)");
+  pps_cmd->add_option("--frame-size", pps_frame_size, "On-wire frame size in bytes (64-1518)")
+      ->default_val(64);
+  pps_cmd->add_option("--duration", pps_duration, "Test duration in seconds")->default_val(2);
+  pps_cmd->add_option("--backend", pps_backend, "TX path: auto, xdp or tpacket")
+      ->default_val("auto");
+  pps_cmd->add_option("--tx-cpu", pps_tx_cpu, "Pin the TX thread to this core")->default_val(-1);
+  pps_cmd->add_option("--rx-cpu", pps_rx_cpu, "Pin the RX thread to this core")->default_val(-1);
+
+  // Energy subcommand
+  auto energy_cmd = app.add_subcommand("energy", "Measure joules per run of a benchmark workload");
+  std::string energy_workload = "spin";
+  std::string energy_rail;
+  int         energy_runs    = 3;
+  int         energy_idle_ms = 1000;
+  int         energy_spin_ms = 2000;
+  energy_cmd->add_option("--workload", energy_workload, "Workload: spin, cpu, memory or storage")
+      ->default_val("spin");
+  energy_cmd->add_option("--rail", energy_rail, "Rail to meter (default: highest idle power)");
+  energy_cmd->add_option("--runs", energy_runs, "Workload runs")->default_val(3);
+  energy_cmd->add_option("--idle-ms", energy_idle_ms, "Idle baseline window in ms")
+      ->default_val(1000);
+  energy_cmd->add_option("--spin-ms", energy_spin_ms, "Duration of one spin run in ms")
+      ->default_val(2000);
+
+  // Suspend subcommand
+  auto suspend_cmd =
+      app.add_subcommand("suspend", "Measure suspend/resume latency over RTC-woken cycles");
+  std::string suspend_state = "freeze";
+  std::string suspend_mem_sleep;
+  std::string suspend_rtc        = "rtc0";
+  int         suspend_cycles     = 3;
+  int         suspend_wake_after = 2;
+  suspend_cmd->add_option("--state", suspend_state, "Sleep state: freeze or mem")
+      ->default_val("freeze");
+  suspend_cmd->add_option("--mem-sleep", suspend_mem_sleep,
+                          "mem_sleep variant for mem: s2idle, shallow or deep");
+  suspend_cmd->add_option("--rtc", suspend_rtc, "RTC used as wake source")->default_val("rtc0");
+  suspend_cmd->add_option("--cycles", suspend_cycles, "Suspend/resume cycles")->default_val(3);
+  suspend_cmd->add_option("--wake-after", suspend_wake_after, "Seconds until the RTC wakes")
+      ->default_val(2);
+
+  // cpufreq sweep subcommand
+  auto cpufreq_cmd =
+      app.add_subcommand("cpufreq", "Energy sweep over cpufreq governors and pinned frequencies");
+  std::vector<std::string> cpufreq_governors;
+  std::vector<int>         cpufreq_frequencies;
+  std::string              cpufreq_rail;
+  int                      cpufreq_runs    = 1;
+  int                      cpufreq_idle_ms = 500;
+  uint64_t                 cpufreq_work    = 100000000;
+  cpufreq_cmd->add_option("--governor", cpufreq_governors,
+                          "Governor to test (repeatable, default: all available)");
+  cpufreq_cmd->add_option("--freq", cpufreq_frequencies,
+                          "Frequency to pin in kHz (repeatable, default: all available)");
+  cpufreq_cmd->add_option("--rail", cpufreq_rail, "Rail to meter (default: highest idle power)");
+  cpufreq_cmd->add_option("--runs", cpufreq_runs, "Workload runs per setting")->default_val(1);
+  cpufreq_cmd->add_option("--idle-ms", cpufreq_idle_ms, "Idle baseline window per setting in ms")
+      ->default_val(500);
+  cpufreq_cmd->add_option("--work", cpufreq_work, "Arithmetic rounds per core and run")
+      ->default_val(100000000);
+
+  // Burn-in subcommand
+  auto burnin_cmd =
+      app.add_subcommand("burnin", "Stress several subsystems at once while watching the board");
+  int                      burnin_duration  = 600;
+  int                      burnin_sample_ms = 1000;
+  std::vector<std::string> burnin_loads;
+  std::string              burnin_storage_path = "/tmp";
+  std::string              burnin_rail;
+  burnin_cmd->add_option("-d,--duration", burnin_duration, "Burn-in duration in seconds")
+      ->default_val(600);
+  burnin_cmd->add_option("--load", burnin_loads,
+                         "Load to run, NAME or NAME=INTENSITY (repeatable, default: cpu, memory, "
+                         "storage and networking)");
+  burnin_cmd->add_option("--storage-path", burnin_storage_path,
+                         "Directory for the storage load's scratch file")
+      ->default_val("/tmp");
+  burnin_cmd->add_option("--sample-ms", burnin_sample_ms, "Telemetry sample interval in ms")
+      ->default_val(1000);
+  burnin_cmd->add_option("--rail", burnin_rail, "Rail to meter (default: highest power)");
+  std::string burnin_record;
+  burnin_cmd->add_option("--record", burnin_record,
+                         "Record every raw sample to a binary telemetry file (see replay/export)");
+
+  // Daemon subcommand
+  auto daemon_cmd = app.add_subcommand(
+      "daemon", "Keep testers resident, sample continuously and serve state on a Unix socket");
+  std::vector<std::string> daemon_peripherals;
+  std::string              daemon_socket        = "/run/nxp-imx93-hw-vv.sock";
+  int                      daemon_window        = 60;
+  int                      daemon_test_interval = 3600;
+  int                      daemon_metrics_port  = 0;
+  std::string              daemon_metrics_addr  = "127.0.0.1";
+  daemon_cmd->add_option("peripherals", daemon_peripherals,
+                         "Peripherals to keep resident (default: all available)")
+      ->expected(0, -1);
+  daemon_cmd->add_option("--socket", daemon_socket, "Unix socket to serve requests on")
+      ->default_val("/run/nxp-imx93-hw-vv.sock");
+  daemon_cmd->add_option("--window", daemon_window, "Seconds per monitor run")->default_val(60);
+  daemon_cmd->add_option("--test-interval", daemon_test_interval,
+                         "Seconds between short tests (0 = on request only)")
+      ->default_val(3600);
+  daemon_cmd->add_option("--metrics-port", daemon_metrics_port,
+                         "Serve Prometheus /metrics over HTTP on this port (0 = off)")
+      ->default_val(0)
+      ->check(CLI::Range(0, 65535));
+  daemon_cmd->add_option("--metrics-address", daemon_metrics_addr, "IPv4 address /metrics binds")
+      ->default_val("127.0.0.1");
+
+  // Telemetry replay/export subcommands
+  auto replay_cmd =
+      app.add_subcommand("replay", "Summarise a binary telemetry recording like a monitor report");
+  auto export_cmd =
+      app.add_subcommand("export", "Convert a binary telemetry recording to CSV or JSON");
+  std::string              telemetry_file;
+  double                   telemetry_from = 0.0;
+  double                   telemetry_to   = 0.0;
+  std::vector<std::string> telemetry_metrics;
+  int                      replay_points = 32;
+  std::string              export_format = "csv";
+  std::string              export_out;
+  for (auto* command : {replay_cmd, export_cmd}) {
+    command->add_option("recording", telemetry_file, "File written with --record")->required();
+    command->add_option("--from", telemetry_from, "Start, in seconds from the recording start")
+        ->default_val(0.0);
+    command->add_option("--to", telemetry_to, "End, in seconds from the recording start (0: end)")
+        ->default_val(0.0);
+    command->add_option("--metric", telemetry_metrics,
+                        "Metric to include (repeatable, default: all)");
+  }
+  replay_cmd->add_option("--points", replay_points, "Buckets printed per metric")->default_val(32);
+  export_cmd->add_option("--format", export_format, "csv or json")->default_val("csv");
+  export_cmd->add_option("--out", export_out, "Output file (default: stdout)");
 
   CLI11_PARSE(app, argc, argv);
 
@@ -141,6 +507,9 @@ int main(int argc, char* argv[]) {
   if (json_output) {
     Logger::instance().set_console_output(false);
   }
+  if (async_log) {
+    Logger::instance().set_async(true);
+  }
 
   // Handle list command
   if (*list_cmd) {
@@ -148,8 +517,162 @@ int main(int argc, char* argv[]) {
     return 0;
   }
 
+  // Handle replay/export commands
+  if (*replay_cmd || *export_cmd) {
+    TelemetryReader reader;
+    if (!reader.open(telemetry_file)) {
+      LOG_ERROR(reader.last_error());
+      return 1;
+    }
+    if (reader.truncated()) {
+      LOG_WARN("Recording ends in an incomplete block after {} bytes; reading up to there",
+               reader.valid_bytes());
+    }
+    TelemetryRange range;
+    range.metrics = telemetry_metrics;
+    if (telemetry_from > 0.0) {
+      range.from_ns = reader.created_unix_ns() + static_cast<int64_t>(telemetry_from * 1e9);
+    }
+    if (telemetry_to > 0.0) {
+      range.to_ns = reader.created_unix_ns() + static_cast<int64_t>(telemetry_to * 1e9);
+    }
+
+    if (*replay_cmd) {
+      // Same tiering as PowerSampler, so a week at 1 kHz still fits the coarsest tier
+      TimeSeriesStore store(256, 10, 8);
+      uint64_t        records = reader.replay(range, store);
+      std::cout << "Recording " << telemetry_file << ": " << reader.metrics().size()
+                << " metrics, " << reader.record_count() << " records in " << reader.data_blocks()
+                << " blocks, " << records << " replayed\n"
+                << store.format(static_cast<size_t>(std::max(replay_points, 1)));
+    } else {
+      std::ofstream file;
+      if (!export_out.empty()) {
+        file.open(export_out);
+        if (!file) {
+          LOG_ERROR("Cannot write {}", export_out);
+          return 1;
+        }
+      }
+      std::ostream& out = export_out.empty() ? std::cout : file;
+      if (export_format == "json") {
+        reader.export_json(range, out);
+      } else if (export_format == "csv") {
+        reader.export_csv(range, out);
+      } else {
+        LOG_ERROR("Unknown export format: {}", export_format);
+        return 1;
+      }
+    }
+    if (reader.corrupt_blocks() > 0) {
+      LOG_WARN("{} data blocks failed their checksum", reader.corrupt_blocks());
+    }
+    return 0;
+  }
+
   std::vector<TestReport> reports;
   int                     failed_tests = 0;
+  TelemetryRecorder       recorder;
+
+  // Load the baseline up front so a bad file fails before any test runs
+  Baseline           baseline;
+  BaselineTolerances tolerances;
+  if (!compare_baseline.empty() && !baseline.load(compare_baseline)) {
+    LOG_ERROR(baseline.last_error());
+    return 1;
+  }
+  for (const auto& spec : baseline_tolerances) {
+    if (!tolerances.parse(spec)) {
+      LOG_ERROR("Invalid tolerance: {}", spec);
+      return 1;
+    }
+  }
+
+  TestWatchdogConfig watchdog_config;
+  watchdog_config.timeout = std::chrono::seconds(std::max(test_timeout, 0));
+  TestWatchdog watchdog(watchdog_config);
+  g_watchdog = &watchdog;
+  struct sigaction interrupt_action;
+  memset(&interrupt_action, 0, sizeof(interrupt_action));
+  interrupt_action.sa_handler = handle_interrupt;
+  interrupt_action.sa_flags   = SA_RESETHAND;
+  sigemptyset(&interrupt_action.sa_mask);
+  sigaction(SIGINT, &interrupt_action, nullptr);
+  sigaction(SIGTERM, &interrupt_action, nullptr);
+
+  // Deadline of a test that is expected to take a given number of seconds
+  auto deadline = [&](int64_t expected_s) {
+    return test_timeout > 0 ? std::chrono::milliseconds((test_timeout + expected_s) * 1000)
+                            : std::chrono::milliseconds(0);
+  };
+
+  // An abandoned test may still be using the logger, the recorder or locals of main(), so
+  // once output is written, leave without running the destructors it would race with
+  auto finish = [](int status, size_t abandoned) {
+    if (abandoned > 0) {
+      LOG_WARN("{} abandoned tests are still running; exiting without cleanup", abandoned);
+      Logger::instance().flush();
+      std::cout.flush();
+      std::cerr.flush();
+      std::quick_exit(status);
+    }
+    return status;
+  };
+
+  // Every test's report is kept for the JSON output and printed otherwise
+  auto record_report = [&](const TestReport& report) {
+    reports.push_back(report);
+    if (!json_output) {
+      LOG_INFO("Result: {}", test_result_to_string(report.result));
+      LOG_INFO("Details: {}", report.details);
+    }
+    if (report.result != TestResult::SUCCESS) {
+      failed_tests++;
+    }
+  };
+
+  // Handle daemon command; runs until SIGINT/SIGTERM
+  if (*daemon_cmd) {
+    HealthDaemonConfig config;
+    config.socket_path     = daemon_socket;
+    config.sample_window   = std::chrono::seconds(std::max(daemon_window, 1));
+    config.test_interval   = std::chrono::seconds(std::max(daemon_test_interval, 0));
+    config.timeout         = std::chrono::seconds(std::max(test_timeout, 0));
+    config.metrics_port    = daemon_metrics_port > 0 ? daemon_metrics_port : -1;
+    config.metrics_address = daemon_metrics_addr;
+    HealthDaemon daemon(config);
+
+    if (daemon_peripherals.empty()) {
+      for (const auto& pair : tester_registry) {
+        if (pair.second.probe()) {
+          daemon_peripherals.push_back(pair.first);
+        }
+      }
+    }
+    for (const auto& name : daemon_peripherals) {
+      auto it = tester_registry.find(name);
+      if (it == tester_registry.end()) {
+        LOG_ERROR("Unknown peripheral: {}", name);
+        return 1;
+      }
+      std::shared_ptr<PeripheralTester> tester = it->second.create();
+      if (!tester->prepare()) {
+        LOG_WARN("{}: Not available, skipping...", name);
+        continue;
+      }
+      daemon.add_tester(name, tester);
+    }
+    if (!daemon.start()) {
+      LOG_ERROR(daemon.last_error());
+      return 1;
+    }
+    while (!watchdog.interrupted()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    daemon.stop();
+    LOG_INFO("Health daemon stopped after {} requests", daemon.requests_served());
+    return finish(0, daemon.abandoned());
+  }
 
   /**
    * @brief Lambda function to execute a test for a specific peripheral.
@@ -164,55 +687,95 @@ int main(int argc, char* argv[]) {
    */
   auto run_test = [&](const std::string& name, bool is_monitor = false, int duration = 0) {
     if (tester_registry.find(name) == tester_registry.end()) {
-      LOG_ERROR("Unknown peripheral: " + name);
+      LOG_ERROR("Unknown peripheral: {}", name);
       return;
     }
 
-    auto tester = tester_registry[name]();
-    if (!tester->is_available()) {
-      LOG_WARN(name + ": Not available, skipping...");
+    if (watchdog.interrupted()) {
+      return;
+    }
+    std::shared_ptr<PeripheralTester> tester = tester_registry[name].create();
+    if (!tester->prepare()) {
+      LOG_WARN("{}: Not available, skipping...", name);
       return;
     }
 
     TestReport report;
     if (is_monitor) {
-      LOG_INFO("Running monitoring test for " + name + " (" + std::to_string(duration) + "s)...");
-      report = tester->monitor_test(std::chrono::seconds(duration));
-    } else {
-      LOG_INFO("Running short test for " + name + "...");
-      report = tester->short_test();
-    }
+      auto* networking = dynamic_cast<NetworkingTester*>(tester.get());
+      if (networking != nullptr) {
+        NetworkMonitorConfig config;
+        config.sample_interval = std::chrono::milliseconds(std::max(monitor_sample_ms, 1));
+        config.generate_load   = monitor_load;
+        config.load.host       = monitor_load_host;
+        networking->set_monitor_config(config);
+      }
+      auto* power = dynamic_cast<PowerTester*>(tester.get());
+      if (power != nullptr) {
+        PowerSamplerConfig config;
+        config.brownout.relative_threshold = monitor_brownout_fraction;
+        for (const auto& spec : monitor_brownout_rails) {
+          std::string rail;
+          double      volts = 0.0;
+          if (parse_rail_threshold(spec, rail, volts)) {  // Validated by CLI11
+            config.brownout.absolute_threshold_v[rail] = volts;
+          }
+        }
+        power->set_monitor_config(config);
+      }
 
-    reports.push_back(report);
+      if (recorder.is_open()) {
+        tester->set_telemetry_sink(recorder.sink(name));
+      }
+      LOG_INFO("Running monitoring test for {} ({}s)...", name, duration);
+      report = watchdog.run(
+          tester,
+          [duration](PeripheralTester& t) {
+            return t.monitor_test(std::chrono::seconds(duration));
+          },
+          deadline(duration));
 
-    if (!json_output) {
-      LOG_INFO("Result: " + test_result_to_string(report.result));
-      LOG_INFO("Details: " + report.details);
+      if (networking != nullptr && !monitor_series_output.empty() &&
+          report.result != TestResult::TIMEOUT && report.result != TestResult::SKIPPED) {
+        std::ofstream series_file(monitor_series_output);
+        NetworkMonitor::write_csv(networking->last_monitor_result(), series_file);
+      }
+    } else {
+      LOG_INFO("Running short test for {}...", name);
+      report = watchdog.run(tester, [](PeripheralTester& t) { return t.short_test(); });
     }
 
-    if (report.result != TestResult::SUCCESS) {
-      failed_tests++;
-    }
+    record_report(report);
   };
 
   // Handle test command
   if (*test_cmd) {
     if (test_all) {
+      test_peripherals.clear();
       for (const auto& pair : tester_registry) {
-        run_test(pair.first, false);
+        test_peripherals.push_back(pair.first);
+      }
+    } else if (test_peripherals.empty()) {
+      std::cout << "Error: Specify --all or provide peripheral names for test command\n";
+      return 1;
+    }
+    // Round-robin, so drift over the session spreads evenly across peripherals
+    for (int run = 1; run <= test_repeat && !watchdog.interrupted(); ++run) {
+      if (test_repeat > 1) {
+        LOG_INFO("Run {} of {}", run, test_repeat);
       }
-    } else if (!test_peripherals.empty()) {
       for (const auto& peripheral : test_peripherals) {
         run_test(peripheral, false);
       }
-    } else {
-      std::cout << "Error: Specify --all or provide peripheral names for test command\n";
-      return 1;
     }
   }
 
   // Handle monitor command
   if (*monitor_cmd) {
+    if (!monitor_record.empty() && !recorder.open(monitor_record)) {
+      LOG_ERROR(recorder.last_error());
+      return 1;
+    }
     if (monitor_all) {
       for (const auto& pair : tester_registry) {
         run_test(pair.first, true, monitor_duration);
@@ -225,35 +788,364 @@ int main(int argc, char* argv[]) {
       std::cout << "Error: Specify --all or provide peripheral names for monitor command\n";
       return 1;
     }
+    if (recorder.is_open()) {
+      recorder.close();
+      LOG_INFO("Recorded {} samples to {} ({} dropped)", recorder.records_written(), monitor_record,
+               recorder.records_dropped());
+    }
+  }
+
+  // Handle throughput command
+  if (*throughput_cmd) {
+    ThroughputConfig config;
+    config.protocol     = throughput_udp ? TransportProtocol::UDP : TransportProtocol::TCP;
+    config.host         = throughput_host;
+    config.port         = static_cast<uint16_t>(throughput_port);
+    config.streams      = static_cast<uint32_t>(std::max(throughput_streams, 1));
+    config.duration     = std::chrono::seconds(throughput_duration);
+    config.bitrate_mbps = throughput_bitrate;
+
+    if (throughput_server) {
+      ThroughputEngine engine(config);
+      if (!engine.start_server()) {
+        LOG_ERROR("Throughput server failed: {}", engine.last_error());
+        return 1;
+      }
+      LOG_INFO("Throughput server listening on {}:{}", config.host, engine.server_port());
+      auto end_time = std::chrono::steady_clock::now() + config.duration;
+      while ((throughput_duration == 0 || std::chrono::steady_clock::now() < end_time) &&
+             !watchdog.interrupted()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      }
+      engine.stop_server();
+      LOG_INFO("Throughput server received {} bytes", engine.server_bytes_received());
+      return 0;
+    }
+
+    auto tester = std::make_shared<NetworkingTester>();
+    tester->prepare();
+    LOG_INFO("Running throughput test against {}:{}...", config.host, config.port);
+    TestReport report = watchdog.run(
+        tester,
+        [config](PeripheralTester& t) {
+          return static_cast<NetworkingTester&>(t).throughput_test(config);
+        },
+        deadline(throughput_duration));
+    record_report(report);
+  }
+
+  // Handle dns command
+  if (*dns_cmd) {
+    DnsBenchmarkConfig config;
+    config.servers = dns_servers;
+    config.port    = static_cast<uint16_t>(dns_port);
+    config.names   = dns_names.empty()
+                         ? std::vector<std::string>{"google.com", "github.com", "stackoverflow.com",
+                                                    "kernel.org", "nxp.com"}
+                         : dns_names;
+    config.repeat  = static_cast<uint32_t>(std::max(dns_repeat, 1));
+    config.timeout = std::chrono::milliseconds(std::max(dns_timeout_ms, 1));
+
+    DnsStubServer stub;
+    if (dns_stub) {
+      if (!stub.start()) {
+        LOG_ERROR("Failed to start DNS stub resolver");
+        return 1;
+      }
+      config.servers = {"127.0.0.1"};
+      config.port    = stub.port();
+    }
+
+    auto tester = std::make_shared<NetworkingTester>();
+    tester->prepare();
+    LOG_INFO("Running DNS benchmark...");
+    TestReport report = watchdog.run(
+        tester,
+        [config](PeripheralTester& t) {
+          return static_cast<NetworkingTester&>(t).dns_benchmark_test(config);
+        },
+        deadline(0));
+    record_report(report);
+  }
+
+  // Handle ethtool command
+  if (*ethtool_cmd) {
+    EthtoolTestConfig config;
+    config.interface_name = ethtool_interface;
+    config.load.host      = ethtool_host;
+    config.load.port      = static_cast<uint16_t>(ethtool_port);
+    config.load.duration  = std::chrono::seconds(std::max(ethtool_duration, 1));
+    config.offload_ab     = ethtool_ab;
+    if (!ethtool_features.empty()) {
+      config.ab_features = ethtool_features;
+    }
+
+    auto tester = std::make_shared<NetworkingTester>();
+    tester->prepare();
+    LOG_INFO("Running ethtool verification...");
+    TestReport report = watchdog.run(
+        tester,
+        [config](PeripheralTester& t) {
+          return static_cast<NetworkingTester&>(t).ethtool_test(config);
+        },
+        deadline(ethtool_duration));
+    record_report(report);
+  }
+
+  // Handle ptp command
+  if (*ptp_cmd) {
+    PtpTimestampConfig config;
+    config.tx_interface   = ptp_interface;
+    config.rx_interface   = ptp_rx_interface;
+    config.ptp_device     = ptp_device;
+    config.offset_samples = static_cast<uint32_t>(std::max(ptp_samples, 1));
+    config.packets        = static_cast<uint32_t>(std::max(ptp_packets, 1));
+    config.allow_software = !ptp_hardware_only;
+
+    auto tester = std::make_shared<NetworkingTester>();
+    tester->prepare();
+    LOG_INFO("Running PTP timestamp test...");
+    TestReport report = watchdog.run(
+        tester,
+        [config](PeripheralTester& t) {
+          return static_cast<NetworkingTester&>(t).ptp_test(config);
+        },
+        deadline(0));
+    record_report(report);
+  }
+
+  // Handle pps command
+  if (*pps_cmd) {
+    PacketRateConfig config;
+    config.tx_interface = pps_interface;
+    config.rx_interface = pps_rx_interface;
+    config.frame_size   = static_cast<size_t>(std::max(pps_frame_size, 0));
+    config.duration     = std::chrono::seconds(std::max(pps_duration, 1));
+    config.tx_cpu       = pps_tx_cpu;
+    config.rx_cpu       = pps_rx_cpu;
+    if (pps_backend == "xdp") {
+      config.backend = PacketTxBackend::XDP;
+    } else if (pps_backend == "tpacket") {
+      config.backend = PacketTxBackend::TPACKET;
+    }
+
+    auto tester = std::make_shared<NetworkingTester>();
+    tester->prepare();
+    LOG_INFO("Running packet rate test...");
+    TestReport report = watchdog.run(
+        tester,
+        [config](PeripheralTester& t) {
+          return static_cast<NetworkingTester&>(t).packet_rate_test(config);
+        },
+        deadline(pps_duration));
+    record_report(report);
+  }
+
+  // Handle energy command
+  if (*energy_cmd) {
+    EnergyMeterConfig config;
+    config.rail        = energy_rail;
+    config.runs        = static_cast<uint32_t>(std::max(energy_runs, 1));
+    config.idle_window = std::chrono::milliseconds(std::max(energy_idle_ms, 0));
+
+    // Peripheral workloads count the checks each short_test() pass completes
+    EnergyMeter::Workload workload;
+    if (energy_workload == "spin") {
+      auto spin = std::chrono::milliseconds(std::max(energy_spin_ms, 1));
+      workload  = [spin]() { return EnergyMeter::cpu_spin(spin); };
+    } else if (energy_workload == "cpu") {
+      workload = make_workload_pass<CPUTester>();
+    } else if (energy_workload == "memory") {
+      workload = make_workload_pass<MemoryTester>();
+    } else if (energy_workload == "storage") {
+      workload = make_workload_pass<StorageTester>();
+    } else {
+      LOG_ERROR("Unknown workload: {}", energy_workload);
+      return 1;
+    }
+    if (!workload) {
+      LOG_ERROR("Workload not available: {}", energy_workload);
+      return 1;
+    }
+
+    auto tester = std::make_shared<PowerTester>();
+    tester->prepare();
+    LOG_INFO("Running energy measurement...");
+    TestReport report = watchdog.run(
+        tester,
+        [energy_workload, workload, config](PeripheralTester& t) {
+          return static_cast<PowerTester&>(t).energy_test(energy_workload, workload, config);
+        },
+        deadline(0));
+    record_report(report);
+  }
+
+  // Handle suspend command
+  if (*suspend_cmd) {
+    SuspendLatencyConfig config;
+    config.state      = suspend_state;
+    config.mem_sleep  = suspend_mem_sleep;
+    config.rtc        = suspend_rtc;
+    config.cycles     = static_cast<uint32_t>(std::max(suspend_cycles, 1));
+    config.wake_after = std::chrono::seconds(std::max(suspend_wake_after, 1));
+
+    auto tester = std::make_shared<PowerTester>();
+    tester->prepare();
+    LOG_INFO("Running suspend/resume latency test...");
+    TestReport report = watchdog.run(
+        tester,
+        [config](PeripheralTester& t) {
+          return static_cast<PowerTester&>(t).suspend_test(config);
+        },
+        deadline(suspend_cycles * (suspend_wake_after + 10)));
+    record_report(report);
+  }
+
+  // Handle cpufreq command
+  if (*cpufreq_cmd) {
+    CpufreqSweepConfig config;
+    config.governors = cpufreq_governors;
+    for (int frequency : cpufreq_frequencies) {
+      if (frequency > 0) {
+        config.frequencies_khz.push_back(static_cast<uint32_t>(frequency));
+      }
+    }
+    config.meter.rail        = cpufreq_rail;
+    config.meter.runs        = static_cast<uint32_t>(std::max(cpufreq_runs, 1));
+    config.meter.idle_window = std::chrono::milliseconds(std::max(cpufreq_idle_ms, 0));
+    config.work_per_core     = std::max<uint64_t>(cpufreq_work, 1);
+
+    // A cancelled sweep stops between runs and restores the cpufreq state itself
+    auto tester = std::make_shared<PowerTester>();
+    tester->prepare();
+    LOG_INFO("Running cpufreq energy sweep...");
+    TestReport report = watchdog.run(
+        tester,
+        [config](PeripheralTester& t) {
+          return static_cast<PowerTester&>(t).cpufreq_test(config);
+        },
+        deadline(0));
+    record_report(report);
+  }
+
+  // Handle burnin command
+  if (*burnin_cmd) {
+    BurnInConfig config;
+    config.sample_interval = std::chrono::milliseconds(std::max(burnin_sample_ms, 1));
+    config.power_rail      = burnin_rail;
+
+    // Intensity 0 lets each tester pick its default load size
+    if (burnin_loads.empty()) {
+      burnin_loads = {"cpu", "memory", "storage", "networking"};
+    }
+    auto        burnin = std::make_shared<BurnInTester>(config);
+    std::string setup_errors;  // Reported as a failed burn-in instead of running it
+    for (const auto& load : burnin_loads) {
+      size_t      separator = load.find('=');
+      std::string name      = load.substr(0, separator);
+      int intensity = separator != std::string::npos ? std::atoi(load.c_str() + separator + 1) : 0;
+      auto it       = tester_registry.find(name);
+      if (it == tester_registry.end()) {
+        LOG_ERROR("Unknown burn-in load: {}", name);
+        setup_errors += "Unknown burn-in load: " + name + "\n";
+        continue;
+      }
+      std::unique_ptr<PeripheralTester> tester = it->second.create();
+      if (auto* storage = dynamic_cast<StorageTester*>(tester.get())) {
+        storage->set_stress_path(burnin_storage_path);
+      }
+      burnin->add_load(name, std::move(tester), static_cast<uint32_t>(std::max(intensity, 0)));
+    }
+
+    if (!burnin_record.empty() && !recorder.open(burnin_record)) {
+      LOG_ERROR(recorder.last_error());
+      setup_errors += recorder.last_error() + "\n";
+    }
+    if (!setup_errors.empty()) {
+      TestReport report;
+      report.result          = TestResult::FAILURE;
+      report.peripheral_name = burnin->get_peripheral_name();
+      report.details         = setup_errors;
+      record_report(report);
+    } else {
+      if (recorder.is_open()) {
+        burnin->set_telemetry_sink(recorder.sink("burnin"));
+      }
+      LOG_INFO("Running burn-in for {}s...", burnin_duration);
+      auto       duration = std::chrono::seconds(std::max(burnin_duration, 1));
+      TestReport report   = watchdog.run(
+          burnin, [duration](PeripheralTester& t) { return t.monitor_test(duration); },
+          deadline(duration.count()));
+      recorder.close();
+      record_report(report);
+    }
   }
 
   // If no subcommand was used, show help
-  if (!*list_cmd && !*test_cmd && !*monitor_cmd) {
+  if (!*list_cmd && !*test_cmd && !*monitor_cmd && !*throughput_cmd && !*dns_cmd &&
+      !*ethtool_cmd && !*ptp_cmd && !*pps_cmd && !*energy_cmd && !*suspend_cmd && !*cpufreq_cmd &&
+      !*burnin_cmd && !*daemon_cmd && !*replay_cmd && !*export_cmd) {
     std::cout << app.help() << std::endl;
     return 1;
   }
 
-  if (json_output) {
-    std::stringstream json_ss;
-    json_ss << "{\"tests\": [";
-    for (size_t i = 0; i < reports.size(); ++i) {
-      json_ss << reports[i].to_json();
-      if (i < reports.size() - 1)
-        json_ss << ",";
-    }
-    json_ss << "], \"summary\": {";
-    json_ss << "\"total\": " << reports.size() << ",";
-    json_ss << "\"failed\": " << failed_tests << ",";
-    json_ss << "\"passed\": " << (reports.size() - failed_tests);
-    json_ss << "}}";
+  if (!save_baseline.empty() || !compare_baseline.empty()) {
+    Baseline current;
+    for (const auto& report : reports) {
+      current.add(report);
+    }
+    if (!save_baseline.empty()) {
+      if (!current.save(save_baseline)) {
+        LOG_ERROR(current.last_error());
+        return finish(1, watchdog.abandoned());
+      }
+      LOG_INFO("Saved {} metrics to baseline {}", current.metrics().size(), save_baseline);
+    }
+    if (!compare_baseline.empty()) {
+      LOG_INFO("Comparing against baseline {}...", compare_baseline);
+      record_report(Baseline::comparison_report(baseline.compare(current, tolerances)));
+    }
+  }
 
+  if (json_output) {
+    // Reports are streamed straight to the file descriptor rather than assembled in memory
+    int fd = STDOUT_FILENO;
     if (!output_file.empty()) {
-      std::ofstream out(output_file);
-      out << json_ss.str();
+      fd = ::open(output_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (fd < 0) {
+        std::cerr << "Cannot create " << output_file << std::endl;
+        return finish(1, watchdog.abandoned());
+      }
     } else {
-      std::cout << json_ss.str() << std::endl;
+      std::cout.flush();
+    }
+
+    JsonStream json(fd);
+    json.begin_object().key("tests").begin_array();
+    for (const auto& report : reports) {
+      report.write_json(json);
+    }
+    json.end_array();
+    json.key("summary").begin_object();
+    json.key("total").value(reports.size());
+    json.key("failed").value(failed_tests);
+    json.key("passed").value(reports.size() - failed_tests);
+    json.end_object().end_object();
+    if (output_file.empty()) {
+      json.raw("\n");
+    }
+    bool written = json.flush();
+    if (fd != STDOUT_FILENO) {
+      ::close(fd);
+    }
+    if (!written) {
+      std::cerr << "Failed to write JSON output" << std::endl;
+      return finish(1, watchdog.abandoned());
     }
   }
 
-  return failed_tests == 0 ? 0 : 1;
+  if (watchdog.interrupted()) {
+    return finish(130, watchdog.abandoned());
+  }
+  return finish(failed_tests == 0 ? 0 : 1, watchdog.abandoned());
 }
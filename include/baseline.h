@@ -0,0 +1,202 @@
+/**
+ * @file baseline.h
+ * @brief Saved benchmark baselines and their regression comparison.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines Baseline, the samples of every metric a run reported
+ * grouped per peripheral, and the statistics used to decide whether a later
+ * run regressed against a saved one.
+ *
+ * @details
+ * - Every metric keeps all of its samples, one per repeated run, so a
+ *   comparison works on medians rather than on one noisy value.
+ * - A metric's goal is derived from its unit: rates such as MB/s or Mbps
+ *   should go up, times and energies such as ms or J should go down, and
+ *   anything else (counts, temperatures, sizes) is only reported if it moves.
+ * - A metric regresses when its median moved the wrong way by more than its
+ *   tolerance and the 95% confidence intervals of the two medians do not
+ *   overlap, so a single outlier cannot fail a run.
+ * - The file is plain text, one tab-separated metric per line, so baselines
+ *   can be diffed and reviewed alongside the BSP change they belong to.
+ */
+
+#ifndef BASELINE_H
+#define BASELINE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "peripheral_tester.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @enum MetricGoal
+ * @brief Which direction of change is an improvement.
+ */
+enum class MetricGoal {
+  HIGHER, /**< Throughputs and rates */
+  LOWER,  /**< Latencies, durations, power and energy */
+  NONE    /**< Counts, sizes, temperatures; any significant change is reported */
+};
+
+/**
+ * @brief Returns the goal of a metric from its unit, e.g. HIGHER for "MB/s".
+ */
+MetricGoal metric_goal(const std::string& unit);
+
+std::string metric_goal_to_string(MetricGoal goal);
+
+/**
+ * @struct SampleStats
+ * @brief Robust summary of repeated measurements of one metric.
+ */
+struct SampleStats {
+  size_t samples = 0;
+  double median  = 0.0;
+  double mad     = 0.0; /**< Median absolute deviation from the median */
+  double ci_low  = 0.0; /**< 95% confidence interval of the median */
+  double ci_high = 0.0;
+
+  /**
+   * @brief Computes the summary; the interval uses order statistics, so it
+   * needs no assumption about the distribution and spans all samples below six.
+   */
+  static SampleStats of(std::vector<double> values);
+};
+
+/**
+ * @struct BaselineMetric
+ * @brief All samples of one metric of one peripheral.
+ */
+struct BaselineMetric {
+  std::string         peripheral; /**< e.g. "Storage" */
+  std::string         name;       /**< e.g. "mmcblk0_write_speed" */
+  std::string         unit;
+  MetricGoal          goal = MetricGoal::NONE;
+  std::vector<double> values;
+
+  /**
+   * @brief Returns "peripheral/name", the key tolerances are matched against.
+   */
+  std::string key() const {
+    return peripheral + "/" + name;
+  }
+};
+
+/**
+ * @enum BaselineVerdict
+ * @brief Outcome of comparing one metric against its baseline.
+ */
+enum class BaselineVerdict {
+  UNCHANGED, /**< Within tolerance, or not distinguishable from noise */
+  IMPROVED,
+  REGRESSED,
+  CHANGED,   /**< Significant change of a metric without a goal */
+  MISSING,   /**< In the baseline but not measured this run */
+  NEW        /**< Measured this run but not in the baseline */
+};
+
+std::string baseline_verdict_to_string(BaselineVerdict verdict);
+
+/**
+ * @struct BaselineComparison
+ * @brief One metric of a run compared against the saved baseline.
+ */
+struct BaselineComparison {
+  std::string     key;
+  std::string     unit;
+  MetricGoal      goal = MetricGoal::NONE;
+  SampleStats     baseline;
+  SampleStats     current;
+  double          change_percent    = 0.0; /**< Of the median; NaN if the baseline median is 0 */
+  double          tolerance_percent = 0.0;
+  BaselineVerdict verdict           = BaselineVerdict::UNCHANGED;
+};
+
+/**
+ * @struct BaselineTolerances
+ * @brief Allowed change of the median in percent, per metric.
+ */
+struct BaselineTolerances {
+  double                        default_percent = 5.0;
+  std::map<std::string, double> overrides; /**< By key prefix, e.g. "Storage/" */
+
+  /**
+   * @brief Parses "PERCENT" as the default or "PREFIX=PERCENT" as an override.
+   * @return false if the percentage is not a non-negative number.
+   */
+  bool parse(const std::string& spec);
+
+  /**
+   * @brief Returns the tolerance of the longest override prefixing the key, or the default.
+   */
+  double for_key(const std::string& key) const;
+};
+
+/**
+ * @class Baseline
+ * @brief Samples of the metrics of one or more runs, saved to and loaded from a file.
+ */
+class Baseline {
+public:
+  /**
+   * @brief Adds every finite metric of a completed report as one more sample.
+   *
+   * Reports that were skipped, timed out or are not supported carry no
+   * measurements and are ignored.
+   */
+  void add(const TestReport& report);
+
+  const std::vector<BaselineMetric>& metrics() const {
+    return metrics_;
+  }
+
+  /**
+   * @brief Writes the baseline; see last_error() on failure.
+   */
+  bool save(const std::string& path);
+
+  /**
+   * @brief Replaces the contents with a saved baseline; see last_error() on failure.
+   */
+  bool load(const std::string& path);
+
+  /**
+   * @brief Compares a run against this baseline.
+   * @param current Metrics of the run.
+   * @param tolerances Allowed change per metric.
+   * @return One comparison per metric of either side, in baseline order, new ones last.
+   */
+  std::vector<BaselineComparison> compare(const Baseline&           current,
+                                          const BaselineTolerances& tolerances) const;
+
+  /**
+   * @brief Summarises comparisons as a report that fails if anything regressed.
+   *
+   * Every compared metric becomes a check, and its median change a metric
+   * named after its key with a "_change" suffix.
+   */
+  static TestReport comparison_report(const std::vector<BaselineComparison>& comparisons);
+
+  /**
+   * @brief Returns the error of the last failed save() or load().
+   */
+  const std::string& last_error() const {
+    return error_;
+  }
+
+private:
+  BaselineMetric& find_or_add(const std::string& peripheral, const std::string& name,
+                              const std::string& unit);
+
+  std::vector<BaselineMetric>   metrics_;
+  std::map<std::string, size_t> index_; /**< Key to position in metrics_ */
+  std::string                   error_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // BASELINE_H
@@ -0,0 +1,178 @@
+/**
+ * @file burnin_tester.h
+ * @brief Concurrent multi-subsystem burn-in for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the BurnInTester class, which runs the stress() loads
+ * of several peripheral testers at the same time for a fixed duration while
+ * sampling load throughput, SoC temperature, CPU frequency, rail power and
+ * hardware error counters.
+ *
+ * @details
+ * - Each load runs on its own thread; all of them share one stop flag and
+ *   are stopped together when the duration ends.
+ * - Load progress is read from the testers' StressCounters once per sample
+ *   interval, so throughput degradation caused by thermal throttling or
+ *   bus contention is visible as a drop between the first and last quarter
+ *   of the run.
+ * - Per-load rates, temperature, frequency and power go into
+ *   monitor_series(), so memory stays bounded on multi-day runs.
+ * - Temperature is the hottest thermal zone, frequency the mean
+ *   scaling_cur_freq over all CPUs, power the metered rail of PowerSampler.
+ * - EDAC corrected/uncorrected counts and network interface error and drop
+ *   counters are compared between start and end; any growth of an error
+ *   counter fails the burn-in, drops are reported only.
+ * - The sysfs root is configurable so tests can run against a fake tree.
+ */
+
+#ifndef BURNIN_TESTER_H
+#define BURNIN_TESTER_H
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "peripheral_tester.h"
+#include "power_sampler.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct BurnInConfig
+ * @brief Sampling parameters of a burn-in.
+ */
+struct BurnInConfig {
+  std::string               sysfs_root      = "/sys";
+  std::chrono::milliseconds sample_interval = std::chrono::milliseconds(1000);
+  PowerSamplerConfig        power;      /**< Its sysfs_root is replaced by the one above */
+  std::string               power_rail; /**< Rail to meter; empty = highest average power */
+};
+
+/**
+ * @struct BurnInLoadResult
+ * @brief Outcome of one stress load.
+ */
+struct BurnInLoadResult {
+  std::string name;
+  uint32_t    intensity  = 0;
+  TestResult  result     = TestResult::SKIPPED;
+  uint64_t    operations = 0;
+  uint64_t    bytes      = 0;
+  uint64_t    errors     = 0;
+  std::string unit;                  /**< "MB/s" for data-bound loads, otherwise "ops/s" */
+  double      average_rate    = 0.0; /**< Over the whole run */
+  double      first_rate      = 0.0; /**< Over the first quarter of the samples */
+  double      last_rate       = 0.0; /**< Over the last quarter of the samples */
+  double      degradation_pct = 0.0; /**< Drop of last_rate below first_rate */
+};
+
+/**
+ * @struct BurnInResult
+ * @brief Outcome of a burn-in.
+ */
+struct BurnInResult {
+  bool                            success   = false;
+  bool                            supported = false; /**< At least one load could run */
+  double                          elapsed_s = 0.0;
+  size_t                          samples   = 0; /**< Sample intervals; see monitor_series() */
+  std::vector<BurnInLoadResult>   loads;
+  double                          max_temperature_c = NAN;
+  double                          min_cpu_mhz       = NAN;
+  double                          max_cpu_mhz       = NAN;
+  std::string                     power_rail; /**< Empty without power telemetry */
+  double                          energy_j        = 0.0;
+  double                          average_power_w = 0.0;
+  std::map<std::string, uint64_t> counter_deltas; /**< Error/drop counters that grew */
+  std::string                     error_message;
+};
+
+/**
+ * @class BurnInTester
+ * @brief Runs several peripheral stress loads concurrently and watches the board.
+ *
+ * The loads are added with add_load() before the run; monitor_test() runs
+ * them for the requested duration and short_test() for ten seconds.
+ */
+class BurnInTester : public PeripheralTester {
+public:
+  /**
+   * @brief Constructs a burn-in without loads.
+   * @param config Sampling configuration.
+   */
+  explicit BurnInTester(const BurnInConfig& config = BurnInConfig());
+
+  /**
+   * @brief Adds a load to the mix.
+   * @param name Name used in the report, e.g. "memory".
+   * @param tester Tester whose stress() provides the load; prepare() is called here.
+   * @param intensity Passed to stress(); its meaning is tester specific.
+   */
+  void add_load(const std::string& name, std::unique_ptr<PeripheralTester> tester,
+                uint32_t intensity);
+
+  /**
+   * @brief Runs a ten-second burn-in.
+   * @return TestReport with the per-load and telemetry summary.
+   */
+  TestReport short_test() override;
+
+  /**
+   * @brief Runs all loads concurrently for the given duration.
+   * @param duration Burn-in length.
+   * @return TestReport with the per-load and telemetry summary.
+   */
+  TestReport monitor_test(std::chrono::seconds duration) override;
+
+  std::string get_peripheral_name() const override {
+    return "BurnIn";
+  }
+
+  /**
+   * @brief Returns true once at least one load has been added.
+   */
+  bool is_available() const override;
+
+  /**
+   * @brief Returns the summary of the last run.
+   */
+  const BurnInResult& last_result() const {
+    return result_;
+  }
+
+  /**
+   * @brief Computes the average, first/last-quarter rates and degradation of a load.
+   * @param rate Per-interval rate series of the load.
+   * @param summary Load result whose rate fields are filled in.
+   */
+  static void summarize_rates(const TimeSeries& rate, BurnInLoadResult& summary);
+
+private:
+  struct Load {
+    std::string                       name;
+    std::unique_ptr<PeripheralTester> tester;
+    uint32_t                          intensity = 0;
+  };
+
+  /**
+   * @brief Runs the burn-in and fills result_.
+   */
+  void run(std::chrono::milliseconds duration);
+
+  /**
+   * @brief Returns the error and drop counters of EDAC and network interfaces.
+   */
+  std::map<std::string, uint64_t> read_error_counters() const;
+
+  BurnInConfig      config_;
+  std::vector<Load> loads_;
+  BurnInResult      result_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // BURNIN_TESTER_H
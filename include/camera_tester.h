@@ -86,7 +86,17 @@ public:
    */
   bool is_available() const override;
 
+  /**
+   * @brief Returns true if a V4L2 device or class exists, without constructing a tester.
+   */
+  static bool probe();
+
 private:
+  /**
+   * @brief Enumerates the V4L2 camera devices if probe() succeeds.
+   */
+  void discover() override;
+
   /**
    * @brief Enumerates all camera devices on the system.
    * @return Vector of CameraInfo structures.
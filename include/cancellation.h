@@ -0,0 +1,89 @@
+/**
+ * @file cancellation.h
+ * @brief Cooperative cancellation of running tests.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines CancellationToken, which a watchdog or signal path
+ * sets and long-running test loops check between steps.
+ *
+ * @details
+ * - Loops replace their pacing sleeps with wait_for()/wait_until(), which
+ *   return as soon as the token is cancelled, so a cancelled monitor stops
+ *   within one step instead of at the end of its interval.
+ * - cancel() takes a mutex and must not be called from a signal handler;
+ *   handlers set a flag that the watchdog turns into cancel().
+ */
+
+#ifndef CANCELLATION_H
+#define CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace imx93_peripheral_test {
+
+/**
+ * @class CancellationToken
+ * @brief Flag that asks a running test to stop, with interruptible waits.
+ */
+class CancellationToken {
+public:
+  CancellationToken() = default;
+
+  CancellationToken(const CancellationToken&)            = delete;
+  CancellationToken& operator=(const CancellationToken&) = delete;
+
+  /**
+   * @brief Asks the test to stop and wakes any wait in progress.
+   */
+  void cancel() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cancelled_.store(true, std::memory_order_release);
+    }
+    wake_.notify_all();
+  }
+
+  /**
+   * @brief Clears the flag before the next test.
+   */
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_.store(false, std::memory_order_release);
+  }
+
+  bool cancelled() const {
+    return cancelled_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Sleeps until a time point or until cancelled.
+   * @return true if the token is cancelled.
+   */
+  template <typename Clock, typename Duration>
+  bool wait_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return wake_.wait_until(lock, deadline, [this]() { return cancelled(); });
+  }
+
+  /**
+   * @brief Sleeps for a duration or until cancelled.
+   * @return true if the token is cancelled.
+   */
+  template <typename Rep, typename Period>
+  bool wait_for(const std::chrono::duration<Rep, Period>& duration) {
+    return wait_until(std::chrono::steady_clock::now() + duration);
+  }
+
+private:
+  std::atomic<bool>       cancelled_{false};
+  std::mutex              mutex_;
+  std::condition_variable wake_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // CANCELLATION_H
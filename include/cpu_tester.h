@@ -90,7 +90,27 @@ public:
    */
   bool is_available() const override;
 
+  /**
+   * @brief Returns true if /proc/cpuinfo exists, without constructing a tester.
+   */
+  static bool probe();
+
+  /**
+   * @brief Runs the prime benchmark in a loop on several threads.
+   * @param intensity Worker threads; 0 = one per online core.
+   * @param stop Set by the caller to end the load.
+   * @param counters Counts benchmark passes and passes with a wrong result.
+   * @return SUCCESS if every pass computed the expected primes.
+   */
+  TestResult stress(uint32_t intensity, const std::atomic<bool>& stop,
+                    StressCounters& counters) override;
+
 private:
+  /**
+   * @brief Reads CPU, M33 and NPU information if probe() succeeds.
+   */
+  void discover() override;
+
   /**
    * @brief Retrieves CPU information from system files.
    * @return CPUInfo structure with system CPU details.
@@ -0,0 +1,102 @@
+/**
+ * @file cpufreq_sweep.h
+ * @brief cpufreq governor and fixed-frequency energy sweep for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the CpufreqSweep class, which runs the same fixed
+ * amount of work under every cpufreq governor and at a set of pinned
+ * frequencies, measures completion time and energy with EnergyMeter, and
+ * marks the energy/performance Pareto front.
+ *
+ * @details
+ * - Governors are switched through scaling_governor of every policy; fixed
+ *   frequencies pin scaling_min_freq and scaling_max_freq together under
+ *   the performance governor, which works without the userspace governor.
+ * - The original governor and limits of every policy are restored when the
+ *   sweep ends, fails, or is cancelled through config.meter.cancel, which
+ *   is checked between runs and between operating points.
+ */
+
+#ifndef CPUFREQ_SWEEP_H
+#define CPUFREQ_SWEEP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "energy_meter.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct CpufreqSweepConfig
+ * @brief Parameters of a governor/frequency sweep.
+ */
+struct CpufreqSweepConfig {
+  std::string              cpu_root = "/sys/devices/system/cpu";
+  EnergyMeterConfig        meter;                     /**< Power root, rail, runs per point */
+  std::vector<std::string> governors;                 /**< Empty = all available */
+  std::vector<uint32_t>    frequencies_khz;           /**< Empty = all available */
+  uint64_t                 work_per_core = 100000000; /**< cpu_work() rounds per core */
+  EnergyMeter::Workload    workload;                  /**< Replaces cpu_work() if set */
+};
+
+/**
+ * @struct CpufreqOperatingPoint
+ * @brief Measurements of the workload at one governor or frequency.
+ */
+struct CpufreqOperatingPoint {
+  std::string governor;
+  uint32_t    frequency_khz   = 0; /**< Pinned frequency, 0 for a governor point */
+  bool        success         = false;
+  double      time_s          = 0.0; /**< Mean completion time per run */
+  double      energy_j        = 0.0; /**< Mean energy per run */
+  double      average_power_w = 0.0;
+  bool        pareto          = false; /**< No other point is both faster and cheaper */
+  std::string error_message;
+};
+
+/**
+ * @struct CpufreqSweepResult
+ * @brief Outcome of a sweep.
+ */
+struct CpufreqSweepResult {
+  bool                               success   = false;
+  bool                               supported = false; /**< cpufreq policies were found */
+  std::vector<std::string>           policies;
+  std::vector<CpufreqOperatingPoint> points;
+  std::string                        error_message;
+};
+
+/**
+ * @class CpufreqSweep
+ * @brief Measures time and energy of a workload across cpufreq settings.
+ */
+class CpufreqSweep {
+public:
+  /**
+   * @brief Constructs a sweep with the given configuration.
+   * @param config Sweep configuration.
+   */
+  explicit CpufreqSweep(const CpufreqSweepConfig& config = CpufreqSweepConfig());
+
+  /**
+   * @brief Runs the workload at every governor and frequency.
+   * @return CpufreqSweepResult with one point per setting.
+   */
+  CpufreqSweepResult run();
+
+  /**
+   * @brief Marks the points that no other successful point dominates.
+   * @param points Points to classify; failed points are never on the front.
+   */
+  static void mark_pareto_front(std::vector<CpufreqOperatingPoint>& points);
+
+private:
+  CpufreqSweepConfig config_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // CPUFREQ_SWEEP_H
@@ -91,7 +91,17 @@ public:
    */
   bool is_available() const override;
 
+  /**
+   * @brief Returns true if DRM/KMS exists, without constructing a tester.
+   */
+  static bool probe();
+
 private:
+  /**
+   * @brief Enumerates the DRM connectors if probe() succeeds.
+   */
+  void discover() override;
+
   /**
    * @brief Enumerates all display interfaces on the system.
    * @return Vector of DisplayInfo structures.
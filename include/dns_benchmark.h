@@ -0,0 +1,181 @@
+/**
+ * @file dns_benchmark.h
+ * @brief Asynchronous DNS resolver benchmark for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the DnsBenchmark class, which sends raw DNS queries
+ * over UDP to every configured nameserver concurrently from one epoll loop,
+ * and DnsStubServer, a minimal in-process responder used as a CI target.
+ *
+ * @details
+ * - Queries are never issued through getaddrinfo(), so a dead resolver costs
+ *   one timeout for the whole batch instead of one timeout per name.
+ * - Every name is queried against every server, giving per-server latency
+ *   percentiles and failure rates over the same workload.
+ * - ICMP port-unreachable errors on the connected sockets fail the pending
+ *   queries of that server immediately.
+ */
+
+#ifndef DNS_BENCHMARK_H
+#define DNS_BENCHMARK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct DnsBenchmarkConfig
+ * @brief Parameters of a resolver benchmark run.
+ */
+struct DnsBenchmarkConfig {
+  std::vector<std::string>  servers;            /**< Numeric addresses; empty = /etc/resolv.conf */
+  uint16_t                  port          = 53;
+  std::vector<std::string>  names;              /**< Names to resolve (A records) */
+  uint32_t                  repeat        = 1;  /**< Times each name is queried per server */
+  std::chrono::milliseconds timeout       = std::chrono::milliseconds(1000);
+  uint32_t                  max_in_flight = 64; /**< Outstanding queries across all servers */
+};
+
+/**
+ * @struct DnsServerStats
+ * @brief Per-server latency and failure statistics.
+ */
+struct DnsServerStats {
+  std::string server;
+  uint32_t    queries      = 0;
+  uint32_t    resolved     = 0;
+  uint32_t    nxdomain     = 0;
+  uint32_t    server_fail  = 0;
+  uint32_t    timeouts     = 0;
+  uint32_t    unreachable  = 0;
+  double      min_ms       = 0.0; /**< Latency over all answered queries */
+  double      avg_ms       = 0.0;
+  double      p50_ms       = 0.0;
+  double      p99_ms       = 0.0;
+  double      max_ms       = 0.0;
+  double      failure_rate = 0.0; /**< (server_fail + timeouts + unreachable) / queries */
+};
+
+/**
+ * @struct DnsBenchmarkResult
+ * @brief Outcome of a resolver benchmark run.
+ */
+struct DnsBenchmarkResult {
+  bool                        success   = false; /**< At least one query resolved */
+  double                      elapsed_s = 0.0;
+  std::vector<DnsServerStats> servers;
+  std::vector<std::string>    resolved_names;    /**< Names resolved by at least one server */
+  std::string                 error_message;
+};
+
+/**
+ * @class DnsBenchmark
+ * @brief Concurrent raw-UDP DNS resolver benchmark.
+ */
+class DnsBenchmark {
+public:
+  /**
+   * @brief Constructs a benchmark with the given configuration.
+   * @param config Benchmark configuration.
+   */
+  explicit DnsBenchmark(const DnsBenchmarkConfig& config = DnsBenchmarkConfig());
+
+  /**
+   * @brief Sends all queries and waits for the answers or the timeout.
+   * @return DnsBenchmarkResult with per-server statistics.
+   */
+  DnsBenchmarkResult run();
+
+  /**
+   * @brief Reads the nameserver entries of a resolv.conf file.
+   * @param path Path to the resolv.conf file.
+   * @return Nameserver addresses in file order.
+   */
+  static std::vector<std::string> read_resolv_conf(const std::string& path = "/etc/resolv.conf");
+
+  /**
+   * @brief Encodes a recursive A query for a name.
+   * @param id Query identifier.
+   * @param name Domain name (a trailing dot is accepted).
+   * @param packet Receives the encoded query.
+   * @return false if the name is not a valid domain name.
+   */
+  static bool encode_query(uint16_t id, const std::string& name, std::vector<uint8_t>& packet);
+
+private:
+  DnsBenchmarkConfig config_;
+};
+
+/**
+ * @class DnsStubServer
+ * @brief Minimal UDP DNS responder for tests and offline benchmarking.
+ *
+ * Answers every A query with 127.0.0.1, except names under ".invalid"
+ * which get NXDOMAIN. Runs on a background thread until stop() or
+ * destruction.
+ */
+class DnsStubServer {
+public:
+  /**
+   * @brief Constructs a stopped responder.
+   */
+  DnsStubServer();
+
+  /**
+   * @brief Stops the responder if running.
+   */
+  ~DnsStubServer();
+
+  DnsStubServer(const DnsStubServer&)            = delete;
+  DnsStubServer& operator=(const DnsStubServer&) = delete;
+
+  /**
+   * @brief Binds to address:port and starts answering.
+   * @param address Numeric IPv4 bind address.
+   * @param port UDP port; 0 picks an ephemeral port.
+   * @return true if the responder is running.
+   */
+  bool start(const std::string& address = "127.0.0.1", uint16_t port = 0);
+
+  /**
+   * @brief Stops the responder thread and closes its socket.
+   */
+  void stop();
+
+  /**
+   * @brief Returns the port the responder is bound to.
+   */
+  uint16_t port() const {
+    return port_;
+  }
+
+  /**
+   * @brief Returns the number of queries answered so far.
+   */
+  uint64_t queries_answered() const {
+    return answered_.load();
+  }
+
+private:
+  /**
+   * @brief Receive loop answering queries until stop().
+   */
+  void serve();
+
+  std::thread           thread_;
+  std::atomic<bool>     running_;
+  std::atomic<uint64_t> answered_;
+  int                   fd_;
+  int                   wake_fd_;
+  uint16_t              port_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // DNS_BENCHMARK_H
@@ -0,0 +1,114 @@
+/**
+ * @file energy_meter.h
+ * @brief Energy-per-workload measurement for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the EnergyMeter class, which runs an arbitrary
+ * workload while PowerSampler integrates the power drawn on one rail, giving
+ * joules per run and operations per joule for performance-per-watt
+ * comparisons.
+ *
+ * @details
+ * - Idle power is measured over a quiet window before the first run.
+ * - Energy per run is the rail's average power during the run times its
+ *   wall-clock duration, so runs shorter than a few sample periods still
+ *   get a usable figure.
+ * - The rail is chosen by name, or defaults to the rail drawing the most
+ *   power at idle (normally the board input).
+ */
+
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "cancellation.h"
+#include "power_sampler.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct EnergyMeterConfig
+ * @brief Parameters of an energy measurement.
+ */
+struct EnergyMeterConfig {
+  PowerSamplerConfig        sampler;
+  std::string               rail;        /**< Rail name; empty = highest idle power */
+  std::chrono::milliseconds idle_window = std::chrono::milliseconds(1000);
+  uint32_t                  runs        = 3;
+  CancellationToken*        cancel      = nullptr; /**< Ends the measurement between runs */
+};
+
+/**
+ * @struct EnergyMeasurement
+ * @brief Energy figures of a workload.
+ */
+struct EnergyMeasurement {
+  bool        success         = false;
+  bool        workload_failed = false; /**< A run returned 0 operations */
+  std::string workload;
+  std::string rail;
+  uint32_t    runs                 = 0;
+  uint64_t    ops                  = 0;   /**< Sum of the workload's return values */
+  double      run_time_s           = 0.0; /**< Mean wall-clock time per run */
+  double      idle_power_w         = 0.0;
+  double      average_power_w      = 0.0; /**< Mean rail power while the workload ran */
+  double      peak_power_w         = 0.0;
+  double      energy_per_run_j     = 0.0;
+  double      net_energy_per_run_j = 0.0; /**< Energy above the idle baseline */
+  double      ops_per_joule        = 0.0;
+  std::string error_message;
+};
+
+/**
+ * @class EnergyMeter
+ * @brief Measures the energy a workload costs on one power rail.
+ */
+class EnergyMeter {
+public:
+  /**
+   * @brief Callable run once per measurement run.
+   * @return Operations completed (bytes, iterations, ...); 0 fails the measurement.
+   */
+  using Workload = std::function<uint64_t()>;
+
+  /**
+   * @brief Constructs a meter with the given configuration.
+   * @param config Meter configuration.
+   */
+  explicit EnergyMeter(const EnergyMeterConfig& config = EnergyMeterConfig());
+
+  /**
+   * @brief Measures idle power, then runs the workload config.runs times.
+   * @param name Workload name for the result.
+   * @param workload Workload to run.
+   * @return EnergyMeasurement with per-run energy and efficiency.
+   */
+  EnergyMeasurement measure(const std::string& name, const Workload& workload);
+
+  /**
+   * @brief Built-in load that spins integer arithmetic on every online core.
+   * @param duration How long to spin.
+   * @return Loop iterations completed across all cores.
+   */
+  static uint64_t cpu_spin(std::chrono::milliseconds duration);
+
+  /**
+   * @brief Built-in load with a fixed amount of work, so its run time
+   *        depends on CPU frequency.
+   * @param rounds_per_core Arithmetic rounds run on every online core.
+   * @return Rounds completed across all cores.
+   */
+  static uint64_t cpu_work(uint64_t rounds_per_core);
+
+private:
+  EnergyMeterConfig config_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // ENERGY_METER_H
@@ -0,0 +1,239 @@
+/**
+ * @file ethtool_interface.h
+ * @brief SIOCETHTOOL access to Ethernet link, statistics and offload state.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the EthtoolInterface class, a thin wrapper over the
+ * ethtool ioctls needed to verify the i.MX93 EQoS and FEC MACs: negotiated
+ * link settings, driver statistics, offload features and ring/coalesce
+ * parameters.
+ *
+ * @details
+ * - Link settings use ETHTOOL_GLINKSETTINGS with the link-mode mask size
+ *   handshake, falling back to the deprecated ETHTOOL_GSET.
+ * - Statistic and feature names are fetched once per interface and cached,
+ *   so repeated get_stats() calls cost a single ioctl.
+ * - Changing features with set_feature() requires CAP_NET_ADMIN.
+ */
+
+#ifndef ETHTOOL_INTERFACE_H
+#define ETHTOOL_INTERFACE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "throughput_engine.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct EthtoolLinkInfo
+ * @brief Negotiated link parameters.
+ */
+struct EthtoolLinkInfo {
+  int32_t     speed_mbps = -1; /**< -1 when unknown (no link or virtual device) */
+  std::string duplex     = "Unknown";
+  bool        autoneg    = false;
+  std::string port       = "Other";
+};
+
+/**
+ * @struct EthtoolStat
+ * @brief One named driver statistic from ETHTOOL_GSTATS.
+ */
+struct EthtoolStat {
+  std::string name;
+  uint64_t    value = 0;
+};
+
+/**
+ * @struct EthtoolFeature
+ * @brief State of one netdev feature from ETHTOOL_GFEATURES.
+ */
+struct EthtoolFeature {
+  std::string name;
+  bool        available = false; /**< Can be changed by the user */
+  bool        requested = false;
+  bool        active    = false;
+  bool        fixed     = false; /**< Never changed by the driver or user */
+};
+
+/**
+ * @struct EthtoolRing
+ * @brief DMA ring sizes from ETHTOOL_GRINGPARAM.
+ */
+struct EthtoolRing {
+  uint32_t rx_pending = 0;
+  uint32_t rx_max     = 0;
+  uint32_t tx_pending = 0;
+  uint32_t tx_max     = 0;
+};
+
+/**
+ * @struct EthtoolCoalesce
+ * @brief Interrupt coalescing parameters from ETHTOOL_GCOALESCE.
+ */
+struct EthtoolCoalesce {
+  uint32_t rx_usecs      = 0;
+  uint32_t rx_max_frames = 0;
+  uint32_t tx_usecs      = 0;
+  uint32_t tx_max_frames = 0;
+  bool     adaptive_rx   = false;
+  bool     adaptive_tx   = false;
+};
+
+/**
+ * @struct EthtoolTsInfo
+ * @brief Timestamping capabilities and PHC association from ETHTOOL_GET_TS_INFO.
+ */
+struct EthtoolTsInfo {
+  uint32_t so_timestamping = 0;  /**< Supported SOF_TIMESTAMPING_* flags */
+  int32_t  phc_index       = -1; /**< /dev/ptpN index, -1 without a PHC */
+  uint32_t tx_types        = 0;  /**< Bit mask of supported HWTSTAMP_TX_* values */
+  uint32_t rx_filters      = 0;  /**< Bit mask of supported HWTSTAMP_FILTER_* values */
+};
+
+/**
+ * @struct EthtoolTestConfig
+ * @brief Parameters of NetworkingTester::ethtool_test().
+ */
+struct EthtoolTestConfig {
+  std::string              interface_name; /**< Empty = first Ethernet interface that is up */
+  ThroughputConfig         load;           /**< Load to a peer for error deltas and A/B runs */
+  bool                     offload_ab  = false;
+  std::vector<std::string> ab_features = {"tx-tcp-segmentation", "rx-gro",
+                                          "tx-checksum-ip-generic", "rx-checksum"};
+};
+
+/**
+ * @class EthtoolInterface
+ * @brief ethtool ioctl access to a single network interface.
+ */
+class EthtoolInterface {
+public:
+  /**
+   * @brief Opens the control socket used for SIOCETHTOOL.
+   * @param interface_name Network interface name.
+   */
+  explicit EthtoolInterface(const std::string& interface_name);
+
+  /**
+   * @brief Closes the control socket.
+   */
+  ~EthtoolInterface();
+
+  EthtoolInterface(const EthtoolInterface&)            = delete;
+  EthtoolInterface& operator=(const EthtoolInterface&) = delete;
+
+  /**
+   * @brief Reads the driver name and bus address (ETHTOOL_GDRVINFO).
+   * @param driver Receives the driver name.
+   * @param bus_info Receives the bus address.
+   * @return true on success.
+   */
+  bool get_driver_info(std::string& driver, std::string& bus_info);
+
+  /**
+   * @brief Reads negotiated speed, duplex, autoneg and port.
+   * @param info Receives the link parameters.
+   * @return true on success.
+   */
+  bool get_link_settings(EthtoolLinkInfo& info);
+
+  /**
+   * @brief Reads all driver statistics.
+   * @param stats Receives name/value pairs in driver order.
+   * @return true on success.
+   */
+  bool get_stats(std::vector<EthtoolStat>& stats);
+
+  /**
+   * @brief Reads the state of all netdev features.
+   * @param features Receives one entry per feature.
+   * @return true on success.
+   */
+  bool get_features(std::vector<EthtoolFeature>& features);
+
+  /**
+   * @brief Requests a feature on or off (ETHTOOL_SFEATURES).
+   * @param name Feature name, e.g. "tx-tcp-segmentation".
+   * @param enable Requested state.
+   * @return true if the feature is active in the requested state afterwards.
+   */
+  bool set_feature(const std::string& name, bool enable);
+
+  /**
+   * @brief Reads the DMA ring sizes.
+   * @param ring Receives the ring parameters.
+   * @return true on success.
+   */
+  bool get_ring(EthtoolRing& ring);
+
+  /**
+   * @brief Reads the interrupt coalescing parameters.
+   * @param coalesce Receives the coalescing parameters.
+   * @return true on success.
+   */
+  bool get_coalesce(EthtoolCoalesce& coalesce);
+
+  /**
+   * @brief Reads timestamping capabilities and the associated PHC.
+   * @param info Receives the timestamping information.
+   * @return true on success.
+   */
+  bool get_timestamping_info(EthtoolTsInfo& info);
+
+  /**
+   * @brief Returns the error of the last failed call.
+   */
+  const std::string& last_error() const {
+    return last_error_;
+  }
+
+  /**
+   * @brief Checks whether a statistic name denotes an error or drop counter.
+   * @param name Driver statistic name.
+   * @return true for names containing err, drop, crc, fifo, miss, overrun, ...
+   */
+  static bool is_error_counter(const std::string& name);
+
+  /**
+   * @brief Computes per-statistic increases between two get_stats() results.
+   * @param before Earlier statistics.
+   * @param after Later statistics of the same interface.
+   * @param errors_only Only include counters accepted by is_error_counter().
+   * @return Statistics that increased, with the increase as value.
+   */
+  static std::vector<EthtoolStat> counter_deltas(const std::vector<EthtoolStat>& before,
+                                                 const std::vector<EthtoolStat>& after,
+                                                 bool                            errors_only);
+
+private:
+  /**
+   * @brief Issues SIOCETHTOOL with the given command buffer.
+   * @param data Command structure starting with the ethtool command number.
+   * @param what Command name used in last_error().
+   * @return true on success.
+   */
+  bool ethtool_ioctl(void* data, const char* what);
+
+  /**
+   * @brief Fetches a string set (ETHTOOL_GSSET_INFO + ETHTOOL_GSTRINGS).
+   * @param string_set ETH_SS_* identifier.
+   * @param names Receives the strings.
+   * @return true on success.
+   */
+  bool get_string_set(uint32_t string_set, std::vector<std::string>& names);
+
+  std::string              interface_name_;
+  int                      fd_;
+  std::vector<std::string> stat_names_;
+  std::vector<std::string> feature_names_;
+  std::string              last_error_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // ETHTOOL_INTERFACE_H
@@ -139,7 +139,17 @@ public:
    */
   bool is_available() const override;
 
+  /**
+   * @brief Returns true if a device tree or GPIO sysfs exists, without constructing a tester.
+   */
+  static bool probe();
+
 private:
+  /**
+   * @brief Reads the board model and header information if probe() succeeds.
+   */
+  void discover() override;
+
   /**
    * @brief Retrieves form factor information from system.
    * @return FormFactorInfo structure with hardware details.
@@ -116,7 +116,17 @@ public:
    */
   bool is_available() const override;
 
+  /**
+   * @brief Returns true if GPIO sysfs exists, without constructing a tester.
+   */
+  static bool probe();
+
 private:
+  /**
+   * @brief Sets availability from probe(); the pin table needs no discovery.
+   */
+  void discover() override;
+
   /**
    * @brief Tests basic digital I/O operations.
    * @return TestResult indicating success or failure.
@@ -86,7 +86,17 @@ public:
    */
   bool is_available() const override;
 
+  /**
+   * @brief Returns true if a DRM or Vivante galcore device exists, without constructing a tester.
+   */
+  static bool probe();
+
 private:
+  /**
+   * @brief Reads GPU information, including the OpenGL and Vulkan tool queries if probe() succeeds.
+   */
+  void discover() override;
+
   /**
    * @brief Retrieves GPU information from system.
    * @return GPUInfo structure with system GPU details.
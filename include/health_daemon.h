@@ -0,0 +1,259 @@
+/**
+ * @file health_daemon.h
+ * @brief Resident health monitoring of FRDM-IMX93 peripherals behind a Unix socket.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines HealthDaemon, which keeps a set of prepared testers
+ * resident, samples them continuously and answers queries about their
+ * current state over a Unix domain socket.
+ *
+ * @details
+ * - Every tester has its own worker thread that runs back-to-back
+ *   monitor_test() windows and, every test interval or on request, a
+ *   short_test(); each run goes through a TestWatchdog, so a hung test is
+ *   reported as TIMEOUT instead of stalling the daemon.
+ * - A test that does not even stop after its grace period is abandoned
+ *   while still running inside the tester, so that peripheral is retired:
+ *   its worker stops and the tester is never entered again.
+ * - Monitor samples reach a shared history store through a TimeSeriesSink
+ *   as they are taken, named "peripheral/metric"; its downsampling tiers
+ *   keep memory fixed however long the daemon runs.
+ * - The socket serves one request per connection: a single text line in,
+ *   a single JSON object and a newline out.
+ * - With a metrics port, the latest sample of every metric and the test
+ *   counters are also published to a MetricRegistry and served to
+ *   Prometheus by a MetricsExporter.
+ *
+ * Requests:
+ * - `status`: uptime and, per peripheral, windows and tests run, the last
+ *   short test result and whether it was retired.
+ * - `latest [PERIPHERAL]`: newest sample and summary of every metric, plus
+ *   the last short test and monitor window reports.
+ * - `test PERIPHERAL`: queues a short test and cuts the running window
+ *   short; the result shows up in `latest`.
+ * - `range METRIC FROM TO [POINTS]`: buckets of one metric between two
+ *   Unix times in seconds, as [start, end, min, mean, max, samples];
+ *   values <= 0 are relative to now.
+ */
+
+#ifndef HEALTH_DAEMON_H
+#define HEALTH_DAEMON_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json_utils.h"
+#include "metrics_exporter.h"
+#include "peripheral_tester.h"
+#include "test_watchdog.h"
+#include "time_series.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct HealthDaemonConfig
+ * @brief Schedule, socket and history size of a daemon.
+ */
+struct HealthDaemonConfig {
+  std::string          socket_path      = "/run/nxp-imx93-hw-vv.sock";
+  std::chrono::seconds sample_window    = std::chrono::seconds(60);   /**< One monitor run */
+  std::chrono::seconds test_interval    = std::chrono::seconds(3600); /**< 0 = on request only */
+  std::chrono::seconds timeout          = std::chrono::seconds(600);  /**< Beyond a run; 0 = none */
+  size_t               history_capacity = 256; /**< Buckets per tier and metric */
+  size_t               history_factor   = 10;
+  size_t               history_tiers    = 8;   /**< A week at 1 kHz still fits the coarsest tier */
+  size_t               max_points       = 512; /**< Default bucket budget of a range request */
+  int                  metrics_port     = -1;  /**< /metrics port; -1 = off, 0 = any free port */
+  std::string          metrics_address  = "127.0.0.1";
+};
+
+/**
+ * @class HealthDaemon
+ * @brief Samples resident testers continuously and serves their state on a Unix socket.
+ */
+class HealthDaemon {
+public:
+  /**
+   * @brief Constructs a stopped daemon.
+   * @param config Schedule and socket configuration.
+   */
+  explicit HealthDaemon(const HealthDaemonConfig& config = HealthDaemonConfig());
+
+  /**
+   * @brief Stops the daemon if running.
+   */
+  ~HealthDaemon();
+
+  HealthDaemon(const HealthDaemon&)            = delete;
+  HealthDaemon& operator=(const HealthDaemon&) = delete;
+
+  /**
+   * @brief Adds a prepared tester; only valid before start().
+   * @param name Peripheral name used in requests and metric names, e.g. "cpu".
+   * @param tester Tester whose prepare() has returned true.
+   */
+  void add_tester(const std::string& name, std::shared_ptr<PeripheralTester> tester);
+
+  /**
+   * @brief Binds the socket and starts the server and worker threads.
+   * @return true on success; see last_error() otherwise.
+   *
+   * A stale socket left at the path by a previous run is replaced; any
+   * other file there is an error.
+   */
+  bool start();
+
+  /**
+   * @brief Cancels running tests, joins the threads and removes the socket.
+   *
+   * The testers' watchdogs stay interrupted, so a stopped daemon cannot be
+   * started again.
+   */
+  void stop();
+
+  bool running() const {
+    return running_;
+  }
+
+  /**
+   * @brief Answers one request line; what the socket server sends back, minus the newline.
+   */
+  std::string handle_request(const std::string& request);
+
+  /**
+   * @brief Queues a short test of a peripheral and cuts its running window short.
+   * @return false if the peripheral is unknown or retired.
+   */
+  bool request_test(const std::string& name);
+
+  /**
+   * @brief Returns the port /metrics is served on, or 0 if it is not.
+   */
+  uint16_t metrics_port() const {
+    return exporter_ ? exporter_->port() : 0;
+  }
+
+  /**
+   * @brief Returns the values published for Prometheus.
+   */
+  const MetricRegistry& metrics() const {
+    return *metrics_;
+  }
+
+  /**
+   * @brief Returns the number of runs whose threads were abandoned while still running.
+   */
+  size_t abandoned() const;
+
+  /**
+   * @brief Returns the number of requests answered so far.
+   */
+  uint64_t requests_served() const {
+    return requests_served_.load();
+  }
+
+  /**
+   * @brief Returns the first error seen, or an empty string.
+   */
+  std::string last_error() const;
+
+private:
+  struct History;
+  class HistorySink;
+
+  /**
+   * @brief A resident tester and the results of its latest runs.
+   */
+  struct Worker {
+    std::string                       name;
+    std::shared_ptr<PeripheralTester> tester;
+    TestWatchdog                      watchdog;
+    std::thread                       thread;
+    bool                              test_requested = false; /**< Guarded by state_mutex_ */
+    bool                              in_window      = false;
+    bool                              retired        = false; /**< A run was abandoned */
+    uint64_t                          windows        = 0;
+    uint64_t                          tests          = 0;
+    uint64_t                          failures       = 0;
+    std::shared_ptr<const TestReport> last_test;
+    std::shared_ptr<const TestReport> last_window;
+
+    // MetricRegistry slots; only the worker thread writes them
+    size_t                        windows_slot  = MetricRegistry::NO_SLOT;
+    size_t                        tests_slot    = MetricRegistry::NO_SLOT;
+    size_t                        failures_slot = MetricRegistry::NO_SLOT;
+    size_t                        passed_slot   = MetricRegistry::NO_SLOT;
+    std::map<std::string, size_t> report_slots; /**< Short test metric name to slot */
+  };
+
+  /**
+   * @brief Window and short test loop of one worker thread.
+   */
+  void run_worker(Worker& worker);
+
+  /**
+   * @brief Accept loop answering requests until stop().
+   */
+  void serve();
+
+  /**
+   * @brief Reads one request from a connection, answers it and closes it.
+   */
+  void serve_connection(int fd);
+
+  Worker* find_worker(const std::string& name);
+
+  /**
+   * @brief Retires a worker whose watchdog abandoned a run; call with state_mutex_ held.
+   * @return true if the worker must stop.
+   */
+  bool retire_if_abandoned(Worker& worker);
+
+  /**
+   * @brief Publishes the counters and metrics of a finished short test.
+   */
+  void publish_test(Worker& worker, const TestReport& report);
+
+  /**
+   * @brief Returns the deadline of a run expected to take a given time.
+   */
+  std::chrono::milliseconds deadline(std::chrono::seconds expected) const;
+
+  void write_status(JsonStream& json);
+  void write_latest(JsonStream& json, const std::string& peripheral);
+
+  /**
+   * @brief Writes a range answer, or returns an error without writing anything.
+   */
+  std::string write_range(JsonStream& json, const std::vector<std::string>& words);
+
+  HealthDaemonConfig                    config_;
+  std::vector<std::unique_ptr<Worker>>  workers_;
+  std::atomic<bool>                     running_{false};
+  std::thread                           server_;
+  int                                   listen_fd_ = -1;
+  int                                   wake_fd_   = -1;
+  std::atomic<uint64_t>                 requests_served_{0};
+  std::chrono::steady_clock::time_point started_;
+
+  mutable std::mutex      state_mutex_; /**< Worker results and requests */
+  std::condition_variable schedule_;    /**< Wakes idle workers on requests and stop() */
+  std::string             error_;
+
+  // Shared with the testers' sinks, which an abandoned test may keep using
+  std::shared_ptr<History>         history_;
+  std::shared_ptr<MetricRegistry>  metrics_;
+  std::unique_ptr<MetricsExporter> exporter_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // HEALTH_DAEMON_H
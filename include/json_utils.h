@@ -6,7 +6,15 @@
  *
  * This header provides helper functions for converting C++ data types
  * to JSON-formatted strings, including proper string escaping and
- * type-specific formatting.
+ * type-specific formatting, and JsonStream, which serialises whole
+ * documents into one reusable buffer that is flushed incrementally.
+ *
+ * @details
+ * - String escaping scans eight bytes at a time for quotes, backslashes
+ *   and control characters and copies clean runs in one append, so long
+ *   report details cost little more than a memcpy.
+ * - JsonStream tracks commas itself; callers only open and close
+ *   containers and emit keys and values.
  *
  * @version 1.0
  * @date 2025-11-17
@@ -15,10 +23,21 @@
 #ifndef JSON_UTILS_H
 #define JSON_UTILS_H
 
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 #include <map>
+#include <ostream>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace imx93_peripheral_test {
@@ -44,42 +63,63 @@ public:
    * @note Follows JSON string escaping rules as per RFC 8259.
    */
   static std::string escape_string(const std::string& str) {
-    std::stringstream ss;
-    ss << "\"";
-    for (char c : str) {
-      switch (c) {
-        case '"':
-          ss << "\\\"";
-          break;
-        case '\\':
-          ss << "\\\\";
-          break;
-        case '\b':
-          ss << "\\b";
-          break;
-        case '\f':
-          ss << "\\f";
-          break;
-        case '\n':
-          ss << "\\n";
-          break;
-        case '\r':
-          ss << "\\r";
-          break;
-        case '\t':
-          ss << "\\t";
-          break;
-        default:
-          if (static_cast<unsigned char>(c) <= '\x1f') {
-            ss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
-               << static_cast<unsigned char>(c);
-          } else {
-            ss << c;
-          }
+    std::string out;
+    out.reserve(str.size() + 2);
+    out += '"';
+    append_escaped(out, str);
+    out += '"';
+    return out;
+  }
+
+  /**
+   * @brief Appends the JSON-escaped form of a string, without quotes.
+   *
+   * Eight bytes are tested at once for '"', '\\' and bytes below 0x20;
+   * runs without any of them are appended in one piece.
+   *
+   * @param out Buffer to append to.
+   * @param str The input string to escape.
+   */
+  static void append_escaped(std::string& out, std::string_view str) {
+    constexpr uint64_t ONES  = 0x0101010101010101ULL;
+    constexpr uint64_t HIGHS = 0x8080808080808080ULL;
+    auto               has_zero_byte = [](uint64_t word) { return (word - ONES) & ~word & HIGHS; };
+
+    const char* data  = str.data();
+    size_t      size  = str.size();
+    size_t      clean = 0;  // Start of the run not yet appended
+    size_t      i     = 0;
+    while (i < size) {
+      if (size - i >= sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        uint64_t special = has_zero_byte(word ^ (ONES * '"')) |
+                           has_zero_byte(word ^ (ONES * '\\')) |
+                           ((word - ONES * 0x20) & ~word & HIGHS);  // Bytes below 0x20
+        if (special == 0) {
+          i += sizeof(word);
+          continue;
+        }
+      }
+      // Something in the next eight bytes needs a closer look
+      size_t stop = std::min(size, i + sizeof(uint64_t));
+      for (; i < stop; ++i) {
+        const char* escape = escape_sequence(data[i]);
+        if (escape == nullptr) {
+          continue;
+        }
+        out.append(data + clean, i - clean);
+        if (escape[0] != '\0') {
+          out += escape;
+        } else {
+          char unicode[8];
+          std::snprintf(unicode, sizeof(unicode), "\\u%04x", static_cast<unsigned char>(data[i]));
+          out += unicode;
+        }
+        clean = i + 1;
       }
     }
-    ss << "\"";
-    return ss.str();
+    out.append(data + clean, size - clean);
   }
 
   /**
@@ -120,6 +160,253 @@ public:
   static std::string to_json_value(bool value) {
     return value ? "true" : "false";
   }
+
+private:
+  /**
+   * @brief Returns the escape for a character, "" for \\u00XX, or nullptr if none is needed.
+   */
+  static const char* escape_sequence(char c) {
+    switch (c) {
+      case '"':
+        return "\\\"";
+      case '\\':
+        return "\\\\";
+      case '\b':
+        return "\\b";
+      case '\f':
+        return "\\f";
+      case '\n':
+        return "\\n";
+      case '\r':
+        return "\\r";
+      case '\t':
+        return "\\t";
+      default:
+        return static_cast<unsigned char>(c) < 0x20 ? "" : nullptr;
+    }
+  }
+};
+
+/**
+ * @class JsonStream
+ * @brief Streaming JSON writer with a reusable output buffer.
+ *
+ * Output goes to a file descriptor or std::ostream once the buffer grows
+ * past the flush threshold, or stays in the buffer when neither is given.
+ * The layout matches the rest of the tool: ": " after keys and "," between
+ * members.
+ *
+ * @note Not thread-safe.
+ */
+class JsonStream {
+public:
+  /**
+   * @brief Writes into the internal buffer only; see str().
+   */
+  JsonStream() = default;
+
+  /**
+   * @brief Writes to a file descriptor, which stays owned by the caller.
+   * @param fd Destination, e.g. STDOUT_FILENO.
+   * @param flush_bytes Buffer size that triggers a write.
+   */
+  explicit JsonStream(int fd, size_t flush_bytes = 1 << 16) : fd_(fd), flush_bytes_(flush_bytes) {
+    buffer_.reserve(flush_bytes_ + 256);
+  }
+
+  /**
+   * @brief Writes to a stream.
+   * @param out Destination.
+   * @param flush_bytes Buffer size that triggers a write.
+   */
+  explicit JsonStream(std::ostream& out, size_t flush_bytes = 1 << 16)
+      : stream_(&out), flush_bytes_(flush_bytes) {
+    buffer_.reserve(flush_bytes_ + 256);
+  }
+
+  ~JsonStream() {
+    flush();
+  }
+
+  JsonStream(const JsonStream&)            = delete;
+  JsonStream& operator=(const JsonStream&) = delete;
+
+  JsonStream& begin_object() {
+    return open('{');
+  }
+
+  JsonStream& end_object() {
+    return close('}');
+  }
+
+  JsonStream& begin_array() {
+    return open('[');
+  }
+
+  JsonStream& end_array() {
+    return close(']');
+  }
+
+  /**
+   * @brief Starts an object member; the next call writes its value.
+   */
+  JsonStream& key(std::string_view name) {
+    separate();
+    buffer_ += '"';
+    JsonWriter::append_escaped(buffer_, name);
+    buffer_ += "\": ";
+    after_key_ = true;
+    return *this;
+  }
+
+  JsonStream& value(std::string_view text) {
+    separate();
+    buffer_ += '"';
+    JsonWriter::append_escaped(buffer_, text);
+    buffer_ += '"';
+    return done();
+  }
+
+  JsonStream& value(const char* text) {
+    return value(std::string_view(text));
+  }
+
+  JsonStream& value(const std::string& text) {
+    return value(std::string_view(text));
+  }
+
+  JsonStream& value(bool flag) {
+    separate();
+    buffer_ += flag ? "true" : "false";
+    return done();
+  }
+
+  template <typename T, typename std::enable_if_t<std::is_integral_v<T>, int> = 0>
+  JsonStream& value(T number) {
+    separate();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    buffer_.append(digits, result.ptr);
+    return done();
+  }
+
+  /**
+   * @brief Writes a number with 15 significant digits; NaN and infinities become null.
+   */
+  JsonStream& value(double number) {
+    separate();
+    if (std::isfinite(number)) {
+      char digits[32];
+      int  length = std::snprintf(digits, sizeof(digits), "%.15g", number);
+      buffer_.append(digits, static_cast<size_t>(length));
+    } else {
+      buffer_ += "null";
+    }
+    return done();
+  }
+
+  JsonStream& null() {
+    separate();
+    buffer_ += "null";
+    return done();
+  }
+
+  /**
+   * @brief Writes an already serialised JSON value as is.
+   */
+  JsonStream& raw(std::string_view json) {
+    separate();
+    buffer_.append(json.data(), json.size());
+    return done();
+  }
+
+  /**
+   * @brief Writes the buffer to the destination, if any, and empties it.
+   * @return false if a write failed.
+   */
+  bool flush() {
+    if (fd_ >= 0) {
+      size_t written = 0;
+      while (written < buffer_.size()) {
+        ssize_t result = ::write(fd_, buffer_.data() + written, buffer_.size() - written);
+        if (result < 0 && errno == EINTR) {
+          continue;
+        }
+        if (result <= 0) {
+          ok_ = false;
+          break;
+        }
+        written += static_cast<size_t>(result);
+      }
+      buffer_.clear();
+    } else if (stream_ != nullptr) {
+      stream_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+      ok_ = ok_ && stream_->good();
+      buffer_.clear();
+    }
+    return ok_;
+  }
+
+  /**
+   * @brief Returns the unflushed output; the whole document without a destination.
+   */
+  const std::string& str() const {
+    return buffer_;
+  }
+
+  /**
+   * @brief Returns false once a write to the destination has failed.
+   */
+  bool ok() const {
+    return ok_;
+  }
+
+private:
+  JsonStream& open(char bracket) {
+    separate();
+    buffer_ += bracket;
+    has_members_.push_back(false);
+    return *this;
+  }
+
+  JsonStream& close(char bracket) {
+    buffer_ += bracket;
+    if (!has_members_.empty()) {
+      has_members_.pop_back();
+    }
+    return done();
+  }
+
+  /**
+   * @brief Writes the comma in front of a member that is not the first of its container.
+   */
+  void separate() {
+    if (after_key_) {
+      after_key_ = false;
+      return;
+    }
+    if (!has_members_.empty()) {
+      if (has_members_.back()) {
+        buffer_ += ',';
+      }
+      has_members_.back() = true;
+    }
+  }
+
+  JsonStream& done() {
+    if ((fd_ >= 0 || stream_ != nullptr) && buffer_.size() >= flush_bytes_) {
+      flush();
+    }
+    return *this;
+  }
+
+  std::string       buffer_;
+  int               fd_          = -1;
+  std::ostream*     stream_      = nullptr;
+  size_t            flush_bytes_ = 1 << 16;
+  std::vector<bool> has_members_; /**< One entry per open container */
+  bool              after_key_ = false;
+  bool              ok_        = true;
 };
 
 }  // namespace imx93_peripheral_test
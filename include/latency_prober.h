@@ -0,0 +1,97 @@
+/**
+ * @file latency_prober.h
+ * @brief In-process ICMP echo latency prober for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the LatencyProber class which measures round-trip
+ * latency to many hosts concurrently without forking external tools.
+ *
+ * @details
+ * Probes are sent over an unprivileged ICMP datagram socket
+ * (SOCK_DGRAM/IPPROTO_ICMP) when the kernel permits it through
+ * net.ipv4.ping_group_range, falling back to a raw ICMP socket otherwise.
+ * All targets are driven from a single epoll loop and RTTs are computed from
+ * kernel software timestamps (SO_TIMESTAMPING) where available.
+ */
+
+#ifndef LATENCY_PROBER_H
+#define LATENCY_PROBER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct ProbeConfig
+ * @brief Parameters of a probe train sent to every target.
+ */
+struct ProbeConfig {
+  uint32_t                  count        = 5;   /**< Echo requests per target */
+  std::chrono::milliseconds interval     = std::chrono::milliseconds(100);  /**< Spacing */
+  std::chrono::milliseconds timeout      = std::chrono::milliseconds(2000); /**< Reply wait */
+  uint16_t                  payload_size = 56;  /**< ICMP payload bytes */
+};
+
+/**
+ * @struct LatencyStats
+ * @brief Round-trip statistics for a single probed host.
+ */
+struct LatencyStats {
+  std::string host;                      /**< Host as given by the caller */
+  uint32_t    sent              = 0;     /**< Echo requests transmitted */
+  uint32_t    received          = 0;     /**< Matching echo replies received */
+  double      min_ms            = 0.0;   /**< Minimum RTT */
+  double      avg_ms            = 0.0;   /**< Mean RTT */
+  double      p99_ms            = 0.0;   /**< 99th percentile RTT (nearest rank) */
+  double      max_ms            = 0.0;   /**< Maximum RTT */
+  double      jitter_ms         = 0.0;   /**< Mean absolute difference of consecutive RTTs */
+  double      loss_percent      = 100.0; /**< Percentage of unanswered probes */
+  bool        kernel_timestamps = false; /**< RTTs derived from kernel timestamps */
+  std::string error_message;             /**< Set when the host could not be probed */
+};
+
+/**
+ * @class LatencyProber
+ * @brief Concurrent ICMP echo prober driven by a single epoll loop.
+ *
+ * @note Only IPv4 targets are supported. Hostnames are resolved once with
+ *       getaddrinfo before the probe train starts.
+ * @note Not thread-safe; use one instance per thread.
+ */
+class LatencyProber {
+public:
+  /**
+   * @brief Constructs a prober with the given probe train parameters.
+   * @param config Probe train configuration.
+   */
+  explicit LatencyProber(const ProbeConfig& config = ProbeConfig());
+
+  /**
+   * @brief Sends a probe train to every host concurrently and collects RTTs.
+   *
+   * Returns once every probe has been answered or the timeout after the last
+   * transmission has elapsed.
+   *
+   * @param hosts IPv4 addresses or hostnames to probe.
+   * @return One LatencyStats entry per host, in the order given.
+   */
+  std::vector<LatencyStats> probe(const std::vector<std::string>& hosts);
+
+  /**
+   * @brief Convenience wrapper probing a single host.
+   * @param host IPv4 address or hostname.
+   * @return LatencyStats for the host.
+   */
+  LatencyStats probe(const std::string& host);
+
+private:
+  ProbeConfig config_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // LATENCY_PROBER_H
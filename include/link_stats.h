@@ -0,0 +1,152 @@
+/**
+ * @file link_stats.h
+ * @brief Netlink-based network interface counter sampling.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the LinkStatsCollector class which retrieves link
+ * state and 64-bit counters for every interface with a single RTM_GETLINK
+ * dump instead of reading several sysfs files per interface.
+ *
+ * @details
+ * Counters come from IFLA_STATS64 so they do not wrap on gigabit links, and
+ * the collector keeps its netlink socket and receive buffer open between
+ * samples so it can be polled at high rates.
+ */
+
+#ifndef LINK_STATS_H
+#define LINK_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct LinkCounters
+ * @brief State and 64-bit counters of one interface at one instant.
+ */
+struct LinkCounters {
+  std::string interface_name;
+  int         ifindex         = 0;
+  uint32_t    flags           = 0;     /**< IFF_* flags from ifinfomsg */
+  bool        is_up           = false; /**< IFF_UP */
+  bool        has_carrier     = false; /**< IFLA_CARRIER, or IFF_LOWER_UP when absent */
+  uint32_t    mtu             = 0;
+  std::string mac_address;
+  uint32_t    carrier_changes = 0;     /**< IFLA_CARRIER_CHANGES */
+  std::string kind;                    /**< IFLA_INFO_KIND, e.g. "veth"; empty for physical NICs */
+  int         link_ifindex    = 0;     /**< IFLA_LINK, the peer of a veth */
+  uint64_t    rx_bytes        = 0;
+  uint64_t    tx_bytes        = 0;
+  uint64_t    rx_packets      = 0;
+  uint64_t    tx_packets      = 0;
+  uint64_t    rx_errors       = 0;
+  uint64_t    tx_errors       = 0;
+  uint64_t    rx_dropped      = 0;
+  uint64_t    tx_dropped      = 0;
+};
+
+/**
+ * @struct LinkSnapshot
+ * @brief Counters of all interfaces from one RTM_GETLINK dump.
+ */
+struct LinkSnapshot {
+  std::chrono::steady_clock::time_point timestamp;
+  std::vector<LinkCounters>             links;
+
+  /**
+   * @brief Looks up an interface by name.
+   * @param name Interface name.
+   * @return Pointer to the counters, or nullptr if not present.
+   */
+  const LinkCounters* find(const std::string& name) const {
+    for (const auto& link : links) {
+      if (link.interface_name == name) {
+        return &link;
+      }
+    }
+    return nullptr;
+  }
+};
+
+/**
+ * @struct LinkRates
+ * @brief Per-interface rates and counter deltas between two snapshots.
+ */
+struct LinkRates {
+  std::string interface_name;
+  double      interval_s            = 0.0;
+  double      rx_bps                = 0.0;
+  double      tx_bps                = 0.0;
+  double      rx_pps                = 0.0;
+  double      tx_pps                = 0.0;
+  uint64_t    rx_errors_delta       = 0;
+  uint64_t    tx_errors_delta       = 0;
+  uint64_t    rx_dropped_delta      = 0;
+  uint64_t    tx_dropped_delta      = 0;
+  uint32_t    carrier_changes_delta = 0;
+  bool        is_up                 = false;
+  bool        has_carrier           = false;
+};
+
+/**
+ * @class LinkStatsCollector
+ * @brief Samples link state and counters of all interfaces over rtnetlink.
+ *
+ * @note Not thread-safe; each sampling thread should own its collector.
+ */
+class LinkStatsCollector {
+public:
+  /**
+   * @brief Opens the NETLINK_ROUTE socket used for sampling.
+   */
+  LinkStatsCollector();
+
+  /**
+   * @brief Closes the netlink socket.
+   */
+  ~LinkStatsCollector();
+
+  LinkStatsCollector(const LinkStatsCollector&)            = delete;
+  LinkStatsCollector& operator=(const LinkStatsCollector&) = delete;
+
+  /**
+   * @brief Checks whether the netlink socket could be opened.
+   * @return true if sample() can be used.
+   */
+  bool is_open() const {
+    return fd_ >= 0;
+  }
+
+  /**
+   * @brief Takes one snapshot of all interfaces with a single RTM_GETLINK dump.
+   * @param snapshot Filled with the state of every interface.
+   * @return true on success.
+   */
+  bool sample(LinkSnapshot& snapshot);
+
+  /**
+   * @brief Computes per-interface rates between two snapshots.
+   *
+   * Interfaces missing from either snapshot are skipped. Counter resets
+   * (current below previous) yield zero rather than a wrapped delta.
+   *
+   * @param previous Earlier snapshot.
+   * @param current Later snapshot.
+   * @return Rates for every interface present in both snapshots.
+   */
+  static std::vector<LinkRates> compute_rates(const LinkSnapshot& previous,
+                                              const LinkSnapshot& current);
+
+private:
+  int               fd_;
+  uint32_t          seq_;
+  std::vector<char> buffer_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // LINK_STATS_H
@@ -10,19 +10,40 @@
  *
  * @version 1.0
  * @date 2025-11-17
+ *
+ * @details
+ * - By default every call formats and writes its entry under a mutex.
+ * - In asynchronous mode, callers only copy the message into a bounded
+ *   lock-free ring; a background thread formats and writes entries in
+ *   batches, flushing the file once per batch. When the ring is full the
+ *   message is dropped and counted rather than blocking the caller, and
+ *   the number dropped is logged once the ring drains.
+ * - The date and time part of the timestamp is formatted once per second.
+ * - The LOG_* macros check the level before evaluating their arguments and
+ *   accept "{}" format strings, so filtered messages cost one comparison.
+ *   Levels below IMX93_LOG_MIN_LEVEL are removed at compile time.
  */
 
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <atomic>
+#include <charconv>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
 #include <memory>
 #include <mutex>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 
 namespace imx93_peripheral_test {
 
@@ -35,6 +56,75 @@ namespace imx93_peripheral_test {
  */
 enum class LogLevel { DEBUG, INFO, WARNING, ERROR };
 
+/**
+ * @def IMX93_LOG_MIN_LEVEL
+ * @brief Lowest LogLevel, as a number from 0 (DEBUG) to 3 (ERROR), that is compiled in.
+ *
+ * Set by CMake's LOG_MIN_LEVEL; Release builds drop DEBUG messages.
+ */
+#ifndef IMX93_LOG_MIN_LEVEL
+#define IMX93_LOG_MIN_LEVEL 0
+#endif
+
+namespace log_detail {
+
+inline void append_argument(std::string& out, const char* value) {
+  out += value;
+}
+
+// Any other pointer would otherwise convert to bool and print "true"
+template <typename T>
+void append_argument(std::string& out, const T* value) = delete;
+
+inline void append_argument(std::string& out, std::string_view value) {
+  out.append(value.data(), value.size());
+}
+
+inline void append_argument(std::string& out, char value) {
+  out += value;
+}
+
+inline void append_argument(std::string& out, bool value) {
+  out += value ? "true" : "false";
+}
+
+template <typename T>
+std::enable_if_t<std::is_integral_v<T>> append_argument(std::string& out, T value) {
+  char digits[24];
+  auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  out.append(digits, result.ptr);
+}
+
+inline void append_argument(std::string& out, double value) {
+  char digits[32];  // Round-trips doubles, like the baseline file
+  int  length = std::snprintf(digits, sizeof(digits), "%.17g", value);
+  out.append(digits, static_cast<size_t>(length));
+}
+
+inline void format_to(std::string& out, const char* format) {
+  out += format;
+}
+
+/**
+ * @brief Appends a format string with each "{}" replaced by the next argument.
+ *
+ * Arguments without a placeholder are ignored; placeholders without an
+ * argument are kept as they are.
+ */
+template <typename T, typename... Rest>
+void format_to(std::string& out, const char* format, const T& first, const Rest&... rest) {
+  const char* hole = std::strstr(format, "{}");
+  if (hole == nullptr) {
+    out += format;
+    return;
+  }
+  out.append(format, hole);
+  append_argument(out, first);
+  format_to(out, hole + 2, rest...);
+}
+
+}  // namespace log_detail
+
 /**
  * @class Logger
  * @brief Singleton logger class for thread-safe logging operations.
@@ -90,7 +180,14 @@ public:
    * @param level The minimum log level to output.
    */
   void set_level(LogLevel level) {
-    level_ = level;
+    level_.store(level, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns true if messages of a level are currently written.
+   */
+  bool enabled(LogLevel level) const {
+    return level >= level_.load(std::memory_order_relaxed);
   }
 
   /**
@@ -121,35 +218,109 @@ public:
    * @note ERROR level messages are sent to stderr, others to stdout.
    */
   void log(LogLevel level, const std::string& message) {
-    if (level < level_)
+    if (!enabled(level))
       return;
 
+    auto now = std::chrono::system_clock::now();
+    if (async_.load(std::memory_order_acquire)) {
+      if (!push(level, now, message)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+      }
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
-    auto                        now  = std::chrono::system_clock::now();
-    auto                        time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+    std::string                 log_entry;
+    format_entry(level, now, message, log_entry);
 
-    std::stringstream ss;
-    ss << "[" << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S") << "."
-       << std::setfill('0') << std::setw(3) << ms.count() << "] "
-       << "[" << level_to_string(level) << "] " << message << "\n";
+    // ERROR level messages go to stderr, others to stdout
+    if (level == LogLevel::ERROR) {
+      write_locked(std::string(), log_entry, log_entry);
+    } else {
+      write_locked(log_entry, std::string(), log_entry);
+    }
+  }
+
+  /**
+   * @brief Logs a message built from a format string with "{}" placeholders.
+   *
+   * Strings, characters, booleans, integers and floating-point values are
+   * appended directly into the message, without temporary strings.
+   *
+   * @param level The severity level of the message.
+   * @param format Message text with one "{}" per argument.
+   * @param args Values for the placeholders.
+   */
+  template <typename... Args>
+  void log(LogLevel level, const char* format, const Args&... args) {
+    if (!enabled(level))
+      return;
 
-    std::string log_entry = ss.str();
+    std::string message;
+    message.reserve(std::strlen(format) + 16 * sizeof...(Args));
+    log_detail::format_to(message, format, args...);
+    log(level, message);
+  }
 
-    // Print to console if enabled
-    if (console_output_) {
-      if (level == LogLevel::ERROR) {
-        std::cerr << log_entry;
-      } else {
-        std::cout << log_entry;
+  /**
+   * @brief Switches between synchronous and asynchronous logging.
+   *
+   * In asynchronous mode log() only queues the message; a background
+   * thread writes queued entries in batches. Disabling the mode writes
+   * everything still queued before returning.
+   *
+   * @param enable true to log asynchronously.
+   * @param capacity Queued messages before new ones are dropped; rounded up
+   *        to a power of two.
+   *
+   * @note Call while no other thread is logging, e.g. at startup.
+   */
+  void set_async(bool enable, size_t capacity = 8192) {
+    if (enable == async_.load()) {
+      return;
+    }
+    if (!enable) {
+      async_.store(false, std::memory_order_release);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
       }
+      wake_.notify_all();
+      writer_.join();
+      return;
     }
 
-    // Write to file if open
-    if (file_stream_.is_open()) {
-      file_stream_ << log_entry;
-      file_stream_.flush();
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    slots_.reset(new Slot[size]);
+    for (size_t i = 0; i < size; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
     }
+    mask_ = size - 1;
+    enqueue_pos_.store(0, std::memory_order_relaxed);
+    dequeue_pos_ = 0;
+    stopping_    = false;
+    writer_      = std::thread(&Logger::write_loop, this);
+    async_.store(true, std::memory_order_release);
+  }
+
+  /**
+   * @brief Writes all queued entries before returning.
+   */
+  void flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (slots_) {
+      drain_locked();
+    }
+  }
+
+  /**
+   * @brief Returns the number of messages dropped because the queue was full.
+   */
+  uint64_t dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
   }
 
 private:
@@ -166,6 +337,7 @@ private:
    * Ensures the log file is properly closed when the logger is destroyed.
    */
   ~Logger() {
+    set_async(false);
     if (file_stream_.is_open()) {
       file_stream_.close();
     }
@@ -181,7 +353,7 @@ private:
    * @param level The log level to convert.
    * @return String representation of the log level.
    */
-  std::string level_to_string(LogLevel level) {
+  static const char* level_to_string(LogLevel level) {
     switch (level) {
       case LogLevel::DEBUG:
         return "DEBUG";
@@ -196,44 +368,201 @@ private:
     }
   }
 
-  std::mutex    mutex_;         /**< Mutex for thread-safe operations */
-  std::ofstream file_stream_;   /**< File stream for log file output */
-  LogLevel      level_;         /**< Current minimum log level */
-  bool          console_output_; /**< Whether to output to console */
+  /**
+   * @brief One queued message; sequence tells producers and the writer whose turn it is.
+   */
+  struct Slot {
+    std::atomic<size_t>                   sequence{0};
+    LogLevel                              level = LogLevel::INFO;
+    std::chrono::system_clock::time_point time;
+    std::string                           message;
+  };
+
+  /**
+   * @brief Queues a message without locking.
+   * @return false if the queue is full.
+   */
+  bool push(LogLevel level, std::chrono::system_clock::time_point time,
+            const std::string& message) {
+    size_t position = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot*  slot     = nullptr;
+    for (;;) {
+      slot            = &slots_[position & mask_];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      auto   lag      = static_cast<std::ptrdiff_t>(sequence - position);
+      if (lag == 0) {
+        if (enqueue_pos_.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (lag < 0) {
+        return false;  // The writer has not freed this slot yet
+      } else {
+        position = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->level   = level;
+    slot->time    = time;
+    slot->message = message;
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    // Wake the writer early for errors and when a quarter of the ring has filled
+    if (level == LogLevel::ERROR || ((position + 1) & (mask_ >> 2)) == 0) {
+      wake_.notify_one();
+    }
+    return true;
+  }
+
+  /**
+   * @brief Background thread of asynchronous mode.
+   */
+  void write_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+      wake_.wait_for(lock, std::chrono::milliseconds(50));
+      drain_locked();
+    }
+    drain_locked();
+  }
+
+  /**
+   * @brief Formats and writes all queued entries as one batch per destination.
+   */
+  void drain_locked() {
+    std::string out_batch, err_batch, file_batch;
+    for (;;) {
+      Slot& slot = slots_[dequeue_pos_ & mask_];
+      if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+        break;
+      }
+      std::string& batch = slot.level == LogLevel::ERROR ? err_batch : out_batch;
+      size_t       begin = batch.size();
+      format_entry(slot.level, slot.time, slot.message, batch);
+      file_batch.append(batch, begin, std::string::npos);
+      slot.message.clear();
+      slot.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+      ++dequeue_pos_;
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped_) {
+      std::string notice;
+      format_entry(LogLevel::WARNING, std::chrono::system_clock::now(),
+                   std::to_string(dropped - reported_dropped_) +
+                       " log messages dropped (queue full)",
+                   notice);
+      out_batch += notice;
+      file_batch += notice;
+      reported_dropped_ = dropped;
+    }
+    write_locked(out_batch, err_batch, file_batch);
+  }
+
+  /**
+   * @brief Writes formatted entries to the console and the log file.
+   */
+  void write_locked(const std::string& out, const std::string& err, const std::string& file) {
+    if (console_output_) {
+      if (!out.empty()) {
+        std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+      }
+      if (!err.empty()) {
+        std::cerr.write(err.data(), static_cast<std::streamsize>(err.size()));
+      }
+    }
+    if (file_stream_.is_open() && !file.empty()) {
+      file_stream_.write(file.data(), static_cast<std::streamsize>(file.size()));
+      file_stream_.flush();
+    }
+  }
+
+  /**
+   * @brief Appends "[date time.ms] [LEVEL] message\n" to an entry buffer.
+   */
+  void format_entry(LogLevel level, std::chrono::system_clock::time_point time,
+                    const std::string& message, std::string& out) {
+    auto seconds = std::chrono::system_clock::to_time_t(time);
+    if (seconds != cached_second_) {
+      struct tm local;
+      if (localtime_r(&seconds, &local) != nullptr) {
+        std::strftime(cached_text_, sizeof(cached_text_), "%Y-%m-%d %H:%M:%S", &local);
+      }
+      cached_second_ = seconds;
+    }
+    auto ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() %
+        1000;
+
+    char prefix[64];
+    int  length = std::snprintf(prefix, sizeof(prefix), "[%s.%03d] [%s] ", cached_text_,
+                                static_cast<int>(ms), level_to_string(level));
+    out.append(prefix, static_cast<size_t>(length));
+    out += message;
+    out += '\n';
+  }
+
+  std::mutex            mutex_;          /**< Guards output, formatting and dequeuing */
+  std::ofstream         file_stream_;    /**< File stream for log file output */
+  std::atomic<LogLevel> level_;          /**< Current minimum log level */
+  bool                  console_output_; /**< Whether to output to console */
+
+  std::time_t cached_second_   = -1; /**< Second that cached_text_ shows */
+  char        cached_text_[24] = "";
+
+  std::atomic<bool>       async_{false};
+  std::unique_ptr<Slot[]> slots_;
+  size_t                  mask_ = 0;
+  std::thread             writer_;
+  std::condition_variable wake_;
+  bool                    stopping_ = false; /**< Guarded by mutex_ */
+
+  alignas(64) std::atomic<size_t> enqueue_pos_{0}; /**< Next slot producers claim */
+  alignas(64) size_t dequeue_pos_ = 0;             /**< Next slot to write; guarded by mutex_ */
+  std::atomic<uint64_t> dropped_{0};
+  uint64_t              reported_dropped_ = 0;
 };
 
 // Helper macros
 /**
- * @def LOG_DEBUG(msg)
- * @brief Logs a debug message.
- * @param msg The message to log.
+ * @def IMX93_LOG(level, ...)
+ * @brief Logs a message if its level is compiled in and enabled.
+ *
+ * The arguments are evaluated only when the message will be written.
+ *
+ * @param level The LogLevel of the message.
+ * @param ... A message string, or a "{}" format string followed by its arguments.
+ */
+#define IMX93_LOG(level, ...)                                            \
+  do {                                                                   \
+    if (static_cast<int>(level) >= IMX93_LOG_MIN_LEVEL &&                \
+        imx93_peripheral_test::Logger::instance().enabled(level)) {      \
+      imx93_peripheral_test::Logger::instance().log(level, __VA_ARGS__); \
+    }                                                                    \
+  } while (0)
+
+/**
+ * @def LOG_DEBUG(...)
+ * @brief Logs a debug message; removed from builds with IMX93_LOG_MIN_LEVEL above 0.
  */
-#define LOG_DEBUG(msg) \
-  imx93_peripheral_test::Logger::instance().log(imx93_peripheral_test::LogLevel::DEBUG, msg)
+#define LOG_DEBUG(...) IMX93_LOG(imx93_peripheral_test::LogLevel::DEBUG, __VA_ARGS__)
 
 /**
- * @def LOG_INFO(msg)
+ * @def LOG_INFO(...)
  * @brief Logs an info message.
- * @param msg The message to log.
  */
-#define LOG_INFO(msg) \
-  imx93_peripheral_test::Logger::instance().log(imx93_peripheral_test::LogLevel::INFO, msg)
+#define LOG_INFO(...) IMX93_LOG(imx93_peripheral_test::LogLevel::INFO, __VA_ARGS__)
 
 /**
- * @def LOG_WARN(msg)
+ * @def LOG_WARN(...)
  * @brief Logs a warning message.
- * @param msg The message to log.
  */
-#define LOG_WARN(msg) \
-  imx93_peripheral_test::Logger::instance().log(imx93_peripheral_test::LogLevel::WARNING, msg)
+#define LOG_WARN(...) IMX93_LOG(imx93_peripheral_test::LogLevel::WARNING, __VA_ARGS__)
 
 /**
- * @def LOG_ERROR(msg)
+ * @def LOG_ERROR(...)
  * @brief Logs an error message.
- * @param msg The message to log.
  */
-#define LOG_ERROR(msg) \
-  imx93_peripheral_test::Logger::instance().log(imx93_peripheral_test::LogLevel::ERROR, msg)
+#define LOG_ERROR(...) IMX93_LOG(imx93_peripheral_test::LogLevel::ERROR, __VA_ARGS__)
 
 }  // namespace imx93_peripheral_test
 
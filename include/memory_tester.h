@@ -86,7 +86,27 @@ public:
    */
   bool is_available() const override;
 
+  /**
+   * @brief Returns true if /proc/meminfo exists, without constructing a tester.
+   */
+  static bool probe();
+
+  /**
+   * @brief Writes and verifies a buffer in a loop until stopped.
+   * @param intensity Buffer size in MB; 0 = 64 MB.
+   * @param stop Set by the caller to end the load.
+   * @param counters Counts passes, bytes written plus read, and mismatched words.
+   * @return SUCCESS if no word ever read back wrong.
+   */
+  TestResult stress(uint32_t intensity, const std::atomic<bool>& stop,
+                    StressCounters& counters) override;
+
 private:
+  /**
+   * @brief Reads /proc/meminfo and the dmidecode memory type if probe() succeeds.
+   */
+  void discover() override;
+
   /**
    * @brief Retrieves memory information from system.
    * @return MemoryInfo structure with system memory details.
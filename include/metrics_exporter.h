@@ -0,0 +1,234 @@
+/**
+ * @file metrics_exporter.h
+ * @brief Prometheus text exposition of the latest sampled values over local HTTP.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines MetricRegistry, a fixed set of latest values that
+ * samplers update, and MetricsExporter, a minimal HTTP server that renders
+ * the registry on GET /metrics in the Prometheus text format (0.0.4).
+ *
+ * @details
+ * - Slots and families are allocated when the registry is constructed and
+ *   their names are rendered once, at registration. Updating a value is a
+ *   single atomic store, so samplers never wait for a scrape.
+ * - A scrape reads the atomics and appends to a per-connection buffer that
+ *   is reused, so after the first few scrapes it does not allocate either.
+ * - The server is one thread polling non-blocking sockets; every response
+ *   closes its connection, and clients idle for more than a few seconds are
+ *   dropped.
+ */
+
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace imx93_peripheral_test {
+
+/**
+ * @enum MetricType
+ * @brief Prometheus type of a metric family.
+ */
+enum class MetricType { GAUGE, COUNTER };
+
+/**
+ * @class MetricRegistry
+ * @brief Fixed-capacity table of the latest value of every exported metric.
+ *
+ * @note add() and add_family() are thread-safe; set() and render() are
+ * lock-free and may run concurrently with them. Counters are set to their
+ * total by their single writer.
+ */
+class MetricRegistry {
+public:
+  static constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+
+  /**
+   * @brief Allocates all slots up front.
+   * @param capacity Maximum number of metric series.
+   * @param families Maximum number of metric names.
+   */
+  explicit MetricRegistry(size_t capacity = 1024, size_t families = 256);
+
+  MetricRegistry(const MetricRegistry&)            = delete;
+  MetricRegistry& operator=(const MetricRegistry&) = delete;
+
+  /**
+   * @brief Returns a family, creating it on first use.
+   * @param name Metric name; characters Prometheus does not allow become '_'.
+   * @param help Description for the HELP line.
+   * @param type Gauge or counter.
+   * @return Family index, or NO_SLOT if the registry is full.
+   */
+  size_t add_family(const std::string& name, const std::string& help, MetricType type);
+
+  /**
+   * @brief Returns the slot of one labelled series of a family, creating it on first use.
+   * @param family Index from add_family().
+   * @param label_name Label, e.g. "peripheral"; empty for none.
+   * @param label_value Its value.
+   * @return Slot index, or NO_SLOT if the registry is full or family is NO_SLOT.
+   */
+  size_t add(size_t family, const std::string& label_name = "",
+             const std::string& label_value = "");
+
+  /**
+   * @brief Publishes the latest value of a slot; ignores NO_SLOT.
+   */
+  void set(size_t slot, double value) {
+    if (slot < count_.load(std::memory_order_acquire)) {
+      slots_[slot].value.store(value, std::memory_order_relaxed);
+      slots_[slot].has_value.store(true, std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief Appends every slot that has a value, grouped by family.
+   * @param out Destination; keeps its capacity between calls.
+   */
+  void render(std::string& out) const;
+
+  /**
+   * @brief Returns the number of slots in use.
+   */
+  size_t size() const {
+    return count_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Converts a name to one Prometheus accepts, e.g. "cpu/ops/s" to "cpu_ops_s".
+   */
+  static std::string sanitize(const std::string& name);
+
+private:
+  struct Family {
+    std::string name;
+    std::string header; /**< HELP and TYPE lines */
+  };
+
+  struct Slot {
+    size_t              family = 0;
+    std::string         key; /**< Name and labels, followed by a space */
+    std::atomic<double> value{0.0};
+    std::atomic<bool>   has_value{false};
+  };
+
+  size_t                    capacity_;
+  size_t                    family_capacity_;
+  std::unique_ptr<Slot[]>   slots_;
+  std::unique_ptr<Family[]> families_;
+  std::atomic<size_t>       count_{0};
+  std::atomic<size_t>       family_count_{0};
+  std::mutex                mutex_; /**< Serialises registration */
+};
+
+/**
+ * @struct MetricsExporterConfig
+ * @brief Where and how the /metrics endpoint listens.
+ */
+struct MetricsExporterConfig {
+  std::string               address         = "127.0.0.1"; /**< Numeric IPv4 bind address */
+  uint16_t                  port            = 9877;        /**< 0 picks a free port */
+  size_t                    max_connections = 8;
+  std::chrono::milliseconds idle_timeout    = std::chrono::milliseconds(5000);
+};
+
+/**
+ * @class MetricsExporter
+ * @brief Non-blocking single-threaded HTTP server for a MetricRegistry.
+ *
+ * GET or HEAD of / or /metrics returns the registry; other paths get 404
+ * and other methods 405.
+ */
+class MetricsExporter {
+public:
+  /**
+   * @brief Constructs a stopped exporter.
+   * @param registry Values to serve; shared with the samplers.
+   * @param config Listening configuration.
+   */
+  MetricsExporter(std::shared_ptr<const MetricRegistry> registry,
+                  const MetricsExporterConfig&          config = MetricsExporterConfig());
+
+  /**
+   * @brief Stops the exporter if running.
+   */
+  ~MetricsExporter();
+
+  MetricsExporter(const MetricsExporter&)            = delete;
+  MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+  /**
+   * @brief Binds the port and starts serving.
+   * @return true on success; see last_error() otherwise.
+   */
+  bool start();
+
+  /**
+   * @brief Closes every connection and stops the server thread.
+   */
+  void stop();
+
+  /**
+   * @brief Returns the port the exporter is bound to.
+   */
+  uint16_t port() const {
+    return port_;
+  }
+
+  /**
+   * @brief Returns the number of scrapes answered so far.
+   */
+  uint64_t scrapes() const {
+    return scrapes_.load();
+  }
+
+  /**
+   * @brief Returns the error of the last failed start(), or an empty string.
+   */
+  const std::string& last_error() const {
+    return error_;
+  }
+
+private:
+  struct Connection;
+
+  /**
+   * @brief Poll loop accepting, reading and answering until stop().
+   */
+  void serve();
+
+  /**
+   * @brief Reads what a connection has sent and prepares the response once complete.
+   * @return false if the connection should be closed.
+   */
+  bool receive(Connection& connection);
+
+  /**
+   * @brief Sends as much of the pending response as the socket takes.
+   * @return false once the response is sent or the socket failed.
+   */
+  bool transmit(Connection& connection);
+
+  std::shared_ptr<const MetricRegistry> registry_;
+  MetricsExporterConfig                 config_;
+  std::unique_ptr<Connection[]>         connections_;
+  std::thread                           thread_;
+  std::atomic<bool>                     running_{false};
+  std::atomic<uint64_t>                 scrapes_{0};
+  int                                   fd_      = -1;
+  int                                   wake_fd_ = -1;
+  uint16_t                              port_    = 0;
+  std::string                           error_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // METRICS_EXPORTER_H
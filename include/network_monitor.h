@@ -0,0 +1,133 @@
+/**
+ * @file network_monitor.h
+ * @brief Sampling network monitor for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the NetworkMonitor class which samples link state,
+ * carrier changes and 64-bit interface counters at a fixed rate and keeps a
+ * per-interface time series of throughput and error/drop deltas in a
+ * TimeSeriesStore, so memory stays fixed however long the run.
+ *
+ * @details
+ * - Samples are taken on an absolute schedule so the rate does not drift
+ *   with the cost of each netlink dump.
+ * - Carrier changes are counted from IFLA_CARRIER_CHANGES as well as from
+ *   carrier transitions between consecutive samples, so a flap shorter than
+ *   the sample interval is still detected.
+ * - An optional ThroughputEngine load runs on a background thread for the
+ *   whole monitoring window.
+ */
+
+#ifndef NETWORK_MONITOR_H
+#define NETWORK_MONITOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "cancellation.h"
+#include "link_stats.h"
+#include "throughput_engine.h"
+#include "time_series.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct NetworkMonitorConfig
+ * @brief Parameters of a monitoring run.
+ */
+struct NetworkMonitorConfig {
+  std::chrono::milliseconds       duration        = std::chrono::milliseconds(10000);
+  std::chrono::milliseconds       sample_interval = std::chrono::milliseconds(100);
+  std::vector<std::string>        interfaces;            /**< Empty = all interfaces */
+  bool                            generate_load = false; /**< Run a background throughput load */
+  ThroughputConfig                load;                  /**< 127.0.0.1 = in-process loopback */
+  CancellationToken*              cancel = nullptr;      /**< Ends the run early when cancelled */
+  std::shared_ptr<TimeSeriesSink> series_sink;           /**< Receives every interface sample */
+};
+
+/**
+ * @struct InterfaceTimeSeries
+ * @brief Time series and totals of one interface over a monitoring run.
+ */
+struct InterfaceTimeSeries {
+  std::string interface_name;
+  size_t      rx_series        = 0; /**< Index of <interface>_rx [Mbps] in the result's store */
+  size_t      tx_series        = 0; /**< Index of <interface>_tx [Mbps] */
+  size_t      errors_series    = 0; /**< Index of <interface>_errors, RX + TX per interval */
+  size_t      drops_series     = 0; /**< Index of <interface>_drops, RX + TX per interval */
+  uint32_t    carrier_changes  = 0; /**< Carrier up/down transitions */
+  uint64_t    total_errors     = 0; /**< RX + TX errors during the run */
+  uint64_t    total_dropped    = 0; /**< RX + TX drops during the run */
+  double      peak_rx_bps      = 0.0;
+  double      peak_tx_bps      = 0.0;
+  double      mean_rx_bps      = 0.0;
+  double      mean_tx_bps      = 0.0;
+  double      carrier_down_s   = 0.0; /**< Time sampled without carrier */
+  bool        up_at_start      = false;
+  bool        carrier_at_start = false;
+  bool        has_carrier      = false; /**< Carrier at the last sample */
+};
+
+/**
+ * @struct NetworkMonitorResult
+ * @brief Outcome of a monitoring run.
+ */
+struct NetworkMonitorResult {
+  bool                             success      = false; /**< Sampling worked for the whole run */
+  uint32_t                         sample_count = 0;
+  double                           elapsed_s    = 0.0;
+  std::vector<InterfaceTimeSeries> interfaces;
+  TimeSeriesStore                  series; /**< Samples of every interface, from monitor start */
+  bool                             load_ran = false;
+  ThroughputResult                 load_result;
+  std::string                      error_message;
+};
+
+/**
+ * @class NetworkMonitor
+ * @brief Samples interface counters at a fixed rate over a monitoring window.
+ */
+class NetworkMonitor {
+public:
+  /**
+   * @brief Constructs a monitor with the given configuration.
+   * @param config Monitoring configuration.
+   */
+  explicit NetworkMonitor(const NetworkMonitorConfig& config = NetworkMonitorConfig());
+
+  /**
+   * @brief Runs the monitor for config.duration, blocking the caller.
+   * @return NetworkMonitorResult with per-interface time series.
+   */
+  NetworkMonitorResult run();
+
+  /**
+   * @brief Writes the per-interface time series as CSV.
+   *
+   * One row per interface and raw sample still held by the store (the most
+   * recent 256) with the columns interface,time_s,rx_mbps,tx_mbps,errors,drops.
+   *
+   * @param result Result of a monitoring run.
+   * @param out Stream to write to.
+   */
+  static void write_csv(const NetworkMonitorResult& result, std::ostream& out);
+
+private:
+  /**
+   * @brief Checks whether an interface was selected in the configuration.
+   * @param name Interface name.
+   * @return true if the interface should be recorded.
+   */
+  bool is_selected(const std::string& name) const;
+
+  NetworkMonitorConfig config_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // NETWORK_MONITOR_H
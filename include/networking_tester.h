@@ -16,7 +16,15 @@
 #include <string>
 #include <vector>
 
+#include "dns_benchmark.h"
+#include "ethtool_interface.h"
+#include "latency_prober.h"
+#include "link_stats.h"
+#include "network_monitor.h"
+#include "packet_rate_engine.h"
 #include "peripheral_tester.h"
+#include "ptp_timestamp.h"
+#include "throughput_engine.h"
 
 namespace imx93_peripheral_test {
 
@@ -48,8 +56,14 @@ struct NetworkInterfaceInfo {
   bool                 has_carrier;
   uint64_t             rx_bytes;
   uint64_t             tx_bytes;
-  uint32_t             rx_packets;
-  uint32_t             tx_packets;
+  uint64_t             rx_packets;
+  uint64_t             tx_packets;
+  uint64_t             rx_errors;
+  uint64_t             tx_errors;
+  uint64_t             rx_dropped;
+  uint64_t             tx_dropped;
+  std::string          link_kind;      /**< rtnetlink link kind, e.g. "veth"; empty for NICs */
+  std::string          peer_interface; /**< Other end of a veth pair */
 };
 
 /**
@@ -94,10 +108,13 @@ public:
   /**
    * @brief Performs extended monitoring of networking performance.
    *
-   * Monitors networking over time for:
-   * - Connection stability
-   * - Bandwidth consistency
-   * - Packet loss monitoring
+   * Samples every interface at the configured rate for:
+   * - Link state and carrier changes (flaps)
+   * - RX/TX throughput and packet rates
+   * - Error and drop counter growth
+   *
+   * Fails if an interface that was up loses carrier, if error counters
+   * increase, or if the optional background load fails.
    *
    * @param duration Monitoring duration in seconds.
    * @return TestReport with monitoring results.
@@ -118,9 +135,110 @@ public:
    */
   bool is_available() const override;
 
+  /**
+   * @brief Returns true if /proc/net/dev exists, without constructing a tester.
+   */
+  static bool probe();
+
+  /**
+   * @brief Runs back-to-back loopback TCP transfers until stopped.
+   * @param intensity Parallel streams; 0 = 1.
+   * @param stop Set by the caller to end the load.
+   * @param counters Counts transfers, bytes received, and failed transfers.
+   * @return SUCCESS if every transfer completed.
+   */
+  TestResult stress(uint32_t intensity, const std::atomic<bool>& stop,
+                    StressCounters& counters) override;
+
+  /**
+   * @brief Runs a throughput test against a ThroughputEngine server.
+   *
+   * Connects to config.host:config.port with the configured number of
+   * parallel streams and reports goodput, retransmits and CPU cost.
+   *
+   * @param config Throughput run configuration.
+   * @return TestReport with the throughput results.
+   */
+  TestReport throughput_test(const ThroughputConfig& config);
+
+  /**
+   * @brief Runs a DNS resolver benchmark.
+   *
+   * Queries every name against every configured nameserver concurrently and
+   * reports per-server latency percentiles and failure rates. Metrics are
+   * named by the server's position, e.g. "dns0_p99", and its address is
+   * given in the details.
+   *
+   * @param config DNS benchmark configuration.
+   * @return TestReport with the per-server results.
+   */
+  TestReport dns_benchmark_test(const DnsBenchmarkConfig& config);
+
+  /**
+   * @brief Verifies an Ethernet interface through the ethtool ioctls.
+   *
+   * Reports driver, negotiated speed/duplex, ring and coalescing parameters
+   * and offload state, checks that no NIC error counter grows while the
+   * configured load runs, and optionally A/B-measures throughput with each
+   * listed offload toggled (restoring the original state afterwards).
+   * The load must go to a peer: for a loopback host the report is
+   * NOT_SUPPORTED and only lists the interface state.
+   *
+   * @param config Interface, load and offload A/B configuration.
+   * @return TestReport with the link, counter and A/B results.
+   */
+  TestReport ethtool_test(const EthtoolTestConfig& config);
+
+  /**
+   * @brief Measures PHC-to-system offset and packet timestamp jitter.
+   *
+   * Uses hardware timestamps and the interface PHC when the driver supports
+   * them, otherwise software timestamps (unless disabled in the config).
+   *
+   * @param config Interfaces, PHC device and sample counts.
+   * @return TestReport with the offset and path latency distributions.
+   */
+  TestReport ptp_test(const PtpTimestampConfig& config);
+
+  /**
+   * @brief Runs a small-frame packet rate (pps) stress test.
+   *
+   * Without an explicit interface the first veth pair found by interface
+   * discovery is used, falling back to lo, so no frames leave the board
+   * unless a NIC is named.
+   *
+   * @param config Interfaces, frame size, duration and TX backend.
+   * @return TestReport with TX/RX pps, drops and per-core CPU utilisation.
+   */
+  TestReport packet_rate_test(const PacketRateConfig& config);
+
+  /**
+   * @brief Sets the sampling rate, interface filter and load used by monitor_test().
+   * @param config Monitor configuration; its duration is overridden by monitor_test().
+   */
+  void set_monitor_config(const NetworkMonitorConfig& config) {
+    monitor_config_ = config;
+  }
+
+  /**
+   * @brief Returns the per-interface time series of the last monitor_test().
+   */
+  const NetworkMonitorResult& last_monitor_result() const {
+    return monitor_result_;
+  }
+
 private:
+  /**
+   * @brief Enumerates the network interfaces if probe() succeeds.
+   */
+  void discover() override;
+
   /**
    * @brief Enumerates network interfaces.
+   *
+   * Takes one RTM_GETLINK snapshot for link state and counters and one
+   * getifaddrs() pass for IPv4 addresses.
+   *
    * @return Vector of NetworkInterfaceInfo structures.
    */
   std::vector<NetworkInterfaceInfo> enumerate_interfaces();
@@ -133,12 +251,20 @@ private:
 
   /**
    * @brief Tests DNS resolution.
+   *
+   * Resolves a few well-known names through the /etc/resolv.conf servers with
+   * DnsBenchmark, so an unreachable resolver costs a single short timeout.
+   *
    * @return TestResult indicating success or failure.
    */
   TestResult test_dns_resolution();
 
   /**
-   * @brief Tests network bandwidth.
+   * @brief Tests network stack bandwidth over loopback.
+   *
+   * Runs a short TCP ThroughputEngine transfer against an in-process server
+   * on 127.0.0.1 and stores the outcome in bandwidth_result_.
+   *
    * @return TestResult indicating success or failure.
    */
   TestResult test_bandwidth();
@@ -150,18 +276,17 @@ private:
   TestResult test_latency();
 
   /**
-   * @brief Monitors network connectivity over time.
-   * @param duration Monitoring duration.
-   * @return TestResult indicating success or failure.
+   * @brief Parses network interface information.
+   * @param link Link state and counters from a netlink snapshot.
+   * @return NetworkInterfaceInfo structure (without IP address information).
    */
-  TestResult monitor_connectivity(std::chrono::seconds duration);
+  NetworkInterfaceInfo parse_interface_info(const LinkCounters& link);
 
   /**
-   * @brief Parses network interface information.
-   * @param interface_name Name of the network interface.
-   * @return NetworkInterfaceInfo structure.
+   * @brief Picks the interfaces of a packet rate test from interface discovery.
+   * @param config Receives tx_interface and rx_interface if tx_interface is empty.
    */
-  NetworkInterfaceInfo parse_interface_info(const std::string& interface_name);
+  void select_packet_rate_interfaces(PacketRateConfig& config);
 
   /**
    * @brief Gets the default gateway.
@@ -169,14 +294,12 @@ private:
    */
   std::string get_default_gateway();
 
-  /**
-   * @brief Pings a host to test connectivity.
-   * @param host Host to ping.
-   * @return TestResult indicating success or failure.
-   */
-  TestResult ping_host(const std::string& host);
-
   std::vector<NetworkInterfaceInfo> interfaces_;
+  LatencyStats                      latency_stats_;
+  DnsBenchmarkResult                dns_result_;
+  NetworkTestResult                 bandwidth_result_;
+  NetworkMonitorConfig              monitor_config_;
+  NetworkMonitorResult              monitor_result_;
   bool                              networking_available_;
 };
 
@@ -0,0 +1,112 @@
+/**
+ * @file packet_rate_engine.h
+ * @brief Small-packet (pps) stress engine for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the PacketRateEngine class, which floods minimum-size
+ * Ethernet frames from one interface and counts them on another (or the same
+ * one for lo) to expose the per-packet CPU cost that large-frame throughput
+ * tests hide.
+ *
+ * @details
+ * - Frames are transmitted through an AF_XDP socket in copy mode when the
+ *   kernel allows it, otherwise through an AF_PACKET PACKET_TX_RING
+ *   (TPACKET_V3) so that one send() flushes a whole batch.
+ * - Frames are received through an AF_PACKET TPACKET_V3 block ring, which
+ *   hands over many frames per poll() wake-up without a copy.
+ * - TX and RX run on their own threads, optionally pinned, and per-core CPU
+ *   utilisation is taken from /proc/stat over the same interval.
+ * - Interface counters are sampled with LinkStatsCollector before and after
+ *   the run to report drops outside the rings.
+ */
+
+#ifndef PACKET_RATE_ENGINE_H
+#define PACKET_RATE_ENGINE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace imx93_peripheral_test {
+
+/**
+ * @enum PacketTxBackend
+ * @brief Transmit path used by a packet rate run.
+ */
+enum class PacketTxBackend { AUTO, XDP, TPACKET };
+
+/**
+ * @struct PacketRateConfig
+ * @brief Parameters of a packet rate run.
+ */
+struct PacketRateConfig {
+  std::string               tx_interface;        /**< Empty = discovered by the tester */
+  std::string               rx_interface;        /**< Empty = same as tx_interface */
+  size_t                    frame_size  = 64;    /**< On-wire size including the FCS */
+  std::chrono::milliseconds duration    = std::chrono::milliseconds(2000);
+  PacketTxBackend           backend     = PacketTxBackend::AUTO;
+  uint32_t                  tx_batch    = 64;    /**< Frames queued per kernel kick */
+  uint32_t                  ring_frames = 4096;  /**< TX ring and UMEM size in frames */
+  int                       tx_cpu      = -1;    /**< Core to pin the TX thread to, -1 = any */
+  int                       rx_cpu      = -1;    /**< Core to pin the RX thread to, -1 = any */
+};
+
+/**
+ * @struct CoreUtilisation
+ * @brief Busy share of one CPU core over the run.
+ */
+struct CoreUtilisation {
+  int    core            = 0;
+  double busy_percent    = 0.0; /**< Non-idle, non-iowait share of the interval */
+  double softirq_percent = 0.0; /**< Share spent in softirq (packet processing) */
+};
+
+/**
+ * @struct PacketRateResult
+ * @brief Outcome of a packet rate run.
+ */
+struct PacketRateResult {
+  bool                         success = false;
+  std::string                  tx_backend;           /**< "AF_XDP" or "TPACKET_V3" */
+  std::string                  xdp_error;            /**< Why AUTO did not use AF_XDP */
+  std::string                  tx_interface;
+  std::string                  rx_interface;
+  double                       elapsed_s       = 0.0;
+  uint64_t                     frames_sent     = 0;  /**< Accepted by the kernel */
+  uint64_t                     frames_received = 0;
+  uint64_t                     ring_drops      = 0;  /**< RX ring overruns (PACKET_STATISTICS) */
+  uint64_t                     interface_drops = 0;  /**< tx/rx_dropped growth on both ends */
+  double                       tx_pps          = 0.0;
+  double                       rx_pps          = 0.0;
+  double                       loss_percent    = 0.0;
+  std::vector<CoreUtilisation> cores;
+  std::string                  error_message;
+};
+
+/**
+ * @class PacketRateEngine
+ * @brief Minimum-size frame generator and counter over mmap rings.
+ */
+class PacketRateEngine {
+public:
+  /**
+   * @brief Constructs an engine with the given configuration.
+   * @param config Packet rate configuration; tx_interface must be set.
+   */
+  explicit PacketRateEngine(const PacketRateConfig& config = PacketRateConfig());
+
+  /**
+   * @brief Transmits for the configured duration and counts received frames.
+   * @return PacketRateResult with rates, drops and per-core utilisation.
+   */
+  PacketRateResult run();
+
+private:
+  PacketRateConfig config_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // PACKET_RATE_ENGINE_H
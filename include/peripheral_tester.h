@@ -28,12 +28,21 @@
 #ifndef PERIPHERAL_TESTER_H
 #define PERIPHERAL_TESTER_H
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <ctime>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "cancellation.h"
 #include "json_utils.h"
+#include "time_series.h"
 
 /**
  * @namespace imx93_peripheral_test
@@ -76,6 +85,56 @@ inline std::string test_result_to_string(TestResult result) {
   }
 }
 
+/**
+ * @brief Limit value of a TestMetric side that is not checked.
+ */
+constexpr double NO_LIMIT = std::numeric_limits<double>::quiet_NaN();
+
+/**
+ * @struct TestMetric
+ * @brief One numeric result of a test, with its unit and optional pass limits.
+ */
+struct TestMetric {
+  std::string name;             /**< e.g. "write_speed" */
+  std::string unit;             /**< e.g. "MB/s"; empty for counts */
+  double      value = 0.0;
+  double      lower = NO_LIMIT; /**< Lowest passing value */
+  double      upper = NO_LIMIT; /**< Highest passing value */
+
+  bool has_limits() const {
+    return !std::isnan(lower) || !std::isnan(upper);
+  }
+
+  /**
+   * @brief Returns true if the value lies within the limits that are set.
+   */
+  bool within_limits() const {
+    if (std::isnan(value)) {
+      return !has_limits();
+    }
+    return (std::isnan(lower) || value >= lower) && (std::isnan(upper) || value <= upper);
+  }
+};
+
+/**
+ * @struct SubTestResult
+ * @brief Outcome of one step of a test, e.g. the benchmark of the CPU test.
+ */
+struct SubTestResult {
+  std::string name;
+  TestResult  result;
+};
+
+/**
+ * @struct ReportSeries
+ * @brief One monitor series of a test, downsampled to the buckets its report prints.
+ */
+struct ReportSeries {
+  std::string                   name;    /**< e.g. "temperature" */
+  std::string                   unit;    /**< e.g. "C" */
+  std::vector<TimeSeriesBucket> buckets; /**< Oldest first */
+};
+
 /**
  * @struct TestReport
  * @brief Structure containing detailed test results and metadata.
@@ -89,6 +148,9 @@ struct TestReport {
   std::chrono::milliseconds             duration;        /**< Time taken to complete the test */
   std::string                           details;   /**< Detailed test output or error messages */
   std::chrono::system_clock::time_point timestamp; /**< When the test was executed */
+  std::vector<TestMetric>               metrics;   /**< Numeric results, in recording order */
+  std::vector<SubTestResult>            checks;    /**< Outcomes of the individual steps */
+  std::vector<ReportSeries>             series;    /**< Sampled by monitor tests */
 
   /**
    * @brief Default constructor initializing all fields.
@@ -96,22 +158,118 @@ struct TestReport {
   TestReport()
       : result(TestResult::SKIPPED), duration(0), timestamp(std::chrono::system_clock::now()) {}
 
+  /**
+   * @brief Writes the report as one JSON object; series are only written if sampled.
+   */
+  void write_json(JsonStream& json) const {
+    auto      time = std::chrono::system_clock::to_time_t(timestamp);
+    struct tm local;
+    char      formatted[32] = "";
+    if (localtime_r(&time, &local) != nullptr) {
+      std::strftime(formatted, sizeof(formatted), "%Y-%m-%d %H:%M:%S", &local);
+    }
+
+    json.begin_object();
+    json.key("peripheral").value(peripheral_name);
+    json.key("result").value(test_result_to_string(result));
+    json.key("duration_ms").value(static_cast<int64_t>(duration.count()));
+    json.key("timestamp").value(formatted);
+    json.key("details").value(details);
+
+    json.key("metrics").begin_array();
+    for (const auto& metric : metrics) {
+      json.begin_object();
+      json.key("name").value(metric.name);
+      json.key("value").value(metric.value);
+      json.key("unit").value(metric.unit);
+      if (metric.has_limits()) {
+        if (!std::isnan(metric.lower)) {
+          json.key("lower").value(metric.lower);
+        }
+        if (!std::isnan(metric.upper)) {
+          json.key("upper").value(metric.upper);
+        }
+        json.key("pass").value(metric.within_limits());
+      }
+      json.end_object();
+    }
+    json.end_array();
+
+    json.key("checks").begin_array();
+    for (const auto& check : checks) {
+      json.begin_object();
+      json.key("name").value(check.name);
+      json.key("result").value(test_result_to_string(check.result));
+      json.end_object();
+    }
+    json.end_array();
+
+    if (!series.empty()) {
+      json.key("series").begin_array();
+      for (const auto& entry : series) {
+        json.begin_object();
+        json.key("name").value(entry.name);
+        json.key("unit").value(entry.unit);
+        json.key("buckets").begin_array();
+        for (const auto& bucket : entry.buckets) {
+          json.begin_object();
+          json.key("start_s").value(bucket.start_s);
+          json.key("end_s").value(bucket.end_s);
+          json.key("min").value(bucket.min);
+          json.key("mean").value(bucket.mean);
+          json.key("max").value(bucket.max);
+          json.key("samples").value(bucket.samples);
+          json.end_object();
+        }
+        json.end_array();
+        json.end_object();
+      }
+      json.end_array();
+    }
+    json.end_object();
+  }
+
+  /**
+   * @brief Returns the metric with a name, or nullptr.
+   */
+  const TestMetric* metric(const std::string& name) const {
+    for (const auto& entry : metrics) {
+      if (entry.name == name) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Returns the result of a step, or SKIPPED if it was not recorded.
+   */
+  TestResult check(const std::string& name) const {
+    for (const auto& entry : checks) {
+      if (entry.name == name) {
+        return entry.result;
+      }
+    }
+    return TestResult::SKIPPED;
+  }
+
   std::string to_json() const {
-    std::stringstream ss;
-    auto              time = std::chrono::system_clock::to_time_t(timestamp);
-    std::stringstream time_ss;
-    time_ss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
-
-    ss << "{"
-       << "\"peripheral\": " << JsonWriter::to_json_value(peripheral_name) << ","
-       << "\"result\": " << JsonWriter::to_json_value(test_result_to_string(result)) << ","
-       << "\"duration_ms\": " << duration.count() << ","
-       << "\"timestamp\": " << JsonWriter::to_json_value(time_ss.str()) << ","
-       << "\"details\": " << JsonWriter::to_json_value(details) << "}";
-    return ss.str();
+    JsonStream json;
+    write_json(json);
+    return json.str();
   }
 };
 
+/**
+ * @struct StressCounters
+ * @brief Live progress of a stress load, read by the caller while it runs.
+ */
+struct StressCounters {
+  std::atomic<uint64_t> operations{0}; /**< Completed passes, transfers or loops */
+  std::atomic<uint64_t> bytes{0};      /**< Bytes moved, for data-bound loads */
+  std::atomic<uint64_t> errors{0};     /**< Verification mismatches or failed operations */
+};
+
 /**
  * @class PeripheralTester
  * @brief Abstract base class for all peripheral testing implementations.
@@ -202,9 +360,78 @@ public:
    * @return true if the peripheral is available and testable, false otherwise.
    *
    * @note This method should perform minimal checks to avoid side effects.
+   * @note Reflects discovery, so call prepare() first.
    */
   virtual bool is_available() const = 0;
 
+  /**
+   * @brief Discovers the peripheral before its first test.
+   *
+   * Constructors only set defaults, so creating a tester is cheap; reading
+   * device information and running external tools happens here, once.
+   * Each tester also has a static probe() that checks for the interface
+   * without constructing anything, for listing.
+   *
+   * @return is_available() after discovery.
+   */
+  bool prepare() {
+    if (!prepared_) {
+      prepared_ = true;
+      discover();
+    }
+    return is_available();
+  }
+
+  /**
+   * @brief Applies a sustained, self-verifying load until stop is set.
+   *
+   * Used by burn-in runs to load several peripherals at once. Progress is
+   * published through counters so the caller can sample throughput over
+   * time.
+   *
+   * @param intensity Load level in the peripheral's own unit (threads, MiB,
+   *        streams); 0 selects its default.
+   * @param stop Set by the caller to end the load.
+   * @param counters Receives operations, bytes and errors as the load runs.
+   * @return SUCCESS if no errors were found, NOT_SUPPORTED if the
+   *         peripheral has no stress load.
+   */
+  virtual TestResult stress(uint32_t intensity, const std::atomic<bool>& stop,
+                            StressCounters& counters) {
+    (void)intensity;
+    (void)stop;
+    (void)counters;
+    return TestResult::NOT_SUPPORTED;
+  }
+
+  /**
+   * @brief Returns the metrics recorded by the last monitor_test().
+   *
+   * Memory is bounded by the store's fixed ring capacity regardless of the
+   * monitoring duration; older data survives as min/max/mean buckets.
+   */
+  const TimeSeriesStore& monitor_series() const {
+    return monitor_series_;
+  }
+
+  /**
+   * @brief Forwards every raw sample of later monitor runs to a sink, e.g. a recorder.
+   * @param sink Sink to use, or nullptr to stop forwarding.
+   */
+  void set_telemetry_sink(std::shared_ptr<TimeSeriesSink> sink) {
+    monitor_series_.set_sink(sink);
+  }
+
+  /**
+   * @brief Returns the token a watchdog cancels to stop the running test.
+   *
+   * Monitor loops wait on it instead of sleeping and stress loads end when
+   * it is set, so a cancelled test returns its partial results promptly.
+   */
+  CancellationToken& cancellation() {
+    return cancellation_;
+  }
+
 protected:
   /**
    * @brief Protected constructor to prevent direct instantiation.
@@ -215,11 +442,17 @@ protected:
    */
   PeripheralTester() = default;
 
+  /**
+   * @brief Detects the peripheral and gathers its information; called once by prepare().
+   */
+  virtual void discover() {}
+
   /**
    * @brief Creates a standardized test report.
    *
    * Helper method for derived classes to create TestReport objects
-   * with consistent formatting and metadata.
+   * with consistent formatting and metadata. Metrics and checks added since
+   * the previous report are moved into it.
    *
    * @param result The outcome of the test.
    * @param details Additional information about the test execution.
@@ -228,15 +461,83 @@ protected:
    * @return TestReport populated with the provided information.
    */
   TestReport create_report(TestResult result, const std::string& details,
-                           std::chrono::milliseconds test_duration) const {
+                           std::chrono::milliseconds test_duration) {
     TestReport report;
     report.result          = result;
     report.peripheral_name = get_peripheral_name();
     report.duration        = test_duration;
     report.details         = details;
     report.timestamp       = std::chrono::system_clock::now();
+    report.metrics         = std::move(metrics_);
+    report.checks          = std::move(checks_);
+    metrics_.clear();
+    checks_.clear();
     return report;
   }
+
+  /**
+   * @brief Adds a numeric result to the next report.
+   * @param name Identifier in snake_case, stable across releases.
+   * @param value Measured value.
+   * @param unit Unit of the value; empty for counts.
+   * @param lower Lowest passing value, or NO_LIMIT.
+   * @param upper Highest passing value, or NO_LIMIT.
+   */
+  void add_metric(const std::string& name, double value, const std::string& unit,
+                  double lower = NO_LIMIT, double upper = NO_LIMIT) {
+    TestMetric metric;
+    metric.name  = name;
+    metric.unit  = unit;
+    metric.value = value;
+    metric.lower = lower;
+    metric.upper = upper;
+    metrics_.push_back(std::move(metric));
+  }
+
+  /**
+   * @brief Adds the outcome of one step to the next report.
+   * @return The result, so the call can wrap the step.
+   */
+  TestResult add_check(const std::string& name, TestResult result) {
+    checks_.push_back({name, result});
+    return result;
+  }
+
+  /**
+   * @brief Creates the report of a monitor test from the series it sampled.
+   *
+   * Like create_report(), and additionally adds the min, mean and max of every
+   * monitor series as metrics, carries the series downsampled to at most
+   * REPORT_SERIES_POINTS buckets, and appends them as text to the details.
+   */
+  TestReport create_monitor_report(TestResult result, const std::string& details,
+                                   std::chrono::milliseconds test_duration) {
+    std::vector<ReportSeries> sampled;
+    for (const auto& series : monitor_series_.series()) {
+      TimeSeriesBucket all = series.summary();
+      if (all.samples == 0) {
+        continue;
+      }
+      add_metric(series.name() + "_min", all.min, series.unit());
+      add_metric(series.name() + "_mean", all.mean, series.unit());
+      add_metric(series.name() + "_max", all.max, series.unit());
+      sampled.push_back({series.name(), series.unit(), series.downsampled(REPORT_SERIES_POINTS)});
+    }
+    std::string text   = details + monitor_series_.format(REPORT_SERIES_POINTS);
+    TestReport  report = create_report(result, text, test_duration);
+    report.series = std::move(sampled);
+    return report;
+  }
+
+  static constexpr size_t REPORT_SERIES_POINTS = 32; /**< Buckets per series in a report */
+
+  TimeSeriesStore            monitor_series_; /**< Metrics of the last monitor run */
+  std::vector<TestMetric>    metrics_;        /**< Collected for the next report */
+  std::vector<SubTestResult> checks_;         /**< Collected for the next report */
+  CancellationToken          cancellation_;   /**< Checked by long-running loops */
+
+private:
+  bool prepared_ = false; /**< discover() has run */
 };
 
 }  // namespace imx93_peripheral_test
@@ -0,0 +1,269 @@
+/**
+ * @file power_sampler.h
+ * @brief High-rate power telemetry sampler for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the PowerSampler class, which reads every voltage,
+ * current and power channel the kernel exposes at up to 1 kHz and integrates
+ * the energy drawn on each rail.
+ *
+ * @details
+ * - Channels are discovered once under class/power_supply (voltage_now,
+ *   current_now, power_now), class/hwmon (in*_input, curr*_input,
+ *   power*_input) and class/regulator (microvolts, microamps).
+ * - Every channel file stays open; a sample is one pread() per channel.
+ * - A dedicated thread samples on an absolute schedule into a fixed-size
+ *   ring buffer and integrates rail power with the trapezoidal rule.
+ * - Every sample also feeds a RailStabilityTracker for per-rail ripple and
+ *   brown-out detection, and a TimeSeriesStore of per-rail power whose
+ *   downsampling tiers keep days of 1 kHz data in constant memory.
+ * - The sysfs root is configurable so tests can run against a fake tree.
+ */
+
+#ifndef POWER_SAMPLER_H
+#define POWER_SAMPLER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rail_stability.h"
+#include "time_series.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @enum PowerQuantity
+ * @brief Physical quantity of a telemetry channel.
+ */
+enum class PowerQuantity { VOLTAGE, CURRENT, POWER };
+
+/**
+ * @struct PowerChannel
+ * @brief One sysfs telemetry attribute.
+ */
+struct PowerChannel {
+  std::string   source;  /**< "power_supply", "hwmon" or "regulator" */
+  std::string   device;  /**< Supply, hwmon chip or regulator name */
+  std::string   label;   /**< Attribute label, e.g. "in1" or "VDD_SOC" */
+  std::string   path;
+  PowerQuantity quantity = PowerQuantity::VOLTAGE;
+  double        scale    = 1.0; /**< Raw value to V, A or W */
+};
+
+/**
+ * @struct PowerRail
+ * @brief A rail whose power is read directly or computed from V x I.
+ */
+struct PowerRail {
+  std::string name;
+  int         power_channel   = -1; /**< Index into channels(), -1 if absent */
+  int         voltage_channel = -1;
+  int         current_channel = -1;
+};
+
+/**
+ * @struct RailStats
+ * @brief Power statistics of one rail since the last reset_stats().
+ */
+struct RailStats {
+  std::string name;
+  uint64_t    samples   = 0;
+  double      energy_j  = 0.0; /**< Trapezoidal integral of power over time */
+  double      average_w = 0.0; /**< energy_j / elapsed time */
+  double      min_w     = 0.0;
+  double      peak_w    = 0.0;
+  double      last_w    = 0.0;
+};
+
+/**
+ * @struct PowerSamplerConfig
+ * @brief Parameters of a power sampler.
+ */
+struct PowerSamplerConfig {
+  std::string                     sysfs_root    = "/sys";
+  std::chrono::microseconds       period        = std::chrono::microseconds(1000); /**< >= 1 ms */
+  size_t                          ring_capacity = 16384; /**< Samples kept in the ring buffer */
+  BrownoutConfig                  brownout;
+  std::shared_ptr<TimeSeriesSink> series_sink; /**< Receives every rail power sample */
+};
+
+/**
+ * @struct PowerReading
+ * @brief Values of all channels at one instant, in V, A and W.
+ */
+struct PowerReading {
+  std::chrono::steady_clock::time_point timestamp;
+  std::vector<double>                   values; /**< One value per channel */
+};
+
+/**
+ * @class PowerSampler
+ * @brief Discovers sysfs power channels and samples them on a background thread.
+ */
+class PowerSampler {
+public:
+  /**
+   * @brief Constructs a sampler; channels are discovered by discover().
+   * @param config Sampler configuration.
+   */
+  explicit PowerSampler(const PowerSamplerConfig& config = PowerSamplerConfig());
+
+  /**
+   * @brief Stops sampling and closes all channel files.
+   */
+  ~PowerSampler();
+
+  PowerSampler(const PowerSampler&)            = delete;
+  PowerSampler& operator=(const PowerSampler&) = delete;
+
+  /**
+   * @brief Finds and opens every telemetry channel under the sysfs root.
+   * @return true if at least one channel was found.
+   */
+  bool discover();
+
+  /**
+   * @brief Returns the discovered channels.
+   */
+  const std::vector<PowerChannel>& channels() const {
+    return channels_;
+  }
+
+  /**
+   * @brief Returns the rails power is computed for.
+   */
+  const std::vector<PowerRail>& rails() const {
+    return rails_;
+  }
+
+  /**
+   * @brief Reads all channels once on the calling thread.
+   * @param reading Receives the timestamp and values; channels that cannot be
+   *        read keep the value from the previous call.
+   * @return true if every channel was read.
+   */
+  bool read(PowerReading& reading);
+
+  /**
+   * @brief Starts the sampling thread.
+   * @return false if no channels were discovered or it is already running.
+   */
+  bool start();
+
+  /**
+   * @brief Stops the sampling thread.
+   */
+  void stop();
+
+  /**
+   * @brief Clears the rail statistics so a new measurement window starts now.
+   */
+  void reset_stats();
+
+  /**
+   * @brief Returns per-rail statistics since start() or reset_stats().
+   */
+  std::vector<RailStats> rail_stats() const;
+
+  /**
+   * @brief Returns per-rail ripple and brown-out statistics since start() or reset_stats().
+   */
+  std::vector<RailStability> rail_stability() const;
+
+  /**
+   * @brief Returns the per-rail power series since start() or reset_stats().
+   */
+  TimeSeriesStore power_series() const;
+
+  /**
+   * @brief Copies up to max_samples of the most recent readings, oldest first.
+   * @param max_samples Maximum number of readings to return.
+   */
+  std::vector<PowerReading> recent(size_t max_samples) const;
+
+  /**
+   * @brief Returns the number of samples taken since start().
+   */
+  uint64_t samples_taken() const {
+    return samples_taken_.load();
+  }
+
+  /**
+   * @brief Returns the achieved sampling rate since start().
+   */
+  double achieved_rate_hz() const;
+
+  /**
+   * @brief Computes the power of a rail from one reading.
+   * @param rail Rail to evaluate.
+   * @param values Channel values of the reading.
+   * @return Rail power in watts.
+   */
+  static double rail_power(const PowerRail& rail, const std::vector<double>& values);
+
+private:
+  /**
+   * @brief Adds a channel if the attribute exists and can be opened.
+   * @return Index of the channel, or -1.
+   */
+  int add_channel(const std::string& source, const std::string& device, const std::string& label,
+                  const std::string& path, PowerQuantity quantity, double scale);
+
+  /**
+   * @brief Adds voltage_now/current_now/power_now of every power supply.
+   */
+  void discover_power_supplies();
+
+  /**
+   * @brief Adds in*, curr* and power* inputs of every hwmon chip.
+   */
+  void discover_hwmon();
+
+  /**
+   * @brief Adds microvolts/microamps of every regulator that reports them.
+   */
+  void discover_regulators();
+
+  /**
+   * @brief Sampling loop run by the background thread.
+   */
+  void sample_loop();
+
+  /**
+   * @brief Appends a reading to the ring and updates the rail statistics.
+   */
+  void record(const PowerReading& reading);
+
+  PowerSamplerConfig        config_;
+  std::vector<PowerChannel> channels_;
+  std::vector<int>          fds_;
+  std::vector<PowerRail>    rails_;
+
+  mutable std::mutex                                 mutex_;
+  std::vector<std::chrono::steady_clock::time_point> ring_times_;
+  std::vector<double>                                ring_values_; /**< capacity x channels */
+  size_t                                             ring_head_  = 0;
+  size_t                                             ring_count_ = 0;
+  std::vector<RailStats>                             stats_;
+  std::chrono::steady_clock::time_point              stats_start_;
+  std::chrono::steady_clock::time_point              last_time_;
+  std::vector<double>                                last_power_;
+  RailStabilityTracker                               stability_;
+  TimeSeriesStore                                    series_;
+
+  std::thread                           thread_;
+  std::atomic<bool>                     running_;
+  std::atomic<uint64_t>                 samples_taken_;
+  std::chrono::steady_clock::time_point started_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // POWER_SAMPLER_H
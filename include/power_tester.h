@@ -15,7 +15,11 @@
 #include <string>
 #include <vector>
 
+#include "cpufreq_sweep.h"
+#include "energy_meter.h"
 #include "peripheral_tester.h"
+#include "power_sampler.h"
+#include "suspend_latency.h"
 
 namespace imx93_peripheral_test {
 
@@ -112,7 +116,73 @@ public:
    */
   bool is_available() const override;
 
+  /**
+   * @brief Returns true if power supply, regulator or SoC sysfs entries exist.
+   */
+  static bool probe();
+
+  /**
+   * @brief Sets the sampling period and brown-out thresholds used by monitor_test().
+   * @param config Sampler configuration.
+   */
+  void set_monitor_config(const PowerSamplerConfig& config) {
+    monitor_config_ = config;
+  }
+
+  /**
+   * @brief Measures the energy a workload costs per run.
+   *
+   * Samples the selected rail while the workload runs and reports joules per
+   * run, average/peak power and operations per joule. The idle and load
+   * figures are kept for last_consumption().
+   *
+   * @param name Workload name for the report.
+   * @param workload Workload to run once per measurement run.
+   * @param config Energy meter configuration.
+   * @return TestReport with the energy figures; FAILURE if a run completed no
+   *         operations, NOT_SUPPORTED without a power rail.
+   */
+  TestReport energy_test(const std::string& name, const EnergyMeter::Workload& workload,
+                         const EnergyMeterConfig& config = EnergyMeterConfig());
+
+  /**
+   * @brief Measures suspend entry and resume latency over RTC-woken cycles.
+   *
+   * Reports per-cycle time suspended, device suspend/resume phase times,
+   * the wakeup source and the devices slowest to resume. The system really
+   * suspends, so this is never part of short_test().
+   *
+   * @param config Suspend probe configuration.
+   * @return TestReport with the latency figures; NOT_SUPPORTED without the
+   *         requested state or an RTC wake alarm.
+   */
+  TestReport suspend_test(const SuspendLatencyConfig& config = SuspendLatencyConfig());
+
+  /**
+   * @brief Sweeps cpufreq governors and pinned frequencies with a fixed workload.
+   *
+   * Reports completion time, energy and average power of each setting and
+   * the energy/performance Pareto front. The original governor and limits
+   * are restored afterwards, including when the test is cancelled.
+   *
+   * @param config Sweep configuration.
+   * @return TestReport with one line per setting; NOT_SUPPORTED without cpufreq.
+   */
+  TestReport cpufreq_test(const CpufreqSweepConfig& config = CpufreqSweepConfig());
+
+  /**
+   * @brief Returns the idle/load power of the last energy measurement.
+   */
+  const PowerConsumption& last_consumption() const {
+    return consumption_;
+  }
+
 private:
+  /**
+   * @brief Reads the power supply and PMIC information if probe() succeeds.
+   */
+  void discover() override;
+
   /**
    * @brief Retrieves power information from system.
    * @return PowerInfo structure with system power details.
@@ -145,13 +215,22 @@ private:
 
   /**
    * @brief Monitors power consumption over time.
+   *
+   * Samples every telemetry channel with PowerSampler for the whole duration
+   * and records per-rail energy, average and peak power, voltage ripple and
+   * brown-out dips in monitor_details_.
+   *
    * @param duration Monitoring duration.
-   * @return TestResult indicating success or failure.
+   * @return TestResult; FAILURE on any brown-out dip.
    */
   TestResult monitor_power_consumption(std::chrono::seconds duration);
 
   /**
    * @brief Measures power consumption under different loads.
+   *
+   * Uses EnergyMeter with a short all-core spin as the load. Suspend power
+   * is left at zero; it cannot be sampled while the system is suspended.
+   *
    * @return PowerConsumption structure with measurements.
    */
   PowerConsumption measure_power_consumption();
@@ -163,8 +242,11 @@ private:
    */
   PowerInfo parse_power_supply(const std::string& supply_path);
 
-  PowerInfo power_info_;
-  bool      power_available_;
+  PowerInfo          power_info_;
+  bool               power_available_;
+  PowerSamplerConfig monitor_config_;
+  std::string        monitor_details_;
+  PowerConsumption   consumption_;
 };
 
 }  // namespace imx93_peripheral_test
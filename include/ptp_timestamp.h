@@ -0,0 +1,128 @@
+/**
+ * @file ptp_timestamp.h
+ * @brief TSN/PTP timestamp accuracy measurement for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the PtpTimestampProbe class, which measures how well
+ * the PTP hardware clock (PHC) of an interface tracks the system clock and
+ * how stable packet timestamps are on the path between two interfaces.
+ *
+ * @details
+ * - The PHC is discovered with ETHTOOL_GET_TS_INFO and read through
+ *   /dev/ptpN using PTP_SYS_OFFSET_PRECISE (hardware cross-timestamp),
+ *   falling back to PTP_SYS_OFFSET_EXTENDED and PTP_SYS_OFFSET.
+ * - Hardware timestamping is enabled with SIOCSHWTSTAMP and the previous
+ *   configuration is restored afterwards.
+ * - IEEE 1588 ethertype frames are sent on one interface and received on
+ *   another (or the same one for lo) through AF_PACKET sockets with
+ *   SO_TIMESTAMPING; the TX-to-RX timestamp difference gives path latency
+ *   and jitter.
+ * - Without a PHC or hardware timestamping support the probe falls back to
+ *   software timestamps, so it also runs in CI over lo or a veth pair.
+ */
+
+#ifndef PTP_TIMESTAMP_H
+#define PTP_TIMESTAMP_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct PtpTimestampConfig
+ * @brief Parameters of a timestamp accuracy run.
+ */
+struct PtpTimestampConfig {
+  std::string               tx_interface = "lo";
+  std::string               rx_interface;          /**< Empty = same as tx_interface */
+  std::string               ptp_device;            /**< Empty = PHC of tx_interface */
+  uint32_t                  offset_samples = 50;   /**< PHC-to-system offset readings */
+  uint32_t                  packets        = 100;  /**< Timestamped frames to exchange */
+  std::chrono::milliseconds interval       = std::chrono::milliseconds(5);
+  bool                      allow_software = true; /**< Fall back to software timestamps */
+};
+
+/**
+ * @struct TimingDistribution
+ * @brief Summary of a set of nanosecond measurements.
+ */
+struct TimingDistribution {
+  uint32_t count     = 0;
+  double   min_ns    = 0.0;
+  double   max_ns    = 0.0;
+  double   mean_ns   = 0.0;
+  double   stddev_ns = 0.0;
+  double   p50_ns    = 0.0;
+  double   p99_ns    = 0.0;
+  double   jitter_ns = 0.0; /**< Mean absolute difference of consecutive values */
+
+  /**
+   * @brief Summarises measurements given in acquisition order.
+   * @param values Measurements in nanoseconds.
+   * @return Distribution of the values.
+   */
+  static TimingDistribution from_samples(const std::vector<double>& values);
+};
+
+/**
+ * @struct PtpTimestampResult
+ * @brief Outcome of a timestamp accuracy run.
+ */
+struct PtpTimestampResult {
+  bool               success = false;
+  std::string        phc_device;                   /**< Empty without a PHC */
+  std::string        offset_method = "none";       /**< PRECISE, EXTENDED, BASIC or none */
+  TimingDistribution phc_offset;                   /**< PHC minus CLOCK_REALTIME */
+  TimingDistribution phc_read_window;              /**< Width of the system-time bracket */
+  bool               hardware_timestamps = false;  /**< Frames were hardware timestamped */
+  uint32_t           packets_sent        = 0;
+  uint32_t           packets_timestamped = 0;      /**< Frames with both TX and RX timestamps */
+  TimingDistribution path_latency;                 /**< RX minus TX timestamp */
+  std::string        error_message;
+};
+
+/**
+ * @class PtpTimestampProbe
+ * @brief Measures PHC offset and packet timestamp jitter.
+ */
+class PtpTimestampProbe {
+public:
+  /**
+   * @brief Constructs a probe with the given configuration.
+   * @param config Probe configuration.
+   */
+  explicit PtpTimestampProbe(const PtpTimestampConfig& config = PtpTimestampConfig());
+
+  /**
+   * @brief Runs the PHC offset sampling and the frame exchange.
+   * @return PtpTimestampResult with both distributions.
+   */
+  PtpTimestampResult run();
+
+private:
+  /**
+   * @brief Samples the PHC-to-system offset through /dev/ptpN.
+   * @param device PTP character device path.
+   * @param result Receives the method and distributions.
+   * @return true if at least one offset was read.
+   */
+  bool sample_phc_offset(const std::string& device, PtpTimestampResult& result);
+
+  /**
+   * @brief Exchanges timestamped frames between the TX and RX interfaces.
+   * @param hardware Request hardware timestamps.
+   * @param result Receives packet counters and the latency distribution.
+   * @return true if at least one frame was timestamped on both ends.
+   */
+  bool exchange_frames(bool hardware, PtpTimestampResult& result);
+
+  PtpTimestampConfig config_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // PTP_TIMESTAMP_H
@@ -0,0 +1,184 @@
+/**
+ * @file rail_stability.h
+ * @brief Streaming power-rail ripple and brown-out analysis for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines StreamingStats, a constant-memory accumulator, and
+ * RailStabilityTracker, which PowerSampler feeds with every sample to track
+ * per-rail voltage/current/power statistics, RMS ripple and brown-out dips.
+ *
+ * @details
+ * - StreamingStats uses Welford's update, so mean and variance stay
+ *   accurate over billions of samples without storing any of them.
+ * - RMS ripple is the standard deviation of the rail voltage, i.e. the RMS
+ *   of its AC component.
+ * - A dip starts at the first sample below the rail's threshold and ends at
+ *   the first sample back above it; only the most recent max_events dips
+ *   are kept, with running totals for the rest, so week-long monitors use
+ *   bounded memory.
+ */
+
+#ifndef RAIL_STABILITY_H
+#define RAIL_STABILITY_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace imx93_peripheral_test {
+
+/**
+ * @class StreamingStats
+ * @brief O(1)-memory count, min, max, mean and variance of a sample stream.
+ */
+class StreamingStats {
+public:
+  /**
+   * @brief Adds one sample.
+   */
+  void add(double value);
+
+  /**
+   * @brief Forgets all samples.
+   */
+  void reset();
+
+  uint64_t count() const {
+    return count_;
+  }
+
+  double mean() const {
+    return mean_;
+  }
+
+  double min() const {
+    return min_;
+  }
+
+  double max() const {
+    return max_;
+  }
+
+  /**
+   * @brief Returns the population variance, 0 with fewer than two samples.
+   */
+  double variance() const;
+
+  /**
+   * @brief Returns the population standard deviation.
+   */
+  double stddev() const;
+
+private:
+  uint64_t count_ = 0;
+  double   mean_  = 0.0;
+  double   m2_    = 0.0; /**< Sum of squared deviations from the mean */
+  double   min_   = 0.0;
+  double   max_   = 0.0;
+};
+
+/**
+ * @struct BrownoutConfig
+ * @brief Thresholds of brown-out detection.
+ */
+struct BrownoutConfig {
+  double                        relative_threshold = 0.9; /**< Of the rail's mean; 0 disables */
+  std::map<std::string, double> absolute_threshold_v;     /**< Per-rail override, in volts */
+  size_t                        max_events = 64;          /**< Dips kept per rail */
+};
+
+/**
+ * @struct BrownoutEvent
+ * @brief One voltage dip below a rail's threshold.
+ */
+struct BrownoutEvent {
+  std::chrono::system_clock::time_point start;
+  double                                duration_ms   = 0.0;
+  double                                min_voltage_v = 0.0;
+  double                                threshold_v   = 0.0;
+  bool                                  ongoing       = false; /**< Still below at last sample */
+};
+
+/**
+ * @struct RailStability
+ * @brief Streaming statistics and brown-outs of one rail.
+ */
+struct RailStability {
+  std::string                name;
+  StreamingStats             voltage; /**< Empty if the rail has no voltage channel */
+  StreamingStats             current;
+  StreamingStats             power;
+  uint64_t                   dip_count      = 0;
+  double                     longest_dip_ms = 0.0;
+  double                     total_dip_ms   = 0.0;
+  std::vector<BrownoutEvent> dips; /**< Most recent dips, oldest first */
+};
+
+/**
+ * @class RailStabilityTracker
+ * @brief Accumulates per-rail statistics and detects brown-outs sample by sample.
+ */
+class RailStabilityTracker {
+public:
+  /**
+   * @brief Constructs a tracker with the given thresholds.
+   * @param config Brown-out configuration.
+   */
+  explicit RailStabilityTracker(const BrownoutConfig& config = BrownoutConfig());
+
+  /**
+   * @brief Clears all statistics and sets the tracked rails.
+   * @param rail_names One name per rail, in rail index order.
+   */
+  void reset(const std::vector<std::string>& rail_names);
+
+  /**
+   * @brief Adds one sample of a rail.
+   * @param rail Rail index.
+   * @param timestamp Sample time.
+   * @param voltage Rail voltage in V, NaN if not measured.
+   * @param current Rail current in A, NaN if not measured.
+   * @param power Rail power in W.
+   */
+  void add(size_t rail, std::chrono::steady_clock::time_point timestamp, double voltage,
+           double current, double power);
+
+  /**
+   * @brief Returns the statistics of every rail; a dip still in progress is
+   *        included up to the last sample and marked ongoing.
+   */
+  std::vector<RailStability> snapshot() const;
+
+private:
+  struct RailState {
+    RailStability                         stats;
+    std::deque<BrownoutEvent>             dips;
+    bool                                  in_dip = false;
+    std::chrono::steady_clock::time_point dip_start;
+    std::chrono::steady_clock::time_point last_sample;
+    double                                dip_min_v       = 0.0;
+    double                                dip_threshold_v = 0.0;
+  };
+
+  /**
+   * @brief Threshold of a rail in volts, 0 while there is none yet.
+   */
+  double threshold(const RailState& state) const;
+
+  /**
+   * @brief Closes a dip at the given time and records it.
+   */
+  void close_dip(RailState& state, std::chrono::steady_clock::time_point end) const;
+
+  BrownoutConfig                      config_;
+  std::vector<RailState>              rails_;
+  std::chrono::system_clock::duration wall_offset_; /**< system_clock minus steady_clock */
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // RAIL_STABILITY_H
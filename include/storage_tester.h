@@ -93,7 +93,35 @@ public:
    */
   bool is_available() const override;
 
+  /**
+   * @brief Returns true if block device information exists, without constructing a tester.
+   */
+  static bool probe();
+
+  /**
+   * @brief Writes, syncs and verifies a scratch file in a loop until stopped.
+   * @param intensity Scratch file size in MB; 0 = 32 MB.
+   * @param stop Set by the caller to end the load.
+   * @param counters Counts passes, bytes written plus read, and mismatched blocks.
+   * @return SUCCESS if all I/O succeeded and every block read back intact.
+   */
+  TestResult stress(uint32_t intensity, const std::atomic<bool>& stop,
+                    StressCounters& counters) override;
+
+  /**
+   * @brief Sets the directory stress() puts its scratch file in.
+   * @param path Directory on the filesystem under test; defaults to /tmp.
+   */
+  void set_stress_path(const std::string& path) {
+    stress_path_ = path;
+  }
+
 private:
+  /**
+   * @brief Enumerates the block devices if probe() succeeds.
+   */
+  void discover() override;
+
   /**
    * @brief Enumerates all storage devices on the system.
    * @return Vector of StorageDevice structures.
@@ -153,6 +181,7 @@ private:
 
   std::vector<StorageDevice> storage_devices_;
   bool                       storage_available_;
+  std::string                stress_path_ = "/tmp";
 };
 
 }  // namespace imx93_peripheral_test
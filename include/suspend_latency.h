@@ -0,0 +1,129 @@
+/**
+ * @file suspend_latency.h
+ * @brief Suspend/resume latency measurement for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the SuspendLatencyProbe class, which runs repeated
+ * suspend cycles woken by the RTC alarm and reports how long the system
+ * takes to enter and leave suspend, which device callbacks dominate, and
+ * which wakeup source fired.
+ *
+ * @details
+ * - Each cycle arms /sys/class/rtc/<rtc>/wakealarm and writes the requested
+ *   state ("freeze" or "mem") to /sys/power/state; the write returns after
+ *   resume.
+ * - CLOCK_MONOTONIC stops while timekeeping is suspended and CLOCK_BOOTTIME
+ *   does not, so their difference across the write is the time suspended.
+ * - pm_print_times and pm_debug_messages are enabled for the run so the
+ *   kernel log carries per-phase and per-device callback times; both are
+ *   restored afterwards.
+ * - /sys/power/suspend_stats confirms each cycle and supplies the hardware
+ *   sleep time on kernels that report it.
+ */
+
+#ifndef SUSPEND_LATENCY_H
+#define SUSPEND_LATENCY_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct SuspendLatencyConfig
+ * @brief Parameters of a suspend/resume run.
+ */
+struct SuspendLatencyConfig {
+  std::string               sysfs_root = "/sys";
+  std::string               kmsg_path  = "/dev/kmsg";
+  std::string               state      = "freeze"; /**< "freeze" or "mem" */
+  std::string               mem_sleep;             /**< s2idle/shallow/deep; empty = leave */
+  std::string               rtc        = "rtc0";
+  uint32_t                  cycles     = 3;
+  std::chrono::seconds      wake_after = std::chrono::seconds(2);
+  std::chrono::milliseconds settle     = std::chrono::milliseconds(1000); /**< Between cycles */
+};
+
+/**
+ * @struct DeviceSuspendTime
+ * @brief Time spent in one device's PM callbacks during a cycle.
+ */
+struct DeviceSuspendTime {
+  std::string device;  /**< "<driver> <device>" as printed by the kernel */
+  double      suspend_ms = 0.0;
+  double      resume_ms  = 0.0;
+};
+
+/**
+ * @struct SuspendCycle
+ * @brief Measurements of one suspend/resume cycle.
+ */
+struct SuspendCycle {
+  bool                           success      = false;
+  double                         total_ms     = 0.0;  /**< CLOCK_BOOTTIME across the write */
+  double                         active_ms    = 0.0;  /**< CLOCK_MONOTONIC across the write */
+  double                         suspended_ms = 0.0;  /**< total_ms - active_ms */
+  double                         hw_sleep_ms  = -1.0; /**< suspend_stats/last_hw_sleep */
+  double                         entry_ms     = -1.0; /**< Device suspend phases, from the log */
+  double                         resume_ms    = -1.0; /**< Device resume phases, from the log */
+  int                            wakeup_irq   = -1;
+  std::vector<std::string>       wakeup_sources; /**< Sources whose wakeup_count increased */
+  std::vector<DeviceSuspendTime> devices;
+  std::string                    error_message;
+};
+
+/**
+ * @struct SuspendLatencyResult
+ * @brief Outcome of a suspend/resume run.
+ */
+struct SuspendLatencyResult {
+  bool                      success   = false;
+  bool                      supported = false; /**< State and RTC wake alarm are available */
+  std::string               state;
+  std::vector<SuspendCycle> cycles;
+  std::string               error_message;
+};
+
+/**
+ * @class SuspendLatencyProbe
+ * @brief Runs RTC-woken suspend cycles and measures their latency.
+ */
+class SuspendLatencyProbe {
+public:
+  /**
+   * @brief Constructs a probe with the given configuration.
+   * @param config Probe configuration.
+   */
+  explicit SuspendLatencyProbe(const SuspendLatencyConfig& config = SuspendLatencyConfig());
+
+  /**
+   * @brief Runs config.cycles suspend/resume cycles.
+   *
+   * The system really suspends; run it on a target or a disposable VM.
+   *
+   * @return SuspendLatencyResult with one entry per attempted cycle.
+   */
+  SuspendLatencyResult run();
+
+  /**
+   * @brief Extracts phase and device callback times from kernel log lines.
+   * @param lines Log messages without the kmsg record prefix.
+   * @param cycle Receives entry_ms, resume_ms and devices.
+   */
+  static void parse_pm_log(const std::vector<std::string>& lines, SuspendCycle& cycle);
+
+private:
+  /**
+   * @brief Runs one cycle and fills in its measurements.
+   */
+  void run_cycle(SuspendCycle& cycle);
+
+  SuspendLatencyConfig config_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // SUSPEND_LATENCY_H
@@ -0,0 +1,143 @@
+/**
+ * @file telemetry_format.h
+ * @brief On-disk layout of binary telemetry recordings.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the fixed-width structures TelemetryRecorder appends
+ * to a recording and TelemetryReader maps back, plus the CRC-32 both use.
+ *
+ * @details
+ * - A recording is a TelemetryFileHeader followed by blocks. Every block is
+ *   a TelemetryBlockHeader plus payload; the header carries the payload
+ *   size, its CRC-32 and a sequence number.
+ * - SCHEMA blocks name the metrics as {id, name length, unit length, name,
+ *   unit}. They are written before the first record that uses them, so new
+ *   metrics can appear at any point of a session.
+ * - DATA blocks hold TelemetryRecord entries of 24 bytes each.
+ * - INDEX blocks follow every few data blocks and list their offsets and
+ *   time ranges, so a reader can skip data outside a requested range.
+ * - Blocks are only appended, so a power cut can at worst leave a torn
+ *   last block, which fails its size or CRC check; everything before it
+ *   stays readable.
+ * - Fields are in host byte order, which is little-endian on i.MX93 and
+ *   on the x86 hosts recordings are usually analysed on.
+ */
+
+#ifndef TELEMETRY_FORMAT_H
+#define TELEMETRY_FORMAT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace imx93_peripheral_test {
+
+constexpr char     TELEMETRY_MAGIC[8]    = {'I', 'M', 'X', '9', '3', 'T', 'L', 'M'};
+constexpr uint32_t TELEMETRY_VERSION     = 1;
+constexpr uint32_t TELEMETRY_BLOCK_MAGIC = 0x4B4C4254;  // "TBLK"
+
+/**
+ * @enum TelemetryBlockType
+ * @brief Kind of payload that follows a block header.
+ */
+enum class TelemetryBlockType : uint16_t {
+  SCHEMA = 1,
+  DATA   = 2,
+  INDEX  = 3
+};
+
+/**
+ * @struct TelemetryFileHeader
+ * @brief First bytes of a recording.
+ */
+struct TelemetryFileHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t record_size;     /**< sizeof(TelemetryRecord) of the writer */
+  int64_t  created_unix_ns; /**< Wall-clock time the recording was opened */
+  uint64_t reserved;
+};
+
+/**
+ * @struct TelemetryBlockHeader
+ * @brief Header in front of every block payload.
+ */
+struct TelemetryBlockHeader {
+  uint32_t magic;
+  uint16_t type; /**< TelemetryBlockType */
+  uint16_t reserved;
+  uint32_t payload_size;
+  uint32_t crc32;    /**< Of the payload */
+  uint64_t sequence; /**< Block number, starting at 0 */
+};
+
+/**
+ * @struct TelemetryRecord
+ * @brief One sample of one metric.
+ */
+struct TelemetryRecord {
+  int64_t  time_ns; /**< Wall-clock time since the Unix epoch */
+  double   value;
+  uint32_t metric;
+  uint32_t reserved;
+};
+
+/**
+ * @struct TelemetryIndexEntry
+ * @brief Location and time range of one data block.
+ */
+struct TelemetryIndexEntry {
+  uint64_t offset; /**< Of the data block header from the start of the file */
+  int64_t  first_ns;
+  int64_t  last_ns;
+  uint32_t records;
+  uint32_t reserved;
+};
+
+/**
+ * @struct TelemetryMetric
+ * @brief Decoded schema entry.
+ */
+struct TelemetryMetric {
+  uint32_t    id = 0;
+  std::string name;
+  std::string unit;
+};
+
+static_assert(sizeof(TelemetryFileHeader) == 32, "Unexpected padding in TelemetryFileHeader");
+static_assert(sizeof(TelemetryBlockHeader) == 24, "Unexpected padding in TelemetryBlockHeader");
+static_assert(sizeof(TelemetryRecord) == 24, "Unexpected padding in TelemetryRecord");
+static_assert(sizeof(TelemetryIndexEntry) == 32, "Unexpected padding in TelemetryIndexEntry");
+
+/**
+ * @brief Computes the CRC-32 (IEEE 802.3) of a buffer.
+ * @param data Bytes to checksum.
+ * @param size Number of bytes.
+ * @param crc CRC of the preceding bytes when checksumming in pieces.
+ */
+inline uint32_t telemetry_crc32(const void* data, size_t size, uint32_t crc = 0) {
+  static const std::array<uint32_t, 256> table = []() {
+    std::array<uint32_t, 256> entries{};
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+      uint32_t value = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+      }
+      entries[i] = value;
+    }
+    return entries;
+  }();
+
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  crc               = ~crc;
+  for (size_t i = 0; i < size; ++i) {
+    crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+}  // namespace imx93_peripheral_test
+
+#endif  // TELEMETRY_FORMAT_H
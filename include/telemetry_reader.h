@@ -0,0 +1,182 @@
+/**
+ * @file telemetry_reader.h
+ * @brief Memory-mapped reading and export of binary telemetry recordings.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the TelemetryReader class, which maps a recording
+ * written by TelemetryRecorder and streams time ranges of it to a callback,
+ * CSV, JSON or a TimeSeriesStore.
+ *
+ * @details
+ * - open() walks the block headers only and checks the CRC of schema and
+ *   index blocks; data block CRCs are checked when a range touches them, so
+ *   opening a multi-gigabyte recording does not read all of it.
+ * - Data blocks covered by an index block are skipped when their time
+ *   range lies outside the request; the unindexed tail is always scanned.
+ * - Reading stops at the first block whose header or size is invalid, as
+ *   left by a power cut; a data block failing its CRC is skipped and
+ *   counted.
+ */
+
+#ifndef TELEMETRY_READER_H
+#define TELEMETRY_READER_H
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "telemetry_format.h"
+#include "time_series.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct TelemetryRange
+ * @brief Selection of records to read.
+ */
+struct TelemetryRange {
+  int64_t                  from_ns = std::numeric_limits<int64_t>::min(); /**< Inclusive */
+  int64_t                  to_ns   = std::numeric_limits<int64_t>::max(); /**< Inclusive */
+  std::vector<std::string> metrics;                                        /**< Empty = all */
+};
+
+/**
+ * @class TelemetryReader
+ * @brief Read-only memory-mapped view of a recording.
+ */
+class TelemetryReader {
+public:
+  TelemetryReader() = default;
+
+  ~TelemetryReader();
+
+  TelemetryReader(const TelemetryReader&)            = delete;
+  TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+  /**
+   * @brief Maps a recording and indexes its blocks.
+   * @param path Recording to open.
+   * @return true if the file header is valid; see last_error() otherwise.
+   */
+  bool open(const std::string& path);
+
+  /**
+   * @brief Unmaps the recording.
+   */
+  void close();
+
+  const std::vector<TelemetryMetric>& metrics() const {
+    return metrics_;
+  }
+
+  int64_t created_unix_ns() const {
+    return created_unix_ns_;
+  }
+
+  size_t data_blocks() const {
+    return blocks_.size();
+  }
+
+  /**
+   * @brief Returns the number of records in valid-looking data blocks.
+   */
+  uint64_t record_count() const;
+
+  /**
+   * @brief Returns true if the recording ends in a torn or invalid block.
+   */
+  bool truncated() const {
+    return valid_bytes_ < size_;
+  }
+
+  /**
+   * @brief Returns the number of leading bytes that form complete blocks.
+   */
+  uint64_t valid_bytes() const {
+    return valid_bytes_;
+  }
+
+  /**
+   * @brief Returns the number of data blocks skipped because of a CRC mismatch so far.
+   */
+  uint64_t corrupt_blocks() const {
+    return corrupt_blocks_;
+  }
+
+  const std::string& last_error() const {
+    return error_;
+  }
+
+  /**
+   * @brief Calls a function for every record in a range, in file order.
+   * @param range Time range and metrics to read.
+   * @param callback Receives each matching record.
+   * @return Number of records passed to the callback.
+   */
+  uint64_t for_each(const TelemetryRange&                             range,
+                    const std::function<void(const TelemetryRecord&)>& callback);
+
+  /**
+   * @brief Writes a range as CSV with a timestamp_ns,metric,unit,value header.
+   * @return Number of records written.
+   */
+  uint64_t export_csv(const TelemetryRange& range, std::ostream& out);
+
+  /**
+   * @brief Writes a range as a JSON object with a metric list and [time_ns, id, value] samples.
+   * @return Number of records written.
+   */
+  uint64_t export_json(const TelemetryRange& range, std::ostream& out);
+
+  /**
+   * @brief Replays a range into a store, one series per metric, timed from the recording start.
+   * @return Number of records replayed.
+   */
+  uint64_t replay(const TelemetryRange& range, TimeSeriesStore& store);
+
+private:
+  struct DataBlock {
+    uint64_t offset   = 0; /**< Of the payload */
+    uint32_t records  = 0;
+    uint32_t crc32    = 0;
+    int64_t  first_ns = 0;
+    int64_t  last_ns  = 0;
+    bool     indexed  = false; /**< first_ns/last_ns are known */
+    bool     checked  = false; /**< CRC verified */
+    bool     corrupt  = false;
+  };
+
+  /**
+   * @brief Parses a schema payload into metrics_.
+   */
+  void parse_schema(const uint8_t* payload, size_t size);
+
+  /**
+   * @brief Copies the time ranges of an index payload into blocks_.
+   */
+  void apply_index(const uint8_t* payload, size_t size);
+
+  /**
+   * @brief Returns a lookup table from metric id to selection for a range.
+   */
+  std::vector<bool> metric_mask(const TelemetryRange& range) const;
+
+  int                          fd_              = -1;
+  const uint8_t*               data_            = nullptr;
+  uint64_t                     size_            = 0;
+  uint64_t                     valid_bytes_     = 0;
+  int64_t                      created_unix_ns_ = 0;
+  uint64_t                     corrupt_blocks_  = 0;
+  std::vector<TelemetryMetric> metrics_;
+  std::vector<int32_t>         metric_index_; /**< Metric id to position in metrics_, or -1 */
+  std::vector<DataBlock>       blocks_;
+  std::string                  error_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // TELEMETRY_READER_H
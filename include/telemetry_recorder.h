@@ -0,0 +1,181 @@
+/**
+ * @file telemetry_recorder.h
+ * @brief Append-only binary recording of monitor samples for FRDM-IMX93 verification.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines the TelemetryRecorder class, which writes every raw
+ * sample of a monitor session to a compact binary file (see
+ * telemetry_format.h) so week-long runs can be analysed afterwards without
+ * keeping them in memory or as JSON text.
+ *
+ * @details
+ * - Producers only append to an in-memory batch under a mutex; a background
+ *   thread turns each batch into blocks and writes them with one write()
+ *   per flush interval, followed by fdatasync() unless disabled.
+ * - The batch is capped; samples arriving while it is full are counted as
+ *   dropped instead of growing memory without bound.
+ * - sink() adapts the recorder to TimeSeriesStore, so any monitor that
+ *   records into monitor_series() can be recorded without changes.
+ */
+
+#ifndef TELEMETRY_RECORDER_H
+#define TELEMETRY_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "telemetry_format.h"
+#include "time_series.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct TelemetryRecorderConfig
+ * @brief Batching parameters of a recorder.
+ */
+struct TelemetryRecorderConfig {
+  std::chrono::milliseconds flush_interval    = std::chrono::milliseconds(1000);
+  size_t                    records_per_block = 2048;    /**< 48 KiB data blocks */
+  size_t                    blocks_per_index  = 16;      /**< Data blocks per index block */
+  size_t                    max_pending       = 1 << 20; /**< Records buffered between flushes */
+  bool                      sync              = true;    /**< fdatasync() after every flush */
+};
+
+/**
+ * @class TelemetryRecorder
+ * @brief Writes metric samples to a binary recording from a background thread.
+ */
+class TelemetryRecorder {
+public:
+  /**
+   * @brief Constructs a closed recorder.
+   * @param config Batching configuration.
+   */
+  explicit TelemetryRecorder(const TelemetryRecorderConfig& config = TelemetryRecorderConfig());
+
+  /**
+   * @brief Flushes and closes the recording.
+   */
+  ~TelemetryRecorder();
+
+  TelemetryRecorder(const TelemetryRecorder&)            = delete;
+  TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+  /**
+   * @brief Creates or truncates a recording and starts the writer thread.
+   * @param path File to write.
+   * @return true on success; see last_error() otherwise.
+   */
+  bool open(const std::string& path);
+
+  /**
+   * @brief Writes everything still buffered, an index for it and closes the file.
+   */
+  void close();
+
+  /**
+   * @brief Returns the id of a metric, registering it on first use.
+   * @param name Metric name, e.g. "cpu/cpu_temperature".
+   * @param unit Unit of the values.
+   */
+  uint32_t add_metric(const std::string& name, const std::string& unit);
+
+  /**
+   * @brief Queues one sample; safe to call from any thread.
+   * @param metric Id from add_metric().
+   * @param at Time the sample was taken.
+   * @param value Sample value.
+   */
+  void record(uint32_t metric, std::chrono::steady_clock::time_point at, double value);
+
+  /**
+   * @brief Returns a sink that records a store's series as "prefix/name".
+   *
+   * @note The recorder must outlive the sink.
+   */
+  std::shared_ptr<TimeSeriesSink> sink(const std::string& prefix);
+
+  bool is_open() const {
+    return fd_ >= 0;
+  }
+
+  uint64_t records_written() const {
+    return records_written_.load();
+  }
+
+  uint64_t records_dropped() const {
+    return records_dropped_.load();
+  }
+
+  uint64_t bytes_written() const {
+    return bytes_written_.load();
+  }
+
+  /**
+   * @brief Returns the first error seen, or an empty string.
+   */
+  std::string last_error() const;
+
+private:
+  /**
+   * @brief Writer loop run by the background thread.
+   */
+  void write_loop();
+
+  /**
+   * @brief Encodes and writes one batch; called by the writer thread only.
+   * @param schema Metric definitions to write first.
+   * @param records Samples to write.
+   * @param final Also index the data blocks not indexed yet.
+   */
+  void flush(const std::vector<TelemetryMetric>& schema,
+             const std::vector<TelemetryRecord>& records, bool final);
+
+  /**
+   * @brief Appends a block header and payload to the output buffer.
+   */
+  void append_block(std::vector<uint8_t>& out, TelemetryBlockType type, const void* payload,
+                    size_t size);
+
+  /**
+   * @brief Writes a whole buffer, retrying short writes.
+   */
+  bool write_all(const std::vector<uint8_t>& buffer);
+
+  TelemetryRecorderConfig  config_;
+  int                      fd_ = -1;
+  std::thread              thread_;
+  std::chrono::nanoseconds wall_offset_{0}; /**< system_clock minus steady_clock */
+
+  mutable std::mutex                     mutex_;
+  std::condition_variable                wake_;
+  bool                                   recording_ = false;
+  bool                                   stopping_  = false;
+  std::map<std::string, TelemetryMetric> metric_ids_;
+  std::vector<TelemetryMetric>           pending_schema_; /**< Not written yet */
+  std::vector<TelemetryRecord>           pending_;
+  std::string                            error_;
+
+  // Writer thread state
+  uint64_t                         offset_   = 0; /**< File size after the last flush */
+  uint64_t                         sequence_ = 0;
+  bool                             failed_   = false;
+  std::vector<TelemetryIndexEntry> unindexed_; /**< Data blocks after the last index block */
+
+  std::atomic<uint64_t> records_written_{0};
+  std::atomic<uint64_t> records_dropped_{0};
+  std::atomic<uint64_t> bytes_written_{0};
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // TELEMETRY_RECORDER_H
@@ -0,0 +1,204 @@
+/**
+ * @file test_watchdog.h
+ * @brief Runs tests under a deadline and stops them on timeout or interrupt.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines TestWatchdog, which runs each test on a worker
+ * thread while the calling thread enforces its deadline.
+ *
+ * @details
+ * - When the deadline passes, the tester's CancellationToken is cancelled
+ *   and the test gets a grace period to return its partial results, which
+ *   are reported as TIMEOUT.
+ * - A test still running after the grace period, e.g. blocked in an ioctl
+ *   or getaddrinfo, is abandoned: its thread is detached and keeps its
+ *   tester alive, and a TIMEOUT report is returned without it so the run
+ *   can move on.
+ * - An abandoned thread outlives everything but its tester: it may still
+ *   be logging or writing to a telemetry sink when the caller is done.
+ *   If abandoned() is not zero at the end of the program, write the
+ *   output and leave with std::quick_exit() rather than returning from
+ *   main(), whose destructors would tear those down under it.
+ * - interrupt() only sets an atomic flag and may be called from a signal
+ *   handler; the running test is then cancelled the same way, reported as
+ *   SKIPPED, and later run() calls return SKIPPED without starting.
+ */
+
+#ifndef TEST_WATCHDOG_H
+#define TEST_WATCHDOG_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "peripheral_tester.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct TestWatchdogConfig
+ * @brief Limits applied to every test run.
+ */
+struct TestWatchdogConfig {
+  std::chrono::milliseconds timeout = std::chrono::milliseconds(0);    /**< 0 = no deadline */
+  std::chrono::milliseconds grace   = std::chrono::milliseconds(2000); /**< Wait after cancel */
+};
+
+/**
+ * @class TestWatchdog
+ * @brief Runs tests on a worker thread and reports TIMEOUT when they overrun.
+ */
+class TestWatchdog {
+public:
+  using Test = std::function<TestReport(PeripheralTester&)>;
+
+  explicit TestWatchdog(const TestWatchdogConfig& config = TestWatchdogConfig())
+      : config_(config) {}
+
+  /**
+   * @brief Runs one test with the configured deadline.
+   * @param tester Tester to run; shared so an abandoned test keeps it alive.
+   * @param test Calls the test method, e.g. short_test().
+   * @param timeout Deadline for this run; negative uses the configured one.
+   * @return The test's report, or a TIMEOUT/SKIPPED report if it was stopped.
+   */
+  TestReport run(std::shared_ptr<PeripheralTester> tester, Test test,
+                 std::chrono::milliseconds timeout = std::chrono::milliseconds(-1)) {
+    if (timeout.count() < 0) {
+      timeout = config_.timeout;
+    }
+    if (interrupted()) {
+      return stopped_report(*tester, TestResult::SKIPPED, "Interrupted before start",
+                            std::chrono::milliseconds(0));
+    }
+
+    auto state = std::make_shared<RunState>();
+    tester->cancellation().reset();
+    std::thread worker([tester, test, state]() {
+      TestReport report;
+      try {
+        report = test(*tester);
+      } catch (const std::exception& e) {
+        report = stopped_report(*tester, TestResult::FAILURE,
+                                std::string("Test threw: ") + e.what(),
+                                std::chrono::milliseconds(0));
+      }
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->report = std::move(report);
+      state->done   = true;
+      state->finished.notify_all();
+    });
+
+    // Signal handlers cannot notify a condition variable, so interrupts are polled
+    const auto start    = std::chrono::steady_clock::now();
+    const auto deadline = start + timeout;
+    TestResult stopped  = TestResult::SUCCESS;
+    {
+      std::unique_lock<std::mutex> lock(state->mutex);
+      while (!state->done) {
+        auto now = std::chrono::steady_clock::now();
+        if (interrupted()) {
+          stopped = TestResult::SKIPPED;
+          break;
+        }
+        if (timeout.count() > 0 && now >= deadline) {
+          stopped = TestResult::TIMEOUT;
+          break;
+        }
+        auto wake = now + POLL_INTERVAL;
+        if (timeout.count() > 0) {
+          wake = std::min(wake, deadline);
+        }
+        state->finished.wait_until(lock, wake);
+      }
+    }
+    if (stopped == TestResult::SUCCESS) {
+      worker.join();
+      return std::move(state->report);
+    }
+
+    tester->cancellation().cancel();
+    bool returned = false;
+    {
+      std::unique_lock<std::mutex> lock(state->mutex);
+      returned = state->finished.wait_for(lock, config_.grace, [&state]() { return state->done; });
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::string reason =
+        stopped == TestResult::TIMEOUT
+            ? "Timed out after " + std::to_string(timeout.count()) + " ms"
+            : std::string("Interrupted");
+    if (!returned) {
+      worker.detach();
+      abandoned_++;
+      return stopped_report(*tester, stopped,
+                            reason + "; the test did not stop and was abandoned", elapsed);
+    }
+
+    worker.join();
+    TestReport report = std::move(state->report);
+    report.result     = stopped;
+    report.details    = reason + "; partial results:\n" + report.details;
+    return report;
+  }
+
+  /**
+   * @brief Stops the running test and skips later ones; async-signal-safe.
+   */
+  void interrupt() {
+    interrupted_.store(true, std::memory_order_relaxed);
+  }
+
+  bool interrupted() const {
+    return interrupted_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the number of tests left running after their grace period.
+   */
+  size_t abandoned() const {
+    return abandoned_.load();
+  }
+
+private:
+  static constexpr std::chrono::milliseconds POLL_INTERVAL{100};
+
+  struct RunState {
+    std::mutex              mutex;
+    std::condition_variable finished;
+    bool                    done = false;
+    TestReport              report;
+  };
+
+  static TestReport stopped_report(const PeripheralTester& tester, TestResult result,
+                                   const std::string& details,
+                                   std::chrono::milliseconds duration) {
+    TestReport report;
+    report.result          = result;
+    report.peripheral_name = tester.get_peripheral_name();
+    report.duration        = duration;
+    report.details         = details;
+    report.timestamp       = std::chrono::system_clock::now();
+    return report;
+  }
+
+  TestWatchdogConfig  config_;
+  std::atomic<bool>   interrupted_{false};
+  std::atomic<size_t> abandoned_{0};
+};
+
+static_assert(std::atomic<bool>::is_always_lock_free,
+              "TestWatchdog::interrupt() must be usable from a signal handler");
+
+}  // namespace imx93_peripheral_test
+
+#endif  // TEST_WATCHDOG_H
@@ -0,0 +1,431 @@
+/**
+ * @file time_series.h
+ * @brief Fixed-capacity, downsampling time-series store for monitor data.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * This header defines TimeSeries, one metric kept in a stack of fixed-size
+ * ring buffers at increasingly coarse resolution, and TimeSeriesStore, the
+ * set of metrics a monitor records.
+ *
+ * @details
+ * - Tier 0 holds raw samples; every bucket of tier k summarises factor^k
+ *   samples as start/end time, min, max, mean and sample count, so peaks
+ *   survive downsampling.
+ * - Each tier is a struct-of-arrays ring of the same capacity; memory is
+ *   fixed at construction no matter how long a monitor runs.
+ * - The bucket of every tier that is still filling is kept open and
+ *   included in reads, so the newest samples always show up.
+ * - downsampled() returns the finest tier that still covers the whole run
+ *   within a point budget, which is what reports print.
+ * - A TimeSeriesSink attached to a store sees every raw sample, so a
+ *   recorder can keep full resolution on disk while memory stays bounded.
+ */
+
+#ifndef TIME_SERIES_H
+#define TIME_SERIES_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace imx93_peripheral_test {
+
+/**
+ * @struct TimeSeriesBucket
+ * @brief Summary of consecutive samples of one metric.
+ */
+struct TimeSeriesBucket {
+  double   start_s = 0.0; /**< Time of the first sample, from the store's origin */
+  double   end_s   = 0.0; /**< Time of the last sample */
+  double   min     = 0.0;
+  double   max     = 0.0;
+  double   mean    = 0.0;
+  uint64_t samples = 0;
+};
+
+/**
+ * @class TimeSeries
+ * @brief One metric in fixed memory with min/max/mean downsampling tiers.
+ */
+class TimeSeries {
+public:
+  /**
+   * @brief Constructs an empty series.
+   * @param name Metric name, e.g. "cpu_temperature".
+   * @param unit Unit of the values, e.g. "C".
+   * @param capacity Buckets kept per tier.
+   * @param factor Buckets of one tier merged into a bucket of the next.
+   * @param tiers Number of tiers, including the raw one.
+   */
+  TimeSeries(const std::string& name, const std::string& unit, size_t capacity = 256,
+             size_t factor = 8, size_t tiers = 6)
+      : name_(name),
+        unit_(unit),
+        capacity_(std::max<size_t>(capacity, 1)),
+        factor_(std::max<size_t>(factor, 2)),
+        tiers_(std::max<size_t>(tiers, 1)) {
+    uint64_t span = 1;
+    for (auto& tier : tiers_) {
+      tier.span = span;
+      tier.start_s.resize(capacity_);
+      tier.end_s.resize(capacity_);
+      tier.min.resize(capacity_);
+      tier.max.resize(capacity_);
+      tier.sum.resize(capacity_);
+      tier.samples.resize(capacity_);
+      span *= factor_;
+    }
+  }
+
+  /**
+   * @brief Adds one sample.
+   * @param time_s Sample time in seconds; must not decrease.
+   * @param value Sample value.
+   */
+  void add(double time_s, double value) {
+    total_.merge(time_s, value);
+    for (auto& tier : tiers_) {
+      tier.open.merge(time_s, value);
+      if (tier.open.samples == tier.span) {
+        tier.push(tier.open, capacity_);
+        tier.open = Accumulator();
+      }
+    }
+  }
+
+  const std::string& name() const {
+    return name_;
+  }
+
+  const std::string& unit() const {
+    return unit_;
+  }
+
+  /**
+   * @brief Returns all samples ever added as one bucket.
+   */
+  TimeSeriesBucket summary() const {
+    return total_.bucket();
+  }
+
+  size_t tier_count() const {
+    return tiers_.size();
+  }
+
+  /**
+   * @brief Returns the buckets of a tier, oldest first, including the open one.
+   * @param level Tier index; 0 is raw samples.
+   */
+  std::vector<TimeSeriesBucket> tier(size_t level) const {
+    std::vector<TimeSeriesBucket> buckets;
+    if (level >= tiers_.size()) {
+      return buckets;
+    }
+    const Tier& tier  = tiers_[level];
+    size_t      first = (tier.head + capacity_ - tier.size) % capacity_;
+    for (size_t i = 0; i < tier.size; ++i) {
+      buckets.push_back(tier.bucket((first + i) % capacity_));
+    }
+    if (tier.open.samples > 0) {
+      buckets.push_back(tier.open.bucket());
+    }
+    return buckets;
+  }
+
+  /**
+   * @brief Returns the finest tier that covers every sample in at most max_points buckets.
+   *
+   * Falls back to the coarsest tier, which then only covers the most recent
+   * capacity x factor^(tiers-1) samples.
+   */
+  std::vector<TimeSeriesBucket> downsampled(size_t max_points) const {
+    for (size_t level = 0; level + 1 < tiers_.size(); ++level) {
+      const Tier& tier = tiers_[level];
+      if (!tier.wrapped && tier.size + (tier.open.samples > 0 ? 1 : 0) <= max_points) {
+        return this->tier(level);
+      }
+    }
+    return tier(tiers_.size() - 1);
+  }
+
+  /**
+   * @brief Returns the newest raw sample as a one-sample bucket, or an empty bucket.
+   */
+  TimeSeriesBucket latest() const {
+    const Tier& raw = tiers_[0];
+    if (raw.size == 0) {
+      return raw.open.bucket();
+    }
+    return raw.bucket((raw.head + capacity_ - 1) % capacity_);
+  }
+
+  /**
+   * @brief Returns the buckets overlapping a time range from the finest tier that covers it.
+   * @param from_s Start of the range, in seconds from the store's origin.
+   * @param to_s End of the range.
+   * @param max_points Bucket budget.
+   *
+   * A tier covers the range if it has not overwritten any bucket yet or
+   * still reaches back to from_s; falls back to the coarsest tier.
+   */
+  std::vector<TimeSeriesBucket> range(double from_s, double to_s, size_t max_points) const {
+    std::vector<TimeSeriesBucket> selected;
+    for (size_t level = 0; level < tiers_.size(); ++level) {
+      std::vector<TimeSeriesBucket> buckets = tier(level);
+      selected.clear();
+      for (const auto& bucket : buckets) {
+        if (bucket.end_s >= from_s && bucket.start_s <= to_s) {
+          selected.push_back(bucket);
+        }
+      }
+      bool covers = !tiers_[level].wrapped || (!buckets.empty() && buckets[0].start_s <= from_s);
+      if (covers && selected.size() <= max_points) {
+        break;
+      }
+    }
+    return selected;
+  }
+
+private:
+  struct Accumulator {
+    double   start_s = 0.0;
+    double   end_s   = 0.0;
+    double   min     = 0.0;
+    double   max     = 0.0;
+    double   sum     = 0.0;
+    uint64_t samples = 0;
+
+    void merge(double time_s, double value) {
+      if (samples == 0) {
+        start_s = time_s;
+        min     = value;
+        max     = value;
+      }
+      end_s = time_s;
+      min   = std::min(min, value);
+      max   = std::max(max, value);
+      sum += value;
+      ++samples;
+    }
+
+    TimeSeriesBucket bucket() const {
+      TimeSeriesBucket bucket;
+      bucket.start_s = start_s;
+      bucket.end_s   = end_s;
+      bucket.min     = min;
+      bucket.max     = max;
+      bucket.mean    = samples > 0 ? sum / samples : 0.0;
+      bucket.samples = samples;
+      return bucket;
+    }
+  };
+
+  /**
+   * @brief Ring of closed buckets, one array per field.
+   */
+  struct Tier {
+    uint64_t              span = 1; /**< Samples per bucket */
+    std::vector<double>   start_s;
+    std::vector<double>   end_s;
+    std::vector<double>   min;
+    std::vector<double>   max;
+    std::vector<double>   sum;
+    std::vector<uint64_t> samples;
+    size_t                head    = 0; /**< Next slot to write */
+    size_t                size    = 0;
+    bool                  wrapped = false; /**< Oldest buckets have been overwritten */
+    Accumulator           open;
+
+    TimeSeriesBucket bucket(size_t slot) const {
+      TimeSeriesBucket bucket;
+      bucket.start_s = start_s[slot];
+      bucket.end_s   = end_s[slot];
+      bucket.min     = min[slot];
+      bucket.max     = max[slot];
+      bucket.samples = samples[slot];
+      bucket.mean    = sum[slot] / bucket.samples;
+      return bucket;
+    }
+
+    void push(const Accumulator& bucket, size_t capacity) {
+      start_s[head] = bucket.start_s;
+      end_s[head]   = bucket.end_s;
+      min[head]     = bucket.min;
+      max[head]     = bucket.max;
+      sum[head]     = bucket.sum;
+      samples[head] = bucket.samples;
+      head          = (head + 1) % capacity;
+      wrapped       = wrapped || size == capacity;
+      size          = std::min(size + 1, capacity);
+    }
+  };
+
+  std::string       name_;
+  std::string       unit_;
+  size_t            capacity_;
+  size_t            factor_;
+  std::vector<Tier> tiers_;
+  Accumulator       total_;
+};
+
+/**
+ * @class TimeSeriesSink
+ * @brief Receives every sample added to a TimeSeriesStore, e.g. to record it to disk.
+ *
+ * @note Called on the thread that adds the sample.
+ */
+class TimeSeriesSink {
+public:
+  virtual ~TimeSeriesSink() = default;
+
+  /**
+   * @brief Announces a series; indices are reused after TimeSeriesStore::clear().
+   */
+  virtual void series_added(size_t series, const std::string& name, const std::string& unit) = 0;
+
+  /**
+   * @brief Receives one raw sample of a previously announced series.
+   */
+  virtual void sample_added(size_t series, std::chrono::steady_clock::time_point at,
+                            double value) = 0;
+};
+
+/**
+ * @class TimeSeriesStore
+ * @brief The metrics recorded by one monitor run, timed from a common origin.
+ *
+ * @note Not thread-safe; a monitor records from one thread. Copies share
+ * the sink.
+ */
+class TimeSeriesStore {
+public:
+  /**
+   * @brief Constructs an empty store; the arguments apply to every series.
+   */
+  explicit TimeSeriesStore(size_t capacity = 256, size_t factor = 8, size_t tiers = 6)
+      : capacity_(capacity),
+        factor_(factor),
+        tiers_(tiers),
+        origin_(std::chrono::steady_clock::now()) {}
+
+  /**
+   * @brief Returns the index of a series, creating it on first use.
+   * @param name Metric name.
+   * @param unit Unit of the values.
+   */
+  size_t add_series(const std::string& name, const std::string& unit) {
+    for (size_t i = 0; i < series_.size(); ++i) {
+      if (series_[i].name() == name) {
+        return i;
+      }
+    }
+    series_.emplace_back(name, unit, capacity_, factor_, tiers_);
+    if (sink_) {
+      sink_->series_added(series_.size() - 1, name, unit);
+    }
+    return series_.size() - 1;
+  }
+
+  /**
+   * @brief Forwards every following sample to a sink; existing series are announced now.
+   * @param sink Sink to use, or nullptr to detach. It is kept across clear().
+   */
+  void set_sink(std::shared_ptr<TimeSeriesSink> sink) {
+    sink_ = sink;
+    for (size_t i = 0; sink_ && i < series_.size(); ++i) {
+      sink_->series_added(i, series_[i].name(), series_[i].unit());
+    }
+  }
+
+  const std::shared_ptr<TimeSeriesSink>& sink() const {
+    return sink_;
+  }
+
+  /**
+   * @brief Adds a sample taken now.
+   */
+  void add(size_t series, double value) {
+    add(series, value, std::chrono::steady_clock::now());
+  }
+
+  /**
+   * @brief Adds a sample taken at the given time.
+   */
+  void add(size_t series, double value, std::chrono::steady_clock::time_point at) {
+    append(series, value, std::chrono::duration<double>(at - origin_).count(), at);
+  }
+
+  /**
+   * @brief Adds a sample taken time_s seconds after the origin.
+   */
+  void add(size_t series, double value, double time_s) {
+    append(series, value, time_s,
+           origin_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(time_s)));
+  }
+
+  /**
+   * @brief Drops every series and restarts the clock.
+   */
+  void clear() {
+    series_.clear();
+    origin_ = std::chrono::steady_clock::now();
+  }
+
+  bool empty() const {
+    return series_.empty();
+  }
+
+  const std::vector<TimeSeries>& series() const {
+    return series_;
+  }
+
+  /**
+   * @brief Renders every series as a summary line plus its downsampled buckets.
+   * @param max_points Bucket budget per series.
+   */
+  std::string format(size_t max_points = 32) const {
+    std::ostringstream out;
+    for (const auto& series : series_) {
+      TimeSeriesBucket all = series.summary();
+      if (all.samples == 0) {
+        continue;
+      }
+      out << "Series " << series.name() << " [" << series.unit() << "]: " << all.samples
+          << " samples, min " << all.min << ", mean " << all.mean << ", max " << all.max
+          << " (buckets: min/mean/max)\n";
+      for (const auto& bucket : series.downsampled(max_points)) {
+        out << "  " << bucket.start_s << "-" << bucket.end_s << " s: " << bucket.min << "/"
+            << bucket.mean << "/" << bucket.max << "\n";
+      }
+    }
+    return out.str();
+  }
+
+private:
+  void append(size_t series, double value, double time_s,
+              std::chrono::steady_clock::time_point at) {
+    if (series < series_.size()) {
+      series_[series].add(time_s, value);
+      if (sink_) {
+        sink_->sample_added(series, at, value);
+      }
+    }
+  }
+
+  size_t                                capacity_;
+  size_t                                factor_;
+  size_t                                tiers_;
+  std::chrono::steady_clock::time_point origin_;
+  std::vector<TimeSeries>               series_;
+  std::shared_ptr<TimeSeriesSink>       sink_;
+};
+
+}  // namespace imx93_peripheral_test
+
+#endif  // TIME_SERIES_H
@@ -124,7 +124,17 @@ public:
    */
   bool is_available() const override;
 
+  /**
+   * @brief Returns true if the USB bus exists, without constructing a tester.
+   */
+  static bool probe();
+
 private:
+  /**
+   * @brief Enumerates the USB controllers and devices if probe() succeeds.
+   */
+  void discover() override;
+
   /**
    * @brief Retrieves USB controller information.
    * @return Vector of USBControllerInfo structures.
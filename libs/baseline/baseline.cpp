@@ -0,0 +1,382 @@
+/**
+ * @file baseline.cpp
+ * @brief Implementation of baseline capture, storage and regression comparison.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "baseline.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr const char* FILE_HEADER = "# nxp-imx93-hw-vv-tool baseline 1";
+
+bool ends_with(const std::string& text, const std::string& suffix) {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+double median_of_sorted(const std::vector<double>& sorted) {
+  size_t middle = sorted.size() / 2;
+  return sorted.size() % 2 == 1 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2.0;
+}
+
+/**
+ * @brief Returns j such that [x_(j), x_(n-j+1)] is a >= 95% interval of the median.
+ *
+ * The number of samples below the median is Binomial(n, 1/2); j is the
+ * largest rank whose lower tail stays within 2.5%, clamped to 1.
+ */
+size_t median_rank(size_t n) {
+  double log_half = std::log(0.5) * static_cast<double>(n);
+  double tail     = 0.0;
+  size_t j        = 0;
+  for (size_t k = 0; k < n; ++k) {
+    double log_choose = std::lgamma(static_cast<double>(n) + 1) -
+                        std::lgamma(static_cast<double>(k) + 1) -
+                        std::lgamma(static_cast<double>(n - k) + 1);
+    tail += std::exp(log_choose + log_half);
+    if (tail > 0.025) {
+      break;
+    }
+    j = k + 1;
+  }
+  return std::max<size_t>(j, 1);
+}
+
+}  // namespace
+
+MetricGoal metric_goal(const std::string& unit) {
+  if (ends_with(unit, "/s") || ends_with(unit, "bps") || unit == "pps" || unit == "ops/J") {
+    return MetricGoal::HIGHER;
+  }
+  for (const char* lower : {"ns", "us", "ms", "s", "J", "mJ", "W", "mW", "CPU-s/Gbit"}) {
+    if (unit == lower) {
+      return MetricGoal::LOWER;
+    }
+  }
+  return MetricGoal::NONE;
+}
+
+std::string metric_goal_to_string(MetricGoal goal) {
+  switch (goal) {
+    case MetricGoal::HIGHER:
+      return "higher";
+    case MetricGoal::LOWER:
+      return "lower";
+    default:
+      return "none";
+  }
+}
+
+std::string baseline_verdict_to_string(BaselineVerdict verdict) {
+  switch (verdict) {
+    case BaselineVerdict::UNCHANGED:
+      return "UNCHANGED";
+    case BaselineVerdict::IMPROVED:
+      return "IMPROVED";
+    case BaselineVerdict::REGRESSED:
+      return "REGRESSED";
+    case BaselineVerdict::CHANGED:
+      return "CHANGED";
+    case BaselineVerdict::MISSING:
+      return "MISSING";
+    case BaselineVerdict::NEW:
+      return "NEW";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+SampleStats SampleStats::of(std::vector<double> values) {
+  SampleStats stats;
+  stats.samples = values.size();
+  if (values.empty()) {
+    return stats;
+  }
+  std::sort(values.begin(), values.end());
+  stats.median = median_of_sorted(values);
+
+  size_t j      = median_rank(values.size());
+  stats.ci_low  = values[j - 1];
+  stats.ci_high = values[values.size() - j];
+
+  for (double& value : values) {
+    value = std::fabs(value - stats.median);
+  }
+  std::sort(values.begin(), values.end());
+  stats.mad = median_of_sorted(values);
+  return stats;
+}
+
+bool BaselineTolerances::parse(const std::string& spec) {
+  size_t      separator = spec.rfind('=');
+  std::string percent   = separator == std::string::npos ? spec : spec.substr(separator + 1);
+  char*       end       = nullptr;
+  double      value     = std::strtod(percent.c_str(), &end);
+  if (percent.empty() || *end != '\0' || !(value >= 0.0)) {
+    return false;
+  }
+  if (separator == std::string::npos) {
+    default_percent = value;
+  } else {
+    overrides[spec.substr(0, separator)] = value;
+  }
+  return true;
+}
+
+double BaselineTolerances::for_key(const std::string& key) const {
+  double percent = default_percent;
+  size_t longest = 0;
+  for (const auto& pair : overrides) {
+    if (pair.first.size() >= longest && key.compare(0, pair.first.size(), pair.first) == 0) {
+      percent = pair.second;
+      longest = pair.first.size();
+    }
+  }
+  return percent;
+}
+
+BaselineMetric& Baseline::find_or_add(const std::string& peripheral, const std::string& name,
+                                      const std::string& unit) {
+  std::string key = peripheral + "/" + name;
+  auto        it  = index_.find(key);
+  if (it != index_.end()) {
+    return metrics_[it->second];
+  }
+  BaselineMetric metric;
+  metric.peripheral = peripheral;
+  metric.name       = name;
+  metric.unit       = unit;
+  metric.goal       = metric_goal(unit);
+  index_.emplace(key, metrics_.size());
+  metrics_.push_back(std::move(metric));
+  return metrics_.back();
+}
+
+void Baseline::add(const TestReport& report) {
+  if (report.result != TestResult::SUCCESS && report.result != TestResult::FAILURE) {
+    return;
+  }
+  for (const auto& metric : report.metrics) {
+    if (std::isfinite(metric.value)) {
+      find_or_add(report.peripheral_name, metric.name, metric.unit).values.push_back(metric.value);
+    }
+  }
+}
+
+bool Baseline::save(const std::string& path) {
+  std::ofstream file(path);
+  if (!file) {
+    error_ = "Cannot create " + path + ": " + std::strerror(errno);
+    return false;
+  }
+  file << FILE_HEADER << "\n# peripheral\tmetric\tunit\tgoal\tsamples...\n";
+  for (const auto& metric : metrics_) {
+    file << metric.peripheral << '\t' << metric.name << '\t' << metric.unit << '\t'
+         << metric_goal_to_string(metric.goal);
+    for (double value : metric.values) {
+      char digits[32];
+      std::snprintf(digits, sizeof(digits), "%.17g", value);
+      file << '\t' << digits;
+    }
+    file << '\n';
+  }
+  file.flush();
+  if (!file) {
+    error_ = "Failed to write " + path;
+    return false;
+  }
+  return true;
+}
+
+bool Baseline::load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    error_ = "Cannot open " + path + ": " + std::strerror(errno);
+    return false;
+  }
+  std::string line;
+  if (!std::getline(file, line) || line != FILE_HEADER) {
+    error_ = path + " is not a baseline file";
+    return false;
+  }
+
+  metrics_.clear();
+  index_.clear();
+  size_t number = 1;
+  while (std::getline(file, line)) {
+    number++;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::vector<std::string> fields;
+    std::istringstream       stream(line);
+    std::string              field;
+    while (std::getline(stream, field, '\t')) {
+      fields.push_back(field);
+    }
+    if (fields.size() < 4 || fields[0].empty() || fields[1].empty()) {
+      error_ = path + ":" + std::to_string(number) + ": Expected peripheral, metric, unit, goal";
+      return false;
+    }
+
+    BaselineMetric& metric = find_or_add(fields[0], fields[1], fields[2]);
+    if (fields[3] == "higher") {
+      metric.goal = MetricGoal::HIGHER;
+    } else if (fields[3] == "lower") {
+      metric.goal = MetricGoal::LOWER;
+    } else if (fields[3] == "none") {
+      metric.goal = MetricGoal::NONE;
+    } else {
+      error_ = path + ":" + std::to_string(number) + ": Unknown goal " + fields[3];
+      return false;
+    }
+    for (size_t i = 4; i < fields.size(); ++i) {
+      char*  end   = nullptr;
+      double value = std::strtod(fields[i].c_str(), &end);
+      if (fields[i].empty() || *end != '\0' || !std::isfinite(value)) {
+        error_ = path + ":" + std::to_string(number) + ": Invalid sample " + fields[i];
+        return false;
+      }
+      metric.values.push_back(value);
+    }
+  }
+  return true;
+}
+
+std::vector<BaselineComparison> Baseline::compare(const Baseline&           current,
+                                                  const BaselineTolerances& tolerances) const {
+  std::vector<BaselineComparison> comparisons;
+
+  auto compare_one = [&](const BaselineMetric* before, const BaselineMetric* after) {
+    const BaselineMetric& any = before != nullptr ? *before : *after;
+    BaselineComparison    comparison;
+    comparison.key               = any.key();
+    comparison.unit              = any.unit;
+    comparison.goal              = any.goal;
+    comparison.tolerance_percent = tolerances.for_key(comparison.key);
+    if (before != nullptr) {
+      comparison.baseline = SampleStats::of(before->values);
+    }
+    if (after != nullptr) {
+      comparison.current = SampleStats::of(after->values);
+    }
+    if (comparison.baseline.samples == 0 || comparison.current.samples == 0) {
+      bool missing              = comparison.current.samples == 0;
+      comparison.verdict        = missing ? BaselineVerdict::MISSING : BaselineVerdict::NEW;
+      comparison.change_percent = std::nan("");
+      comparisons.push_back(comparison);
+      return;
+    }
+
+    const SampleStats& a     = comparison.baseline;
+    const SampleStats& b     = comparison.current;
+    double             delta = b.median - a.median;
+    comparison.change_percent =
+        a.median != 0.0 ? 100.0 * delta / std::fabs(a.median) : std::nan("");
+
+    // A change counts only if it exceeds the tolerance and the intervals are apart
+    bool beyond = std::isnan(comparison.change_percent)
+                      ? delta != 0.0
+                      : std::fabs(comparison.change_percent) > comparison.tolerance_percent;
+    bool apart  = b.ci_high < a.ci_low || b.ci_low > a.ci_high;
+    if (!beyond || !apart) {
+      comparison.verdict = BaselineVerdict::UNCHANGED;
+    } else if (comparison.goal == MetricGoal::NONE) {
+      comparison.verdict = BaselineVerdict::CHANGED;
+    } else {
+      bool better        = (delta > 0) == (comparison.goal == MetricGoal::HIGHER);
+      comparison.verdict = better ? BaselineVerdict::IMPROVED : BaselineVerdict::REGRESSED;
+    }
+    comparisons.push_back(comparison);
+  };
+
+  for (const auto& metric : metrics_) {
+    auto it = current.index_.find(metric.key());
+    compare_one(&metric, it != current.index_.end() ? &current.metrics_[it->second] : nullptr);
+  }
+  for (const auto& metric : current.metrics_) {
+    if (index_.find(metric.key()) == index_.end()) {
+      compare_one(nullptr, &metric);
+    }
+  }
+  return comparisons;
+}
+
+TestReport Baseline::comparison_report(const std::vector<BaselineComparison>& comparisons) {
+  TestReport         report;
+  std::ostringstream details;
+  size_t             regressed = 0;
+  size_t             improved  = 0;
+  size_t             compared  = 0;
+
+  report.peripheral_name = "Baseline";
+
+  for (const auto& comparison : comparisons) {
+    TestResult result = TestResult::SUCCESS;
+    switch (comparison.verdict) {
+      case BaselineVerdict::REGRESSED:
+        result = TestResult::FAILURE;
+        regressed++;
+        break;
+      case BaselineVerdict::IMPROVED:
+        improved++;
+        break;
+      case BaselineVerdict::MISSING:
+      case BaselineVerdict::NEW:
+        result = TestResult::SKIPPED;
+        break;
+      default:
+        break;
+    }
+    report.checks.push_back({comparison.key, result});
+    if (result == TestResult::SKIPPED) {
+      continue;
+    }
+    compared++;
+
+    TestMetric change;
+    change.name  = comparison.key + "_change";
+    change.unit  = "%";
+    change.value = comparison.change_percent;
+    // A zero baseline has no relative change to hold to the tolerance
+    bool relative = !std::isnan(change.value);
+    if (relative && comparison.goal == MetricGoal::HIGHER) {
+      change.lower = -comparison.tolerance_percent;
+    } else if (relative && comparison.goal == MetricGoal::LOWER) {
+      change.upper = comparison.tolerance_percent;
+    }
+    report.metrics.push_back(change);
+
+    if (comparison.verdict != BaselineVerdict::UNCHANGED) {
+      char line[512];
+      const SampleStats& a = comparison.baseline;
+      const SampleStats& b = comparison.current;
+      std::snprintf(line, sizeof(line),
+                    "; %s %s: median %.4g -> %.4g %s, MAD %.3g -> %.3g (%+.1f%%, tolerance %.1f%%)",
+                    baseline_verdict_to_string(comparison.verdict).c_str(), comparison.key.c_str(),
+                    a.median, b.median, comparison.unit.c_str(), a.mad, b.mad,
+                    comparison.change_percent, comparison.tolerance_percent);
+      details << line;
+    }
+  }
+
+  report.result  = regressed > 0 ? TestResult::FAILURE : TestResult::SUCCESS;
+  report.details = std::to_string(compared) + " metrics compared, " + std::to_string(regressed) +
+                   " regressed, " + std::to_string(improved) + " improved" + details.str();
+  return report;
+}
+
+}  // namespace imx93_peripheral_test
@@ -0,0 +1,392 @@
+/**
+ * @file burnin_tester.cpp
+ * @brief Implementation of the concurrent multi-subsystem burn-in.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "burnin_tester.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+/**
+ * @brief Reads an integer attribute; false if it is missing or unreadable.
+ */
+bool read_value(const fs::path& path, long long& value) {
+  std::ifstream file(path);
+  return static_cast<bool>(file >> value);
+}
+
+/**
+ * @brief Returns the hottest thermal zone in degrees Celsius, NaN if none.
+ */
+double read_max_temperature(const fs::path& root) {
+  double          hottest = NAN;
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator(root / "class/thermal", ec)) {
+    long long millidegrees = 0;
+    if (entry.path().filename().string().rfind("thermal_zone", 0) == 0 &&
+        read_value(entry.path() / "temp", millidegrees)) {
+      double celsius = millidegrees / 1000.0;
+      hottest        = std::isnan(hottest) ? celsius : std::max(hottest, celsius);
+    }
+  }
+  return hottest;
+}
+
+/**
+ * @brief Returns the mean current frequency of all CPUs in MHz, NaN if none.
+ */
+double read_mean_cpu_mhz(const fs::path& root) {
+  double          sum   = 0.0;
+  int             count = 0;
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator(root / "devices/system/cpu", ec)) {
+    long long khz = 0;
+    if (read_value(entry.path() / "cpufreq/scaling_cur_freq", khz)) {
+      sum += khz / 1000.0;
+      ++count;
+    }
+  }
+  return count > 0 ? sum / count : NAN;
+}
+
+bool is_drop_counter(const std::string& name) {
+  return name.size() >= 8 && name.compare(name.size() - 8, 8, "_dropped") == 0;
+}
+
+}  // namespace
+
+BurnInTester::BurnInTester(const BurnInConfig& config) : config_(config) {}
+
+void BurnInTester::add_load(const std::string& name, std::unique_ptr<PeripheralTester> tester,
+                            uint32_t intensity) {
+  Load load;
+  load.name      = name;
+  load.tester    = std::move(tester);
+  load.intensity = intensity;
+  load.tester->prepare();
+  loads_.push_back(std::move(load));
+}
+
+bool BurnInTester::is_available() const {
+  return !loads_.empty();
+}
+
+TestReport BurnInTester::short_test() {
+  return monitor_test(std::chrono::seconds(10));
+}
+
+TestReport BurnInTester::monitor_test(std::chrono::seconds duration) {
+  auto start_time = std::chrono::steady_clock::now();
+
+  run(duration);
+
+  std::stringstream details;
+  details << std::fixed << std::setprecision(1);
+  details << "Burn-in: " << loads_.size() << " loads for " << result_.elapsed_s << " s, "
+          << result_.samples << " samples\n";
+  for (const auto& load : result_.loads) {
+    details << load.name << " (intensity " << load.intensity
+            << "): " << test_result_to_string(load.result) << ", " << load.operations
+            << " ops, " << load.errors << " errors";
+    add_check(load.name, load.result);
+    add_metric(load.name + "_errors", static_cast<double>(load.errors), "", NO_LIMIT, 0.0);
+    if (load.result != TestResult::NOT_SUPPORTED) {
+      details << ", " << load.average_rate << " " << load.unit << " (first quarter "
+              << load.first_rate << ", last quarter " << load.last_rate << ", degradation "
+              << load.degradation_pct << "%)";
+      add_metric(load.name + "_rate", load.average_rate, load.unit);
+      add_metric(load.name + "_degradation", load.degradation_pct, "%");
+    }
+    details << "\n";
+  }
+  if (!std::isnan(result_.max_temperature_c)) {
+    details << "Max temperature: " << result_.max_temperature_c << " C\n";
+    add_metric("max_temperature", result_.max_temperature_c, "C");
+  }
+  if (!std::isnan(result_.min_cpu_mhz)) {
+    details << "CPU frequency: " << result_.min_cpu_mhz << "-" << result_.max_cpu_mhz
+            << " MHz\n";
+  }
+  if (!result_.power_rail.empty()) {
+    details << std::setprecision(3) << "Power (" << result_.power_rail
+            << "): " << result_.average_power_w << " W average, " << result_.energy_j << " J\n"
+            << std::setprecision(1);
+    add_metric("power_avg", result_.average_power_w, "W");
+    add_metric("energy", result_.energy_j, "J");
+  }
+  for (const auto& counter : result_.counter_deltas) {
+    details << "Counter " << counter.first << ": +" << counter.second << "\n";
+    add_metric(counter.first, static_cast<double>(counter.second), "");
+  }
+  if (!result_.error_message.empty()) {
+    details << "Error: " << result_.error_message << "\n";
+  }
+
+  auto end_time      = std::chrono::steady_clock::now();
+  auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+  TestResult outcome = result_.success     ? TestResult::SUCCESS
+                       : result_.supported ? TestResult::FAILURE
+                                           : TestResult::NOT_SUPPORTED;
+  return create_monitor_report(outcome, details.str(), test_duration);
+}
+
+void BurnInTester::run(std::chrono::milliseconds duration) {
+  result_ = BurnInResult();
+  if (loads_.empty()) {
+    result_.error_message = "No loads configured";
+    return;
+  }
+  fs::path root(config_.sysfs_root);
+
+  PowerSamplerConfig power_config = config_.power;
+  power_config.sysfs_root         = config_.sysfs_root;
+  PowerSampler sampler(power_config);
+  bool         metered = sampler.discover() && !sampler.rails().empty() && sampler.start();
+  size_t       rail    = 0;
+
+  std::map<std::string, uint64_t> counters_before = read_error_counters();
+
+  // StressCounters holds atomics and cannot live in a resizable vector directly
+  std::vector<std::unique_ptr<StressCounters>> counters;
+  std::vector<TestResult>                      outcomes(loads_.size(), TestResult::FAILURE);
+  std::vector<std::thread>                     workers;
+  std::atomic<bool>                            stop(false);
+  for (size_t i = 0; i < loads_.size(); ++i) {
+    counters.push_back(std::make_unique<StressCounters>());
+  }
+
+  const auto start    = std::chrono::steady_clock::now();
+  const auto deadline = start + duration;
+  const auto interval = std::max(config_.sample_interval, std::chrono::milliseconds(1));
+
+  monitor_series_.clear();
+  std::vector<size_t> rate_series;
+  for (const auto& load : loads_) {
+    rate_series.push_back(monitor_series_.add_series(load.name, "ops/s"));
+  }
+  size_t temperature_series = monitor_series_.add_series("max_temperature", "C");
+  size_t frequency_series   = monitor_series_.add_series("cpu_frequency", "MHz");
+  size_t power_series       = 0;
+
+  std::vector<uint64_t> last_operations(loads_.size(), 0);
+  std::vector<uint64_t> last_bytes(loads_.size(), 0);
+  auto                  last_sample = start;
+  auto take_sample = [&](std::chrono::steady_clock::time_point now) {
+    double seconds = std::chrono::duration<double>(now - last_sample).count();
+    for (size_t i = 0; seconds > 0.0 && i < loads_.size(); ++i) {
+      uint64_t operations = counters[i]->operations.load();
+      uint64_t bytes      = counters[i]->bytes.load();
+      monitor_series_.add(rate_series[i], (operations - last_operations[i]) / seconds, now);
+      if (bytes > 0) {
+        // Created once the load turns out to move data
+        size_t throughput = monitor_series_.add_series(loads_[i].name + "_throughput", "MB/s");
+        monitor_series_.add(throughput, (bytes - last_bytes[i]) / 1e6 / seconds, now);
+      }
+      last_operations[i] = operations;
+      last_bytes[i]      = bytes;
+    }
+    last_sample = now;
+
+    double temperature = read_max_temperature(root);
+    double frequency   = read_mean_cpu_mhz(root);
+    if (!std::isnan(temperature)) {
+      monitor_series_.add(temperature_series, temperature, now);
+    }
+    if (!std::isnan(frequency)) {
+      monitor_series_.add(frequency_series, frequency, now);
+    }
+    if (metered) {
+      std::vector<RailStats> stats = sampler.rail_stats();
+      if (rail < stats.size()) {
+        monitor_series_.add(power_series, stats[rail].last_w, now);
+      }
+    }
+    result_.samples++;
+  };
+
+  for (size_t i = 0; i < loads_.size(); ++i) {
+    workers.emplace_back([this, i, &stop, &counters, &outcomes]() {
+      try {
+        outcomes[i] = loads_[i].tester->stress(loads_[i].intensity, stop, *counters[i]);
+      } catch (const std::exception&) {
+        outcomes[i] = TestResult::FAILURE;
+      }
+    });
+  }
+
+  for (auto next = start + interval;; next += interval) {
+    auto target    = std::min(next, deadline);
+    bool cancelled = cancellation_.wait_until(target);
+    if (cancelled) {
+      target = std::chrono::steady_clock::now();
+    }
+    if (metered && result_.samples == 0) {
+      // Pick the rail once the loads are drawing power
+      std::vector<RailStats> stats = sampler.rail_stats();
+      rail                         = stats.size();
+      for (size_t r = 0; r < stats.size(); ++r) {
+        if (config_.power_rail.empty()
+                ? (rail == stats.size() || stats[r].average_w > stats[rail].average_w)
+                : stats[r].name == config_.power_rail) {
+          rail = r;
+        }
+      }
+      if (rail == stats.size()) {
+        result_.error_message = "Rail not found: " + config_.power_rail;
+        metered               = false;
+      } else {
+        power_series = monitor_series_.add_series(stats[rail].name, "W");
+      }
+    }
+    take_sample(target);
+    if (cancelled || target == deadline) {
+      break;
+    }
+  }
+
+  stop = true;
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  result_.elapsed_s =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if (metered) {
+    sampler.stop();
+    std::vector<RailStats> stats = sampler.rail_stats();
+    if (rail < stats.size()) {
+      result_.power_rail      = stats[rail].name;
+      result_.energy_j        = stats[rail].energy_j;
+      result_.average_power_w = stats[rail].average_w;
+    }
+  }
+
+  const std::vector<TimeSeries>& series = monitor_series_.series();
+  TimeSeriesBucket               temperatures = series[temperature_series].summary();
+  TimeSeriesBucket               frequencies  = series[frequency_series].summary();
+  if (temperatures.samples > 0) {
+    result_.max_temperature_c = temperatures.max;
+  }
+  if (frequencies.samples > 0) {
+    result_.min_cpu_mhz = frequencies.min;
+    result_.max_cpu_mhz = frequencies.max;
+  }
+
+  bool loads_ok = true;
+  for (size_t i = 0; i < loads_.size(); ++i) {
+    BurnInLoadResult summary;
+    summary.name       = loads_[i].name;
+    summary.intensity  = loads_[i].intensity;
+    summary.result     = outcomes[i];
+    summary.operations = counters[i]->operations.load();
+    summary.bytes      = counters[i]->bytes.load();
+    summary.errors     = counters[i]->errors.load();
+    summary.unit       = summary.bytes > 0 ? "MB/s" : "ops/s";
+    const TimeSeries* rate = &series[rate_series[i]];
+    for (const auto& candidate : series) {
+      if (summary.bytes > 0 && candidate.name() == summary.name + "_throughput") {
+        rate = &candidate;
+      }
+    }
+    summarize_rates(*rate, summary);
+    result_.loads.push_back(summary);
+
+    if (summary.result == TestResult::NOT_SUPPORTED) {
+      continue;
+    }
+    result_.supported = true;
+    if (summary.result != TestResult::SUCCESS || summary.errors > 0) {
+      loads_ok = false;
+      if (result_.error_message.empty()) {
+        result_.error_message = "Load " + summary.name + " failed";
+      }
+    }
+  }
+
+  bool counters_ok = true;
+  for (const auto& counter : read_error_counters()) {
+    auto     before = counters_before.find(counter.first);
+    uint64_t base   = before != counters_before.end() ? before->second : 0;
+    if (counter.second > base) {
+      result_.counter_deltas[counter.first] = counter.second - base;
+      counters_ok                           = counters_ok && is_drop_counter(counter.first);
+    }
+  }
+  if (!counters_ok && result_.error_message.empty()) {
+    result_.error_message = "Hardware error counters increased";
+  }
+
+  result_.success = result_.supported && loads_ok && counters_ok && result_.error_message.empty();
+}
+
+void BurnInTester::summarize_rates(const TimeSeries& rate, BurnInLoadResult& summary) {
+  TimeSeriesBucket all = rate.summary();
+  if (all.samples == 0) {
+    return;
+  }
+  summary.average_rate = all.mean;
+
+  // Buckets are assigned to a quarter by their midpoint; tiers keep them short
+  double                        span = all.end_s - all.start_s;
+  double                        first_sum = 0.0, last_sum = 0.0;
+  uint64_t                      first_count = 0, last_count = 0;
+  std::vector<TimeSeriesBucket> buckets = rate.downsampled(256);
+  for (const auto& bucket : buckets) {
+    double middle = (bucket.start_s + bucket.end_s) / 2.0;
+    if (middle <= all.start_s + span / 4.0) {
+      first_sum += bucket.mean * bucket.samples;
+      first_count += bucket.samples;
+    }
+    if (middle >= all.end_s - span / 4.0) {
+      last_sum += bucket.mean * bucket.samples;
+      last_count += bucket.samples;
+    }
+  }
+  summary.first_rate      = first_count > 0 ? first_sum / first_count : 0.0;
+  summary.last_rate       = last_count > 0 ? last_sum / last_count : 0.0;
+  summary.degradation_pct = summary.first_rate > 0.0
+                                ? std::max(0.0, (summary.first_rate - summary.last_rate) /
+                                                    summary.first_rate * 100.0)
+                                : 0.0;
+}
+
+std::map<std::string, uint64_t> BurnInTester::read_error_counters() const {
+  static const char* const NET_COUNTERS[] = {"rx_errors", "tx_errors", "rx_crc_errors",
+                                             "rx_dropped", "tx_dropped"};
+
+  fs::path                        root(config_.sysfs_root);
+  std::map<std::string, uint64_t> counters;
+  std::error_code                 ec;
+  long long                       value = 0;
+  for (const auto& entry : fs::directory_iterator(root / "devices/system/edac/mc", ec)) {
+    for (const char* name : {"ce_count", "ue_count"}) {
+      if (read_value(entry.path() / name, value)) {
+        counters["edac/" + entry.path().filename().string() + "/" + name] = value;
+      }
+    }
+  }
+  for (const auto& entry : fs::directory_iterator(root / "class/net", ec)) {
+    for (const char* name : NET_COUNTERS) {
+      if (read_value(entry.path() / "statistics" / name, value)) {
+        counters["net/" + entry.path().filename().string() + "/" + name] = value;
+      }
+    }
+  }
+  return counters;
+}
+
+}  // namespace imx93_peripheral_test
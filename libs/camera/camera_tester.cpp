@@ -32,10 +32,16 @@ namespace fs = std::filesystem;
 
 namespace imx93_peripheral_test {
 
-CameraTester::CameraTester() : camera_available_(false) {
-  // Check if camera interfaces are available on i.MX93
+CameraTester::CameraTester() : camera_available_(false) {}
+
+bool CameraTester::probe() {
   // i.MX93 uses ISI (Image Sensing Interface) with MIPI-CSI2
-  camera_available_ = fs::exists("/dev/video0") || fs::exists("/sys/class/video4linux");
+  return fs::exists("/dev/video0") || fs::exists("/sys/class/video4linux");
+}
+
+void CameraTester::discover() {
+  // Check if camera interfaces are available on i.MX93
+  camera_available_ = probe();
   if (camera_available_) {
     cameras_ = enumerate_cameras();
   }
@@ -53,6 +59,7 @@ TestReport CameraTester::short_test() {
   bool              all_passed = true;
 
   details << "Found " << cameras_.size() << " camera device(s)\n";
+  add_metric("cameras", static_cast<double>(cameras_.size()), "");
 
   for (const auto& camera : cameras_) {
     details << "- " << camera.device_path << " (" << camera.driver_name;
@@ -63,7 +70,7 @@ TestReport CameraTester::short_test() {
   }
 
   // Test MIPI CSI-2 functionality
-  TestResult csi2_result = test_mipi_csi2();
+  TestResult csi2_result = add_check("mipi_csi2", test_mipi_csi2());
   details << "MIPI CSI-2: "
           << (csi2_result == TestResult::SUCCESS
                   ? "PASS"
@@ -73,7 +80,7 @@ TestReport CameraTester::short_test() {
     all_passed = false;
 
   // Test multi-camera support
-  TestResult multi_result = test_multi_camera();
+  TestResult multi_result = add_check("multi_camera", test_multi_camera());
   details << "Multi-camera: "
           << (multi_result == TestResult::SUCCESS
                   ? "PASS"
@@ -102,9 +109,9 @@ TestReport CameraTester::monitor_test(std::chrono::seconds duration) {
   auto end_time      = std::chrono::steady_clock::now();
   auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-  std::string details =
-      "Camera monitoring completed for " + std::to_string(duration.count()) + " seconds";
-  return create_report(result, details, test_duration);
+  std::string details = "Camera monitoring completed for " + std::to_string(duration.count()) +
+                        " seconds\n";
+  return create_monitor_report(result, details, test_duration);
 }
 
 bool CameraTester::is_available() const {
@@ -261,8 +268,12 @@ TestResult CameraTester::monitor_camera_streaming(std::chrono::seconds duration)
   // For monitoring, we check if cameras remain accessible
   bool stable = true;
 
+  monitor_series_.clear();
+  size_t camera_count = monitor_series_.add_series("cameras", "count");
+
   while (std::chrono::steady_clock::now() < end_time && stable) {
     auto current_cameras = enumerate_cameras();
+    monitor_series_.add(camera_count, static_cast<double>(current_cameras.size()));
 
     if (current_cameras.size() != cameras_.size()) {
       stable = false;
@@ -284,7 +295,9 @@ TestResult CameraTester::monitor_camera_streaming(std::chrono::seconds duration)
       }
     }
 
-    std::this_thread::sleep_for(std::chrono::seconds(2));
+    if (cancellation_.wait_for(std::chrono::seconds(2))) {
+      break;
+    }
   }
 
   return stable ? TestResult::SUCCESS : TestResult::FAILURE;
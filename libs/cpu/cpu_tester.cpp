@@ -30,15 +30,27 @@ namespace fs = std::filesystem;
 namespace imx93_peripheral_test {
 
 /**
- * @brief Constructs a CPU tester instance.
+ * @brief Constructs a CPU tester instance; discovery is left to prepare().
+ */
+CPUTester::CPUTester() : cpu_available_(false) {}
+
+/**
+ * @brief Returns true if /proc/cpuinfo exists.
+ */
+bool CPUTester::probe() {
+  return fs::exists("/proc/cpuinfo");
+}
+
+/**
+ * @brief Discovers the CPU peripheral.
  *
  * Initializes the CPU tester by checking for CPU information availability
  * and retrieving initial CPU information from /proc/cpuinfo.
  * For i.MX93, expects to find dual Cortex-A55 cores, and checks for NPU availability.
  */
-CPUTester::CPUTester() : cpu_available_(false) {
+void CPUTester::discover() {
   // Check if CPU information is available
-  cpu_available_ = fs::exists("/proc/cpuinfo");
+  cpu_available_ = probe();
   if (cpu_available_) {
     cpu_info_ = get_cpu_info();
     // Verify we have i.MX93 CPU (Cortex-A55)
@@ -85,15 +97,17 @@ TestReport CPUTester::short_test() {
                   ? "Ethos U-65 (" + std::to_string(cpu_info_.npu_tops) + " TOPS)"
                   : "Not available")
           << "\n";
+  add_metric("cores", cpu_info_.cores, "");
+  add_metric("frequency", cpu_info_.frequency_mhz, "MHz");
 
   // Test basic computation
-  TestResult benchmark_result = benchmark_cpu();
+  TestResult benchmark_result = add_check("benchmark", benchmark_cpu());
   details << "Benchmark: " << (benchmark_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (benchmark_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test temperature
-  TestResult temp_result = test_temperature();
+  TestResult temp_result = add_check("temperature", test_temperature());
   details << "Temperature: " << (temp_result == TestResult::SUCCESS ? "PASS" : "FAIL");
   if (temp_result == TestResult::SUCCESS) {
     details << " (" << cpu_info_.temperature_c << "°C)\n";
@@ -104,13 +118,13 @@ TestReport CPUTester::short_test() {
     all_passed = false;
 
   // Test multi-core
-  TestResult multi_core_result = test_multi_core();
+  TestResult multi_core_result = add_check("multi_core", test_multi_core());
   details << "Multi-core: " << (multi_core_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (multi_core_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test NPU availability
-  TestResult npu_result = test_npu();
+  TestResult npu_result = add_check("npu", test_npu());
   details << "NPU: "
           << (npu_result == TestResult::SUCCESS
                   ? "PASS"
@@ -152,9 +166,9 @@ TestReport CPUTester::monitor_test(std::chrono::seconds duration) {
   auto end_time      = std::chrono::steady_clock::now();
   auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-  std::string details =
-      "CPU monitoring completed for " + std::to_string(duration.count()) + " seconds";
-  return create_report(result, details, test_duration);
+  std::string details = "CPU monitoring completed for " + std::to_string(duration.count()) +
+                        " seconds\n";
+  return create_monitor_report(result, details, test_duration);
 }
 
 /**
@@ -169,6 +183,47 @@ bool CPUTester::is_available() const {
   return cpu_available_;
 }
 
+/**
+ * @brief Loads every core with the prime benchmark until stopped.
+ *
+ * Each pass counts the primes below 10000 by trial division and checks the
+ * count against the known value, so arithmetic errors under heat or
+ * undervolting show up as counter errors rather than going unnoticed.
+ */
+TestResult CPUTester::stress(uint32_t intensity, const std::atomic<bool>& stop,
+                             StressCounters& counters) {
+  const int      MAX_PRIME   = 10000;
+  const uint64_t PRIME_COUNT = 1229;  // pi(10000)
+
+  unsigned threads = intensity > 0 ? intensity : std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&stop, &counters]() {
+      while (!stop.load(std::memory_order_relaxed)) {
+        uint64_t found = 0;
+        for (int num = 2; num <= MAX_PRIME; ++num) {
+          bool is_prime = true;
+          for (int i = 2; i * i <= num; ++i) {
+            if (num % i == 0) {
+              is_prime = false;
+              break;
+            }
+          }
+          found += is_prime ? 1 : 0;
+        }
+        if (found != PRIME_COUNT) {
+          counters.errors++;
+        }
+        counters.operations++;
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  return counters.errors.load() == 0 ? TestResult::SUCCESS : TestResult::FAILURE;
+}
+
 /**
  * @brief Retrieves comprehensive CPU information from system files.
  *
@@ -277,6 +332,7 @@ TestResult CPUTester::benchmark_cpu() {
   // Simple CPU benchmark: calculate prime numbers
   const int        MAX_PRIME = 10000;
   std::vector<int> primes;
+  auto             start = std::chrono::steady_clock::now();
 
   for (int num = 2; num <= MAX_PRIME; ++num) {
     bool is_prime = true;
@@ -291,6 +347,10 @@ TestResult CPUTester::benchmark_cpu() {
     }
   }
 
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  add_metric("benchmark_time", elapsed.count(), "ms");
+  add_metric("benchmark_primes", static_cast<double>(primes.size()), "", 1229, 1229);
+
   // Verify we found some primes
   if (primes.empty() || primes.back() != 9973) {  // 10000th prime is 104729, but we use smaller
     return TestResult::FAILURE;
@@ -316,6 +376,7 @@ TestResult CPUTester::test_temperature() {
   if (temp < 0) {
     return TestResult::NOT_SUPPORTED;
   }
+  add_metric("temperature", temp, "C", 0.0, 100.0);
 
   // Check if temperature is reasonable (0-100°C)
   if (temp < 0 || temp > 100) {
@@ -342,27 +403,28 @@ TestResult CPUTester::monitor_temperature(std::chrono::seconds duration) {
   auto start_time = std::chrono::steady_clock::now();
   auto end_time   = start_time + duration;
 
-  std::vector<double> temperatures;
-  double              min_temp = 999.0;
-  double              max_temp = -999.0;
+  monitor_series_.clear();
+  size_t temperature = monitor_series_.add_series("cpu_temperature", "C");
 
   while (std::chrono::steady_clock::now() < end_time) {
     double temp = get_cpu_temperature();
     if (temp >= 0) {
-      temperatures.push_back(temp);
-      min_temp = std::min(min_temp, temp);
-      max_temp = std::max(max_temp, temp);
+      monitor_series_.add(temperature, temp);
     }
 
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+    if (cancellation_.wait_for(std::chrono::seconds(1))) {
+      break;
+    }
   }
 
-  if (temperatures.empty()) {
+  TimeSeriesBucket temperatures = monitor_series_.series()[temperature].summary();
+  if (temperatures.samples == 0) {
     return TestResult::NOT_SUPPORTED;
   }
 
   // Check temperature stability (variation should be reasonable)
-  double temp_variation = max_temp - min_temp;
+  double temp_variation = temperatures.max - temperatures.min;
+  add_metric("temperature_variation", temp_variation, "C", 0.0, 20.0);
 
   // Allow up to 20°C variation during monitoring
   return (temp_variation <= 20.0) ? TestResult::SUCCESS : TestResult::FAILURE;
@@ -0,0 +1,609 @@
+/**
+ * @file health_daemon.cpp
+ * @brief Implementation of the resident health monitoring daemon.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "health_daemon.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#include "logger.h"
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr size_t MAX_REQUEST = 1024;  // Longer requests are cut off here
+constexpr size_t UNMAPPED    = std::numeric_limits<size_t>::max();
+
+double unix_now_s() {
+  return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief Parses a whole word as a number.
+ */
+bool parse_number(const std::string& word, double& value) {
+  char* end = nullptr;
+  value     = std::strtod(word.c_str(), &end);
+  return !word.empty() && end == word.c_str() + word.size();
+}
+
+}  // namespace
+
+/**
+ * @brief Every sample of every tester, as "peripheral/metric".
+ */
+struct HealthDaemon::History {
+  History(size_t capacity, size_t factor, size_t tiers)
+      : store(capacity, factor, tiers), origin_unix_s(unix_now_s()) {}
+
+  /**
+   * @brief Converts a time in seconds from the store's origin to Unix seconds.
+   */
+  double unix_time(double time_s) const {
+    return origin_unix_s + time_s;
+  }
+
+  std::mutex      mutex;
+  TimeSeriesStore store;
+  double          origin_unix_s; /**< Unix time of the store's origin */
+};
+
+/**
+ * @brief Adds the series of one tester's monitor store to the history.
+ */
+class HealthDaemon::HistorySink : public TimeSeriesSink {
+public:
+  HistorySink(std::shared_ptr<History> history, std::shared_ptr<MetricRegistry> metrics,
+              const std::string& prefix)
+      : history_(std::move(history)), metrics_(std::move(metrics)), prefix_(prefix) {}
+
+  void series_added(size_t series, const std::string& name, const std::string& unit) override {
+    std::string help   = "Latest " + name + " sample in " + unit;
+    size_t      family = metrics_->add_family("imx93_" + name, help, MetricType::GAUGE);
+    size_t      slot   = metrics_->add(family, "peripheral", prefix_);
+    std::lock_guard<std::mutex> lock(history_->mutex);
+    if (series >= ids_.size()) {
+      ids_.resize(series + 1, UNMAPPED);
+      slots_.resize(series + 1, MetricRegistry::NO_SLOT);
+    }
+    ids_[series]   = history_->store.add_series(prefix_ + "/" + name, unit);
+    slots_[series] = slot;
+  }
+
+  void sample_added(size_t series, std::chrono::steady_clock::time_point at,
+                    double value) override {
+    std::lock_guard<std::mutex> lock(history_->mutex);
+    if (series < ids_.size() && ids_[series] != UNMAPPED) {
+      history_->store.add(ids_[series], value, at);
+      metrics_->set(slots_[series], value);
+    }
+  }
+
+private:
+  std::shared_ptr<History>        history_;
+  std::shared_ptr<MetricRegistry> metrics_;
+  std::string                     prefix_;
+  std::vector<size_t>             ids_;   /**< Tester series index to history series index */
+  std::vector<size_t>             slots_; /**< Tester series index to metric slot */
+};
+
+HealthDaemon::HealthDaemon(const HealthDaemonConfig& config)
+    : config_(config),
+      history_(std::make_shared<History>(config.history_capacity, config.history_factor,
+                                         config.history_tiers)),
+      metrics_(std::make_shared<MetricRegistry>()) {}
+
+HealthDaemon::~HealthDaemon() {
+  stop();
+}
+
+void HealthDaemon::add_tester(const std::string& name, std::shared_ptr<PeripheralTester> tester) {
+  auto worker    = std::make_unique<Worker>();
+  worker->name   = name;
+  worker->tester = std::move(tester);
+  worker->tester->set_telemetry_sink(std::make_shared<HistorySink>(history_, metrics_, name));
+
+  auto counter = [&](const char* metric, const char* help, MetricType type) {
+    return metrics_->add(metrics_->add_family(metric, help, type), "peripheral", name);
+  };
+  worker->windows_slot  = counter("imx93_monitor_windows_total", "Monitor windows completed",
+                                  MetricType::COUNTER);
+  worker->tests_slot    = counter("imx93_short_tests_total", "Short tests run",
+                                  MetricType::COUNTER);
+  worker->failures_slot = counter("imx93_short_test_failures_total",
+                                  "Short tests that did not succeed", MetricType::COUNTER);
+  worker->passed_slot   = counter("imx93_short_test_passed",
+                                  "1 if the last short test succeeded, 0 otherwise",
+                                  MetricType::GAUGE);
+  for (size_t slot : {worker->windows_slot, worker->tests_slot, worker->failures_slot}) {
+    metrics_->set(slot, 0.0);
+  }
+  workers_.push_back(std::move(worker));
+}
+
+bool HealthDaemon::start() {
+  if (running_) {
+    return true;
+  }
+
+  const std::string& path = config_.socket_path;
+  sockaddr_un        addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    error_ = "Invalid socket path: " + path;
+    return false;
+  }
+  memcpy(addr.sun_path, path.c_str(), path.size());
+
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  wake_fd_   = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  std::string error;
+  struct stat status;
+  if (listen_fd_ < 0 || wake_fd_ < 0) {
+    error = std::string("Cannot create socket: ") + std::strerror(errno);
+  } else if (lstat(path.c_str(), &status) == 0) {
+    // Only replace a socket nobody is listening on any more
+    if (!S_ISSOCK(status.st_mode)) {
+      error = path + " exists and is not a socket";
+    } else if (connect(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+      error = "Another daemon is listening on " + path;
+    } else {
+      unlink(path.c_str());
+      close(listen_fd_);
+      listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    }
+  }
+  if (error.empty() && (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+                        listen(listen_fd_, 16) < 0)) {
+    error = "Cannot listen on " + path + ": " + std::strerror(errno);
+  }
+  if (!error.empty()) {
+    for (int* fd : {&listen_fd_, &wake_fd_}) {
+      if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+      }
+    }
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    error_ = error;
+    return false;
+  }
+
+  if (config_.metrics_port >= 0) {
+    MetricsExporterConfig exporter_config;
+    exporter_config.address = config_.metrics_address;
+    exporter_config.port    = static_cast<uint16_t>(config_.metrics_port);
+    exporter_               = std::make_unique<MetricsExporter>(metrics_, exporter_config);
+    if (!exporter_->start()) {
+      close(listen_fd_);
+      close(wake_fd_);
+      listen_fd_ = wake_fd_ = -1;
+      unlink(path.c_str());
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      error_ = exporter_->last_error();
+      exporter_.reset();
+      return false;
+    }
+    LOG_INFO("Serving /metrics on {}:{}", config_.metrics_address, exporter_->port());
+  }
+
+  started_ = std::chrono::steady_clock::now();
+  running_ = true;
+  server_  = std::thread(&HealthDaemon::serve, this);
+  for (auto& worker : workers_) {
+    worker->thread = std::thread(&HealthDaemon::run_worker, this, std::ref(*worker));
+  }
+  LOG_INFO("Health daemon listening on {} with {} testers", path, workers_.size());
+  return true;
+}
+
+void HealthDaemon::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  uint64_t one = 1;
+  ssize_t  ret = write(wake_fd_, &one, sizeof(one));
+  (void)ret;
+  {
+    // Taken so a worker cannot miss the wake-up between its check and its wait
+    std::lock_guard<std::mutex> lock(state_mutex_);
+  }
+  schedule_.notify_all();
+  for (auto& worker : workers_) {
+    worker->watchdog.interrupt();
+  }
+
+  server_.join();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+  for (int* fd : {&listen_fd_, &wake_fd_}) {
+    close(*fd);
+    *fd = -1;
+  }
+  unlink(config_.socket_path.c_str());
+  if (exporter_) {
+    exporter_->stop();
+  }
+}
+
+size_t HealthDaemon::abandoned() const {
+  size_t count = 0;
+  for (const auto& worker : workers_) {
+    count += worker->watchdog.abandoned();
+  }
+  return count;
+}
+
+std::string HealthDaemon::last_error() const {
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  return error_;
+}
+
+std::chrono::milliseconds HealthDaemon::deadline(std::chrono::seconds expected) const {
+  return config_.timeout.count() > 0 ? expected + config_.timeout : std::chrono::milliseconds(0);
+}
+
+void HealthDaemon::run_worker(Worker& worker) {
+  const bool scheduled = config_.test_interval.count() > 0;
+  auto       next_test = std::chrono::steady_clock::now();
+  while (running_) {
+    auto now      = std::chrono::steady_clock::now();
+    bool run_test = false;
+    {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      run_test              = worker.test_requested || (scheduled && now >= next_test);
+      worker.test_requested = false;
+      worker.in_window      = !run_test;
+    }
+
+    if (run_test) {
+      auto report = std::make_shared<const TestReport>(worker.watchdog.run(
+          worker.tester, [](PeripheralTester& t) { return t.short_test(); },
+          deadline(std::chrono::seconds(0))));
+      if (report->result != TestResult::SUCCESS && running_) {
+        LOG_WARN("{}: short test {}: {}", worker.name, test_result_to_string(report->result),
+                 report->details);
+      }
+      publish_test(worker, *report);
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      worker.last_test = report;
+      worker.tests++;
+      worker.failures += report->result != TestResult::SUCCESS ? 1 : 0;
+      next_test = std::chrono::steady_clock::now() + config_.test_interval;
+      if (retire_if_abandoned(worker)) {
+        return;
+      }
+      continue;
+    }
+
+    // Windows end at the next scheduled test so it starts on time
+    auto window = std::max(config_.sample_window, std::chrono::seconds(1));
+    if (scheduled) {
+      window = std::clamp(std::chrono::ceil<std::chrono::seconds>(next_test - now),
+                          std::chrono::seconds(1), window);
+    }
+    auto window_end = now + window;
+    auto report     = std::make_shared<const TestReport>(worker.watchdog.run(
+        worker.tester,
+        [this, &worker, window](PeripheralTester& t) {
+          // A request made after the watchdog reset the token but before this check is seen here
+          {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (worker.test_requested) {
+              t.cancellation().cancel();
+            }
+          }
+          return t.monitor_test(window);
+        },
+        deadline(window)));
+
+    // A monitor that returns early must not turn this loop into a busy loop
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    worker.in_window   = false;
+    worker.last_window = report;
+    worker.windows++;
+    metrics_->set(worker.windows_slot, static_cast<double>(worker.windows));
+    if (retire_if_abandoned(worker)) {
+      return;
+    }
+    schedule_.wait_until(lock, window_end,
+                         [this, &worker]() { return !running_ || worker.test_requested; });
+  }
+}
+
+bool HealthDaemon::retire_if_abandoned(Worker& worker) {
+  // The abandoned thread is still inside the tester; running it again would race with it
+  if (worker.watchdog.abandoned() == 0) {
+    return false;
+  }
+  worker.retired = true;
+  metrics_->set(worker.passed_slot, 0.0);
+  if (running_) {
+    LOG_ERROR("{}: a test did not stop after its timeout; retiring this peripheral", worker.name);
+  }
+  return true;
+}
+
+void HealthDaemon::publish_test(Worker& worker, const TestReport& report) {
+  bool passed = report.result == TestResult::SUCCESS;
+  metrics_->set(worker.tests_slot, static_cast<double>(worker.tests + 1));
+  metrics_->set(worker.failures_slot, static_cast<double>(worker.failures + (passed ? 0 : 1)));
+  metrics_->set(worker.passed_slot, passed ? 1.0 : 0.0);
+
+  // Registration allocates, but only the first time a metric shows up
+  for (const auto& metric : report.metrics) {
+    auto it = worker.report_slots.find(metric.name);
+    if (it == worker.report_slots.end()) {
+      std::string help   = "Value of " + metric.name + " in the last short test";
+      size_t      family = metrics_->add_family(
+          "imx93_test_" + metric.name, metric.unit.empty() ? help : help + " (" + metric.unit + ")",
+          MetricType::GAUGE);
+      size_t slot = metrics_->add(family, "peripheral", worker.name);
+      it          = worker.report_slots.emplace(metric.name, slot).first;
+    }
+    metrics_->set(it->second, metric.value);
+  }
+}
+
+bool HealthDaemon::request_test(const std::string& name) {
+  Worker* worker = find_worker(name);
+  if (worker == nullptr) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    if (worker->retired) {
+      return false;
+    }
+    worker->test_requested = true;
+    if (worker->in_window) {
+      worker->tester->cancellation().cancel();
+    }
+  }
+  schedule_.notify_all();
+  return true;
+}
+
+HealthDaemon::Worker* HealthDaemon::find_worker(const std::string& name) {
+  for (auto& worker : workers_) {
+    if (worker->name == name) {
+      return worker.get();
+    }
+  }
+  return nullptr;
+}
+
+void HealthDaemon::serve() {
+  pollfd fds[2];
+  fds[0].fd     = listen_fd_;
+  fds[0].events = POLLIN;
+  fds[1].fd     = wake_fd_;
+  fds[1].events = POLLIN;
+  while (running_) {
+    if (poll(fds, 2, 200) <= 0 || !(fds[0].revents & POLLIN)) {
+      continue;
+    }
+    int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd >= 0) {
+      serve_connection(fd);
+    }
+  }
+}
+
+void HealthDaemon::serve_connection(int fd) {
+  // A client that stops talking cannot hold up the others for long
+  timeval timeout;
+  timeout.tv_sec  = 1;
+  timeout.tv_usec = 0;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  std::string request;
+  char        buffer[256];
+  while (request.size() < MAX_REQUEST && request.find('\n') == std::string::npos) {
+    ssize_t length = recv(fd, buffer, sizeof(buffer), 0);
+    if (length <= 0) {
+      break;
+    }
+    request.append(buffer, static_cast<size_t>(length));
+  }
+  request = request.substr(0, std::min(request.find('\n'), MAX_REQUEST));
+
+  std::string response = handle_request(request) + "\n";
+  size_t      sent     = 0;
+  while (sent < response.size()) {
+    ssize_t length = send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+    if (length <= 0) {
+      break;
+    }
+    sent += static_cast<size_t>(length);
+  }
+  close(fd);
+}
+
+std::string HealthDaemon::handle_request(const std::string& request) {
+  std::vector<std::string> words;
+  std::istringstream       in(request);
+  for (std::string word; in >> word;) {
+    words.push_back(word);
+  }
+  std::string command = words.empty() ? "" : words[0];
+
+  JsonStream json;
+  json.begin_object();
+  std::string error;
+  if (command == "status" && words.size() == 1) {
+    json.key("ok").value(true);
+    write_status(json);
+  } else if (command == "latest" && words.size() <= 2) {
+    std::string peripheral = words.size() == 2 ? words[1] : "";
+    if (!peripheral.empty() && find_worker(peripheral) == nullptr) {
+      error = "Unknown peripheral: " + peripheral;
+    } else {
+      json.key("ok").value(true);
+      write_latest(json, peripheral);
+    }
+  } else if (command == "test" && words.size() == 2) {
+    if (find_worker(words[1]) == nullptr) {
+      error = "Unknown peripheral: " + words[1];
+    } else if (!request_test(words[1])) {
+      error = words[1] + " was retired after a test did not stop";
+    } else {
+      json.key("ok").value(true);
+      json.key("queued").value(words[1]);
+    }
+  } else if (command == "range" && (words.size() == 4 || words.size() == 5)) {
+    error = write_range(json, words);
+  } else {
+    error = "Expected status, latest [PERIPHERAL], test PERIPHERAL or "
+            "range METRIC FROM TO [POINTS]";
+  }
+  if (!error.empty()) {
+    json.key("ok").value(false);
+    json.key("error").value(error);
+  }
+  json.end_object();
+  requests_served_++;
+  return json.str();
+}
+
+void HealthDaemon::write_status(JsonStream& json) {
+  auto uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_);
+  json.key("uptime_s").value(running_ ? uptime.count() : 0.0);
+  json.key("requests").value(requests_served_.load());
+  json.key("peripherals").begin_array();
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  for (const auto& worker : workers_) {
+    json.begin_object();
+    json.key("name").value(worker->name);
+    json.key("windows").value(worker->windows);
+    json.key("tests").value(worker->tests);
+    json.key("retired").value(worker->retired);
+    json.key("last_test");
+    if (worker->last_test) {
+      json.value(test_result_to_string(worker->last_test->result));
+    } else {
+      json.null();
+    }
+    json.end_object();
+  }
+  json.end_array();
+}
+
+void HealthDaemon::write_latest(JsonStream& json, const std::string& peripheral) {
+  std::string prefix = peripheral + "/";
+  json.key("metrics").begin_array();
+  {
+    std::lock_guard<std::mutex> lock(history_->mutex);
+    for (const auto& series : history_->store.series()) {
+      if (!peripheral.empty() && series.name().compare(0, prefix.size(), prefix) != 0) {
+        continue;
+      }
+      TimeSeriesBucket latest = series.latest();
+      TimeSeriesBucket all    = series.summary();
+      if (latest.samples == 0) {
+        continue;
+      }
+      json.begin_object();
+      json.key("name").value(series.name());
+      json.key("unit").value(series.unit());
+      json.key("value").value(latest.mean);
+      json.key("time").value(history_->unix_time(latest.end_s));
+      json.key("min").value(all.min);
+      json.key("mean").value(all.mean);
+      json.key("max").value(all.max);
+      json.key("samples").value(all.samples);
+      json.end_object();
+    }
+  }
+  json.end_array();
+
+  // Reports are immutable once published, so they are written outside the lock
+  std::vector<std::pair<std::string, std::shared_ptr<const TestReport>>> tests;
+  std::vector<std::shared_ptr<const TestReport>>                         windows;
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    for (const auto& worker : workers_) {
+      if (peripheral.empty() || worker->name == peripheral) {
+        tests.emplace_back(worker->name, worker->last_test);
+        windows.push_back(worker->last_window);
+      }
+    }
+  }
+  auto write_report = [&json](const char* key, const std::shared_ptr<const TestReport>& report) {
+    json.key(key);
+    if (report) {
+      report->write_json(json);
+    } else {
+      json.null();
+    }
+  };
+  json.key("reports").begin_array();
+  for (size_t i = 0; i < tests.size(); ++i) {
+    json.begin_object();
+    json.key("peripheral").value(tests[i].first);
+    write_report("last_test", tests[i].second);
+    write_report("last_window", windows[i]);
+    json.end_object();
+  }
+  json.end_array();
+}
+
+std::string HealthDaemon::write_range(JsonStream& json, const std::vector<std::string>& words) {
+  double from   = 0.0;
+  double to     = 0.0;
+  double points = static_cast<double>(config_.max_points);
+  if (!parse_number(words[2], from) || !parse_number(words[3], to)) {
+    return "FROM and TO must be Unix times in seconds, or <= 0 for seconds before now";
+  }
+  if (words.size() == 5 && (!parse_number(words[4], points) || points < 1.0)) {
+    return "POINTS must be a positive number";
+  }
+  double now = unix_now_s();
+  from       = from <= 0.0 ? now + from : from;
+  to         = to <= 0.0 ? now + to : to;
+
+  std::lock_guard<std::mutex> lock(history_->mutex);
+  for (const auto& series : history_->store.series()) {
+    if (series.name() != words[1]) {
+      continue;
+    }
+    json.key("ok").value(true);
+    json.key("metric").value(series.name());
+    json.key("unit").value(series.unit());
+    json.key("buckets").begin_array();
+    for (const auto& bucket :
+         series.range(from - history_->origin_unix_s, to - history_->origin_unix_s,
+                      static_cast<size_t>(points))) {
+      json.begin_array();
+      json.value(history_->unix_time(bucket.start_s)).value(history_->unix_time(bucket.end_s));
+      json.value(bucket.min).value(bucket.mean).value(bucket.max).value(bucket.samples);
+      json.end_array();
+    }
+    json.end_array();
+    return "";
+  }
+  return "Unknown metric: " + words[1];
+}
+
+}  // namespace imx93_peripheral_test
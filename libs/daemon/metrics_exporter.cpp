@@ -0,0 +1,400 @@
+/**
+ * @file metrics_exporter.cpp
+ * @brief Implementation of the metric registry and the /metrics HTTP server.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "metrics_exporter.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr size_t REQUEST_SIZE = 2048;      // Longer request heads get 400
+constexpr size_t BODY_RESERVE = 64 * 1024; // Initial scrape buffer per connection
+
+/**
+ * @brief Appends text with the escapes a HELP line or label value needs.
+ */
+void append_escaped(std::string& out, const std::string& text, bool quotes) {
+  for (char c : text) {
+    if (c == '\\') {
+      out += "\\\\";
+    } else if (c == '\n') {
+      out += "\\n";
+    } else if (c == '"' && quotes) {
+      out += "\\\"";
+    } else {
+      out += c;
+    }
+  }
+}
+
+/**
+ * @brief Appends a sample value the way Prometheus parses it.
+ */
+void append_value(std::string& out, double value) {
+  if (std::isnan(value)) {
+    out += "NaN";
+  } else if (std::isinf(value)) {
+    out += value > 0 ? "+Inf" : "-Inf";
+  } else {
+    char digits[32];
+    int  length = std::snprintf(digits, sizeof(digits), "%.15g", value);
+    out.append(digits, static_cast<size_t>(length));
+  }
+}
+
+}  // namespace
+
+MetricRegistry::MetricRegistry(size_t capacity, size_t families)
+    : capacity_(capacity),
+      family_capacity_(families),
+      slots_(std::make_unique<Slot[]>(capacity)),
+      families_(std::make_unique<Family[]>(families)) {}
+
+std::string MetricRegistry::sanitize(const std::string& name) {
+  std::string result = name;
+  for (char& c : result) {
+    bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                 c == '_' || c == ':';
+    c = valid ? c : '_';
+  }
+  if (result.empty() || (result[0] >= '0' && result[0] <= '9')) {
+    result.insert(0, 1, '_');
+  }
+  return result;
+}
+
+size_t MetricRegistry::add_family(const std::string& name, const std::string& help,
+                                  MetricType type) {
+  std::string                 metric = sanitize(name);
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t                      count = family_count_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < count; ++i) {
+    if (families_[i].name == metric) {
+      return i;
+    }
+  }
+  if (count == family_capacity_) {
+    return NO_SLOT;
+  }
+
+  Family& family = families_[count];
+  family.name    = metric;
+  family.header  = "# HELP " + metric + " ";
+  append_escaped(family.header, help, false);
+  family.header += "\n# TYPE " + metric + (type == MetricType::COUNTER ? " counter\n" : " gauge\n");
+  family_count_.store(count + 1, std::memory_order_release);
+  return count;
+}
+
+size_t MetricRegistry::add(size_t family, const std::string& label_name,
+                           const std::string& label_value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (family >= family_count_.load(std::memory_order_relaxed)) {
+    return NO_SLOT;
+  }
+  std::string key = families_[family].name;
+  if (!label_name.empty()) {
+    key += "{" + sanitize(label_name) + "=\"";
+    append_escaped(key, label_value, true);
+    key += "\"}";
+  }
+  key += ' ';
+
+  size_t count = count_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < count; ++i) {
+    if (slots_[i].key == key) {
+      return i;
+    }
+  }
+  if (count == capacity_) {
+    return NO_SLOT;
+  }
+  slots_[count].family = family;
+  slots_[count].key    = key;
+  count_.store(count + 1, std::memory_order_release);
+  return count;
+}
+
+void MetricRegistry::render(std::string& out) const {
+  size_t families = family_count_.load(std::memory_order_acquire);
+  size_t count    = count_.load(std::memory_order_acquire);
+  for (size_t family = 0; family < families; ++family) {
+    bool header = false;
+    for (size_t i = 0; i < count; ++i) {
+      const Slot& slot = slots_[i];
+      if (slot.family != family || !slot.has_value.load(std::memory_order_acquire)) {
+        continue;
+      }
+      if (!header) {
+        out += families_[family].header;
+        header = true;
+      }
+      out += slot.key;
+      append_value(out, slot.value.load(std::memory_order_relaxed));
+      out += '\n';
+    }
+  }
+}
+
+/**
+ * @brief One client connection and its reusable buffers.
+ */
+struct MetricsExporter::Connection {
+  int                                   fd = -1;
+  char                                  request[REQUEST_SIZE];
+  size_t                                received = 0;
+  char                                  head[256];
+  size_t                                head_size  = 0;
+  size_t                                body_size  = 0; /**< 0 for HEAD requests */
+  size_t                                sent       = 0; /**< Over head and body */
+  bool                                  responding = false;
+  std::string                           body;
+  std::chrono::steady_clock::time_point since;
+
+  void close_socket() {
+    if (fd >= 0) {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+};
+
+MetricsExporter::MetricsExporter(std::shared_ptr<const MetricRegistry> registry,
+                                 const MetricsExporterConfig&          config)
+    : registry_(std::move(registry)),
+      config_(config),
+      connections_(std::make_unique<Connection[]>(std::max<size_t>(config.max_connections, 1))) {
+  config_.max_connections = std::max<size_t>(config.max_connections, 1);
+  for (size_t i = 0; i < config_.max_connections; ++i) {
+    connections_[i].body.reserve(BODY_RESERVE);
+  }
+}
+
+MetricsExporter::~MetricsExporter() {
+  stop();
+}
+
+bool MetricsExporter::start() {
+  if (running_) {
+    return true;
+  }
+  error_.clear();
+
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port   = htons(config_.port);
+  if (inet_pton(AF_INET, config_.address.c_str(), &addr.sin_addr) != 1) {
+    error_ = "Invalid metrics address: " + config_.address;
+    return false;
+  }
+
+  int one  = 1;
+  fd_      = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (fd_ < 0 || wake_fd_ < 0 || setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0 ||
+      bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd_, 16) < 0) {
+    error_ = "Cannot listen on " + config_.address + ":" + std::to_string(config_.port) + ": " +
+             std::strerror(errno);
+    for (int* fd : {&fd_, &wake_fd_}) {
+      if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+      }
+    }
+    return false;
+  }
+
+  socklen_t addr_len = sizeof(addr);
+  getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+  port_ = ntohs(addr.sin_port);
+
+  running_ = true;
+  thread_  = std::thread(&MetricsExporter::serve, this);
+  return true;
+}
+
+void MetricsExporter::stop() {
+  if (running_.exchange(false) && wake_fd_ >= 0) {
+    uint64_t one = 1;
+    ssize_t  ret = write(wake_fd_, &one, sizeof(one));
+    (void)ret;
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  for (size_t i = 0; i < config_.max_connections; ++i) {
+    connections_[i].close_socket();
+  }
+  for (int* fd : {&fd_, &wake_fd_}) {
+    if (*fd >= 0) {
+      close(*fd);
+      *fd = -1;
+    }
+  }
+}
+
+void MetricsExporter::serve() {
+  // fds[0] is the listening socket, fds[1] the wake-up; the rest map to connections via owner
+  std::vector<pollfd> fds(config_.max_connections + 2);
+  std::vector<size_t> owner(config_.max_connections + 2);
+  while (running_) {
+    size_t free_slots = 0;
+    size_t count      = 2;
+    for (size_t i = 0; i < config_.max_connections; ++i) {
+      Connection& connection = connections_[i];
+      if (connection.fd < 0) {
+        free_slots++;
+        continue;
+      }
+      fds[count].fd      = connection.fd;
+      fds[count].events  = connection.responding ? POLLOUT : POLLIN;
+      fds[count].revents = 0;
+      owner[count++]     = i;
+    }
+    fds[0].fd      = fd_;
+    fds[0].events  = free_slots > 0 ? POLLIN : 0;
+    fds[0].revents = 0;
+    fds[1].fd      = wake_fd_;
+    fds[1].events  = POLLIN;
+    fds[1].revents = 0;
+    if (poll(fds.data(), count, 500) < 0) {
+      continue;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    for (size_t i = 2; i < count; ++i) {
+      Connection& connection = connections_[owner[i]];
+      bool        keep       = now - connection.since < config_.idle_timeout;
+      if (keep && fds[i].revents != 0) {
+        keep = connection.responding ? transmit(connection) : receive(connection);
+      }
+      if (!keep) {
+        connection.close_socket();
+      }
+    }
+
+    for (size_t i = 0; i < config_.max_connections && (fds[0].revents & POLLIN); ++i) {
+      Connection& connection = connections_[i];
+      if (connection.fd >= 0) {
+        continue;
+      }
+      connection.fd = accept4(fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (connection.fd < 0) {
+        break;
+      }
+      connection.received   = 0;
+      connection.responding = false;
+      connection.since      = now;
+    }
+  }
+}
+
+bool MetricsExporter::receive(Connection& connection) {
+  ssize_t length = recv(connection.fd, connection.request + connection.received,
+                        REQUEST_SIZE - 1 - connection.received, 0);
+  if (length == 0) {
+    return false;
+  }
+  if (length < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+  connection.received += static_cast<size_t>(length);
+  connection.request[connection.received] = '\0';
+
+  int         status = 200;
+  const char* reason = "OK";
+  bool        head   = false;
+  if (std::strstr(connection.request, "\r\n\r\n") == nullptr &&
+      std::strstr(connection.request, "\n\n") == nullptr) {
+    if (connection.received < REQUEST_SIZE - 1) {
+      return true;
+    }
+    status = 400;
+    reason = "Bad Request";
+  } else {
+    // Request line: METHOD SP PATH[?QUERY] SP VERSION
+    const char* method_end = std::strchr(connection.request, ' ');
+    const char* path       = method_end != nullptr ? method_end + 1 : "";
+    size_t      path_size  = std::strcspn(path, " ?\r\n");
+    size_t      method     = method_end != nullptr ? method_end - connection.request : 0;
+    head = method == 4 && std::strncmp(connection.request, "HEAD", 4) == 0;
+    if (!head && !(method == 3 && std::strncmp(connection.request, "GET", 3) == 0)) {
+      status = 405;
+      reason = "Method Not Allowed";
+    } else if (!(path_size == 1 && path[0] == '/') &&
+               !(path_size == 8 && std::strncmp(path, "/metrics", 8) == 0)) {
+      status = 404;
+      reason = "Not Found";
+    }
+  }
+
+  connection.body.clear();
+  if (status == 200) {
+    registry_->render(connection.body);
+    scrapes_++;
+  } else {
+    connection.body += reason;
+    connection.body += '\n';
+  }
+  int size = std::snprintf(connection.head, sizeof(connection.head),
+                           "HTTP/1.1 %d %s\r\n"
+                           "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                           "Content-Length: %zu\r\n"
+                           "Connection: close\r\n\r\n",
+                           status, reason, connection.body.size());
+  connection.head_size  = static_cast<size_t>(size);
+  connection.body_size  = head ? 0 : connection.body.size();
+  connection.sent       = 0;
+  connection.responding = true;
+  return transmit(connection);
+}
+
+bool MetricsExporter::transmit(Connection& connection) {
+  while (connection.sent < connection.head_size + connection.body_size) {
+    iovec  parts[2];
+    size_t count = 0;
+    if (connection.sent < connection.head_size) {
+      parts[count].iov_base = connection.head + connection.sent;
+      parts[count].iov_len  = connection.head_size - connection.sent;
+      count++;
+    }
+    size_t body_sent      = connection.sent > connection.head_size
+                                ? connection.sent - connection.head_size
+                                : 0;
+    parts[count].iov_base = const_cast<char*>(connection.body.data()) + body_sent;
+    parts[count].iov_len  = connection.body_size - body_sent;
+    count++;
+
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov    = parts;
+    message.msg_iovlen = count;
+    ssize_t length     = sendmsg(connection.fd, &message, MSG_NOSIGNAL);
+    if (length < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    connection.sent += static_cast<size_t>(length);
+  }
+  return false;
+}
+
+}  // namespace imx93_peripheral_test
@@ -27,10 +27,16 @@ namespace fs = std::filesystem;
 
 namespace imx93_peripheral_test {
 
-DisplayTester::DisplayTester() : display_available_(false) {
+DisplayTester::DisplayTester() : display_available_(false) {}
+
+bool DisplayTester::probe() {
+  return fs::exists("/sys/class/drm") || fs::exists("/dev/dri");
+}
+
+void DisplayTester::discover() {
   // Check if display interfaces are available on i.MX93
   // i.MX93 uses DRM/KMS for display management
-  display_available_ = fs::exists("/sys/class/drm") || fs::exists("/dev/dri");
+  display_available_ = probe();
   if (display_available_) {
     displays_ = enumerate_displays();
   }
@@ -48,6 +54,7 @@ TestReport DisplayTester::short_test() {
   bool              all_passed = true;
 
   details << "Found " << displays_.size() << " display interface(s)\n";
+  add_metric("displays", static_cast<double>(displays_.size()), "");
 
   for (const auto& display : displays_) {
     details << "- " << display.interface_name << " (" << display.resolution;
@@ -58,7 +65,7 @@ TestReport DisplayTester::short_test() {
   }
 
   // Test HDMI functionality
-  TestResult hdmi_result = test_hdmi();
+  TestResult hdmi_result = add_check("hdmi", test_hdmi());
   details << "HDMI: "
           << (hdmi_result == TestResult::SUCCESS
                   ? "PASS"
@@ -68,7 +75,7 @@ TestReport DisplayTester::short_test() {
     all_passed = false;
 
   // Test MIPI DSI functionality
-  TestResult dsi_result = test_mipi_dsi();
+  TestResult dsi_result = add_check("mipi_dsi", test_mipi_dsi());
   details << "MIPI DSI: "
           << (dsi_result == TestResult::SUCCESS
                   ? "PASS"
@@ -78,7 +85,7 @@ TestReport DisplayTester::short_test() {
     all_passed = false;
 
   // Test HDMI 720p capability
-  TestResult hdmi_720p_result = test_hdmi_720p();
+  TestResult hdmi_720p_result = add_check("hdmi_720p", test_hdmi_720p());
   details << "HDMI 720p: "
           << (hdmi_720p_result == TestResult::SUCCESS
                   ? "PASS"
@@ -107,9 +114,9 @@ TestReport DisplayTester::monitor_test(std::chrono::seconds duration) {
   auto end_time      = std::chrono::steady_clock::now();
   auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-  std::string details =
-      "Display monitoring completed for " + std::to_string(duration.count()) + " seconds";
-  return create_report(result, details, test_duration);
+  std::string details = "Display monitoring completed for " + std::to_string(duration.count()) +
+                        " seconds\n";
+  return create_monitor_report(result, details, test_duration);
 }
 
 bool DisplayTester::is_available() const {
@@ -282,7 +289,8 @@ TestResult DisplayTester::monitor_display_connection(std::chrono::seconds durati
   auto start_time = std::chrono::steady_clock::now();
   auto end_time   = start_time + duration;
 
-  std::vector<int> connection_counts;
+  monitor_series_.clear();
+  size_t connected = monitor_series_.add_series("displays_connected", "count");
 
   while (std::chrono::steady_clock::now() < end_time) {
     int  connected_count  = 0;
@@ -294,24 +302,19 @@ TestResult DisplayTester::monitor_display_connection(std::chrono::seconds durati
       }
     }
 
-    connection_counts.push_back(connected_count);
-    std::this_thread::sleep_for(std::chrono::seconds(2));
+    monitor_series_.add(connected, connected_count);
+    if (cancellation_.wait_for(std::chrono::seconds(2))) {
+      break;
+    }
   }
 
-  if (connection_counts.empty()) {
+  TimeSeriesBucket connection_counts = monitor_series_.series()[connected].summary();
+  if (connection_counts.samples == 0) {
     return TestResult::FAILURE;
   }
 
   // Check for connection stability (should be consistent)
-  int  first_count = connection_counts.front();
-  bool stable      = true;
-  for (int count : connection_counts) {
-    if (count != first_count) {
-      stable = false;
-      break;
-    }
-  }
-
+  bool stable = connection_counts.min == connection_counts.max;
   return stable ? TestResult::SUCCESS : TestResult::FAILURE;
 }
 
@@ -39,17 +39,28 @@ namespace fs = std::filesystem;
 namespace imx93_peripheral_test {
 
 /**
- * @brief Constructs a form factor tester instance.
+ * @brief Constructs a form factor tester instance; discovery is left to prepare().
+ */
+FormFactorTester::FormFactorTester() : form_factor_available_(false) {}
+
+/**
+ * @brief Returns true if a device tree or GPIO sysfs exists.
+ */
+bool FormFactorTester::probe() {
+  return fs::exists("/proc/device-tree") || fs::exists("/sys/firmware/devicetree") ||
+         fs::exists("/sys/class/gpio");
+}
+
+/**
+ * @brief Discovers the form factor peripheral.
  *
  * Initializes the form factor tester by detecting available physical
  * interfaces and form factor-specific hardware components.
  * For FRDM-IMX93, checks Arduino headers, mikroBUS, and board-specific interfaces.
  */
-
-FormFactorTester::FormFactorTester() : form_factor_available_(false) {
+void FormFactorTester::discover() {
   // Check if form factor testing is available on FRDM-IMX93
-  form_factor_available_ = fs::exists("/proc/device-tree") ||
-                           fs::exists("/sys/firmware/devicetree") || fs::exists("/sys/class/gpio");
+  form_factor_available_ = probe();
 
   if (form_factor_available_) {
     form_factor_info_ = get_form_factor_info();
@@ -75,15 +86,17 @@ TestReport FormFactorTester::short_test() {
   }
   details << "Temperature: " << form_factor_info_.board_temperature_c << "°C\n";
   details << "Available Interfaces: " << form_factor_info_.interfaces.size() << "\n";
+  add_metric("board_temperature", form_factor_info_.board_temperature_c, "C");
+  add_metric("interfaces", static_cast<double>(form_factor_info_.interfaces.size()), "");
 
   // Test board information
-  TestResult board_result = test_board_info();
+  TestResult board_result = add_check("board_info", test_board_info());
   details << "Board Info: " << (board_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (board_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test GPIO pins
-  TestResult gpio_result = test_gpio_pins();
+  TestResult gpio_result = add_check("gpio_pins", test_gpio_pins());
   details << "GPIO Pins: "
           << (gpio_result == TestResult::SUCCESS
                   ? "PASS"
@@ -93,13 +106,13 @@ TestReport FormFactorTester::short_test() {
     all_passed = false;
 
   // Test interfaces
-  TestResult interface_result = test_interfaces();
+  TestResult interface_result = add_check("interfaces", test_interfaces());
   details << "Interfaces: " << (interface_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (interface_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test temperature
-  TestResult temp_result = test_temperature();
+  TestResult temp_result = add_check("temperature", test_temperature());
   details << "Temperature: "
           << (temp_result == TestResult::SUCCESS
                   ? "PASS"
@@ -128,9 +141,9 @@ TestReport FormFactorTester::monitor_test(std::chrono::seconds duration) {
   auto end_time      = std::chrono::steady_clock::now();
   auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-  std::string details =
-      "Interface monitoring completed for " + std::to_string(duration.count()) + " seconds";
-  return create_report(result, details, test_duration);
+  std::string details = "Interface monitoring completed for " + std::to_string(duration.count()) +
+                        " seconds\n";
+  return create_monitor_report(result, details, test_duration);
 }
 
 bool FormFactorTester::is_available() const {
@@ -252,20 +265,30 @@ TestResult FormFactorTester::monitor_interfaces(std::chrono::seconds duration) {
   bool   interfaces_stable = true;
   double initial_temp      = get_board_temperature();
 
+  monitor_series_.clear();
+  size_t temperature = monitor_series_.add_series("board_temperature", "C");
+  size_t interfaces  = monitor_series_.add_series("interfaces", "count");
+
   while (std::chrono::steady_clock::now() < end_time && interfaces_stable) {
     // Check temperature stability
     double current_temp = get_board_temperature();
+    if (current_temp > 0.0) {  // 0 means no sensor
+      monitor_series_.add(temperature, current_temp);
+    }
     if (std::abs(current_temp - initial_temp) > 20.0) {  // More than 20°C change
       interfaces_stable = false;
     }
 
     // Check interface availability
     auto current_interfaces = enumerate_interfaces();
+    monitor_series_.add(interfaces, static_cast<double>(current_interfaces.size()));
     if (current_interfaces.size() != form_factor_info_.interfaces.size()) {
       interfaces_stable = false;
     }
 
-    std::this_thread::sleep_for(std::chrono::seconds(5));
+    if (cancellation_.wait_for(std::chrono::seconds(5))) {
+      break;
+    }
   }
 
   return interfaces_stable ? TestResult::SUCCESS : TestResult::FAILURE;
@@ -43,9 +43,6 @@ namespace fs = std::filesystem;
  * on the FRDM board connectors.
  */
 GPIOTester::GPIOTester() : gpio_available_(false) {
-  // Check if GPIO sysfs is available
-  gpio_available_ = fs::exists("/sys/class/gpio");
-
   // Initialize test pins for FRDM-IMX93
   // GPIO numbering: GPIO_BANK_N = (bank-1) * 32 + pin
   // Example: GPIO1_IO00 = 0, GPIO1_IO01 = 1, GPIO2_IO00 = 32, etc.
@@ -89,6 +86,20 @@ GPIOTester::GPIOTester() : gpio_available_(false) {
   };
 }
 
+/**
+ * @brief Returns true if GPIO sysfs exists.
+ */
+bool GPIOTester::probe() {
+  return fs::exists("/sys/class/gpio");
+}
+
+/**
+ * @brief Sets availability from probe(); the pin table is fixed.
+ */
+void GPIOTester::discover() {
+  gpio_available_ = probe();
+}
+
 /**
  * @brief Destructor that cleans up GPIO resources.
  *
@@ -129,31 +140,31 @@ TestReport GPIOTester::short_test() {
   bool              all_passed = true;
 
   // Test digital I/O
-  TestResult digital_result = test_digital_io();
+  TestResult digital_result = add_check("digital_io", test_digital_io());
   details << "Digital I/O: " << (digital_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (digital_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test PWM
-  TestResult pwm_result = test_pwm();
+  TestResult pwm_result = add_check("pwm", test_pwm());
   details << "PWM: " << (pwm_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (pwm_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test I2C
-  TestResult i2c_result = test_i2c();
+  TestResult i2c_result = add_check("i2c", test_i2c());
   details << "I2C: " << (i2c_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (i2c_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test SPI
-  TestResult spi_result = test_spi();
+  TestResult spi_result = add_check("spi", test_spi());
   details << "SPI: " << (spi_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (spi_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test UART
-  TestResult uart_result = test_uart();
+  TestResult uart_result = add_check("uart", test_uart());
   details << "UART: " << (uart_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (uart_result != TestResult::SUCCESS)
     all_passed = false;
@@ -194,9 +205,9 @@ TestReport GPIOTester::monitor_test(std::chrono::seconds duration) {
   auto end_time      = std::chrono::steady_clock::now();
   auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-  std::string details =
-      "GPIO monitoring completed for " + std::to_string(duration.count()) + " seconds";
-  return create_report(result, details, test_duration);
+  std::string details = "GPIO monitoring completed for " + std::to_string(duration.count()) +
+                        " seconds\n";
+  return create_monitor_report(result, details, test_duration);
 }
 
 /**
@@ -440,14 +451,20 @@ TestResult GPIOTester::monitor_gpio_stability(std::chrono::seconds duration) {
   int stable_count = 0;
   int total_reads  = 0;
 
+  monitor_series_.clear();
+  size_t level = monitor_series_.add_series("gpio" + std::to_string(test_gpio) + "_level", "0/1");
+
   while (std::chrono::steady_clock::now() < end_time) {
     int value = read_gpio(test_gpio);
     if (value != -1) {
       stable_count++;
+      monitor_series_.add(level, value);
     }
     total_reads++;
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if (cancellation_.wait_for(std::chrono::milliseconds(100))) {
+      break;
+    }
   }
 
   // Unexport GPIO
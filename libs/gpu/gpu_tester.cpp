@@ -30,22 +30,29 @@ namespace fs = std::filesystem;
 namespace imx93_peripheral_test {
 
 /**
- * @brief Constructs a GPU tester instance.
+ * @brief Constructs a GPU tester instance; discovery is left to prepare().
+ */
+GPUTester::GPUTester() : gpu_available_(false) {}
+
+/**
+ * @brief Returns true if a DRM or Vivante galcore device exists.
+ */
+bool GPUTester::probe() {
+  // Vivante GPU typically appears as /dev/galcore or through DRM
+  return fs::exists("/dev/dri/card0") || fs::exists("/dev/galcore") ||
+         fs::exists("/dev/dri/renderD128") || fs::exists("/sys/class/misc/galcore");
+}
+
+/**
+ * @brief Discovers the GPU peripheral.
  *
  * Initializes the GPU tester by checking for i.MX93 Vivante GPU availability through
  * DRM (Direct Rendering Manager) devices and Vivante GPU driver presence.
  * The i.MX93 features an integrated Vivante GC520 GPU.
  */
-GPUTester::GPUTester() : gpu_available_(false) {
+void GPUTester::discover() {
   // Check for i.MX93 Vivante GPU through DRM devices
-  // Vivante GPU typically appears as /dev/galcore or through DRM
-  gpu_available_ = fs::exists("/dev/dri/card0") || fs::exists("/dev/galcore") ||
-                   fs::exists("/dev/dri/renderD128");
-
-  // Also check for Vivante-specific device nodes
-  if (!gpu_available_) {
-    gpu_available_ = fs::exists("/sys/class/misc/galcore");
-  }
+  gpu_available_ = probe();
 
   if (gpu_available_) {
     gpu_info_ = get_gpu_info();
@@ -79,9 +86,10 @@ TestReport GPUTester::short_test() {
   details << "GPU Model: " << gpu_info_.model_name << "\n";
   details << "Driver: " << gpu_info_.driver_version << "\n";
   details << "Memory: " << gpu_info_.memory_mb << " MB\n";
+  add_metric("memory", static_cast<double>(gpu_info_.memory_mb), "MB");
 
   // Test OpenGL
-  TestResult opengl_result = test_opengl();
+  TestResult opengl_result = add_check("opengl", test_opengl());
   details << "OpenGL: " << (opengl_result == TestResult::SUCCESS ? "PASS" : "FAIL");
   if (gpu_info_.supports_opengl) {
     details << " (" << gpu_info_.opengl_version << ")";
@@ -91,7 +99,7 @@ TestReport GPUTester::short_test() {
     all_passed = false;
 
   // Test Vulkan
-  TestResult vulkan_result = test_vulkan();
+  TestResult vulkan_result = add_check("vulkan", test_vulkan());
   details << "Vulkan: " << (vulkan_result == TestResult::SUCCESS ? "PASS" : "FAIL");
   if (gpu_info_.supports_vulkan) {
     details << " (" << gpu_info_.vulkan_version << ")";
@@ -101,7 +109,7 @@ TestReport GPUTester::short_test() {
     all_passed = false;
 
   // Test GPU memory
-  TestResult memory_result = test_gpu_memory();
+  TestResult memory_result = add_check("gpu_memory", test_gpu_memory());
   details << "GPU Memory: " << (memory_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (memory_result != TestResult::SUCCESS)
     all_passed = false;
@@ -139,9 +147,9 @@ TestReport GPUTester::monitor_test(std::chrono::seconds duration) {
   auto end_time      = std::chrono::steady_clock::now();
   auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-  std::string details =
-      "GPU monitoring completed for " + std::to_string(duration.count()) + " seconds";
-  return create_report(result, details, test_duration);
+  std::string details = "GPU monitoring completed for " + std::to_string(duration.count()) +
+                        " seconds\n";
+  return create_monitor_report(result, details, test_duration);
 }
 
 /**
@@ -389,27 +397,27 @@ TestResult GPUTester::monitor_gpu_temperature(std::chrono::seconds duration) {
   auto start_time = std::chrono::steady_clock::now();
   auto end_time   = start_time + duration;
 
-  std::vector<double> temperatures;
-  double              min_temp = 999.0;
-  double              max_temp = -999.0;
+  monitor_series_.clear();
+  size_t temperature = monitor_series_.add_series("gpu_temperature", "C");
 
   while (std::chrono::steady_clock::now() < end_time) {
     double temp = get_gpu_temperature();
     if (temp >= 0) {
-      temperatures.push_back(temp);
-      min_temp = std::min(min_temp, temp);
-      max_temp = std::max(max_temp, temp);
+      monitor_series_.add(temperature, temp);
     }
 
-    std::this_thread::sleep_for(std::chrono::seconds(2));
+    if (cancellation_.wait_for(std::chrono::seconds(2))) {
+      break;
+    }
   }
 
-  if (temperatures.empty()) {
+  TimeSeriesBucket temperatures = monitor_series_.series()[temperature].summary();
+  if (temperatures.samples == 0) {
     return TestResult::NOT_SUPPORTED;
   }
 
   // Check temperature stability (variation should be reasonable)
-  double temp_variation = max_temp - min_temp;
+  double temp_variation = temperatures.max - temperatures.min;
   return (temp_variation <= 15.0) ? TestResult::SUCCESS : TestResult::FAILURE;
 }
 
@@ -30,15 +30,27 @@ namespace fs = std::filesystem;
 namespace imx93_peripheral_test {
 
 /**
- * @brief Constructs a Memory tester instance.
+ * @brief Constructs a Memory tester instance; discovery is left to prepare().
+ */
+MemoryTester::MemoryTester() : memory_available_(false) {}
+
+/**
+ * @brief Returns true if /proc/meminfo exists.
+ */
+bool MemoryTester::probe() {
+  return fs::exists("/proc/meminfo");
+}
+
+/**
+ * @brief Discovers the Memory peripheral.
  *
  * Initializes the Memory tester by checking for memory information availability
  * and retrieving initial memory information from /proc/meminfo.
  * For i.MX93, the FRDM board typically has 2GB DDR4 or LPDDR4.
  */
-MemoryTester::MemoryTester() : memory_available_(false) {
+void MemoryTester::discover() {
   // Check if memory information is available
-  memory_available_ = fs::exists("/proc/meminfo");
+  memory_available_ = probe();
   if (memory_available_) {
     memory_info_ = get_memory_info();
   }
@@ -78,25 +90,27 @@ TestReport MemoryTester::short_test() {
   bool correct_size = (memory_info_.total_ram_mb >= 1900 &&
                        memory_info_.total_ram_mb <= 2100);  // Allow some variation
   details << "Capacity Check (2GB): " << (correct_size ? "PASS" : "FAIL") << "\n";
+  add_metric("total_ram", static_cast<double>(memory_info_.total_ram_mb), "MB", 1900, 2100);
+  add_metric("available_ram", static_cast<double>(memory_info_.available_ram_mb), "MB");
   if (!correct_size)
     all_passed = false;
 
   // Test RAM integrity
-  TestResult integrity_result = test_ram_integrity();
+  TestResult integrity_result = add_check("ram_integrity", test_ram_integrity());
   details << "RAM Integrity: " << (integrity_result == TestResult::SUCCESS ? "PASS" : "FAIL")
           << "\n";
   if (integrity_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test memory bandwidth
-  TestResult bandwidth_result = test_memory_bandwidth();
+  TestResult bandwidth_result = add_check("memory_bandwidth", test_memory_bandwidth());
   details << "Memory Bandwidth: " << (bandwidth_result == TestResult::SUCCESS ? "PASS" : "FAIL")
           << "\n";
   if (bandwidth_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test ECC if supported
-  TestResult ecc_result = test_ecc();
+  TestResult ecc_result = add_check("ecc", test_ecc());
   details << "ECC Test: "
           << (ecc_result == TestResult::SUCCESS
                   ? "PASS"
@@ -138,9 +152,9 @@ TestReport MemoryTester::monitor_test(std::chrono::seconds duration) {
   auto end_time      = std::chrono::steady_clock::now();
   auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-  std::string details =
-      "Memory monitoring completed for " + std::to_string(duration.count()) + " seconds";
-  return create_report(result, details, test_duration);
+  std::string details = "Memory monitoring completed for " + std::to_string(duration.count()) +
+                        " seconds\n";
+  return create_monitor_report(result, details, test_duration);
 }
 
 /**
@@ -315,6 +329,12 @@ TestResult MemoryTester::test_memory_bandwidth() {
   auto end_time = std::chrono::high_resolution_clock::now();
   auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
+  std::chrono::duration<double> seconds = end_time - start_time;
+  add_metric("bandwidth_time", static_cast<double>(duration.count()), "ms", 0, 5000);
+  if (seconds.count() > 0) {
+    add_metric("bandwidth", 2.0 * test_size / (1024.0 * 1024.0) / seconds.count(), "MB/s");
+  }
+
   // Basic check - if it took too long, consider it failed
   if (duration.count() > 5000) {  // More than 5 seconds for 100MB
     return TestResult::FAILURE;
@@ -380,9 +400,8 @@ TestResult MemoryTester::monitor_memory_usage(std::chrono::seconds duration) {
   auto start_time = std::chrono::steady_clock::now();
   auto end_time   = start_time + duration;
 
-  std::vector<uint64_t> memory_usage;
-  uint64_t              min_usage = UINT64_MAX;
-  uint64_t              max_usage = 0;
+  monitor_series_.clear();
+  size_t used = monitor_series_.add_series("memory_used", "MB");
 
   while (std::chrono::steady_clock::now() < end_time) {
     std::ifstream meminfo("/proc/meminfo");
@@ -396,23 +415,24 @@ TestResult MemoryTester::monitor_memory_usage(std::chrono::seconds duration) {
           uint64_t available_mb = std::stoull(value) / 1024;
           uint64_t used_mb      = memory_info_.total_ram_mb - available_mb;
 
-          memory_usage.push_back(used_mb);
-          min_usage = std::min(min_usage, used_mb);
-          max_usage = std::max(max_usage, used_mb);
+          monitor_series_.add(used, static_cast<double>(used_mb));
           break;
         }
       }
     }
 
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+    if (cancellation_.wait_for(std::chrono::seconds(1))) {
+      break;
+    }
   }
 
-  if (memory_usage.empty()) {
+  TimeSeriesBucket memory_usage = monitor_series_.series()[used].summary();
+  if (memory_usage.samples == 0) {
     return TestResult::FAILURE;
   }
 
   // Check for memory leaks (usage increase over time)
-  double usage_variation = static_cast<double>(max_usage - min_usage) / memory_info_.total_ram_mb;
+  double usage_variation = (memory_usage.max - memory_usage.min) / memory_info_.total_ram_mb;
   return (usage_variation <= 0.1) ? TestResult::SUCCESS
                                   : TestResult::FAILURE;  // Allow 10% variation
 }
@@ -462,4 +482,58 @@ TestResult MemoryTester::stress_test_memory(size_t test_size_mb) {
   return TestResult::SUCCESS;
 }
 
+/**
+ * @brief Keeps the memory bus busy with write/verify passes until stopped.
+ *
+ * Every pass writes a per-pass pattern of 64-bit words derived from the word
+ * index, so stale data from the previous pass or an aliased address never
+ * verifies, then reads the buffer back. The stop flag is polled per 1 MB
+ * chunk so the load ends promptly even with large buffers.
+ *
+ * @note Like stress_test_memory(), refuses to take more than 80% of available RAM.
+ */
+TestResult MemoryTester::stress(uint32_t intensity, const std::atomic<bool>& stop,
+                                StressCounters& counters) {
+  const uint64_t GOLDEN      = 0x9E3779B97F4A7C15ULL;
+  const size_t   CHUNK_WORDS = 1024 * 1024 / sizeof(uint64_t);
+
+  size_t size_mb = intensity > 0 ? intensity : 64;
+  if (!memory_available_ || size_mb > memory_info_.available_ram_mb * 0.8) {
+    return TestResult::NOT_SUPPORTED;
+  }
+
+  std::vector<uint64_t> buffer;
+  try {
+    buffer.resize(size_mb * CHUNK_WORDS);
+  } catch (const std::bad_alloc&) {
+    return TestResult::FAILURE;
+  }
+
+  for (uint64_t pass = 1; !stop.load(std::memory_order_relaxed); ++pass) {
+    bool finished = true;
+    for (size_t base = 0; base < buffer.size(); base += CHUNK_WORDS) {
+      if (stop.load(std::memory_order_relaxed)) {
+        finished = false;
+        break;
+      }
+      for (size_t i = base; i < base + CHUNK_WORDS; ++i) {
+        buffer[i] = (i * GOLDEN) ^ pass;
+      }
+      counters.bytes += CHUNK_WORDS * sizeof(uint64_t);
+    }
+    for (size_t base = 0; finished && base < buffer.size(); base += CHUNK_WORDS) {
+      uint64_t mismatches = 0;
+      for (size_t i = base; i < base + CHUNK_WORDS; ++i) {
+        mismatches += buffer[i] != ((i * GOLDEN) ^ pass) ? 1 : 0;
+      }
+      counters.errors += mismatches;
+      counters.bytes += CHUNK_WORDS * sizeof(uint64_t);
+    }
+    if (finished) {
+      counters.operations++;
+    }
+  }
+  return counters.errors.load() == 0 ? TestResult::SUCCESS : TestResult::FAILURE;
+}
+
 }  // namespace imx93_peripheral_test
\ No newline at end of file
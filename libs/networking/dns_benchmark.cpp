@@ -0,0 +1,535 @@
+/**
+ * @file dns_benchmark.cpp
+ * @brief Implementation of the asynchronous DNS resolver benchmark.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "dns_benchmark.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr size_t   DNS_HEADER_SIZE  = 12;
+constexpr size_t   DNS_MAX_UDP      = 512;
+constexpr uint16_t DNS_FLAG_QR      = 0x8000;
+constexpr uint16_t DNS_FLAG_RD      = 0x0100;
+constexpr uint16_t DNS_FLAG_RA      = 0x0080;
+constexpr uint16_t DNS_TYPE_A       = 1;
+constexpr uint16_t DNS_CLASS_IN     = 1;
+constexpr uint16_t DNS_RCODE_OK     = 0;
+constexpr uint16_t DNS_RCODE_NXNAME = 3;
+
+enum class QueryStatus { PENDING, RESOLVED, NXDOMAIN, SERVER_FAIL, TIMEOUT, UNREACHABLE };
+
+/**
+ * @brief One query of the benchmark workload.
+ */
+struct Query {
+  size_t                                server;
+  size_t                                name;
+  uint16_t                              id;
+  QueryStatus                           status = QueryStatus::PENDING;
+  std::chrono::steady_clock::time_point sent;
+  std::chrono::steady_clock::time_point deadline;
+  double                                latency_ms = 0.0;
+};
+
+/**
+ * @brief Connected UDP socket to one nameserver.
+ */
+struct ServerSocket {
+  std::string                          address;
+  int                                  fd = -1;
+  std::unordered_map<uint16_t, size_t> pending;  // query id -> index into queries
+};
+
+uint16_t read_be16(const uint8_t* data) {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+void write_be16(std::vector<uint8_t>& packet, uint16_t value) {
+  packet.push_back(static_cast<uint8_t>(value >> 8));
+  packet.push_back(static_cast<uint8_t>(value & 0xff));
+}
+
+/**
+ * @brief Returns the length of the question section starting after the header.
+ * @return 0 if the packet does not hold a complete question.
+ */
+size_t question_length(const uint8_t* data, size_t length) {
+  size_t offset = DNS_HEADER_SIZE;
+  while (offset < length && data[offset] != 0) {
+    // Compression pointers are not valid in a question we sent
+    if ((data[offset] & 0xc0) != 0) {
+      return 0;
+    }
+    offset += data[offset] + 1;
+  }
+  offset += 1 + 4;  // root label, QTYPE, QCLASS
+  return offset <= length ? offset - DNS_HEADER_SIZE : 0;
+}
+
+bool open_server_socket(const std::string& address, uint16_t port, ServerSocket& server) {
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family   = AF_UNSPEC;
+  hints.ai_socktype = SOCK_DGRAM;
+  hints.ai_flags    = AI_NUMERICHOST | AI_NUMERICSERV;
+
+  addrinfo* res = nullptr;
+  if (getaddrinfo(address.c_str(), std::to_string(port).c_str(), &hints, &res) != 0) {
+    return false;
+  }
+
+  server.fd = socket(res->ai_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  bool ok   = server.fd >= 0 && connect(server.fd, res->ai_addr, res->ai_addrlen) == 0;
+  freeaddrinfo(res);
+  if (!ok && server.fd >= 0) {
+    close(server.fd);
+    server.fd = -1;
+  }
+  return ok;
+}
+
+/**
+ * @brief Checks for the reserved ".invalid" TLD (RFC 6761) the stub answers with NXDOMAIN.
+ */
+bool is_invalid_name(const std::string& name) {
+  const std::string suffix = ".invalid";
+  return name == "invalid" ||
+         (name.size() > suffix.size() &&
+          name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0);
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+  size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+}  // namespace
+
+DnsBenchmark::DnsBenchmark(const DnsBenchmarkConfig& config) : config_(config) {}
+
+std::vector<std::string> DnsBenchmark::read_resolv_conf(const std::string& path) {
+  std::vector<std::string> servers;
+  std::ifstream            resolv_file(path);
+  std::string              line;
+  while (std::getline(resolv_file, line)) {
+    std::istringstream iss(line);
+    std::string        keyword, server;
+    if (iss >> keyword >> server && keyword == "nameserver") {
+      servers.push_back(server);
+    }
+  }
+  return servers;
+}
+
+bool DnsBenchmark::encode_query(uint16_t id, const std::string& name,
+                                std::vector<uint8_t>& packet) {
+  packet.clear();
+  write_be16(packet, id);
+  write_be16(packet, DNS_FLAG_RD);
+  write_be16(packet, 1);  // QDCOUNT
+  write_be16(packet, 0);  // ANCOUNT
+  write_be16(packet, 0);  // NSCOUNT
+  write_be16(packet, 0);  // ARCOUNT
+
+  std::string fqdn = name;
+  if (!fqdn.empty() && fqdn.back() == '.') {
+    fqdn.pop_back();
+  }
+  if (fqdn.empty() || fqdn.size() > 253) {
+    return false;
+  }
+
+  std::istringstream labels(fqdn);
+  std::string        label;
+  while (std::getline(labels, label, '.')) {
+    if (label.empty() || label.size() > 63) {
+      return false;
+    }
+    packet.push_back(static_cast<uint8_t>(label.size()));
+    for (char c : label) {
+      packet.push_back(static_cast<uint8_t>(std::tolower(static_cast<unsigned char>(c))));
+    }
+  }
+  packet.push_back(0);
+  write_be16(packet, DNS_TYPE_A);
+  write_be16(packet, DNS_CLASS_IN);
+  return true;
+}
+
+DnsBenchmarkResult DnsBenchmark::run() {
+  DnsBenchmarkResult result;
+  auto               start_time = std::chrono::steady_clock::now();
+
+  std::vector<std::string> addresses =
+      config_.servers.empty() ? read_resolv_conf() : config_.servers;
+  if (addresses.empty()) {
+    result.error_message = "No nameservers configured";
+    return result;
+  }
+  if (config_.names.empty()) {
+    result.error_message = "No names to resolve";
+    return result;
+  }
+
+  // Pre-encode one query per name; ids are patched in at send time
+  std::vector<std::vector<uint8_t>> packets(config_.names.size());
+  for (size_t n = 0; n < config_.names.size(); ++n) {
+    if (!encode_query(0, config_.names[n], packets[n])) {
+      result.error_message = "Invalid domain name: " + config_.names[n];
+      return result;
+    }
+  }
+
+  int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd < 0) {
+    result.error_message = std::string("epoll_create1: ") + strerror(errno);
+    return result;
+  }
+
+  std::vector<ServerSocket> servers(addresses.size());
+  std::vector<uint16_t>     next_id(addresses.size());
+  std::mt19937              rng(std::random_device{}());
+  for (size_t s = 0; s < addresses.size(); ++s) {
+    servers[s].address = addresses[s];
+    next_id[s]         = static_cast<uint16_t>(rng());
+    if (open_server_socket(addresses[s], config_.port, servers[s])) {
+      epoll_event event;
+      memset(&event, 0, sizeof(event));
+      event.events   = EPOLLIN;
+      event.data.u64 = s;
+      epoll_ctl(epoll_fd, EPOLL_CTL_ADD, servers[s].fd, &event);
+    }
+  }
+
+  // Interleave servers so every server sees the same pacing
+  std::vector<Query> queries;
+  for (uint32_t r = 0; r < std::max<uint32_t>(config_.repeat, 1); ++r) {
+    for (size_t n = 0; n < config_.names.size(); ++n) {
+      for (size_t s = 0; s < servers.size(); ++s) {
+        Query query;
+        query.server = s;
+        query.name   = n;
+        query.id     = next_id[s]++;
+        queries.push_back(query);
+      }
+    }
+  }
+
+  auto fail_pending = [&](ServerSocket& server, QueryStatus status) {
+    for (const auto& entry : server.pending) {
+      queries[entry.second].status = status;
+    }
+    server.pending.clear();
+  };
+
+  const uint32_t                   max_in_flight = std::max<uint32_t>(config_.max_in_flight, 1);
+  std::deque<size_t>               in_flight;  // send order == deadline order
+  size_t                           next_query = 0;
+  std::vector<uint8_t>             packet;
+  std::array<uint8_t, DNS_MAX_UDP> response;
+
+  while (next_query < queries.size() || !in_flight.empty()) {
+    // Keep the pipeline full
+    while (next_query < queries.size() && in_flight.size() < max_in_flight) {
+      size_t        index  = next_query++;
+      Query&        query  = queries[index];
+      ServerSocket& server = servers[query.server];
+      if (server.fd < 0) {
+        query.status = QueryStatus::UNREACHABLE;
+        continue;
+      }
+      packet    = packets[query.name];
+      packet[0] = static_cast<uint8_t>(query.id >> 8);
+      packet[1] = static_cast<uint8_t>(query.id & 0xff);
+
+      query.sent     = std::chrono::steady_clock::now();
+      query.deadline = query.sent + config_.timeout;
+      if (send(server.fd, packet.data(), packet.size(), 0) < 0) {
+        query.status = QueryStatus::UNREACHABLE;
+        continue;
+      }
+      server.pending[query.id] = index;
+      in_flight.push_back(index);
+    }
+
+    // Retire answered and expired queries from the front
+    auto now = std::chrono::steady_clock::now();
+    while (!in_flight.empty()) {
+      Query& query = queries[in_flight.front()];
+      if (query.status == QueryStatus::PENDING && query.deadline > now) {
+        break;
+      }
+      if (query.status == QueryStatus::PENDING) {
+        query.status = QueryStatus::TIMEOUT;
+        servers[query.server].pending.erase(query.id);
+      }
+      in_flight.pop_front();
+    }
+    if (in_flight.empty()) {
+      continue;
+    }
+
+    auto wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       queries[in_flight.front()].deadline - now)
+                       .count() +
+                   1;
+    epoll_event events[16];
+    int         ready = epoll_wait(epoll_fd, events, 16, static_cast<int>(wait_ms));
+    for (int e = 0; e < ready; ++e) {
+      ServerSocket& server = servers[events[e].data.u64];
+      while (true) {
+        ssize_t length = recv(server.fd, response.data(), response.size(), 0);
+        if (length < 0) {
+          if (errno == ECONNREFUSED || errno == EHOSTUNREACH || errno == ENETUNREACH) {
+            fail_pending(server, QueryStatus::UNREACHABLE);
+            continue;
+          }
+          break;
+        }
+        auto received = std::chrono::steady_clock::now();
+        if (static_cast<size_t>(length) < DNS_HEADER_SIZE) {
+          continue;
+        }
+
+        uint16_t id    = read_be16(response.data());
+        auto     entry = server.pending.find(id);
+        if (entry == server.pending.end()) {
+          continue;  // late or spoofed answer
+        }
+        Query&                      query    = queries[entry->second];
+        const std::vector<uint8_t>& question = packets[query.name];
+        size_t                      qlen     = question_length(response.data(), length);
+        uint16_t                    flags    = read_be16(response.data() + 2);
+        if (!(flags & DNS_FLAG_QR) || qlen != question.size() - DNS_HEADER_SIZE ||
+            memcmp(response.data() + DNS_HEADER_SIZE, question.data() + DNS_HEADER_SIZE, qlen) !=
+                0) {
+          continue;
+        }
+
+        uint16_t rcode   = flags & 0x000f;
+        uint16_t answers = read_be16(response.data() + 6);
+        if (rcode == DNS_RCODE_OK && answers > 0) {
+          query.status = QueryStatus::RESOLVED;
+        } else if (rcode == DNS_RCODE_OK || rcode == DNS_RCODE_NXNAME) {
+          query.status = QueryStatus::NXDOMAIN;
+        } else {
+          query.status = QueryStatus::SERVER_FAIL;
+        }
+        query.latency_ms = std::chrono::duration<double, std::milli>(received - query.sent).count();
+        server.pending.erase(entry);
+      }
+    }
+  }
+
+  // Aggregate per server
+  std::set<size_t> resolved_names;
+  for (size_t s = 0; s < servers.size(); ++s) {
+    DnsServerStats      stats;
+    std::vector<double> latencies;
+    stats.server = servers[s].address;
+    for (const auto& query : queries) {
+      if (query.server != s) {
+        continue;
+      }
+      stats.queries++;
+      switch (query.status) {
+        case QueryStatus::RESOLVED:
+          stats.resolved++;
+          resolved_names.insert(query.name);
+          break;
+        case QueryStatus::NXDOMAIN:
+          stats.nxdomain++;
+          break;
+        case QueryStatus::SERVER_FAIL:
+          stats.server_fail++;
+          break;
+        case QueryStatus::UNREACHABLE:
+          stats.unreachable++;
+          break;
+        default:
+          stats.timeouts++;
+          break;
+      }
+      if (query.status == QueryStatus::RESOLVED || query.status == QueryStatus::NXDOMAIN ||
+          query.status == QueryStatus::SERVER_FAIL) {
+        latencies.push_back(query.latency_ms);
+      }
+    }
+
+    if (!latencies.empty()) {
+      std::sort(latencies.begin(), latencies.end());
+      double sum = 0.0;
+      for (double latency : latencies) {
+        sum += latency;
+      }
+      stats.min_ms = latencies.front();
+      stats.max_ms = latencies.back();
+      stats.avg_ms = sum / latencies.size();
+      stats.p50_ms = percentile(latencies, 0.50);
+      stats.p99_ms = percentile(latencies, 0.99);
+    }
+    if (stats.queries > 0) {
+      stats.failure_rate =
+          static_cast<double>(stats.server_fail + stats.timeouts + stats.unreachable) /
+          stats.queries;
+    }
+    result.servers.push_back(stats);
+
+    if (servers[s].fd >= 0) {
+      close(servers[s].fd);
+    }
+  }
+  close(epoll_fd);
+
+  for (size_t n : resolved_names) {
+    result.resolved_names.push_back(config_.names[n]);
+  }
+  result.success = !resolved_names.empty();
+  result.elapsed_s =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  return result;
+}
+
+DnsStubServer::DnsStubServer() : running_(false), answered_(0), fd_(-1), wake_fd_(-1), port_(0) {}
+
+DnsStubServer::~DnsStubServer() {
+  stop();
+}
+
+bool DnsStubServer::start(const std::string& address, uint16_t port) {
+  if (running_) {
+    return true;
+  }
+
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port   = htons(port);
+  if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+    return false;
+  }
+
+  fd_      = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (fd_ < 0 || wake_fd_ < 0 || bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    stop();
+    return false;
+  }
+
+  socklen_t addr_len = sizeof(addr);
+  getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+  port_ = ntohs(addr.sin_port);
+
+  running_ = true;
+  thread_  = std::thread(&DnsStubServer::serve, this);
+  return true;
+}
+
+void DnsStubServer::stop() {
+  if (running_.exchange(false) && wake_fd_ >= 0) {
+    uint64_t one = 1;
+    ssize_t  ret = write(wake_fd_, &one, sizeof(one));
+    (void)ret;
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  for (int* fd : {&fd_, &wake_fd_}) {
+    if (*fd >= 0) {
+      close(*fd);
+      *fd = -1;
+    }
+  }
+}
+
+void DnsStubServer::serve() {
+  pollfd fds[2];
+  fds[0].fd     = fd_;
+  fds[0].events = POLLIN;
+  fds[1].fd     = wake_fd_;
+  fds[1].events = POLLIN;
+
+  std::array<uint8_t, DNS_MAX_UDP> buffer;
+  std::vector<uint8_t>             reply;
+  while (running_) {
+    if (poll(fds, 2, 200) <= 0 || !(fds[0].revents & POLLIN)) {
+      continue;
+    }
+
+    sockaddr_storage peer;
+    socklen_t        peer_len = sizeof(peer);
+    ssize_t          length   = recvfrom(fd_, buffer.data(), buffer.size(), 0,
+                                         reinterpret_cast<sockaddr*>(&peer), &peer_len);
+    if (length < static_cast<ssize_t>(DNS_HEADER_SIZE)) {
+      continue;
+    }
+    size_t qlen = question_length(buffer.data(), length);
+    if (qlen == 0 || read_be16(buffer.data() + 4) != 1) {
+      continue;
+    }
+
+    // Decode the name to decide between an answer and NXDOMAIN
+    std::string name;
+    for (size_t offset = DNS_HEADER_SIZE; buffer[offset] != 0; offset += buffer[offset] + 1) {
+      if (!name.empty()) {
+        name += '.';
+      }
+      name.append(reinterpret_cast<const char*>(&buffer[offset + 1]), buffer[offset]);
+    }
+    bool nxdomain = is_invalid_name(name);
+    uint16_t qtype  = read_be16(buffer.data() + DNS_HEADER_SIZE + qlen - 4);
+    bool     answer = !nxdomain && qtype == DNS_TYPE_A;
+
+    reply.assign(buffer.begin(), buffer.begin() + DNS_HEADER_SIZE + qlen);
+    uint16_t flags = DNS_FLAG_QR | DNS_FLAG_RA | (read_be16(buffer.data() + 2) & DNS_FLAG_RD) |
+                     (nxdomain ? DNS_RCODE_NXNAME : DNS_RCODE_OK);
+    reply[2] = static_cast<uint8_t>(flags >> 8);
+    reply[3] = static_cast<uint8_t>(flags & 0xff);
+    reply[6] = 0;
+    reply[7] = answer ? 1 : 0;  // ANCOUNT
+    reply[8] = reply[9] = reply[10] = reply[11] = 0;
+    if (answer) {
+      write_be16(reply, 0xc000 | DNS_HEADER_SIZE);  // pointer to the question name
+      write_be16(reply, DNS_TYPE_A);
+      write_be16(reply, DNS_CLASS_IN);
+      write_be16(reply, 0);  // TTL
+      write_be16(reply, 0);
+      write_be16(reply, 4);  // RDLENGTH
+      reply.insert(reply.end(), {127, 0, 0, 1});
+    }
+
+    if (sendto(fd_, reply.data(), reply.size(), 0, reinterpret_cast<sockaddr*>(&peer), peer_len) >=
+        0) {
+      answered_++;
+    }
+  }
+}
+
+}  // namespace imx93_peripheral_test
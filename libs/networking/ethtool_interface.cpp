@@ -0,0 +1,328 @@
+/**
+ * @file ethtool_interface.cpp
+ * @brief Implementation of SIOCETHTOOL link, statistics and offload access.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "ethtool_interface.h"
+
+#include <linux/ethtool.h>
+#include <linux/sockios.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+std::string duplex_to_string(uint8_t duplex) {
+  switch (duplex) {
+    case DUPLEX_FULL:
+      return "Full";
+    case DUPLEX_HALF:
+      return "Half";
+    default:
+      return "Unknown";
+  }
+}
+
+std::string port_to_string(uint8_t port) {
+  switch (port) {
+    case PORT_TP:
+      return "Twisted Pair";
+    case PORT_MII:
+      return "MII";
+    case PORT_FIBRE:
+      return "Fibre";
+    case PORT_DA:
+      return "Direct Attach";
+    case PORT_NONE:
+      return "None";
+    default:
+      return "Other";
+  }
+}
+
+}  // namespace
+
+EthtoolInterface::EthtoolInterface(const std::string& interface_name)
+    : interface_name_(interface_name), fd_(-1) {
+  fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd_ < 0) {
+    last_error_ = std::string("socket: ") + strerror(errno);
+  }
+}
+
+EthtoolInterface::~EthtoolInterface() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+bool EthtoolInterface::ethtool_ioctl(void* data, const char* what) {
+  if (fd_ < 0) {
+    return false;
+  }
+
+  ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, interface_name_.c_str(), IFNAMSIZ - 1);
+  ifr.ifr_data = static_cast<char*>(data);
+  if (ioctl(fd_, SIOCETHTOOL, &ifr) < 0) {
+    last_error_ = std::string(what) + ": " + strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool EthtoolInterface::get_driver_info(std::string& driver, std::string& bus_info) {
+  ethtool_drvinfo info;
+  memset(&info, 0, sizeof(info));
+  info.cmd = ETHTOOL_GDRVINFO;
+  if (!ethtool_ioctl(&info, "ETHTOOL_GDRVINFO")) {
+    return false;
+  }
+  driver   = info.driver;
+  bus_info = info.bus_info;
+  return true;
+}
+
+bool EthtoolInterface::get_link_settings(EthtoolLinkInfo& info) {
+  // Room for the supported/advertising/lp_advertising masks at their maximum size
+  std::vector<uint32_t> buffer(sizeof(ethtool_link_settings) / sizeof(uint32_t) + 3 * SCHAR_MAX);
+  auto*                 settings = reinterpret_cast<ethtool_link_settings*>(buffer.data());
+
+  // Handshake: the kernel answers with the negated number of mask words it needs
+  settings->cmd = ETHTOOL_GLINKSETTINGS;
+  if (ethtool_ioctl(settings, "ETHTOOL_GLINKSETTINGS") && settings->link_mode_masks_nwords < 0) {
+    int8_t nwords = static_cast<int8_t>(-settings->link_mode_masks_nwords);
+    std::fill(buffer.begin(), buffer.end(), 0);
+    settings->cmd                    = ETHTOOL_GLINKSETTINGS;
+    settings->link_mode_masks_nwords = nwords;
+    if (ethtool_ioctl(settings, "ETHTOOL_GLINKSETTINGS")) {
+      info.speed_mbps = settings->speed == static_cast<uint32_t>(SPEED_UNKNOWN)
+                            ? -1
+                            : static_cast<int32_t>(settings->speed);
+      info.duplex     = duplex_to_string(settings->duplex);
+      info.autoneg    = settings->autoneg == AUTONEG_ENABLE;
+      info.port       = port_to_string(settings->port);
+      return true;
+    }
+  }
+
+  // Drivers without link-mode support still answer the deprecated command
+  ethtool_cmd legacy;
+  memset(&legacy, 0, sizeof(legacy));
+  legacy.cmd = ETHTOOL_GSET;
+  if (!ethtool_ioctl(&legacy, "ETHTOOL_GSET")) {
+    return false;
+  }
+  uint32_t speed  = ethtool_cmd_speed(&legacy);
+  info.speed_mbps =
+      speed == static_cast<uint32_t>(SPEED_UNKNOWN) ? -1 : static_cast<int32_t>(speed);
+  info.duplex     = duplex_to_string(legacy.duplex);
+  info.autoneg    = legacy.autoneg == AUTONEG_ENABLE;
+  info.port       = port_to_string(legacy.port);
+  return true;
+}
+
+bool EthtoolInterface::get_string_set(uint32_t string_set, std::vector<std::string>& names) {
+  std::vector<uint64_t> info_buffer(sizeof(ethtool_sset_info) / sizeof(uint64_t) + 1);
+  auto*                 info = reinterpret_cast<ethtool_sset_info*>(info_buffer.data());
+  info->cmd                  = ETHTOOL_GSSET_INFO;
+  info->sset_mask            = 1ULL << string_set;
+  if (!ethtool_ioctl(info, "ETHTOOL_GSSET_INFO")) {
+    return false;
+  }
+  uint32_t count = (info->sset_mask & (1ULL << string_set)) ? info->data[0] : 0;
+
+  std::vector<uint8_t> strings_buffer(sizeof(ethtool_gstrings) + count * ETH_GSTRING_LEN);
+  auto*                strings = reinterpret_cast<ethtool_gstrings*>(strings_buffer.data());
+  strings->cmd                 = ETHTOOL_GSTRINGS;
+  strings->string_set          = string_set;
+  strings->len                 = count;
+  if (!ethtool_ioctl(strings, "ETHTOOL_GSTRINGS")) {
+    return false;
+  }
+
+  names.clear();
+  for (uint32_t i = 0; i < strings->len; ++i) {
+    const char* name = reinterpret_cast<const char*>(strings->data + i * ETH_GSTRING_LEN);
+    names.emplace_back(name, strnlen(name, ETH_GSTRING_LEN));
+  }
+  return true;
+}
+
+bool EthtoolInterface::get_stats(std::vector<EthtoolStat>& stats) {
+  if (stat_names_.empty() && !get_string_set(ETH_SS_STATS, stat_names_)) {
+    return false;
+  }
+
+  std::vector<uint64_t> buffer(sizeof(ethtool_stats) / sizeof(uint64_t) + stat_names_.size());
+  auto*                 request = reinterpret_cast<ethtool_stats*>(buffer.data());
+  request->cmd                  = ETHTOOL_GSTATS;
+  request->n_stats              = static_cast<uint32_t>(stat_names_.size());
+  if (!ethtool_ioctl(request, "ETHTOOL_GSTATS")) {
+    return false;
+  }
+
+  stats.clear();
+  size_t count = std::min<size_t>(request->n_stats, stat_names_.size());
+  for (size_t i = 0; i < count; ++i) {
+    stats.push_back({stat_names_[i], request->data[i]});
+  }
+  return true;
+}
+
+bool EthtoolInterface::get_features(std::vector<EthtoolFeature>& features) {
+  if (feature_names_.empty() && !get_string_set(ETH_SS_FEATURES, feature_names_)) {
+    return false;
+  }
+
+  uint32_t blocks = static_cast<uint32_t>((feature_names_.size() + 31) / 32);
+  std::vector<uint32_t> buffer(sizeof(ethtool_gfeatures) / sizeof(uint32_t) +
+                               blocks * sizeof(ethtool_get_features_block) / sizeof(uint32_t));
+  auto* request = reinterpret_cast<ethtool_gfeatures*>(buffer.data());
+  request->cmd  = ETHTOOL_GFEATURES;
+  request->size = blocks;
+  if (!ethtool_ioctl(request, "ETHTOOL_GFEATURES")) {
+    return false;
+  }
+
+  features.clear();
+  for (size_t i = 0; i < feature_names_.size(); ++i) {
+    const ethtool_get_features_block& block = request->features[i / 32];
+    uint32_t                          bit   = 1U << (i % 32);
+
+    EthtoolFeature feature;
+    feature.name      = feature_names_[i];
+    feature.available = (block.available & bit) != 0;
+    feature.requested = (block.requested & bit) != 0;
+    feature.active    = (block.active & bit) != 0;
+    feature.fixed     = (block.never_changed & bit) != 0;
+    features.push_back(feature);
+  }
+  return true;
+}
+
+bool EthtoolInterface::set_feature(const std::string& name, bool enable) {
+  if (feature_names_.empty() && !get_string_set(ETH_SS_FEATURES, feature_names_)) {
+    return false;
+  }
+  auto it = std::find(feature_names_.begin(), feature_names_.end(), name);
+  if (it == feature_names_.end()) {
+    last_error_ = "Unknown feature " + name;
+    return false;
+  }
+  size_t index = static_cast<size_t>(it - feature_names_.begin());
+
+  uint32_t blocks = static_cast<uint32_t>((feature_names_.size() + 31) / 32);
+  std::vector<uint32_t> buffer(sizeof(ethtool_sfeatures) / sizeof(uint32_t) +
+                               blocks * sizeof(ethtool_set_features_block) / sizeof(uint32_t));
+  auto* request = reinterpret_cast<ethtool_sfeatures*>(buffer.data());
+  request->cmd  = ETHTOOL_SFEATURES;
+  request->size = blocks;
+  request->features[index / 32].valid     = 1U << (index % 32);
+  request->features[index / 32].requested = enable ? 1U << (index % 32) : 0;
+  if (!ethtool_ioctl(request, "ETHTOOL_SFEATURES")) {
+    return false;
+  }
+
+  // Dependent features may keep the requested one from taking effect
+  std::vector<EthtoolFeature> features;
+  if (!get_features(features)) {
+    return false;
+  }
+  if (features[index].active != enable) {
+    last_error_ = name + " did not change (dependent feature or driver restriction)";
+    return false;
+  }
+  return true;
+}
+
+bool EthtoolInterface::get_ring(EthtoolRing& ring) {
+  ethtool_ringparam param;
+  memset(&param, 0, sizeof(param));
+  param.cmd = ETHTOOL_GRINGPARAM;
+  if (!ethtool_ioctl(&param, "ETHTOOL_GRINGPARAM")) {
+    return false;
+  }
+  ring.rx_pending = param.rx_pending;
+  ring.rx_max     = param.rx_max_pending;
+  ring.tx_pending = param.tx_pending;
+  ring.tx_max     = param.tx_max_pending;
+  return true;
+}
+
+bool EthtoolInterface::get_coalesce(EthtoolCoalesce& coalesce) {
+  ethtool_coalesce param;
+  memset(&param, 0, sizeof(param));
+  param.cmd = ETHTOOL_GCOALESCE;
+  if (!ethtool_ioctl(&param, "ETHTOOL_GCOALESCE")) {
+    return false;
+  }
+  coalesce.rx_usecs      = param.rx_coalesce_usecs;
+  coalesce.rx_max_frames = param.rx_max_coalesced_frames;
+  coalesce.tx_usecs      = param.tx_coalesce_usecs;
+  coalesce.tx_max_frames = param.tx_max_coalesced_frames;
+  coalesce.adaptive_rx   = param.use_adaptive_rx_coalesce != 0;
+  coalesce.adaptive_tx   = param.use_adaptive_tx_coalesce != 0;
+  return true;
+}
+
+bool EthtoolInterface::get_timestamping_info(EthtoolTsInfo& info) {
+  ethtool_ts_info param;
+  memset(&param, 0, sizeof(param));
+  param.cmd = ETHTOOL_GET_TS_INFO;
+  if (!ethtool_ioctl(&param, "ETHTOOL_GET_TS_INFO")) {
+    return false;
+  }
+  info.so_timestamping = param.so_timestamping;
+  info.phc_index       = param.phc_index;
+  info.tx_types        = param.tx_types;
+  info.rx_filters      = param.rx_filters;
+  return true;
+}
+
+bool EthtoolInterface::is_error_counter(const std::string& name) {
+  static const char* const patterns[] = {"err",      "drop",      "crc",      "fifo",    "miss",
+                                         "over",     "collision", "align",    "jabber",  "fragment",
+                                         "undersize", "discard",  "timeout"};
+  std::string lower = name;
+  std::transform(lower.begin(), lower.end(), lower.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  for (const char* pattern : patterns) {
+    if (lower.find(pattern) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<EthtoolStat> EthtoolInterface::counter_deltas(const std::vector<EthtoolStat>& before,
+                                                          const std::vector<EthtoolStat>& after,
+                                                          bool errors_only) {
+  std::vector<EthtoolStat> deltas;
+  size_t                   count = std::min(before.size(), after.size());
+  for (size_t i = 0; i < count; ++i) {
+    if (before[i].name != after[i].name || after[i].value <= before[i].value) {
+      continue;
+    }
+    if (errors_only && !is_error_counter(after[i].name)) {
+      continue;
+    }
+    deltas.push_back({after[i].name, after[i].value - before[i].value});
+  }
+  return deltas;
+}
+
+}  // namespace imx93_peripheral_test
@@ -0,0 +1,417 @@
+/**
+ * @file latency_prober.cpp
+ * @brief Implementation of the in-process ICMP echo latency prober.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * Every target gets its own connected ICMP socket so the kernel demultiplexes
+ * replies, and all sockets are serviced from one epoll loop. Transmit times
+ * come from SO_TIMESTAMPING software TX timestamps read back through the
+ * socket error queue; receive times come from the SCM_TIMESTAMPING control
+ * message. User-space clock readings are used when the kernel does not
+ * provide a timestamp.
+ */
+
+#include "latency_prober.h"
+
+#include <arpa/inet.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/ip_icmp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+/**
+ * @brief Per-host probing state kept for the duration of one probe train.
+ */
+struct ProbeTarget {
+  LatencyStats          stats;
+  sockaddr_in           addr{};
+  int                   fd    = -1;
+  bool                  raw   = false;
+  uint16_t              ident = 0;
+  std::vector<int64_t>  tx_ns;      // Send time per sequence number, 0 if not sent
+  std::vector<int64_t>  rx_ns;      // Reply time per sequence number, 0 if unanswered
+  std::vector<uint8_t>  tx_kernel;  // TX time came from a kernel timestamp
+  std::vector<uint8_t>  rx_kernel;  // RX time came from a kernel timestamp
+  std::vector<uint16_t> send_order; // SOF_TIMESTAMPING_OPT_ID key -> sequence number
+};
+
+int64_t timespec_to_ns(const timespec& ts) {
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+int64_t realtime_ns() {
+  timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return timespec_to_ns(ts);
+}
+
+uint16_t icmp_checksum(const uint8_t* data, size_t length) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i + 1 < length; i += 2) {
+    sum += static_cast<uint32_t>(data[i] << 8 | data[i + 1]);
+  }
+  if (length & 1) {
+    sum += static_cast<uint32_t>(data[length - 1] << 8);
+  }
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return htons(static_cast<uint16_t>(~sum & 0xffff));
+}
+
+bool resolve_ipv4(const std::string& host, sockaddr_in& addr) {
+  addr.sin_family = AF_INET;
+  if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) == 1) {
+    return true;
+  }
+
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+
+  struct addrinfo* res = nullptr;
+  if (getaddrinfo(host.c_str(), nullptr, &hints, &res) != 0 || res == nullptr) {
+    return false;
+  }
+  addr.sin_addr = reinterpret_cast<sockaddr_in*>(res->ai_addr)->sin_addr;
+  freeaddrinfo(res);
+  return true;
+}
+
+/**
+ * @brief Opens and connects the ICMP socket for a target.
+ *
+ * Prefers an unprivileged ping socket; falls back to a raw socket when
+ * ping_group_range excludes the caller.
+ */
+bool open_probe_socket(ProbeTarget& target) {
+  target.fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP);
+  if (target.fd < 0) {
+    target.fd  = socket(AF_INET, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP);
+    target.raw = true;
+  }
+  if (target.fd < 0) {
+    target.stats.error_message = std::string("socket: ") + strerror(errno);
+    return false;
+  }
+
+  // Connecting lets the kernel drop replies from other hosts, including on raw sockets
+  if (connect(target.fd, reinterpret_cast<sockaddr*>(&target.addr), sizeof(target.addr)) < 0) {
+    target.stats.error_message = std::string("connect: ") + strerror(errno);
+    close(target.fd);
+    target.fd = -1;
+    return false;
+  }
+
+  int ts_flags = SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RX_SOFTWARE |
+                 SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_OPT_ID |
+                 SOF_TIMESTAMPING_OPT_TSONLY;
+  if (setsockopt(target.fd, SOL_SOCKET, SO_TIMESTAMPING, &ts_flags, sizeof(ts_flags)) < 0) {
+    // Older kernels: settle for RX timestamps only
+    ts_flags = SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RX_SOFTWARE;
+    setsockopt(target.fd, SOL_SOCKET, SO_TIMESTAMPING, &ts_flags, sizeof(ts_flags));
+  }
+  return true;
+}
+
+void send_probe(ProbeTarget& target, uint16_t seq, uint16_t payload_size) {
+  std::vector<uint8_t> packet(sizeof(icmphdr) + payload_size);
+  for (size_t i = sizeof(icmphdr); i < packet.size(); ++i) {
+    packet[i] = static_cast<uint8_t>(i);
+  }
+
+  icmphdr* hdr          = reinterpret_cast<icmphdr*>(packet.data());
+  hdr->type             = ICMP_ECHO;
+  hdr->code             = 0;
+  hdr->un.echo.id       = htons(target.ident);  // Rewritten by the kernel on ping sockets
+  hdr->un.echo.sequence = htons(seq);
+  hdr->checksum         = 0;
+  hdr->checksum         = icmp_checksum(packet.data(), packet.size());
+
+  int64_t now = realtime_ns();
+  if (send(target.fd, packet.data(), packet.size(), 0) < 0) {
+    if (target.stats.error_message.empty()) {
+      target.stats.error_message = std::string("send: ") + strerror(errno);
+    }
+    return;
+  }
+  target.tx_ns[seq] = now;
+  target.send_order.push_back(seq);
+  target.stats.sent++;
+}
+
+const scm_timestamping* find_timestamping(msghdr& msg) {
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+      return reinterpret_cast<const scm_timestamping*>(CMSG_DATA(cmsg));
+    }
+  }
+  return nullptr;
+}
+
+void drain_replies(ProbeTarget& target) {
+  uint8_t buffer[2048];
+  char    control[512];
+
+  while (true) {
+    iovec  iov = {buffer, sizeof(buffer)};
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received = recvmsg(target.fd, &msg, MSG_DONTWAIT);
+    if (received < 0) {
+      return;
+    }
+
+    int64_t rx_time   = 0;
+    bool    rx_kernel = false;
+    if (const scm_timestamping* ts = find_timestamping(msg)) {
+      rx_time   = timespec_to_ns(ts->ts[0]);
+      rx_kernel = rx_time != 0;
+    }
+    if (rx_time == 0) {
+      rx_time = realtime_ns();
+    }
+
+    // Raw sockets deliver the IP header; ping sockets deliver bare ICMP
+    size_t offset = 0;
+    if (target.raw) {
+      if (static_cast<size_t>(received) < sizeof(iphdr)) {
+        continue;
+      }
+      offset = reinterpret_cast<const iphdr*>(buffer)->ihl * 4u;
+    }
+    if (static_cast<size_t>(received) < offset + sizeof(icmphdr)) {
+      continue;
+    }
+
+    const icmphdr* hdr = reinterpret_cast<const icmphdr*>(buffer + offset);
+    if (hdr->type != ICMP_ECHOREPLY) {
+      continue;
+    }
+    if (target.raw && ntohs(hdr->un.echo.id) != target.ident) {
+      continue;
+    }
+
+    uint16_t seq = ntohs(hdr->un.echo.sequence);
+    if (seq >= target.tx_ns.size() || target.tx_ns[seq] == 0 || target.rx_ns[seq] != 0) {
+      continue;
+    }
+    target.rx_ns[seq]     = rx_time;
+    target.rx_kernel[seq] = rx_kernel;
+    target.stats.received++;
+  }
+}
+
+void drain_tx_timestamps(ProbeTarget& target) {
+  char control[512];
+  char data[64];
+
+  while (true) {
+    iovec  iov = {data, sizeof(data)};
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    if (recvmsg(target.fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      return;
+    }
+
+    const scm_timestamping*  ts  = nullptr;
+    const sock_extended_err* err = nullptr;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+        ts = reinterpret_cast<const scm_timestamping*>(CMSG_DATA(cmsg));
+      } else if (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) {
+        err = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+      }
+    }
+
+    if (ts == nullptr || err == nullptr || err->ee_origin != SO_EE_ORIGIN_TIMESTAMPING) {
+      continue;
+    }
+    if (err->ee_data >= target.send_order.size() || timespec_to_ns(ts->ts[0]) == 0) {
+      continue;
+    }
+    uint16_t seq          = target.send_order[err->ee_data];
+    target.tx_ns[seq]     = timespec_to_ns(ts->ts[0]);
+    target.tx_kernel[seq] = 1;
+  }
+}
+
+void compute_stats(ProbeTarget& target) {
+  LatencyStats&       stats = target.stats;
+  std::vector<double> rtts;
+  bool                all_kernel = true;
+
+  for (size_t seq = 0; seq < target.tx_ns.size(); ++seq) {
+    if (target.tx_ns[seq] == 0 || target.rx_ns[seq] == 0) {
+      continue;
+    }
+    rtts.push_back(static_cast<double>(target.rx_ns[seq] - target.tx_ns[seq]) / 1e6);
+    all_kernel = all_kernel && target.tx_kernel[seq] && target.rx_kernel[seq];
+  }
+
+  stats.loss_percent =
+      stats.sent > 0 ? 100.0 * (stats.sent - stats.received) / stats.sent : 100.0;
+  if (rtts.empty()) {
+    return;
+  }
+
+  // Jitter uses transmission order, so compute it before sorting
+  double jitter_sum = 0.0;
+  for (size_t i = 1; i < rtts.size(); ++i) {
+    jitter_sum += std::fabs(rtts[i] - rtts[i - 1]);
+  }
+  stats.jitter_ms = rtts.size() > 1 ? jitter_sum / (rtts.size() - 1) : 0.0;
+
+  std::sort(rtts.begin(), rtts.end());
+  double sum = 0.0;
+  for (double rtt : rtts) {
+    sum += rtt;
+  }
+  size_t p99_rank         = static_cast<size_t>(std::ceil(0.99 * rtts.size()));
+  stats.min_ms            = rtts.front();
+  stats.max_ms            = rtts.back();
+  stats.avg_ms            = sum / rtts.size();
+  stats.p99_ms            = rtts[std::max<size_t>(p99_rank, 1) - 1];
+  stats.kernel_timestamps = all_kernel;
+}
+
+}  // namespace
+
+LatencyProber::LatencyProber(const ProbeConfig& config) : config_(config) {
+  // Sequence numbers are 16 bit and index the per-target tables
+  config_.count = std::min<uint32_t>(std::max<uint32_t>(config_.count, 1), 65535);
+}
+
+std::vector<LatencyStats> LatencyProber::probe(const std::vector<std::string>& hosts) {
+  std::vector<ProbeTarget> targets(hosts.size());
+
+  int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  for (size_t i = 0; i < hosts.size(); ++i) {
+    ProbeTarget& target = targets[i];
+    target.stats.host   = hosts[i];
+    target.ident        = static_cast<uint16_t>((getpid() + i) & 0xffff);
+    target.tx_ns.assign(config_.count, 0);
+    target.rx_ns.assign(config_.count, 0);
+    target.tx_kernel.assign(config_.count, 0);
+    target.rx_kernel.assign(config_.count, 0);
+
+    if (!resolve_ipv4(hosts[i], target.addr)) {
+      target.stats.error_message = "Unable to resolve host";
+      continue;
+    }
+    if (epoll_fd < 0) {
+      target.stats.error_message = std::string("epoll_create1: ") + strerror(errno);
+      continue;
+    }
+    if (!open_probe_socket(target)) {
+      continue;
+    }
+
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events   = EPOLLIN;  // EPOLLERR (error queue) is always reported
+    event.data.u32 = static_cast<uint32_t>(i);
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, target.fd, &event);
+  }
+
+  auto all_answered = [&targets]() {
+    for (const auto& target : targets) {
+      if (target.fd >= 0 && target.stats.received < target.stats.sent) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  auto     next_send = std::chrono::steady_clock::now();
+  auto     deadline  = next_send;
+  uint32_t next_seq  = 0;
+
+  while (epoll_fd >= 0) {
+    auto now = std::chrono::steady_clock::now();
+    if (next_seq < config_.count && now >= next_send) {
+      for (auto& target : targets) {
+        if (target.fd >= 0) {
+          send_probe(target, static_cast<uint16_t>(next_seq), config_.payload_size);
+        }
+      }
+      next_seq++;
+      next_send += config_.interval;
+      if (next_seq == config_.count) {
+        deadline = now + config_.timeout;
+      }
+    }
+
+    if (next_seq == config_.count && (all_answered() || now >= deadline)) {
+      break;
+    }
+
+    auto wake_time = next_seq < config_.count ? next_send : deadline;
+    auto wait_ms   = std::chrono::ceil<std::chrono::milliseconds>(wake_time - now).count();
+
+    epoll_event events[32];
+    int         ready =
+        epoll_wait(epoll_fd, events, 32, static_cast<int>(std::max<int64_t>(0, wait_ms)));
+    if (ready < 0 && errno != EINTR) {
+      break;
+    }
+    for (int i = 0; i < ready; ++i) {
+      ProbeTarget& target = targets[events[i].data.u32];
+      // Drain TX timestamps first so they are never older than the reply they belong to
+      if (events[i].events & EPOLLERR) {
+        drain_tx_timestamps(target);
+      }
+      if (events[i].events & EPOLLIN) {
+        drain_replies(target);
+      }
+    }
+  }
+
+  std::vector<LatencyStats> results;
+  results.reserve(targets.size());
+  for (auto& target : targets) {
+    if (target.fd >= 0) {
+      drain_tx_timestamps(target);
+      close(target.fd);
+    }
+    compute_stats(target);
+    results.push_back(target.stats);
+  }
+
+  if (epoll_fd >= 0) {
+    close(epoll_fd);
+  }
+  return results;
+}
+
+LatencyStats LatencyProber::probe(const std::string& host) {
+  return probe(std::vector<std::string>{host}).front();
+}
+
+}  // namespace imx93_peripheral_test
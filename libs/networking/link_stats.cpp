@@ -0,0 +1,217 @@
+/**
+ * @file link_stats.cpp
+ * @brief Implementation of netlink-based interface counter sampling.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "link_stats.h"
+
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifndef IFF_LOWER_UP
+#define IFF_LOWER_UP 0x10000 /* Only exported by <linux/if.h>, which clashes with <net/if.h> */
+#endif
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr size_t NETLINK_BUFFER_SIZE = 64 * 1024;
+
+uint64_t counter_delta(uint64_t previous, uint64_t current) {
+  return current >= previous ? current - previous : 0;
+}
+
+std::string format_mac(const unsigned char* data, size_t length) {
+  std::string mac;
+  char        octet[4];
+  for (size_t i = 0; i < length; ++i) {
+    snprintf(octet, sizeof(octet), i == 0 ? "%02x" : ":%02x", data[i]);
+    mac += octet;
+  }
+  return mac;
+}
+
+void parse_link(const nlmsghdr* header, LinkCounters& link) {
+  const auto* info = static_cast<const ifinfomsg*>(NLMSG_DATA(header));
+  link.ifindex     = info->ifi_index;
+  link.flags       = info->ifi_flags;
+  link.is_up       = (info->ifi_flags & IFF_UP) != 0;
+  link.has_carrier = (info->ifi_flags & IFF_LOWER_UP) != 0;
+
+  int length = static_cast<int>(IFLA_PAYLOAD(header));
+  for (const rtattr* attr = IFLA_RTA(info); RTA_OK(attr, length); attr = RTA_NEXT(attr, length)) {
+    const void* data = RTA_DATA(attr);
+    switch (attr->rta_type) {
+      case IFLA_IFNAME:
+        link.interface_name = static_cast<const char*>(data);
+        break;
+      case IFLA_MTU:
+        memcpy(&link.mtu, data, sizeof(link.mtu));
+        break;
+      case IFLA_ADDRESS:
+        link.mac_address = format_mac(static_cast<const unsigned char*>(data), RTA_PAYLOAD(attr));
+        break;
+      case IFLA_CARRIER: {
+        uint8_t carrier  = *static_cast<const uint8_t*>(data);
+        link.has_carrier = carrier != 0;
+        break;
+      }
+      case IFLA_CARRIER_CHANGES:
+        memcpy(&link.carrier_changes, data, sizeof(link.carrier_changes));
+        break;
+      case IFLA_LINK:
+        memcpy(&link.link_ifindex, data, sizeof(link.link_ifindex));
+        break;
+      case IFLA_LINKINFO: {
+        int nested_length = static_cast<int>(RTA_PAYLOAD(attr));
+        for (const rtattr* nested = static_cast<const rtattr*>(data);
+             RTA_OK(nested, nested_length); nested = RTA_NEXT(nested, nested_length)) {
+          if (nested->rta_type == IFLA_INFO_KIND) {
+            link.kind = static_cast<const char*>(RTA_DATA(nested));
+          }
+        }
+        break;
+      }
+      case IFLA_STATS64: {
+        rtnl_link_stats64 stats;
+        memset(&stats, 0, sizeof(stats));
+        memcpy(&stats, data, std::min<size_t>(sizeof(stats), RTA_PAYLOAD(attr)));
+        link.rx_bytes   = stats.rx_bytes;
+        link.tx_bytes   = stats.tx_bytes;
+        link.rx_packets = stats.rx_packets;
+        link.tx_packets = stats.tx_packets;
+        link.rx_errors  = stats.rx_errors;
+        link.tx_errors  = stats.tx_errors;
+        link.rx_dropped = stats.rx_dropped;
+        link.tx_dropped = stats.tx_dropped;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+LinkStatsCollector::LinkStatsCollector() : fd_(-1), seq_(0), buffer_(NETLINK_BUFFER_SIZE) {
+  fd_ = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (fd_ < 0) {
+    return;
+  }
+
+  sockaddr_nl local;
+  memset(&local, 0, sizeof(local));
+  local.nl_family = AF_NETLINK;
+  if (bind(fd_, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+LinkStatsCollector::~LinkStatsCollector() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+bool LinkStatsCollector::sample(LinkSnapshot& snapshot) {
+  snapshot.links.clear();
+  if (fd_ < 0) {
+    return false;
+  }
+
+  struct {
+    nlmsghdr  header;
+    ifinfomsg info;
+  } request;
+  memset(&request, 0, sizeof(request));
+  request.header.nlmsg_len   = NLMSG_LENGTH(sizeof(ifinfomsg));
+  request.header.nlmsg_type  = RTM_GETLINK;
+  request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  request.header.nlmsg_seq   = ++seq_;
+  request.info.ifi_family    = AF_UNSPEC;
+
+  sockaddr_nl kernel;
+  memset(&kernel, 0, sizeof(kernel));
+  kernel.nl_family = AF_NETLINK;
+  if (sendto(fd_, &request, request.header.nlmsg_len, 0, reinterpret_cast<sockaddr*>(&kernel),
+             sizeof(kernel)) < 0) {
+    return false;
+  }
+
+  // The dump normally fits in one datagram; keep reading until NLMSG_DONE otherwise
+  while (true) {
+    ssize_t length = recv(fd_, buffer_.data(), buffer_.size(), 0);
+    if (length < 0) {
+      return false;
+    }
+    snapshot.timestamp = std::chrono::steady_clock::now();
+
+    int remaining = static_cast<int>(length);
+    for (const auto* header = reinterpret_cast<const nlmsghdr*>(buffer_.data());
+         NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+      if (header->nlmsg_seq != seq_) {
+        continue;
+      }
+      if (header->nlmsg_type == NLMSG_DONE) {
+        return true;
+      }
+      if (header->nlmsg_type == NLMSG_ERROR) {
+        return false;
+      }
+      if (header->nlmsg_type == RTM_NEWLINK) {
+        LinkCounters link;
+        parse_link(header, link);
+        snapshot.links.push_back(link);
+      }
+    }
+  }
+}
+
+std::vector<LinkRates> LinkStatsCollector::compute_rates(const LinkSnapshot& previous,
+                                                         const LinkSnapshot& current) {
+  std::vector<LinkRates> rates;
+  double interval = std::chrono::duration<double>(current.timestamp - previous.timestamp).count();
+
+  for (const auto& now : current.links) {
+    const LinkCounters* before = previous.find(now.interface_name);
+    if (before == nullptr) {
+      continue;
+    }
+
+    LinkRates rate;
+    rate.interface_name        = now.interface_name;
+    rate.interval_s            = interval;
+    rate.is_up                 = now.is_up;
+    rate.has_carrier           = now.has_carrier;
+    rate.rx_errors_delta       = counter_delta(before->rx_errors, now.rx_errors);
+    rate.tx_errors_delta       = counter_delta(before->tx_errors, now.tx_errors);
+    rate.rx_dropped_delta      = counter_delta(before->rx_dropped, now.rx_dropped);
+    rate.tx_dropped_delta      = counter_delta(before->tx_dropped, now.tx_dropped);
+    rate.carrier_changes_delta = now.carrier_changes >= before->carrier_changes
+                                     ? now.carrier_changes - before->carrier_changes
+                                     : 0;
+    if (interval > 0) {
+      rate.rx_bps = counter_delta(before->rx_bytes, now.rx_bytes) * 8.0 / interval;
+      rate.tx_bps = counter_delta(before->tx_bytes, now.tx_bytes) * 8.0 / interval;
+      rate.rx_pps = counter_delta(before->rx_packets, now.rx_packets) / interval;
+      rate.tx_pps = counter_delta(before->tx_packets, now.tx_packets) / interval;
+    }
+    rates.push_back(rate);
+  }
+  return rates;
+}
+
+}  // namespace imx93_peripheral_test
@@ -0,0 +1,169 @@
+/**
+ * @file network_monitor.cpp
+ * @brief Implementation of the sampling network monitor.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "network_monitor.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+InterfaceTimeSeries* find_series(std::vector<InterfaceTimeSeries>& series,
+                                 const std::string&                name) {
+  for (auto& entry : series) {
+    if (entry.interface_name == name) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+NetworkMonitor::NetworkMonitor(const NetworkMonitorConfig& config) : config_(config) {}
+
+bool NetworkMonitor::is_selected(const std::string& name) const {
+  return config_.interfaces.empty() ||
+         std::find(config_.interfaces.begin(), config_.interfaces.end(), name) !=
+             config_.interfaces.end();
+}
+
+NetworkMonitorResult NetworkMonitor::run() {
+  NetworkMonitorResult result;
+
+  LinkStatsCollector collector;
+  LinkSnapshot       previous;
+  if (!collector.is_open() || !collector.sample(previous)) {
+    result.error_message = "Failed to read link statistics over rtnetlink";
+    return result;
+  }
+
+  result.series.set_sink(config_.series_sink);
+  for (const auto& link : previous.links) {
+    if (is_selected(link.interface_name)) {
+      InterfaceTimeSeries series;
+      series.interface_name   = link.interface_name;
+      series.up_at_start      = link.is_up;
+      series.carrier_at_start = link.has_carrier;
+      series.has_carrier      = link.has_carrier;
+      series.rx_series        = result.series.add_series(link.interface_name + "_rx", "Mbps");
+      series.tx_series        = result.series.add_series(link.interface_name + "_tx", "Mbps");
+      series.errors_series    = result.series.add_series(link.interface_name + "_errors", "");
+      series.drops_series     = result.series.add_series(link.interface_name + "_drops", "");
+      result.interfaces.push_back(series);
+    }
+  }
+  if (result.interfaces.empty()) {
+    result.error_message = "No matching network interfaces";
+    return result;
+  }
+
+  // Background load for the whole monitoring window
+  std::thread      load_thread;
+  ThroughputResult load_result;
+  if (config_.generate_load) {
+    ThroughputConfig load = config_.load;
+    load.duration         = config_.duration;
+    load.cancel           = config_.cancel;
+    load_thread           = std::thread([load, &load_result]() {
+      ThroughputEngine engine(load);
+      load_result = load.host == "127.0.0.1" ? engine.run_loopback() : engine.run_client();
+    });
+  }
+
+  const auto start       = previous.timestamp;
+  const auto deadline    = start + config_.duration;
+  const auto interval    = std::max(config_.sample_interval, std::chrono::milliseconds(1));
+  auto       next        = start + interval;
+  bool       sampling_ok = true;
+
+  LinkSnapshot current;
+  while (next <= deadline) {
+    if (config_.cancel != nullptr) {
+      if (config_.cancel->wait_until(next)) {
+        break;
+      }
+    } else {
+      std::this_thread::sleep_until(next);
+    }
+    if (!collector.sample(current)) {
+      sampling_ok          = false;
+      result.error_message = "Link statistics sampling failed";
+      break;
+    }
+
+    for (const auto& rate : LinkStatsCollector::compute_rates(previous, current)) {
+      InterfaceTimeSeries* series = find_series(result.interfaces, rate.interface_name);
+      if (series == nullptr) {
+        continue;
+      }
+
+      uint64_t errors  = rate.rx_errors_delta + rate.tx_errors_delta;
+      uint64_t dropped = rate.rx_dropped_delta + rate.tx_dropped_delta;
+      series->carrier_changes += std::max<uint32_t>(
+          rate.carrier_changes_delta, series->has_carrier != rate.has_carrier ? 1 : 0);
+      series->has_carrier    = rate.has_carrier;
+      series->total_errors  += errors;
+      series->total_dropped += dropped;
+      series->peak_rx_bps    = std::max(series->peak_rx_bps, rate.rx_bps);
+      series->peak_tx_bps    = std::max(series->peak_tx_bps, rate.tx_bps);
+      if (!rate.has_carrier) {
+        series->carrier_down_s += rate.interval_s;
+      }
+
+      result.series.add(series->rx_series, rate.rx_bps / 1e6, current.timestamp);
+      result.series.add(series->tx_series, rate.tx_bps / 1e6, current.timestamp);
+      result.series.add(series->errors_series, static_cast<double>(errors), current.timestamp);
+      result.series.add(series->drops_series, static_cast<double>(dropped), current.timestamp);
+    }
+
+    std::swap(previous, current);
+    result.sample_count++;
+
+    // Keep the absolute schedule, but drop slots missed by a slow sample
+    next += interval;
+    auto now = std::chrono::steady_clock::now();
+    if (next < now) {
+      next = now + interval;
+    }
+  }
+
+  if (load_thread.joinable()) {
+    load_thread.join();
+    result.load_ran    = true;
+    result.load_result = load_result;
+  }
+
+  for (auto& series : result.interfaces) {
+    series.mean_rx_bps = result.series.series()[series.rx_series].summary().mean * 1e6;
+    series.mean_tx_bps = result.series.series()[series.tx_series].summary().mean * 1e6;
+  }
+
+  result.elapsed_s = std::chrono::duration<double>(previous.timestamp - start).count();
+  result.success   = sampling_ok;
+  return result;
+}
+
+void NetworkMonitor::write_csv(const NetworkMonitorResult& result, std::ostream& out) {
+  out << "interface,time_s,rx_mbps,tx_mbps,errors,drops\n";
+  const std::vector<TimeSeries>& series = result.series.series();
+  for (const auto& interface : result.interfaces) {
+    // The four series of an interface are sampled together, so their raw tiers line up
+    std::vector<TimeSeriesBucket> rx      = series[interface.rx_series].tier(0);
+    std::vector<TimeSeriesBucket> tx      = series[interface.tx_series].tier(0);
+    std::vector<TimeSeriesBucket> errors  = series[interface.errors_series].tier(0);
+    std::vector<TimeSeriesBucket> dropped = series[interface.drops_series].tier(0);
+    for (size_t i = 0; i < rx.size(); ++i) {
+      out << interface.interface_name << "," << rx[i].end_s << "," << rx[i].mean << ","
+          << tx[i].mean << "," << errors[i].mean << "," << dropped[i].mean << "\n";
+    }
+  }
+}
+
+}  // namespace imx93_peripheral_test
@@ -16,7 +16,6 @@
 
 #include <arpa/inet.h>
 #include <ifaddrs.h>
-#include <linux/ethtool.h>
 #include <linux/if_link.h>
 #include <linux/sockios.h>
 #include <net/if.h>
@@ -41,10 +40,29 @@ namespace fs = std::filesystem;
 
 namespace imx93_peripheral_test {
 
-NetworkingTester::NetworkingTester() : networking_available_(false) {
+namespace {
+
+/**
+ * @brief Offloads listed by ethtool_test(), in display order.
+ */
+const char* const REPORTED_OFFLOADS[] = {
+    "rx-checksum",          "tx-checksum-ip-generic",  "tx-checksum-ipv4",
+    "tx-checksum-ipv6",     "tx-scatter-gather",       "tx-tcp-segmentation",
+    "tx-tcp6-segmentation", "tx-generic-segmentation", "tx-udp-segmentation",
+    "rx-gro",               "rx-lro",                  "rx-vlan-hw-parse"};
+
+}  // namespace
+
+NetworkingTester::NetworkingTester() : bandwidth_result_(), networking_available_(false) {}
+
+bool NetworkingTester::probe() {
+  return fs::exists("/proc/net/dev");
+}
+
+void NetworkingTester::discover() {
   // Check if networking is available
   // i.MX93 has dual ENET QoS controllers (typically eth0 and eth1)
-  networking_available_ = fs::exists("/proc/net/dev") || system("which ip > /dev/null 2>&1") == 0;
+  networking_available_ = probe();
 
   if (networking_available_) {
     interfaces_ = enumerate_interfaces();
@@ -65,30 +83,30 @@ TestReport NetworkingTester::short_test() {
   // Display network information
   details << "Default Gateway: " << get_default_gateway() << "\n";
   details << "DNS Servers: ";
-  // Get DNS servers from /etc/resolv.conf
-  std::ifstream resolv_file("/etc/resolv.conf");
-  if (resolv_file.is_open()) {
-    std::string              line;
-    std::vector<std::string> dns_servers;
-    while (std::getline(resolv_file, line)) {
-      if (line.find("nameserver") == 0) {
-        std::istringstream iss(line);
-        std::string        nameserver;
-        iss >> nameserver;
-        if (iss >> nameserver) {
-          dns_servers.push_back(nameserver);
-        }
-      }
-    }
-    for (size_t i = 0; i < dns_servers.size(); ++i) {
-      if (i > 0)
-        details << ", ";
-      details << dns_servers[i];
-    }
+  std::vector<std::string> dns_servers = DnsBenchmark::read_resolv_conf();
+  for (size_t i = 0; i < dns_servers.size(); ++i) {
+    if (i > 0)
+      details << ", ";
+    details << dns_servers[i];
   }
   details << "\n";
   details << "Available Interfaces: " << interfaces_.size() << "\n";
 
+  // Negotiated link parameters of the Ethernet MACs
+  for (const auto& interface : interfaces_) {
+    EthtoolLinkInfo link;
+    if (interface.type != NetworkInterfaceType::ETHERNET ||
+        !EthtoolInterface(interface.interface_name).get_link_settings(link)) {
+      continue;
+    }
+    details << interface.interface_name << " Link: ";
+    if (link.speed_mbps > 0) {
+      details << link.speed_mbps << " Mbps " << link.duplex << " duplex\n";
+    } else {
+      details << "Unknown speed\n";
+    }
+  }
+
   // Test network interfaces
   bool has_active_interface = false;
   for (const auto& interface : interfaces_) {
@@ -97,13 +115,14 @@ TestReport NetworkingTester::short_test() {
       break;
     }
   }
-  TestResult interface_result = has_active_interface ? TestResult::SUCCESS : TestResult::FAILURE;
+  TestResult interface_result =
+      add_check("interfaces", has_active_interface ? TestResult::SUCCESS : TestResult::FAILURE);
   details << "Interfaces: " << (interface_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (interface_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test connectivity
-  TestResult connectivity_result = test_connectivity();
+  TestResult connectivity_result = add_check("connectivity", test_connectivity());
   details << "Connectivity: "
           << (connectivity_result == TestResult::SUCCESS
                   ? "PASS"
@@ -114,21 +133,58 @@ TestReport NetworkingTester::short_test() {
     all_passed = false;
 
   // Test DNS resolution
-  TestResult dns_result = test_dns_resolution();
-  details << "DNS Resolution: " << (dns_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
+  TestResult dns_result = add_check("dns_resolution", test_dns_resolution());
+  details << "DNS Resolution: " << (dns_result == TestResult::SUCCESS ? "PASS" : "FAIL");
+  for (size_t i = 0; i < dns_result_.servers.size(); ++i) {
+    const auto& server = dns_result_.servers[i];
+    std::string name   = "dns" + std::to_string(i);  // Stable across resolver addresses
+    details << " (" << name << " " << server.server << " " << server.resolved << "/"
+            << server.queries << " resolved, avg " << server.avg_ms << " ms)";
+    add_metric(name + "_avg", server.avg_ms, "ms");
+  }
+  if (!dns_result_.error_message.empty()) {
+    details << " (" << dns_result_.error_message << ")";
+  }
+  details << "\n";
   if (dns_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test latency
-  TestResult latency_result = test_latency();
+  TestResult latency_result = add_check("latency", test_latency());
   details << "Latency: "
           << (latency_result == TestResult::SUCCESS
                   ? "PASS"
-                  : (latency_result == TestResult::NOT_SUPPORTED ? "N/A" : "FAIL"))
-          << "\n";
+                  : (latency_result == TestResult::NOT_SUPPORTED ? "N/A" : "FAIL"));
+  if (latency_stats_.received > 0) {
+    details << " (" << latency_stats_.host << " min/avg/p99/max " << latency_stats_.min_ms << "/"
+            << latency_stats_.avg_ms << "/" << latency_stats_.p99_ms << "/"
+            << latency_stats_.max_ms << " ms, jitter " << latency_stats_.jitter_ms << " ms, loss "
+            << latency_stats_.loss_percent << "%)";
+    add_metric("latency_min", latency_stats_.min_ms, "ms");
+    add_metric("latency_avg", latency_stats_.avg_ms, "ms");
+    add_metric("latency_p99", latency_stats_.p99_ms, "ms");
+    add_metric("latency_max", latency_stats_.max_ms, "ms");
+    add_metric("latency_jitter", latency_stats_.jitter_ms, "ms");
+    add_metric("packet_loss", latency_stats_.loss_percent, "%");
+  }
+  details << "\n";
   if (latency_result != TestResult::SUCCESS && latency_result != TestResult::NOT_SUPPORTED)
     all_passed = false;
 
+  // Test stack throughput over loopback
+  TestResult bandwidth_result = add_check("bandwidth", test_bandwidth());
+  details << "Bandwidth (loopback TCP): "
+          << (bandwidth_result == TestResult::SUCCESS ? "PASS" : "FAIL");
+  if (bandwidth_result == TestResult::SUCCESS) {
+    details << " (" << bandwidth_result_.bandwidth_mbps << " Mbps)";
+    add_metric("loopback_bandwidth", bandwidth_result_.bandwidth_mbps, "Mbps");
+  } else if (!bandwidth_result_.error_message.empty()) {
+    details << " (" << bandwidth_result_.error_message << ")";
+  }
+  details << "\n";
+  if (bandwidth_result != TestResult::SUCCESS)
+    all_passed = false;
+
   auto end_time = std::chrono::steady_clock::now();
   auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
@@ -144,209 +200,570 @@ TestReport NetworkingTester::monitor_test(std::chrono::seconds duration) {
                          std::chrono::milliseconds(0));
   }
 
-  TestResult result = monitor_connectivity(duration);
+  NetworkMonitorConfig config = monitor_config_;
+  config.duration             = duration;
+  config.cancel               = &cancellation_;
+  config.series_sink          = monitor_series_.sink();
+  NetworkMonitor monitor(config);
+  monitor_result_ = monitor.run();
+  monitor_series_ = monitor_result_.series;  // Carries the same sink
+
+  std::stringstream details;
+  bool              all_passed = monitor_result_.success;
+  details << "Samples: " << monitor_result_.sample_count << " every "
+          << config.sample_interval.count() << " ms over " << monitor_result_.elapsed_s << " s\n";
+
+  for (const auto& series : monitor_result_.interfaces) {
+    bool flapped = series.up_at_start && series.carrier_at_start && series.carrier_changes > 0;
+    bool errored = series.total_errors > 0;
+    all_passed   = all_passed && !flapped && !errored;
+
+    details << series.interface_name << ": " << (series.up_at_start ? "UP" : "DOWN")
+            << ", RX mean/peak " << series.mean_rx_bps / 1e6 << "/" << series.peak_rx_bps / 1e6
+            << " Mbps, TX mean/peak " << series.mean_tx_bps / 1e6 << "/"
+            << series.peak_tx_bps / 1e6 << " Mbps, carrier changes " << series.carrier_changes
+            << ", errors " << series.total_errors << ", drops " << series.total_dropped << " - "
+            << ((flapped || errored) ? "FAIL" : "PASS") << "\n";
+
+    // RX/TX min, mean and max come from the monitor series
+    const std::string& name = series.interface_name;
+    add_metric(name + "_carrier_changes", static_cast<double>(series.carrier_changes), "",
+               NO_LIMIT, series.up_at_start && series.carrier_at_start ? 0.0 : NO_LIMIT);
+    add_metric(name + "_errors", static_cast<double>(series.total_errors), "", NO_LIMIT, 0.0);
+    add_metric(name + "_drops", static_cast<double>(series.total_dropped), "");
+  }
+
+  if (monitor_result_.load_ran) {
+    const ThroughputResult& load = monitor_result_.load_result;
+    all_passed                  = all_passed && load.success;
+    details << "Background Load: " << load.goodput_mbps << " Mbps ("
+            << transport_protocol_to_string(config.load.protocol) << ") - "
+            << (load.success ? "PASS" : "FAIL") << "\n";
+    add_metric("load_goodput", load.goodput_mbps, "Mbps");
+    add_check("background_load", load.success ? TestResult::SUCCESS : TestResult::FAILURE);
+    if (!load.error_message.empty()) {
+      details << "Load Error: " << load.error_message << "\n";
+    }
+  }
+  if (!monitor_result_.error_message.empty()) {
+    details << "Error: " << monitor_result_.error_message << "\n";
+  }
 
   auto end_time      = std::chrono::steady_clock::now();
   auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-
-  std::string details =
-      "Network monitoring completed for " + std::to_string(duration.count()) + " seconds";
-  return create_report(result, details, test_duration);
+  return create_monitor_report(all_passed ? TestResult::SUCCESS : TestResult::FAILURE,
+                               details.str(), test_duration);
 }
 
 bool NetworkingTester::is_available() const {
   return networking_available_;
 }
 
-TestResult NetworkingTester::test_connectivity() {
-  // Test connectivity to multiple reliable hosts
-  std::vector<std::string> test_hosts = {"8.8.8.8", "1.1.1.1", "208.67.222.222"};
-
-  int successful_tests = 0;
-  for (const auto& host : test_hosts) {
-    if (ping_host(host) == TestResult::SUCCESS) {
-      successful_tests++;
+TestResult NetworkingTester::stress(uint32_t intensity, const std::atomic<bool>& stop,
+                                    StressCounters& counters) {
+  // Short transfers keep the reaction to stop well under a second
+  ThroughputConfig config;
+  config.streams  = intensity > 0 ? intensity : 1;
+  config.duration = std::chrono::milliseconds(500);
+
+  while (!stop.load(std::memory_order_relaxed)) {
+    ThroughputEngine engine(config);
+    ThroughputResult result = engine.run_loopback();
+    counters.bytes += result.bytes_received;
+    counters.operations++;
+    if (!result.success) {
+      counters.errors++;
+      // A broken stack fails instantly; do not spin on it
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
   }
-
-  // Require at least 2 successful connections
-  return (successful_tests >= 2) ? TestResult::SUCCESS : TestResult::FAILURE;
+  return counters.errors.load() == 0 ? TestResult::SUCCESS : TestResult::FAILURE;
 }
 
-TestResult NetworkingTester::test_dns_resolution() {
-  // Test DNS resolution for common domains
-  std::vector<std::string> test_domains = {"google.com", "github.com", "stackoverflow.com"};
-
-  int successful_resolutions = 0;
-  for (const auto& domain : test_domains) {
-    struct addrinfo hints, *res;
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family   = AF_INET;
-    hints.ai_socktype = SOCK_STREAM;
-
-    if (getaddrinfo(domain.c_str(), NULL, &hints, &res) == 0) {
-      freeaddrinfo(res);
-      successful_resolutions++;
-    }
+TestReport NetworkingTester::throughput_test(const ThroughputConfig& config) {
+  auto start_time = std::chrono::steady_clock::now();
+
+  ThroughputConfig run = config;
+  run.cancel           = &cancellation_;
+  ThroughputEngine engine(run);
+  ThroughputResult result = engine.run_client();
+
+  std::stringstream details;
+  details << "Target: " << config.host << ":" << config.port << " ("
+          << transport_protocol_to_string(config.protocol) << ", " << config.streams
+          << " stream(s))\n";
+  details << "Goodput: " << result.goodput_mbps << " Mbps\n";
+  details << "Transferred: " << result.bytes_received << " bytes in " << result.elapsed_s
+          << " s\n";
+  if (config.protocol == TransportProtocol::TCP) {
+    details << "Retransmits: " << result.retransmits << "\n";
+    details << "Zero-copy: " << (result.zerocopy_used ? "Yes" : "No") << "\n";
+  } else {
+    details << "Datagrams: " << result.datagrams_sent << " sent, " << result.datagrams_lost
+            << " lost\n";
+  }
+  details << "CPU Cost: " << result.cpu_s_per_gbit << " CPU-s/Gbit\n";
+  add_metric("goodput", result.goodput_mbps, "Mbps");
+  add_metric("bytes_received", static_cast<double>(result.bytes_received), "B");
+  add_metric("elapsed", result.elapsed_s, "s");
+  if (config.protocol == TransportProtocol::TCP) {
+    add_metric("retransmits", static_cast<double>(result.retransmits), "");
+  } else {
+    add_metric("datagrams_sent", static_cast<double>(result.datagrams_sent), "");
+    add_metric("datagrams_lost", static_cast<double>(result.datagrams_lost), "");
+  }
+  add_metric("cpu_cost", result.cpu_s_per_gbit, "CPU-s/Gbit");
+  if (!result.error_message.empty()) {
+    details << "Error: " << result.error_message << "\n";
   }
 
-  return (successful_resolutions >= 2) ? TestResult::SUCCESS : TestResult::FAILURE;
+  auto end_time = std::chrono::steady_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+  return create_report(result.success ? TestResult::SUCCESS : TestResult::FAILURE, details.str(),
+                       duration);
 }
 
-TestResult NetworkingTester::test_latency() {
-  // Test latency to a reliable host
-  return ping_host("8.8.8.8");
+TestReport NetworkingTester::dns_benchmark_test(const DnsBenchmarkConfig& config) {
+  auto start_time = std::chrono::steady_clock::now();
+
+  DnsBenchmark       benchmark(config);
+  DnsBenchmarkResult result = benchmark.run();
+
+  std::stringstream details;
+  details << "Names: " << config.names.size() << " x " << config.repeat << " per server\n";
+  for (size_t i = 0; i < result.servers.size(); ++i) {
+    const auto& server = result.servers[i];
+    std::string name   = "dns" + std::to_string(i);
+    details << name << " " << server.server << ": " << server.resolved << " resolved, "
+            << server.nxdomain << " NXDOMAIN, " << server.server_fail << " server failures, "
+            << server.timeouts << " timeouts, " << server.unreachable << " unreachable of "
+            << server.queries << "; min/avg/p50/p99/max " << server.min_ms << "/"
+            << server.avg_ms << "/" << server.p50_ms << "/" << server.p99_ms << "/" << server.max_ms
+            << " ms; failure rate " << server.failure_rate * 100.0 << "%\n";
+    add_metric(name + "_avg", server.avg_ms, "ms");
+    add_metric(name + "_p50", server.p50_ms, "ms");
+    add_metric(name + "_p99", server.p99_ms, "ms");
+    add_metric(name + "_failure_rate", server.failure_rate * 100.0, "%");
+  }
+  details << "Elapsed: " << result.elapsed_s << " s\n";
+  if (!result.error_message.empty()) {
+    details << "Error: " << result.error_message << "\n";
+  }
+
+  auto end_time = std::chrono::steady_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+  return create_report(result.success ? TestResult::SUCCESS : TestResult::FAILURE, details.str(),
+                       duration);
 }
 
-TestResult NetworkingTester::monitor_connectivity(std::chrono::seconds duration) {
+TestReport NetworkingTester::ethtool_test(const EthtoolTestConfig& config) {
   auto start_time = std::chrono::steady_clock::now();
-  auto end_time   = start_time + duration;
-
-  bool connectivity_stable = true;
-  int  check_count         = 0;
-  int  failure_count       = 0;
-
-  while (std::chrono::steady_clock::now() < end_time && connectivity_stable) {
-    check_count++;
-    if (test_connectivity() != TestResult::SUCCESS) {
-      failure_count++;
-      if (failure_count > 3) {  // Allow up to 3 failures
-        connectivity_stable = false;
+
+  std::string interface_name = config.interface_name;
+  if (interface_name.empty()) {
+    for (const auto& interface : interfaces_) {
+      if (interface.type == NetworkInterfaceType::ETHERNET && interface.is_up) {
+        interface_name = interface.interface_name;
+        break;
       }
     }
+  }
+  if (interface_name.empty()) {
+    return create_report(TestResult::NOT_SUPPORTED, "No Ethernet interface is up",
+                         std::chrono::milliseconds(0));
+  }
 
-    std::this_thread::sleep_for(std::chrono::seconds(10));
+  EthtoolInterface            ethtool(interface_name);
+  std::string                 driver = "unknown", bus_info;
+  std::vector<EthtoolFeature> features;
+  bool                        have_driver   = ethtool.get_driver_info(driver, bus_info);
+  bool                        have_features = ethtool.get_features(features);
+  if (!have_driver && !have_features) {
+    return create_report(TestResult::NOT_SUPPORTED,
+                         interface_name + ": ethtool not supported (" + ethtool.last_error() + ")",
+                         std::chrono::milliseconds(0));
   }
 
-  return connectivity_stable ? TestResult::SUCCESS : TestResult::FAILURE;
-}
+  std::stringstream details;
+  bool              all_passed = true;
+  details << "Interface: " << interface_name << " (driver " << driver;
+  if (!bus_info.empty()) {
+    details << ", bus " << bus_info;
+  }
+  details << ")\n";
+
+  EthtoolLinkInfo link;
+  if (ethtool.get_link_settings(link)) {
+    details << "Link: " << (link.speed_mbps > 0 ? std::to_string(link.speed_mbps) + " Mbps"
+                                                : std::string("Unknown speed"))
+            << ", " << link.duplex << " duplex, autoneg " << (link.autoneg ? "on" : "off")
+            << ", port " << link.port << "\n";
+    if (link.speed_mbps > 0) {
+      add_metric("link_speed", link.speed_mbps, "Mbps");
+    }
+  } else {
+    details << "Link: N/A (" << ethtool.last_error() << ")\n";
+  }
 
-std::vector<NetworkInterfaceInfo> NetworkingTester::enumerate_interfaces() {
-  std::vector<NetworkInterfaceInfo> interfaces;
+  EthtoolRing ring;
+  if (ethtool.get_ring(ring)) {
+    details << "Rings: RX " << ring.rx_pending << "/" << ring.rx_max << ", TX " << ring.tx_pending
+            << "/" << ring.tx_max << "\n";
+  }
+  EthtoolCoalesce coalesce;
+  if (ethtool.get_coalesce(coalesce)) {
+    details << "Coalesce: RX " << coalesce.rx_usecs << " us/" << coalesce.rx_max_frames
+            << " frames" << (coalesce.adaptive_rx ? " (adaptive)" : "") << ", TX "
+            << coalesce.tx_usecs << " us/" << coalesce.tx_max_frames << " frames"
+            << (coalesce.adaptive_tx ? " (adaptive)" : "") << "\n";
+  }
 
-  struct ifaddrs *ifaddr, *ifa;
-  if (getifaddrs(&ifaddr) == -1) {
-    return interfaces;
+  if (have_features) {
+    details << "Offloads:";
+    for (const char* name : REPORTED_OFFLOADS) {
+      for (const auto& feature : features) {
+        if (feature.name == name) {
+          details << " " << name << "=" << (feature.active ? "on" : "off")
+                  << (feature.fixed || !feature.available ? "[fixed]" : "");
+        }
+      }
+    }
+    details << "\n";
   }
 
-  for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
-    if (ifa->ifa_addr == NULL)
-      continue;
+  // Loopback traffic never reaches the NIC, so neither its counters nor its offloads would
+  // be exercised; the load needs a peer
+  if (ThroughputEngine::is_loopback_host(config.load.host)) {
+    details << "Load: N/A (needs a peer --host; traffic to " << config.load.host
+            << " does not leave the stack through " << interface_name << ")\n";
+    add_check("load", TestResult::NOT_SUPPORTED);
+    auto end_time = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    return create_report(TestResult::NOT_SUPPORTED, details.str(), duration);
+  }
 
-    // Skip loopback interface
-    if (strcmp(ifa->ifa_name, "lo") == 0)
-      continue;
+  ThroughputConfig load = config.load;
+  load.cancel           = &cancellation_;
+
+  // NIC error counters must not grow under load
+  std::vector<EthtoolStat> stats_before, stats_after;
+  bool                     have_stats = ethtool.get_stats(stats_before);
+  ThroughputResult         baseline   = ThroughputEngine(load).run_client();
+  details << "Load: " << baseline.goodput_mbps << " Mbps ("
+          << transport_protocol_to_string(config.load.protocol) << " to " << config.load.host
+          << ") - " << (baseline.success ? "PASS" : "FAIL") << "\n";
+  add_metric("load_goodput", baseline.goodput_mbps, "Mbps");
+  add_check("load", baseline.success ? TestResult::SUCCESS : TestResult::FAILURE);
+  if (!baseline.success) {
+    all_passed = false;
+    details << "Load Error: " << baseline.error_message << "\n";
+  }
 
-    NetworkInterfaceInfo interface = parse_interface_info(ifa->ifa_name);
+  if (have_stats && ethtool.get_stats(stats_after)) {
+    auto deltas = EthtoolInterface::counter_deltas(stats_before, stats_after, true);
+    details << "NIC Error Counters: " << (deltas.empty() ? "PASS" : "FAIL");
+    for (const auto& delta : deltas) {
+      details << " " << delta.name << "+" << delta.value;
+      add_metric(delta.name, static_cast<double>(delta.value), "", NO_LIMIT, 0.0);
+    }
+    details << "\n";
+    add_check("nic_error_counters", deltas.empty() ? TestResult::SUCCESS : TestResult::FAILURE);
+    all_passed = all_passed && deltas.empty();
+  } else {
+    details << "NIC Error Counters: N/A (" << ethtool.last_error() << ")\n";
+  }
 
-    // Avoid duplicates
-    bool already_added = false;
-    for (const auto& existing : interfaces) {
-      if (existing.interface_name == interface.interface_name) {
-        already_added = true;
-        break;
-      }
+  // Offload A/B: toggle one feature at a time against the baseline run
+  for (const auto& name : config.offload_ab ? config.ab_features : std::vector<std::string>()) {
+    if (cancellation_.cancelled()) {
+      break;
+    }
+    auto feature = std::find_if(features.begin(), features.end(),
+                                [&name](const EthtoolFeature& f) { return f.name == name; });
+    details << "A/B " << name << ": ";
+    if (feature == features.end()) {
+      details << "not supported\n";
+      continue;
+    }
+    if (!feature->available || feature->fixed) {
+      details << "fixed " << (feature->active ? "on" : "off") << "\n";
+      continue;
     }
 
-    if (!already_added) {
-      interfaces.push_back(interface);
+    bool original = feature->active;
+    if (!ethtool.set_feature(name, !original)) {
+      details << "cannot toggle (" << ethtool.last_error() << ")\n";
+      continue;
     }
+    ThroughputResult toggled  = ThroughputEngine(load).run_client();
+    bool             restored = ethtool.set_feature(name, original);
+
+    double on_mbps  = original ? baseline.goodput_mbps : toggled.goodput_mbps;
+    double off_mbps = original ? toggled.goodput_mbps : baseline.goodput_mbps;
+    details << "on " << on_mbps << " Mbps, off " << off_mbps << " Mbps";
+    add_metric(name + "_on", on_mbps, "Mbps");
+    add_metric(name + "_off", off_mbps, "Mbps");
+    if (off_mbps > 0) {
+      details << " (" << (on_mbps / off_mbps - 1.0) * 100.0 << "% with offload)";
+    }
+    if (!restored) {
+      all_passed = false;
+      details << " - RESTORE FAILED (" << ethtool.last_error() << ")";
+    }
+    details << "\n";
   }
 
-  freeifaddrs(ifaddr);
-  return interfaces;
+  auto end_time = std::chrono::steady_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+  return create_report(all_passed ? TestResult::SUCCESS : TestResult::FAILURE, details.str(),
+                       duration);
 }
 
-NetworkInterfaceInfo NetworkingTester::parse_interface_info(const std::string& interface_name) {
-  NetworkInterfaceInfo interface;
-  interface.interface_name = interface_name;
-  interface.is_up          = false;
-  interface.has_carrier    = false;
+TestReport NetworkingTester::ptp_test(const PtpTimestampConfig& config) {
+  auto start_time = std::chrono::steady_clock::now();
 
-  // Determine interface type
-  if (interface_name.find("eth") == 0 || interface_name.find("en") == 0) {
-    interface.type = NetworkInterfaceType::ETHERNET;
-  } else if (interface_name.find("wlan") == 0 || interface_name.find("wl") == 0) {
-    interface.type = NetworkInterfaceType::WIFI;
+  PtpTimestampProbe  probe(config);
+  PtpTimestampResult result = probe.run();
+
+  auto print_distribution = [](std::stringstream& out, const TimingDistribution& dist) {
+    out << "mean " << dist.mean_ns << " ns, stddev " << dist.stddev_ns << " ns, min/p50/p99/max "
+        << dist.min_ns << "/" << dist.p50_ns << "/" << dist.p99_ns << "/" << dist.max_ns
+        << " ns, jitter " << dist.jitter_ns << " ns (" << dist.count << " samples)\n";
+  };
+
+  auto add_distribution = [this](const std::string& name, const TimingDistribution& dist) {
+    add_metric(name + "_mean", dist.mean_ns, "ns");
+    add_metric(name + "_p99", dist.p99_ns, "ns");
+    add_metric(name + "_max", dist.max_ns, "ns");
+    add_metric(name + "_jitter", dist.jitter_ns, "ns");
+  };
+
+  std::stringstream details;
+  if (result.phc_device.empty()) {
+    details << "PHC: none\n";
   } else {
-    interface.type = NetworkInterfaceType::BLUETOOTH;
+    details << "PHC: " << result.phc_device << " (" << result.offset_method << ")\n";
+    if (result.phc_offset.count > 0) {
+      details << "PHC offset: ";
+      print_distribution(details, result.phc_offset);
+      details << "PHC read window: ";
+      print_distribution(details, result.phc_read_window);
+      add_distribution("phc_offset", result.phc_offset);
+      add_distribution("phc_read_window", result.phc_read_window);
+    }
   }
-
-  // Read interface flags
-  std::ifstream flags_file("/sys/class/net/" + interface_name + "/flags");
-  if (flags_file.is_open()) {
-    uint32_t flags;
-    flags_file >> std::hex >> flags;
-    interface.is_up = (flags & IFF_UP) != 0;
+  details << "Timestamps: " << (result.hardware_timestamps ? "hardware" : "software") << "\n";
+  details << "Frames: " << result.packets_timestamped << " of " << result.packets_sent
+          << " timestamped\n";
+  if (result.path_latency.count > 0) {
+    details << "Path latency: ";
+    print_distribution(details, result.path_latency);
+    add_distribution("path_latency", result.path_latency);
   }
-
-  // Read carrier status
-  std::ifstream carrier_file("/sys/class/net/" + interface_name + "/carrier");
-  if (carrier_file.is_open()) {
-    int carrier;
-    carrier_file >> carrier;
-    interface.has_carrier = (carrier == 1);
+  if (!result.error_message.empty()) {
+    details << "Error: " << result.error_message << "\n";
   }
 
-  // Read MAC address
-  std::ifstream address_file("/sys/class/net/" + interface_name + "/address");
-  if (address_file.is_open()) {
-    std::getline(address_file, interface.mac_address);
-  }
+  auto end_time = std::chrono::steady_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+  return create_report(result.success ? TestResult::SUCCESS : TestResult::FAILURE, details.str(),
+                       duration);
+}
 
-  // Read MTU
-  std::ifstream mtu_file("/sys/class/net/" + interface_name + "/mtu");
-  if (mtu_file.is_open()) {
-    mtu_file >> interface.mtu;
-  }
+TestReport NetworkingTester::packet_rate_test(const PacketRateConfig& config) {
+  auto start_time = std::chrono::steady_clock::now();
+
+  PacketRateConfig run_config = config;
+  select_packet_rate_interfaces(run_config);
+  PacketRateEngine engine(run_config);
+  PacketRateResult result = engine.run();
 
-  // Read statistics
-  std::ifstream rx_bytes_file("/sys/class/net/" + interface_name + "/statistics/rx_bytes");
-  if (rx_bytes_file.is_open()) {
-    rx_bytes_file >> interface.rx_bytes;
+  std::stringstream details;
+  details << "Path: " << result.tx_interface << " -> " << result.rx_interface << ", "
+          << run_config.frame_size << "-byte frames\n";
+  details << "TX backend: " << (result.tx_backend.empty() ? "none" : result.tx_backend) << "\n";
+  if (!result.xdp_error.empty() && result.tx_backend != "AF_XDP") {
+    details << "AF_XDP unavailable: " << result.xdp_error << "\n";
   }
+  details << "TX: " << result.frames_sent << " frames, " << result.tx_pps / 1000.0 << " kpps\n";
+  details << "RX: " << result.frames_received << " frames, " << result.rx_pps / 1000.0
+          << " kpps\n";
+  details << "Loss: " << result.loss_percent << "% (ring drops " << result.ring_drops
+          << ", interface drops " << result.interface_drops << ")\n";
+  add_metric("tx_rate", result.tx_pps, "pps");
+  add_metric("rx_rate", result.rx_pps, "pps");
+  add_metric("loss", result.loss_percent, "%");
+  for (const auto& core : result.cores) {
+    details << "CPU" << core.core << ": " << core.busy_percent << "% busy, "
+            << core.softirq_percent << "% softirq\n";
+    add_metric("cpu" + std::to_string(core.core) + "_busy", core.busy_percent, "%");
+  }
+  if (!result.error_message.empty()) {
+    details << "Error: " << result.error_message << "\n";
+  }
+
+  auto end_time = std::chrono::steady_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+  return create_report(result.success ? TestResult::SUCCESS : TestResult::FAILURE, details.str(),
+                       duration);
+}
+
+TestResult NetworkingTester::test_connectivity() {
+  // Probe multiple reliable hosts concurrently
+  std::vector<std::string> test_hosts = {"8.8.8.8", "1.1.1.1", "208.67.222.222"};
 
-  std::ifstream tx_bytes_file("/sys/class/net/" + interface_name + "/statistics/tx_bytes");
-  if (tx_bytes_file.is_open()) {
-    tx_bytes_file >> interface.tx_bytes;
+  ProbeConfig config;
+  config.count = 1;
+  LatencyProber prober(config);
+
+  int successful_tests = 0;
+  for (const auto& stats : prober.probe(test_hosts)) {
+    if (stats.received > 0) {
+      successful_tests++;
+    }
   }
 
-  std::ifstream rx_packets_file("/sys/class/net/" + interface_name + "/statistics/rx_packets");
-  if (rx_packets_file.is_open()) {
-    rx_packets_file >> interface.rx_packets;
+  // Require at least 2 successful connections
+  return (successful_tests >= 2) ? TestResult::SUCCESS : TestResult::FAILURE;
+}
+
+TestResult NetworkingTester::test_dns_resolution() {
+  // Resolve common domains through every configured nameserver in parallel
+  DnsBenchmarkConfig config;
+  config.names = {"google.com", "github.com", "stackoverflow.com"};
+  DnsBenchmark benchmark(config);
+
+  dns_result_ = benchmark.run();
+  return (dns_result_.resolved_names.size() >= 2) ? TestResult::SUCCESS : TestResult::FAILURE;
+}
+
+TestResult NetworkingTester::test_bandwidth() {
+  ThroughputConfig config;
+  config.protocol = TransportProtocol::TCP;
+  config.duration = std::chrono::milliseconds(1000);
+
+  ThroughputEngine engine(config);
+  ThroughputResult result = engine.run_loopback();
+
+  bandwidth_result_.protocol       = NetworkProtocol::TCP;
+  bandwidth_result_.test_passed    = result.success;
+  bandwidth_result_.latency_ms     = 0;
+  bandwidth_result_.bandwidth_mbps = static_cast<uint32_t>(result.goodput_mbps);
+  bandwidth_result_.error_message  = result.error_message;
+
+  return result.success ? TestResult::SUCCESS : TestResult::FAILURE;
+}
+
+TestResult NetworkingTester::test_latency() {
+  // Measure latency to a reliable host with a short probe train
+  ProbeConfig config;
+  config.count = 5;
+  LatencyProber prober(config);
+
+  latency_stats_ = prober.probe("8.8.8.8");
+  return (latency_stats_.received > 0) ? TestResult::SUCCESS : TestResult::FAILURE;
+}
+
+std::vector<NetworkInterfaceInfo> NetworkingTester::enumerate_interfaces() {
+  std::vector<NetworkInterfaceInfo> interfaces;
+
+  LinkStatsCollector collector;
+  LinkSnapshot       snapshot;
+  if (!collector.sample(snapshot)) {
+    return interfaces;
   }
 
-  std::ifstream tx_packets_file("/sys/class/net/" + interface_name + "/statistics/tx_packets");
-  if (tx_packets_file.is_open()) {
-    tx_packets_file >> interface.tx_packets;
+  for (const auto& link : snapshot.links) {
+    // Skip loopback interface
+    if (link.flags & IFF_LOOPBACK)
+      continue;
+    interfaces.push_back(parse_interface_info(link));
+    for (const auto& peer : snapshot.links) {
+      if (link.link_ifindex != 0 && peer.ifindex == link.link_ifindex) {
+        interfaces.back().peer_interface = peer.interface_name;
+      }
+    }
   }
 
-  // Get IP address using getifaddrs
+  // Get IP addresses using getifaddrs
   struct ifaddrs *ifaddr, *ifa;
   if (getifaddrs(&ifaddr) == 0) {
     for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
-      if (ifa->ifa_addr == NULL)
+      if (ifa->ifa_addr == NULL || ifa->ifa_addr->sa_family != AF_INET)
         continue;
-      if (strcmp(ifa->ifa_name, interface_name.c_str()) == 0) {
-        if (ifa->ifa_addr->sa_family == AF_INET) {
-          struct sockaddr_in* addr = (struct sockaddr_in*)ifa->ifa_addr;
-          char                ip_str[INET_ADDRSTRLEN];
-          inet_ntop(AF_INET, &addr->sin_addr, ip_str, INET_ADDRSTRLEN);
-          interface.ip_address = ip_str;
-
-          // Get subnet mask
-          struct sockaddr_in* netmask = (struct sockaddr_in*)ifa->ifa_netmask;
-          inet_ntop(AF_INET, &netmask->sin_addr, ip_str, INET_ADDRSTRLEN);
-          interface.subnet_mask = ip_str;
-        }
+
+      for (auto& interface : interfaces) {
+        if (interface.interface_name != ifa->ifa_name)
+          continue;
+
+        struct sockaddr_in* addr = (struct sockaddr_in*)ifa->ifa_addr;
+        char                ip_str[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &addr->sin_addr, ip_str, INET_ADDRSTRLEN);
+        interface.ip_address = ip_str;
+
+        // Get subnet mask
+        struct sockaddr_in* netmask = (struct sockaddr_in*)ifa->ifa_netmask;
+        inet_ntop(AF_INET, &netmask->sin_addr, ip_str, INET_ADDRSTRLEN);
+        interface.subnet_mask = ip_str;
       }
     }
     freeifaddrs(ifaddr);
   }
 
+  return interfaces;
+}
+
+NetworkInterfaceInfo NetworkingTester::parse_interface_info(const LinkCounters& link) {
+  NetworkInterfaceInfo interface = {};
+  interface.interface_name       = link.interface_name;
+
+  // Determine interface type
+  const std::string& interface_name = link.interface_name;
+  if (interface_name.find("eth") == 0 || interface_name.find("en") == 0) {
+    interface.type = NetworkInterfaceType::ETHERNET;
+  } else if (interface_name.find("wlan") == 0 || interface_name.find("wl") == 0) {
+    interface.type = NetworkInterfaceType::WIFI;
+  } else {
+    interface.type = NetworkInterfaceType::BLUETOOTH;
+  }
+
+  interface.is_up       = link.is_up;
+  interface.has_carrier = link.has_carrier;
+  interface.mac_address = link.mac_address;
+  interface.mtu         = link.mtu;
+
+  // 64-bit statistics from IFLA_STATS64
+  interface.rx_bytes   = link.rx_bytes;
+  interface.tx_bytes   = link.tx_bytes;
+  interface.rx_packets = link.rx_packets;
+  interface.tx_packets = link.tx_packets;
+  interface.rx_errors  = link.rx_errors;
+  interface.tx_errors  = link.tx_errors;
+  interface.rx_dropped = link.rx_dropped;
+  interface.tx_dropped = link.tx_dropped;
+  interface.link_kind  = link.kind;
+
   return interface;
 }
 
+void NetworkingTester::select_packet_rate_interfaces(PacketRateConfig& config) {
+  if (!config.tx_interface.empty()) {
+    return;
+  }
+
+  // A veth pair keeps the flood on the board; physical NICs must be named explicitly
+  for (const auto& interface : enumerate_interfaces()) {
+    if (interface.link_kind == "veth" && interface.is_up && interface.has_carrier &&
+        !interface.peer_interface.empty()) {
+      config.tx_interface = interface.interface_name;
+      config.rx_interface = interface.peer_interface;
+      return;
+    }
+  }
+  config.tx_interface = "lo";
+  config.rx_interface.clear();
+}
+
 std::string NetworkingTester::get_default_gateway() {
   std::ifstream route_file("/proc/net/route");
   if (!route_file.is_open()) {
@@ -374,10 +791,4 @@ std::string NetworkingTester::get_default_gateway() {
   return "";
 }
 
-TestResult NetworkingTester::ping_host(const std::string& host) {
-  std::string command = "ping -c 1 -W 2 " + host + " > /dev/null 2>&1";
-  int         result  = system(command.c_str());
-  return (result == 0) ? TestResult::SUCCESS : TestResult::FAILURE;
-}
-
 }  // namespace imx93_peripheral_test
\ No newline at end of file
@@ -0,0 +1,665 @@
+/**
+ * @file packet_rate_engine.cpp
+ * @brief Implementation of the small-packet (pps) stress engine.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "packet_rate_engine.h"
+
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <linux/if_xdp.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include "link_stats.h"
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr uint16_t ETH_P_PKTGEN     = 0x88b5;      // IEEE 802 local experimental ethertype
+constexpr uint32_t FRAME_MAGIC      = 0x494d5839;  // "IMX9"
+constexpr size_t   FCS_LEN          = 4;
+constexpr size_t   MIN_WIRE_SIZE    = 64;
+constexpr size_t   MAX_WIRE_SIZE    = ETH_FRAME_LEN + FCS_LEN;
+constexpr uint32_t TX_FRAME_SIZE    = 2048;  // TX ring slot and UMEM chunk size
+constexpr uint32_t TX_BLOCK_SIZE    = 1 << 16;
+constexpr uint32_t RX_BLOCK_SIZE    = 1 << 18;
+constexpr uint32_t RX_BLOCK_COUNT   = 64;
+constexpr uint32_t RX_FRAME_SIZE    = 2048;
+constexpr uint32_t RX_BLOCK_TIMEOUT = 10;  // ms before a partly filled block is retired
+constexpr auto     DRAIN_TIME       = std::chrono::milliseconds(50);
+constexpr size_t   TX_DATA_OFFSET   = TPACKET_ALIGN(sizeof(tpacket3_hdr));
+
+/**
+ * @brief Cumulative jiffies of one core from /proc/stat.
+ */
+struct CpuTimes {
+  uint64_t busy    = 0;
+  uint64_t softirq = 0;
+  uint64_t total   = 0;
+};
+
+std::vector<CpuTimes> read_cpu_times() {
+  std::vector<CpuTimes> cores;
+  std::ifstream         stat_file("/proc/stat");
+  std::string           line;
+  while (std::getline(stat_file, line)) {
+    // Per-core lines only; the aggregate "cpu " line has no index
+    if (line.compare(0, 3, "cpu") != 0 || line.size() < 4 || line[3] == ' ') {
+      continue;
+    }
+    std::istringstream iss(line);
+    std::string        label;
+    uint64_t user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0, steal = 0;
+    iss >> label >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal;
+    CpuTimes times;
+    times.busy    = user + nice + system + irq + softirq + steal;
+    times.softirq = softirq;
+    times.total   = times.busy + idle + iowait;
+    cores.push_back(times);
+  }
+  return cores;
+}
+
+void pin_current_thread(int cpu) {
+  if (cpu < 0) {
+    return;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  sched_setaffinity(0, sizeof(set), &set);
+}
+
+bool get_hw_address(const std::string& interface_name, uint8_t mac[ETH_ALEN]) {
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return false;
+  }
+  ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
+  bool ok = ioctl(fd, SIOCGIFHWADDR, &ifr) == 0;
+  close(fd);
+  if (ok) {
+    memcpy(mac, ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+  }
+  return ok;
+}
+
+uint32_t round_up_pow2(uint32_t value) {
+  uint32_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+/**
+ * @brief Common interface of the two transmit paths.
+ */
+class Transmitter {
+public:
+  virtual ~Transmitter() = default;
+
+  /**
+   * @brief Sends the prepared frame until the deadline, then flushes the ring.
+   * @return false on a hard socket error.
+   */
+  virtual bool transmit(std::chrono::steady_clock::time_point deadline, uint32_t batch,
+                        uint64_t& sent, std::string& error) = 0;
+};
+
+/**
+ * @brief AF_XDP transmitter in copy mode; needs no XDP program because it only sends.
+ */
+class XdpTransmitter : public Transmitter {
+public:
+  ~XdpTransmitter() override {
+    if (tx_map_ != MAP_FAILED) {
+      munmap(tx_map_, tx_map_size_);
+    }
+    if (cq_map_ != MAP_FAILED) {
+      munmap(cq_map_, cq_map_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+    if (umem_ != MAP_FAILED) {
+      munmap(umem_, umem_size_);
+    }
+  }
+
+  bool open(int ifindex, const std::vector<uint8_t>& frame, uint32_t frames, std::string& error) {
+    size_ = round_up_pow2(frames);
+    len_  = static_cast<uint32_t>(frame.size());
+    fd_   = socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+      return fail("socket", error);
+    }
+
+    umem_size_ = static_cast<size_t>(size_) * TX_FRAME_SIZE;
+    umem_ = mmap(nullptr, umem_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (umem_ == MAP_FAILED) {
+      return fail("mmap UMEM", error);
+    }
+    // Every chunk holds the same frame, so descriptors never need rewriting
+    for (uint32_t i = 0; i < size_; ++i) {
+      memcpy(static_cast<uint8_t*>(umem_) + static_cast<size_t>(i) * TX_FRAME_SIZE, frame.data(),
+             frame.size());
+    }
+
+    xdp_umem_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.addr       = reinterpret_cast<uint64_t>(umem_);
+    reg.len        = umem_size_;
+    reg.chunk_size = TX_FRAME_SIZE;
+    if (setsockopt(fd_, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) != 0) {
+      return fail("XDP_UMEM_REG", error);
+    }
+    // The kernel insists on a fill ring even for a TX-only socket
+    if (setsockopt(fd_, SOL_XDP, XDP_UMEM_FILL_RING, &size_, sizeof(size_)) != 0 ||
+        setsockopt(fd_, SOL_XDP, XDP_UMEM_COMPLETION_RING, &size_, sizeof(size_)) != 0 ||
+        setsockopt(fd_, SOL_XDP, XDP_TX_RING, &size_, sizeof(size_)) != 0) {
+      return fail("XDP ring setup", error);
+    }
+
+    xdp_mmap_offsets offsets;
+    socklen_t        optlen = sizeof(offsets);
+    if (getsockopt(fd_, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &optlen) != 0) {
+      return fail("XDP_MMAP_OFFSETS", error);
+    }
+    tx_map_size_ = offsets.tx.desc + size_ * sizeof(xdp_desc);
+    tx_map_      = mmap(nullptr, tx_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        fd_, XDP_PGOFF_TX_RING);
+    cq_map_size_ = offsets.cr.desc + size_ * sizeof(uint64_t);
+    cq_map_      = mmap(nullptr, cq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        fd_, XDP_UMEM_PGOFF_COMPLETION_RING);
+    if (tx_map_ == MAP_FAILED || cq_map_ == MAP_FAILED) {
+      return fail("mmap XDP rings", error);
+    }
+    auto* tx_base = static_cast<uint8_t*>(tx_map_);
+    auto* cq_base = static_cast<uint8_t*>(cq_map_);
+    tx_producer_  = reinterpret_cast<uint32_t*>(tx_base + offsets.tx.producer);
+    tx_desc_      = reinterpret_cast<xdp_desc*>(tx_base + offsets.tx.desc);
+    cq_producer_  = reinterpret_cast<uint32_t*>(cq_base + offsets.cr.producer);
+    cq_consumer_  = reinterpret_cast<uint32_t*>(cq_base + offsets.cr.consumer);
+
+    sockaddr_xdp addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sxdp_family   = AF_XDP;
+    addr.sxdp_flags    = XDP_COPY;
+    addr.sxdp_ifindex  = static_cast<uint32_t>(ifindex);
+    addr.sxdp_queue_id = 0;
+    if (bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+      return fail("bind", error);
+    }
+    return true;
+  }
+
+  bool transmit(std::chrono::steady_clock::time_point deadline, uint32_t batch, uint64_t& sent,
+                std::string& error) override {
+    const uint32_t mask        = size_ - 1;
+    uint32_t       producer    = *tx_producer_;
+    uint32_t       outstanding = 0;
+
+    auto reap = [&]() {
+      uint32_t done = __atomic_load_n(cq_producer_, __ATOMIC_ACQUIRE) - *cq_consumer_;
+      if (done > 0) {
+        __atomic_store_n(cq_consumer_, *cq_consumer_ + done, __ATOMIC_RELEASE);
+        outstanding -= done;
+        sent += done;
+      }
+    };
+
+    while (std::chrono::steady_clock::now() < deadline) {
+      reap();
+      uint32_t count = std::min(batch, size_ - outstanding);
+      for (uint32_t i = 0; i < count; ++i, ++producer) {
+        xdp_desc& desc = tx_desc_[producer & mask];
+        desc.addr      = static_cast<uint64_t>(producer & mask) * TX_FRAME_SIZE;
+        desc.len       = len_;
+        desc.options   = 0;
+      }
+      __atomic_store_n(tx_producer_, producer, __ATOMIC_RELEASE);
+      outstanding += count;
+
+      // Copy mode transmits from the sendto() kick
+      if (sendto(fd_, nullptr, 0, MSG_DONTWAIT, nullptr, 0) < 0 && errno != EAGAIN &&
+          errno != EBUSY && errno != ENOBUFS) {
+        error = std::string("AF_XDP sendto: ") + strerror(errno);
+        return false;
+      }
+    }
+
+    auto drain_deadline = std::chrono::steady_clock::now() + DRAIN_TIME;
+    while (outstanding > 0 && std::chrono::steady_clock::now() < drain_deadline) {
+      sendto(fd_, nullptr, 0, MSG_DONTWAIT, nullptr, 0);
+      reap();
+    }
+    return true;
+  }
+
+private:
+  bool fail(const char* what, std::string& error) {
+    error = std::string(what) + ": " + strerror(errno);
+    return false;
+  }
+
+  int       fd_          = -1;
+  void*     umem_        = MAP_FAILED;
+  size_t    umem_size_   = 0;
+  void*     tx_map_      = MAP_FAILED;
+  size_t    tx_map_size_ = 0;
+  void*     cq_map_      = MAP_FAILED;
+  size_t    cq_map_size_ = 0;
+  uint32_t  size_        = 0;
+  uint32_t  len_         = 0;
+  uint32_t* tx_producer_ = nullptr;
+  xdp_desc* tx_desc_     = nullptr;
+  uint32_t* cq_producer_ = nullptr;
+  uint32_t* cq_consumer_ = nullptr;
+};
+
+/**
+ * @brief AF_PACKET transmitter over a TPACKET_V3 PACKET_TX_RING.
+ */
+class TpacketTransmitter : public Transmitter {
+public:
+  ~TpacketTransmitter() override {
+    if (ring_ != MAP_FAILED) {
+      munmap(ring_, ring_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  bool open(int ifindex, const std::vector<uint8_t>& frame, uint32_t frames, std::string& error) {
+    len_ = static_cast<uint32_t>(frame.size());
+    // Protocol 0: the socket only transmits and never queues received frames
+    fd_ = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+      return fail("socket", error);
+    }
+    int version = TPACKET_V3;
+    if (setsockopt(fd_, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) {
+      return fail("PACKET_VERSION", error);
+    }
+    // Skipping the qdisc is what a pps generator wants; not fatal if refused
+    int one = 1;
+    setsockopt(fd_, SOL_PACKET, PACKET_QDISC_BYPASS, &one, sizeof(one));
+
+    tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+    uint32_t per_block = TX_BLOCK_SIZE / TX_FRAME_SIZE;
+    req.tp_block_size  = TX_BLOCK_SIZE;
+    req.tp_block_nr    = std::max<uint32_t>(1, (frames + per_block - 1) / per_block);
+    req.tp_frame_size  = TX_FRAME_SIZE;
+    req.tp_frame_nr    = req.tp_block_nr * per_block;
+    if (setsockopt(fd_, SOL_PACKET, PACKET_TX_RING, &req, sizeof(req)) != 0) {
+      return fail("PACKET_TX_RING", error);
+    }
+    frame_count_ = req.tp_frame_nr;
+    ring_size_   = static_cast<size_t>(req.tp_block_size) * req.tp_block_nr;
+    ring_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, 0);
+    if (ring_ == MAP_FAILED) {
+      return fail("mmap TX ring", error);
+    }
+    for (uint32_t i = 0; i < frame_count_; ++i) {
+      memcpy(slot(i) + TX_DATA_OFFSET, frame.data(), frame.size());
+    }
+
+    memset(&dest_, 0, sizeof(dest_));
+    dest_.sll_family   = AF_PACKET;
+    dest_.sll_protocol = htons(ETH_P_PKTGEN);
+    dest_.sll_ifindex  = ifindex;
+    dest_.sll_halen    = ETH_ALEN;
+    memcpy(dest_.sll_addr, frame.data(), ETH_ALEN);
+    return true;
+  }
+
+  bool transmit(std::chrono::steady_clock::time_point deadline, uint32_t batch, uint64_t& sent,
+                std::string& error) override {
+    uint32_t index  = 0;
+    uint32_t queued = 0;
+    while (std::chrono::steady_clock::now() < deadline) {
+      auto*    header = reinterpret_cast<tpacket3_hdr*>(slot(index));
+      uint32_t status = __atomic_load_n(&header->tp_status, __ATOMIC_ACQUIRE);
+      if (status & TP_STATUS_WRONG_FORMAT) {
+        error = "TX ring frame rejected (TP_STATUS_WRONG_FORMAT)";
+        return false;
+      }
+      if (status != TP_STATUS_AVAILABLE) {
+        // Ring full: a blocking flush waits for the kernel to drain it
+        if (!flush(0, sent, error)) {
+          return false;
+        }
+        queued = 0;
+        continue;
+      }
+      header->tp_len         = len_;
+      header->tp_next_offset = 0;
+      __atomic_store_n(&header->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+      index = (index + 1) % frame_count_;
+      if (++queued >= batch) {
+        if (!flush(MSG_DONTWAIT, sent, error)) {
+          return false;
+        }
+        queued = 0;
+      }
+    }
+    return flush(0, sent, error);
+  }
+
+private:
+  uint8_t* slot(uint32_t index) {
+    return static_cast<uint8_t*>(ring_) + static_cast<size_t>(index) * TX_FRAME_SIZE;
+  }
+
+  bool flush(int flags, uint64_t& sent, std::string& error) {
+    ssize_t bytes = sendto(fd_, nullptr, 0, flags, reinterpret_cast<sockaddr*>(&dest_),
+                           sizeof(dest_));
+    if (bytes > 0) {
+      sent += static_cast<uint64_t>(bytes) / len_;
+      return true;
+    }
+    if (bytes < 0 && errno != EAGAIN && errno != ENOBUFS && errno != EINTR) {
+      error = std::string("PACKET_TX_RING send: ") + strerror(errno);
+      return false;
+    }
+    return true;
+  }
+
+  bool fail(const char* what, std::string& error) {
+    error = std::string(what) + ": " + strerror(errno);
+    return false;
+  }
+
+  int         fd_          = -1;
+  void*       ring_        = MAP_FAILED;
+  size_t      ring_size_   = 0;
+  uint32_t    frame_count_ = 0;
+  uint32_t    len_         = 0;
+  sockaddr_ll dest_;
+};
+
+/**
+ * @brief AF_PACKET receiver over a TPACKET_V3 RX block ring.
+ */
+class TpacketReceiver {
+public:
+  ~TpacketReceiver() {
+    if (ring_ != MAP_FAILED) {
+      munmap(ring_, ring_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  bool open(int ifindex, std::string& error) {
+    fd_ = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons(ETH_P_PKTGEN));
+    if (fd_ < 0) {
+      return fail("socket", error);
+    }
+    int version = TPACKET_V3;
+    if (setsockopt(fd_, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) {
+      return fail("PACKET_VERSION", error);
+    }
+    // Frames sent on the same interface (lo) would otherwise be seen twice
+    int one = 1;
+    setsockopt(fd_, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one));
+
+    tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size     = RX_BLOCK_SIZE;
+    req.tp_block_nr       = RX_BLOCK_COUNT;
+    req.tp_frame_size     = RX_FRAME_SIZE;
+    req.tp_frame_nr       = RX_BLOCK_SIZE / RX_FRAME_SIZE * RX_BLOCK_COUNT;
+    req.tp_retire_blk_tov = RX_BLOCK_TIMEOUT;
+    if (setsockopt(fd_, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) != 0) {
+      return fail("PACKET_RX_RING", error);
+    }
+    ring_size_ = static_cast<size_t>(RX_BLOCK_SIZE) * RX_BLOCK_COUNT;
+    ring_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, 0);
+    if (ring_ == MAP_FAILED) {
+      return fail("mmap RX ring", error);
+    }
+
+    sockaddr_ll addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family   = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_PKTGEN);
+    addr.sll_ifindex  = ifindex;
+    if (bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+      return fail("bind", error);
+    }
+    // PACKET_STATISTICS clears on read; start counting drops from here
+    tpacket_stats_v3 stats;
+    socklen_t        optlen = sizeof(stats);
+    getsockopt(fd_, SOL_PACKET, PACKET_STATISTICS, &stats, &optlen);
+    return true;
+  }
+
+  /**
+   * @brief Consumes ready blocks until stop is set and no block is ready.
+   */
+  void receive(const std::atomic<bool>& stop, std::atomic<uint64_t>& received) {
+    uint32_t block = 0;
+    while (true) {
+      uint8_t* base   = static_cast<uint8_t*>(ring_) + static_cast<size_t>(block) * RX_BLOCK_SIZE;
+      auto*    desc   = reinterpret_cast<tpacket_block_desc*>(base);
+      uint32_t status = __atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE);
+      if ((status & TP_STATUS_USER) == 0) {
+        if (stop.load()) {
+          break;
+        }
+        pollfd pfd{fd_, POLLIN | POLLERR, 0};
+        poll(&pfd, 1, static_cast<int>(RX_BLOCK_TIMEOUT));
+        continue;
+      }
+
+      uint64_t count  = 0;
+      auto*    packet = reinterpret_cast<tpacket3_hdr*>(reinterpret_cast<uint8_t*>(desc) +
+                                                     desc->hdr.bh1.offset_to_first_pkt);
+      for (uint32_t i = 0; i < desc->hdr.bh1.num_pkts; ++i) {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(packet) + packet->tp_mac;
+        uint32_t       magic;
+        if (packet->tp_snaplen >= ETH_HLEN + sizeof(magic)) {
+          memcpy(&magic, data + ETH_HLEN, sizeof(magic));
+          count += magic == FRAME_MAGIC;
+        }
+        packet = reinterpret_cast<tpacket3_hdr*>(reinterpret_cast<uint8_t*>(packet) +
+                                                 packet->tp_next_offset);
+      }
+      received.fetch_add(count, std::memory_order_relaxed);
+      __atomic_store_n(&desc->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+      block = (block + 1) % RX_BLOCK_COUNT;
+    }
+  }
+
+  /**
+   * @brief Returns the frames dropped because the ring was full.
+   */
+  uint64_t drops() {
+    tpacket_stats_v3 stats;
+    memset(&stats, 0, sizeof(stats));
+    socklen_t optlen = sizeof(stats);
+    getsockopt(fd_, SOL_PACKET, PACKET_STATISTICS, &stats, &optlen);
+    return stats.tp_drops;
+  }
+
+private:
+  bool fail(const char* what, std::string& error) {
+    error = std::string(what) + ": " + strerror(errno);
+    return false;
+  }
+
+  int    fd_        = -1;
+  void*  ring_      = MAP_FAILED;
+  size_t ring_size_ = 0;
+};
+
+uint64_t drop_counters(const LinkSnapshot& snapshot, const std::string& tx, const std::string& rx) {
+  uint64_t total = 0;
+  if (const LinkCounters* link = snapshot.find(tx)) {
+    total += link->tx_dropped + link->rx_dropped;
+  }
+  if (rx != tx) {
+    if (const LinkCounters* link = snapshot.find(rx)) {
+      total += link->tx_dropped + link->rx_dropped;
+    }
+  }
+  return total;
+}
+
+}  // namespace
+
+PacketRateEngine::PacketRateEngine(const PacketRateConfig& config) : config_(config) {}
+
+PacketRateResult PacketRateEngine::run() {
+  PacketRateResult result;
+  result.tx_interface = config_.tx_interface;
+  result.rx_interface = config_.rx_interface.empty() ? config_.tx_interface : config_.rx_interface;
+
+  int tx_index = static_cast<int>(if_nametoindex(result.tx_interface.c_str()));
+  int rx_index = static_cast<int>(if_nametoindex(result.rx_interface.c_str()));
+  if (tx_index == 0 || rx_index == 0) {
+    result.error_message = "Unknown interface";
+    return result;
+  }
+  if (config_.frame_size < MIN_WIRE_SIZE || config_.frame_size > MAX_WIRE_SIZE) {
+    result.error_message = "Frame size must be between 64 and 1518 bytes";
+    return result;
+  }
+
+  // Unicast to the receiving interface so a NIC behind a loopback cable accepts it
+  std::vector<uint8_t> frame(config_.frame_size - FCS_LEN, 0);
+  ether_header*        eth = reinterpret_cast<ether_header*>(frame.data());
+  get_hw_address(result.rx_interface, eth->ether_dhost);
+  get_hw_address(result.tx_interface, eth->ether_shost);
+  eth->ether_type = htons(ETH_P_PKTGEN);
+  memcpy(frame.data() + ETH_HLEN, &FRAME_MAGIC, sizeof(FRAME_MAGIC));
+
+  TpacketReceiver receiver;
+  if (!receiver.open(rx_index, result.error_message)) {
+    result.error_message = "RX ring: " + result.error_message;
+    return result;
+  }
+
+  std::unique_ptr<Transmitter> transmitter;
+  if (config_.backend != PacketTxBackend::TPACKET) {
+    auto xdp = std::make_unique<XdpTransmitter>();
+    if (xdp->open(tx_index, frame, config_.ring_frames, result.xdp_error)) {
+      transmitter       = std::move(xdp);
+      result.tx_backend = "AF_XDP";
+    } else if (config_.backend == PacketTxBackend::XDP) {
+      result.error_message = "AF_XDP: " + result.xdp_error;
+      return result;
+    }
+  }
+  if (!transmitter) {
+    auto tpacket = std::make_unique<TpacketTransmitter>();
+    if (!tpacket->open(tx_index, frame, config_.ring_frames, result.error_message)) {
+      result.error_message = "TX ring: " + result.error_message;
+      return result;
+    }
+    transmitter       = std::move(tpacket);
+    result.tx_backend = "TPACKET_V3";
+  }
+
+  LinkStatsCollector    collector;
+  LinkSnapshot          links_before, links_after;
+  bool                  have_links = collector.sample(links_before);
+  std::vector<CpuTimes> cpu_before = read_cpu_times();
+
+  std::atomic<bool>     stop_rx(false);
+  std::atomic<uint64_t> received(0);
+  std::thread           rx_thread([&]() {
+    pin_current_thread(config_.rx_cpu);
+    receiver.receive(stop_rx, received);
+  });
+
+  uint64_t    sent = 0;
+  bool        tx_ok = true;
+  std::string tx_error;
+  auto        start_time = std::chrono::steady_clock::now();
+  auto        end_time   = start_time;
+  std::thread tx_thread([&]() {
+    pin_current_thread(config_.tx_cpu);
+    tx_ok    = transmitter->transmit(start_time + config_.duration,
+                                     std::max<uint32_t>(config_.tx_batch, 1), sent, tx_error);
+    end_time = std::chrono::steady_clock::now();
+  });
+  tx_thread.join();
+
+  std::this_thread::sleep_for(DRAIN_TIME);
+  stop_rx.store(true);
+  rx_thread.join();
+
+  std::vector<CpuTimes> cpu_after = read_cpu_times();
+  have_links = have_links && collector.sample(links_after);
+
+  result.elapsed_s       = std::chrono::duration<double>(end_time - start_time).count();
+  result.frames_sent     = sent;
+  result.frames_received = received.load();
+  result.ring_drops      = receiver.drops();
+  if (have_links) {
+    uint64_t before        = drop_counters(links_before, result.tx_interface, result.rx_interface);
+    uint64_t after         = drop_counters(links_after, result.tx_interface, result.rx_interface);
+    result.interface_drops = after >= before ? after - before : 0;
+  }
+  if (result.elapsed_s > 0.0) {
+    result.tx_pps = result.frames_sent / result.elapsed_s;
+    result.rx_pps = result.frames_received / result.elapsed_s;
+  }
+  if (result.frames_sent > 0) {
+    uint64_t lost       = result.frames_sent > result.frames_received
+                              ? result.frames_sent - result.frames_received
+                              : 0;
+    result.loss_percent = 100.0 * lost / result.frames_sent;
+  }
+
+  for (size_t core = 0; core < std::min(cpu_before.size(), cpu_after.size()); ++core) {
+    uint64_t total = cpu_after[core].total - cpu_before[core].total;
+    if (total == 0) {
+      continue;
+    }
+    CoreUtilisation usage;
+    usage.core            = static_cast<int>(core);
+    usage.busy_percent    = 100.0 * (cpu_after[core].busy - cpu_before[core].busy) / total;
+    usage.softirq_percent = 100.0 * (cpu_after[core].softirq - cpu_before[core].softirq) / total;
+    result.cores.push_back(usage);
+  }
+
+  if (!tx_ok) {
+    result.error_message = tx_error;
+  } else if (result.frames_sent == 0) {
+    result.error_message = "No frames transmitted";
+  } else if (result.frames_received == 0) {
+    result.error_message = "No frames received on " + result.rx_interface;
+  }
+  result.success = result.error_message.empty();
+  return result;
+}
+
+}  // namespace imx93_peripheral_test
@@ -0,0 +1,512 @@
+/**
+ * @file ptp_timestamp.cpp
+ * @brief Implementation of the TSN/PTP timestamp accuracy probe.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "ptp_timestamp.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/errqueue.h>
+#include <linux/if_packet.h>
+#include <linux/net_tstamp.h>
+#include <linux/ptp_clock.h>
+#include <linux/sockios.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "ethtool_interface.h"
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr uint32_t FRAME_MAGIC       = 0x494d5839;  // "IMX9"
+constexpr size_t   MIN_FRAME_SIZE    = 60;          // Ethernet minimum without FCS
+constexpr int      TIMESTAMP_WAIT_MS = 100;
+
+// IEEE 1588 "all except peer delay" multicast address
+const uint8_t PTP_MULTICAST[ETH_ALEN] = {0x01, 0x1b, 0x19, 0x00, 0x00, 0x00};
+
+int64_t to_ns(const timespec& ts) {
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+int64_t to_ns(const ptp_clock_time& ts) {
+  return static_cast<int64_t>(ts.sec) * 1000000000LL + ts.nsec;
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+  size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+/**
+ * @brief Enables hardware timestamping on an interface and restores the
+ *        previous configuration when destroyed.
+ */
+class HwTimestampGuard {
+public:
+  explicit HwTimestampGuard(const std::string& interface_name)
+      : fd_(socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0)), saved_valid_(false), enabled_(false) {
+    memset(&ifr_, 0, sizeof(ifr_));
+    strncpy(ifr_.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
+    memset(&saved_, 0, sizeof(saved_));
+  }
+
+  ~HwTimestampGuard() {
+    if (enabled_ && saved_valid_) {
+      ifr_.ifr_data = reinterpret_cast<char*>(&saved_);
+      ioctl(fd_, SIOCSHWTSTAMP, &ifr_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  HwTimestampGuard(const HwTimestampGuard&)            = delete;
+  HwTimestampGuard& operator=(const HwTimestampGuard&) = delete;
+
+  bool enable(std::string& error) {
+    if (fd_ < 0) {
+      error = std::string("socket: ") + strerror(errno);
+      return false;
+    }
+    ifr_.ifr_data = reinterpret_cast<char*>(&saved_);
+    saved_valid_  = ioctl(fd_, SIOCGHWTSTAMP, &ifr_) == 0;
+
+    hwtstamp_config config;
+    memset(&config, 0, sizeof(config));
+    config.tx_type   = HWTSTAMP_TX_ON;
+    config.rx_filter = HWTSTAMP_FILTER_ALL;
+    ifr_.ifr_data    = reinterpret_cast<char*>(&config);
+    if (ioctl(fd_, SIOCSHWTSTAMP, &ifr_) != 0) {
+      error = std::string("SIOCSHWTSTAMP: ") + strerror(errno);
+      return false;
+    }
+    // Drivers may upgrade the filter (e.g. to PTP_V2_EVENT); anything but NONE is usable
+    enabled_ = config.tx_type == HWTSTAMP_TX_ON && config.rx_filter != HWTSTAMP_FILTER_NONE;
+    if (!enabled_) {
+      error = "driver rejected TX/RX hardware timestamping";
+    }
+    return enabled_;
+  }
+
+private:
+  int             fd_;
+  ifreq           ifr_;
+  hwtstamp_config saved_;
+  bool            saved_valid_;
+  bool            enabled_;
+};
+
+/**
+ * @brief Extracts the timestamp of a received or errqueue message.
+ * @return true if a usable timestamp of the requested kind was found.
+ */
+bool extract_timestamp(msghdr& msg, bool hardware, int64_t& ns) {
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING) {
+      continue;
+    }
+    scm_timestamping ts;
+    memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+    // ts[0] is the software timestamp, ts[2] the raw hardware one
+    const timespec& chosen = hardware ? ts.ts[2] : ts.ts[0];
+    if (chosen.tv_sec == 0 && chosen.tv_nsec == 0) {
+      return false;
+    }
+    ns = to_ns(chosen);
+    return true;
+  }
+  return false;
+}
+
+bool wait_readable(int fd, short events) {
+  pollfd pfd{fd, events, 0};
+  return poll(&pfd, 1, TIMESTAMP_WAIT_MS) > 0;
+}
+
+/**
+ * @brief Reads the TX timestamp of the last sent frame from the error queue.
+ */
+bool read_tx_timestamp(int fd, bool hardware, int64_t& ns) {
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    char    control[256];
+    uint8_t data[64];
+    iovec   iov{data, sizeof(data)};
+    msghdr  msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+    if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) >= 0) {
+      return extract_timestamp(msg, hardware, ns);
+    }
+    if (errno != EAGAIN || attempt > 0) {
+      return false;
+    }
+    // POLLERR is always reported; requesting no events waits for the errqueue only
+    wait_readable(fd, 0);
+  }
+  return false;
+}
+
+/**
+ * @brief Receives frames until the one carrying the given sequence number arrives.
+ */
+bool read_rx_timestamp(int fd, uint32_t sequence, bool hardware, int64_t& ns) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TIMESTAMP_WAIT_MS);
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (!wait_readable(fd, POLLIN)) {
+      return false;
+    }
+    char        control[256];
+    uint8_t     frame[ETH_FRAME_LEN];
+    iovec       iov{frame, sizeof(frame)};
+    sockaddr_ll from;
+    msghdr      msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name       = &from;
+    msg.msg_namelen    = sizeof(from);
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t len        = recvmsg(fd, &msg, MSG_DONTWAIT);
+    if (len < static_cast<ssize_t>(ETH_HLEN + 8) || from.sll_pkttype == PACKET_OUTGOING) {
+      continue;
+    }
+    uint32_t magic, seq;
+    memcpy(&magic, frame + ETH_HLEN, sizeof(magic));
+    memcpy(&seq, frame + ETH_HLEN + 4, sizeof(seq));
+    if (magic == FRAME_MAGIC && seq == sequence) {
+      return extract_timestamp(msg, hardware, ns);
+    }
+  }
+  return false;
+}
+
+int open_packet_socket(uint16_t protocol, int ifindex) {
+  int fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons(protocol));
+  if (fd < 0) {
+    return -1;
+  }
+  sockaddr_ll addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sll_family   = AF_PACKET;
+  addr.sll_protocol = htons(protocol);
+  addr.sll_ifindex  = ifindex;
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+bool get_hw_address(const std::string& interface_name, uint8_t mac[ETH_ALEN]) {
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return false;
+  }
+  ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
+  bool ok = ioctl(fd, SIOCGIFHWADDR, &ifr) == 0;
+  close(fd);
+  if (ok) {
+    memcpy(mac, ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+  }
+  return ok;
+}
+
+}  // namespace
+
+TimingDistribution TimingDistribution::from_samples(const std::vector<double>& values) {
+  TimingDistribution dist;
+  if (values.empty()) {
+    return dist;
+  }
+  dist.count = static_cast<uint32_t>(values.size());
+
+  double sum = 0.0;
+  for (double v : values) {
+    sum += v;
+  }
+  dist.mean_ns = sum / values.size();
+
+  double variance = 0.0;
+  double jitter   = 0.0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    variance += (values[i] - dist.mean_ns) * (values[i] - dist.mean_ns);
+    if (i > 0) {
+      jitter += std::fabs(values[i] - values[i - 1]);
+    }
+  }
+  dist.stddev_ns = std::sqrt(variance / values.size());
+  dist.jitter_ns = values.size() > 1 ? jitter / (values.size() - 1) : 0.0;
+
+  std::vector<double> sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+  dist.min_ns = sorted.front();
+  dist.max_ns = sorted.back();
+  dist.p50_ns = percentile(sorted, 0.50);
+  dist.p99_ns = percentile(sorted, 0.99);
+  return dist;
+}
+
+PtpTimestampProbe::PtpTimestampProbe(const PtpTimestampConfig& config) : config_(config) {}
+
+PtpTimestampResult PtpTimestampProbe::run() {
+  PtpTimestampResult result;
+  if (config_.rx_interface.empty()) {
+    config_.rx_interface = config_.tx_interface;
+  }
+  if (if_nametoindex(config_.tx_interface.c_str()) == 0 ||
+      if_nametoindex(config_.rx_interface.c_str()) == 0) {
+    result.error_message = "Unknown interface";
+    return result;
+  }
+
+  EthtoolInterface ethtool(config_.tx_interface);
+  EthtoolTsInfo    ts_info;
+  bool             have_ts_info = ethtool.get_timestamping_info(ts_info);
+  result.phc_device             = config_.ptp_device;
+  if (result.phc_device.empty() && have_ts_info && ts_info.phc_index >= 0) {
+    result.phc_device = "/dev/ptp" + std::to_string(ts_info.phc_index);
+  }
+  if (!result.phc_device.empty() && !sample_phc_offset(result.phc_device, result)) {
+    return result;
+  }
+
+  // Hardware timestamps need a PHC and both TX and RX hardware support
+  const uint32_t hw_flags = SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RX_HARDWARE |
+                            SOF_TIMESTAMPING_RAW_HARDWARE;
+  bool hw_capable = have_ts_info && ts_info.phc_index >= 0 &&
+                    (ts_info.so_timestamping & hw_flags) == hw_flags;
+
+  std::string hw_error;
+  if (hw_capable) {
+    HwTimestampGuard tx_guard(config_.tx_interface);
+    HwTimestampGuard rx_guard(config_.rx_interface);
+    bool enabled = tx_guard.enable(hw_error) &&
+                   (config_.rx_interface == config_.tx_interface || rx_guard.enable(hw_error));
+    if (enabled && exchange_frames(true, result)) {
+      result.hardware_timestamps = true;
+    } else if (hw_error.empty()) {
+      hw_error = result.error_message.empty() ? "no hardware timestamps received"
+                                              : result.error_message;
+    }
+  } else {
+    hw_error = "no hardware timestamping support";
+  }
+
+  if (!result.hardware_timestamps) {
+    if (!config_.allow_software) {
+      result.error_message = "Hardware timestamping unavailable: " + hw_error;
+      return result;
+    }
+    result.error_message.clear();
+    if (!exchange_frames(false, result)) {
+      return result;
+    }
+  }
+
+  // A few frames may be lost to unrelated traffic filling the poll window
+  result.success = result.packets_timestamped * 10 >= result.packets_sent * 9;
+  if (!result.success) {
+    result.error_message = "Only " + std::to_string(result.packets_timestamped) + " of " +
+                           std::to_string(result.packets_sent) + " frames timestamped";
+  }
+  return result;
+}
+
+bool PtpTimestampProbe::sample_phc_offset(const std::string& device, PtpTimestampResult& result) {
+  int fd = open(device.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    result.error_message = "Cannot open " + device + ": " + strerror(errno);
+    return false;
+  }
+
+  std::vector<double> offsets;
+  std::vector<double> windows;
+  for (uint32_t i = 0; i < config_.offset_samples; ++i) {
+    if (i > 0) {
+      std::this_thread::sleep_for(config_.interval);
+    }
+
+    // Hardware cross-timestamp: the PHC and system time are latched together
+    if (result.offset_method == "none" || result.offset_method == "PRECISE") {
+      ptp_sys_offset_precise precise;
+      memset(&precise, 0, sizeof(precise));
+      if (ioctl(fd, PTP_SYS_OFFSET_PRECISE, &precise) == 0) {
+        result.offset_method = "PRECISE";
+        offsets.push_back(
+            static_cast<double>(to_ns(precise.device) - to_ns(precise.sys_realtime)));
+        windows.push_back(0.0);
+        continue;
+      }
+    }
+
+    // Driver-side bracketing of each PHC read; keep the tightest bracket
+    if (result.offset_method == "none" || result.offset_method == "EXTENDED") {
+      ptp_sys_offset_extended extended;
+      memset(&extended, 0, sizeof(extended));
+      extended.n_samples = 5;
+      if (ioctl(fd, PTP_SYS_OFFSET_EXTENDED, &extended) == 0) {
+        result.offset_method = "EXTENDED";
+        int64_t best_window  = std::numeric_limits<int64_t>::max();
+        int64_t best_offset  = 0;
+        for (unsigned int s = 0; s < extended.n_samples; ++s) {
+          int64_t before = to_ns(extended.ts[s][0]);
+          int64_t phc    = to_ns(extended.ts[s][1]);
+          int64_t after  = to_ns(extended.ts[s][2]);
+          if (after - before < best_window) {
+            best_window = after - before;
+            best_offset = phc - (before + (after - before) / 2);
+          }
+        }
+        offsets.push_back(static_cast<double>(best_offset));
+        windows.push_back(static_cast<double>(best_window));
+        continue;
+      }
+    }
+
+    // Basic interleaved system/PHC/system reads
+    ptp_sys_offset basic;
+    memset(&basic, 0, sizeof(basic));
+    basic.n_samples = 5;
+    if (ioctl(fd, PTP_SYS_OFFSET, &basic) != 0) {
+      break;
+    }
+    result.offset_method = "BASIC";
+    int64_t best_window  = std::numeric_limits<int64_t>::max();
+    int64_t best_offset  = 0;
+    for (unsigned int s = 0; s < basic.n_samples; ++s) {
+      int64_t before = to_ns(basic.ts[2 * s]);
+      int64_t phc    = to_ns(basic.ts[2 * s + 1]);
+      int64_t after  = to_ns(basic.ts[2 * s + 2]);
+      if (after - before < best_window) {
+        best_window = after - before;
+        best_offset = phc - (before + (after - before) / 2);
+      }
+    }
+    offsets.push_back(static_cast<double>(best_offset));
+    windows.push_back(static_cast<double>(best_window));
+  }
+  int saved_errno = errno;
+  close(fd);
+
+  if (offsets.empty()) {
+    result.offset_method = "none";
+    result.error_message = "PHC offset ioctls failed on " + device + ": " + strerror(saved_errno);
+    return false;
+  }
+  result.phc_offset      = TimingDistribution::from_samples(offsets);
+  result.phc_read_window = TimingDistribution::from_samples(windows);
+  return true;
+}
+
+bool PtpTimestampProbe::exchange_frames(bool hardware, PtpTimestampResult& result) {
+  result.packets_sent        = 0;
+  result.packets_timestamped = 0;
+  result.path_latency        = TimingDistribution();
+
+  int tx_index = static_cast<int>(if_nametoindex(config_.tx_interface.c_str()));
+  int rx_index = static_cast<int>(if_nametoindex(config_.rx_interface.c_str()));
+  // Protocol 0 keeps the TX socket from receiving its own frames
+  int tx_fd = open_packet_socket(0, tx_index);
+  int rx_fd = open_packet_socket(ETH_P_1588, rx_index);
+  if (tx_fd < 0 || rx_fd < 0) {
+    result.error_message = std::string("AF_PACKET socket: ") + strerror(errno);
+    if (tx_fd >= 0) {
+      close(tx_fd);
+    }
+    if (rx_fd >= 0) {
+      close(rx_fd);
+    }
+    return false;
+  }
+
+  uint32_t flags = SOF_TIMESTAMPING_OPT_TSONLY;
+  flags |= hardware ? SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE
+                    : SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+  uint32_t rx_flags = hardware ? SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE
+                               : SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+  int ignore_outgoing = 1;
+  // PACKET_IGNORE_OUTGOING is an optimisation; PACKET_OUTGOING frames are also filtered on read
+  setsockopt(rx_fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &ignore_outgoing, sizeof(ignore_outgoing));
+  if (setsockopt(tx_fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) != 0 ||
+      setsockopt(rx_fd, SOL_SOCKET, SO_TIMESTAMPING, &rx_flags, sizeof(rx_flags)) != 0) {
+    result.error_message = std::string("SO_TIMESTAMPING: ") + strerror(errno);
+    close(tx_fd);
+    close(rx_fd);
+    return false;
+  }
+
+  uint8_t frame[MIN_FRAME_SIZE];
+  memset(frame, 0, sizeof(frame));
+  ether_header* eth = reinterpret_cast<ether_header*>(frame);
+  memcpy(eth->ether_dhost, PTP_MULTICAST, ETH_ALEN);
+  if (!get_hw_address(config_.tx_interface, eth->ether_shost)) {
+    memset(eth->ether_shost, 0, ETH_ALEN);
+  }
+  eth->ether_type = htons(ETH_P_1588);
+  memcpy(frame + ETH_HLEN, &FRAME_MAGIC, sizeof(FRAME_MAGIC));
+
+  sockaddr_ll dest;
+  memset(&dest, 0, sizeof(dest));
+  dest.sll_family  = AF_PACKET;
+  dest.sll_ifindex = tx_index;
+  dest.sll_halen   = ETH_ALEN;
+  memcpy(dest.sll_addr, PTP_MULTICAST, ETH_ALEN);
+
+  std::vector<double> latencies;
+  latencies.reserve(config_.packets);
+  for (uint32_t seq = 0; seq < config_.packets; ++seq) {
+    if (seq > 0) {
+      std::this_thread::sleep_for(config_.interval);
+    }
+    memcpy(frame + ETH_HLEN + 4, &seq, sizeof(seq));
+    if (sendto(tx_fd, frame, sizeof(frame), 0, reinterpret_cast<sockaddr*>(&dest),
+               sizeof(dest)) != static_cast<ssize_t>(sizeof(frame))) {
+      result.error_message = std::string("sendto: ") + strerror(errno);
+      break;
+    }
+    ++result.packets_sent;
+
+    int64_t rx_ns = 0;
+    int64_t tx_ns = 0;
+    bool    rx_ok = read_rx_timestamp(rx_fd, seq, hardware, rx_ns);
+    bool    tx_ok = read_tx_timestamp(tx_fd, hardware, tx_ns);
+    if (rx_ok && tx_ok) {
+      ++result.packets_timestamped;
+      latencies.push_back(static_cast<double>(rx_ns - tx_ns));
+    }
+  }
+  close(tx_fd);
+  close(rx_fd);
+
+  result.path_latency = TimingDistribution::from_samples(latencies);
+  if (result.packets_timestamped == 0 && result.error_message.empty()) {
+    result.error_message = hardware ? "No hardware timestamps received"
+                                    : "No software timestamps received";
+  }
+  return result.packets_timestamped > 0;
+}
+
+}  // namespace imx93_peripheral_test
@@ -0,0 +1,625 @@
+/**
+ * @file throughput_engine.cpp
+ * @brief Implementation of the built-in TCP/UDP throughput engine.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ *
+ * Wire protocol:
+ * - TCP: the client streams arbitrary payload and half-closes the connection;
+ *   the server answers with the 64-bit big-endian byte count it received.
+ * - UDP: every datagram starts with a UdpHeader. After the transfer the
+ *   client repeats an END datagram until the server answers with a REPORT
+ *   carrying the datagrams and bytes received from that client socket.
+ */
+
+#include "throughput_engine.h"
+
+#include <arpa/inet.h>
+#include <endian.h>
+#include <linux/errqueue.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr uint32_t UDP_MAGIC       = 0x494d5839;  // "IMX9"
+constexpr uint32_t UDP_TYPE_DATA   = 0;
+constexpr uint32_t UDP_TYPE_END    = 1;
+constexpr uint32_t UDP_TYPE_REPORT = 2;
+constexpr size_t   UDP_MAX_PAYLOAD = 65507;
+constexpr size_t   TCP_RECV_BUFFER = 256 * 1024;
+
+/**
+ * @brief Header at the start of every UDP datagram (all fields big-endian).
+ */
+struct UdpHeader {
+  uint32_t magic;
+  uint32_t type;
+  uint64_t seq;        // DATA: sequence number, END: datagrams sent
+  uint64_t datagrams;  // REPORT: datagrams received
+  uint64_t bytes;      // REPORT: bytes received
+};
+
+/**
+ * @brief Per-stream client outcome, merged into ThroughputResult.
+ */
+struct StreamResult {
+  uint64_t                              bytes_sent     = 0;
+  uint64_t                              bytes_received = 0;
+  uint64_t                              datagrams_sent = 0;
+  uint64_t                              datagrams_lost = 0;
+  uint64_t                              retransmits    = 0;
+  bool                                  zerocopy_used  = false;
+  std::chrono::steady_clock::time_point finished;
+  std::string                           error_message;
+};
+
+/**
+ * @brief Byte counters the server keeps per UDP client socket.
+ */
+struct UdpPeerCounters {
+  uint64_t datagrams = 0;
+  uint64_t bytes     = 0;
+};
+
+uint32_t clamp_batch(uint32_t batch_size) {
+  return std::min<uint32_t>(std::max<uint32_t>(batch_size, 1), 1024);
+}
+
+bool resolve_ipv4(const std::string& host, uint16_t port, sockaddr_in& addr) {
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port   = htons(port);
+  if (host.empty() || host == "0.0.0.0") {
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    return true;
+  }
+  if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) == 1) {
+    return true;
+  }
+
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+
+  struct addrinfo* res = nullptr;
+  if (getaddrinfo(host.c_str(), nullptr, &hints, &res) != 0 || res == nullptr) {
+    return false;
+  }
+  addr.sin_addr = reinterpret_cast<sockaddr_in*>(res->ai_addr)->sin_addr;
+  freeaddrinfo(res);
+  return true;
+}
+
+bool cancelled(const ThroughputConfig& config) {
+  return config.cancel != nullptr && config.cancel->cancelled();
+}
+
+/**
+ * @brief Time to wait for the server's byte count; short once cancelled, so a stopped run
+ *        still reports what the server received without outliving its watchdog grace.
+ */
+std::chrono::milliseconds report_timeout(const ThroughputConfig& config,
+                                         std::chrono::milliseconds timeout) {
+  return cancelled(config) ? std::min(timeout, std::chrono::milliseconds(100)) : timeout;
+}
+
+void set_timeout(int fd, int option, std::chrono::milliseconds timeout) {
+  timeval tv;
+  tv.tv_sec  = static_cast<time_t>(timeout.count() / 1000);
+  tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+  setsockopt(fd, SOL_SOCKET, option, &tv, sizeof(tv));
+}
+
+double cpu_time_seconds() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec +
+         usage.ru_stime.tv_usec / 1e6;
+}
+
+/**
+ * @brief Reaps MSG_ZEROCOPY completion notifications from the error queue.
+ *
+ * @param fd Socket with SO_ZEROCOPY enabled.
+ * @param wait_ms How long to wait for the first notification.
+ * @param completed Incremented by the number of completed sends.
+ * @param zerocopied Set when any send avoided the copy.
+ */
+void reap_zerocopy(int fd, int wait_ms, uint64_t& completed, bool& zerocopied) {
+  pollfd pfd = {fd, 0, 0};
+  if (wait_ms > 0 && poll(&pfd, 1, wait_ms) <= 0) {
+    return;
+  }
+
+  char control[128];
+  while (true) {
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+    if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      return;
+    }
+
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (cmsg->cmsg_level != SOL_IP || cmsg->cmsg_type != IP_RECVERR) {
+        continue;
+      }
+      const auto* err = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+      if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      completed += static_cast<uint64_t>(err->ee_data - err->ee_info) + 1;
+      if (!(err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)) {
+        zerocopied = true;
+      }
+    }
+  }
+}
+
+void run_tcp_stream(const ThroughputConfig& config, const sockaddr_in& addr, size_t message_size,
+                    std::chrono::steady_clock::time_point deadline, StreamResult& result) {
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    result.error_message = std::string("socket: ") + strerror(errno);
+    return;
+  }
+  set_timeout(fd, SO_SNDTIMEO, std::chrono::milliseconds(2000));
+  if (connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+    result.error_message = std::string("connect: ") + strerror(errno);
+    close(fd);
+    result.finished = std::chrono::steady_clock::now();
+    return;
+  }
+
+  bool zerocopy = false;
+  if (config.zerocopy) {
+    int one  = 1;
+    zerocopy = setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+  }
+
+  // The payload never changes, so a single pinned buffer is safe to reuse with MSG_ZEROCOPY
+  std::vector<char> buffer(message_size);
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<char>(i);
+  }
+
+  uint64_t zc_issued    = 0;
+  uint64_t zc_completed = 0;
+  while (std::chrono::steady_clock::now() < deadline && !cancelled(config)) {
+    int     flags = MSG_NOSIGNAL | (zerocopy ? MSG_ZEROCOPY : 0);
+    ssize_t sent  = send(fd, buffer.data(), buffer.size(), flags);
+    if (sent < 0) {
+      if (errno == ENOBUFS && zerocopy) {
+        // Notification backlog exceeded optmem_max; wait for completions
+        reap_zerocopy(fd, 10, zc_completed, result.zerocopy_used);
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        continue;
+      }
+      result.error_message = std::string("send: ") + strerror(errno);
+      break;
+    }
+    result.bytes_sent += static_cast<uint64_t>(sent);
+    if (zerocopy) {
+      zc_issued++;
+      if (zc_issued - zc_completed >= 64) {
+        reap_zerocopy(fd, 0, zc_completed, result.zerocopy_used);
+      }
+    }
+  }
+  result.finished = std::chrono::steady_clock::now();
+
+  tcp_info  info;
+  socklen_t info_len = sizeof(info);
+  if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &info_len) == 0) {
+    result.retransmits = info.tcpi_total_retrans;
+  }
+
+  shutdown(fd, SHUT_WR);
+  for (int attempt = 0; zerocopy && zc_completed < zc_issued && attempt < 10 && !cancelled(config);
+       ++attempt) {
+    reap_zerocopy(fd, 100, zc_completed, result.zerocopy_used);
+  }
+
+  // Receiver-side byte count; fall back to bytes sent if the peer is not our server
+  uint64_t report = 0;
+  set_timeout(fd, SO_RCVTIMEO, report_timeout(config, std::chrono::milliseconds(3000)));
+  if (recv(fd, &report, sizeof(report), MSG_WAITALL) == static_cast<ssize_t>(sizeof(report))) {
+    result.bytes_received = be64toh(report);
+  } else {
+    result.bytes_received = result.bytes_sent;
+  }
+  close(fd);
+}
+
+void run_udp_stream(const ThroughputConfig& config, const sockaddr_in& addr, size_t message_size,
+                    std::chrono::steady_clock::time_point deadline, StreamResult& result) {
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    result.error_message = std::string("socket: ") + strerror(errno);
+    return;
+  }
+  int sndbuf = 4 * 1024 * 1024;
+  setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+  if (connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+    result.error_message = std::string("connect: ") + strerror(errno);
+    close(fd);
+    result.finished = std::chrono::steady_clock::now();
+    return;
+  }
+
+  uint32_t                       batch = clamp_batch(config.batch_size);
+  std::vector<std::vector<char>> buffers(batch, std::vector<char>(message_size, 0x5a));
+  std::vector<iovec>             iovs(batch);
+  std::vector<mmsghdr>           msgs(batch);
+  for (uint32_t i = 0; i < batch; ++i) {
+    iovs[i] = {buffers[i].data(), message_size};
+    memset(&msgs[i], 0, sizeof(msgs[i]));
+    msgs[i].msg_hdr.msg_iov    = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  auto     start         = std::chrono::steady_clock::now();
+  double   bytes_per_sec = config.bitrate_mbps * 1e6 / 8.0;
+  uint64_t seq           = 0;
+  while (std::chrono::steady_clock::now() < deadline && !cancelled(config)) {
+    for (uint32_t i = 0; i < batch; ++i) {
+      UdpHeader header = {htonl(UDP_MAGIC), htonl(UDP_TYPE_DATA), htobe64(seq + i), 0, 0};
+      memcpy(buffers[i].data(), &header, sizeof(header));
+    }
+
+    int sent = sendmmsg(fd, msgs.data(), batch, 0);
+    if (sent < 0) {
+      if (errno == ENOBUFS || errno == EAGAIN || errno == EINTR) {
+        continue;
+      }
+      result.error_message = std::string("sendmmsg: ") + strerror(errno);
+      break;
+    }
+    seq += static_cast<uint64_t>(sent);
+    result.bytes_sent += static_cast<uint64_t>(sent) * message_size;
+
+    if (bytes_per_sec > 0) {
+      auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                             std::chrono::duration<double>(result.bytes_sent / bytes_per_sec));
+      std::this_thread::sleep_until(std::min(due, deadline));
+    }
+  }
+  result.finished       = std::chrono::steady_clock::now();
+  result.datagrams_sent = seq;
+
+  // Retry END until the server reports what it received from this socket
+  set_timeout(fd, SO_RCVTIMEO, std::chrono::milliseconds(100));
+  bool reported = false;
+  int  attempts = cancelled(config) ? 1 : 20;
+  for (int attempt = 0; attempt < attempts && !reported && result.error_message.empty();
+       ++attempt) {
+    UdpHeader end = {htonl(UDP_MAGIC), htonl(UDP_TYPE_END), htobe64(seq), 0, 0};
+    send(fd, &end, sizeof(end), 0);
+
+    UdpHeader report;
+    ssize_t   len = recv(fd, &report, sizeof(report), 0);
+    if (len == static_cast<ssize_t>(sizeof(report)) && ntohl(report.magic) == UDP_MAGIC &&
+        ntohl(report.type) == UDP_TYPE_REPORT) {
+      uint64_t datagrams    = be64toh(report.datagrams);
+      result.bytes_received = be64toh(report.bytes);
+      result.datagrams_lost = seq > datagrams ? seq - datagrams : 0;
+      reported              = true;
+    }
+  }
+  if (!reported && result.error_message.empty()) {
+    result.error_message = "No report from throughput server";
+  }
+  close(fd);
+}
+
+}  // namespace
+
+ThroughputEngine::ThroughputEngine(const ThroughputConfig& config)
+    : config_(config),
+      server_running_(false),
+      server_bytes_(0),
+      listen_fd_(-1),
+      udp_fd_(-1),
+      wake_fd_(-1),
+      server_port_(0) {}
+
+ThroughputEngine::~ThroughputEngine() {
+  stop_server();
+}
+
+bool ThroughputEngine::start_server() {
+  if (server_running_) {
+    return true;
+  }
+  stop_server();  // Joins a server loop that ended on its own and closes its sockets
+
+  sockaddr_in addr;
+  if (!resolve_ipv4(config_.host, config_.port, addr)) {
+    last_error_ = "Unable to resolve bind address " + config_.host;
+    return false;
+  }
+
+  listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  udp_fd_    = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  wake_fd_   = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (listen_fd_ < 0 || udp_fd_ < 0 || wake_fd_ < 0) {
+    last_error_ = std::string("socket: ") + strerror(errno);
+    stop_server();
+    return false;
+  }
+
+  int one = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(listen_fd_, 128) < 0) {
+    last_error_ = std::string("bind/listen: ") + strerror(errno);
+    stop_server();
+    return false;
+  }
+
+  // UDP shares the port chosen for TCP so clients only need one number
+  socklen_t addr_len = sizeof(addr);
+  getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+  server_port_ = ntohs(addr.sin_port);
+
+  int rcvbuf = 4 * 1024 * 1024;
+  setsockopt(udp_fd_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  if (bind(udp_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    last_error_ = std::string("bind udp: ") + strerror(errno);
+    stop_server();
+    return false;
+  }
+
+  server_bytes_   = 0;
+  server_running_ = true;
+  server_thread_  = std::thread(&ThroughputEngine::server_loop, this);
+  return true;
+}
+
+void ThroughputEngine::stop_server() {
+  if (server_running_.exchange(false) && wake_fd_ >= 0) {
+    uint64_t one = 1;
+    ssize_t  ret = write(wake_fd_, &one, sizeof(one));
+    (void)ret;
+  }
+  if (server_thread_.joinable()) {
+    server_thread_.join();
+  }
+  for (int* fd : {&listen_fd_, &udp_fd_, &wake_fd_}) {
+    if (*fd >= 0) {
+      close(*fd);
+      *fd = -1;
+    }
+  }
+}
+
+void ThroughputEngine::server_loop() {
+  int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd < 0) {
+    server_running_ = false;  // Not serving, so start_server() must not report it running
+    return;
+  }
+
+  auto watch = [epoll_fd](int fd) {
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events  = EPOLLIN;
+    event.data.fd = fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+  };
+  watch(listen_fd_);
+  watch(udp_fd_);
+  watch(wake_fd_);
+
+  std::unordered_map<int, uint64_t>    connections;  // fd -> bytes received
+  std::map<uint64_t, UdpPeerCounters> udp_peers;    // address:port -> counters
+  std::vector<char>                   tcp_buffer(TCP_RECV_BUFFER);
+
+  const uint32_t                 batch = clamp_batch(config_.batch_size);
+  std::vector<std::vector<char>> udp_buffers(batch, std::vector<char>(UDP_MAX_PAYLOAD));
+  std::vector<iovec>             iovs(batch);
+  std::vector<sockaddr_in>       peers(batch);
+  std::vector<mmsghdr>           msgs(batch);
+
+  while (server_running_) {
+    epoll_event events[64];
+    int         ready = epoll_wait(epoll_fd, events, 64, 200);
+    for (int e = 0; e < ready; ++e) {
+      int fd = events[e].data.fd;
+
+      if (fd == listen_fd_) {
+        int conn;
+        while ((conn = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+          connections[conn] = 0;
+          watch(conn);
+        }
+      } else if (fd == udp_fd_) {
+        while (true) {
+          for (uint32_t i = 0; i < batch; ++i) {
+            iovs[i] = {udp_buffers[i].data(), udp_buffers[i].size()};
+            memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_iov     = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen  = 1;
+            msgs[i].msg_hdr.msg_name    = &peers[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+          }
+          int received = recvmmsg(udp_fd_, msgs.data(), batch, MSG_DONTWAIT, nullptr);
+          if (received <= 0) {
+            break;
+          }
+
+          for (int i = 0; i < received; ++i) {
+            if (msgs[i].msg_len < sizeof(UdpHeader)) {
+              continue;
+            }
+            UdpHeader header;
+            memcpy(&header, udp_buffers[i].data(), sizeof(header));
+            if (ntohl(header.magic) != UDP_MAGIC) {
+              continue;
+            }
+
+            uint64_t key = static_cast<uint64_t>(ntohl(peers[i].sin_addr.s_addr)) << 16 |
+                           ntohs(peers[i].sin_port);
+            UdpPeerCounters& counters = udp_peers[key];
+            if (ntohl(header.type) == UDP_TYPE_END) {
+              UdpHeader report = {htonl(UDP_MAGIC), htonl(UDP_TYPE_REPORT), header.seq,
+                                  htobe64(counters.datagrams), htobe64(counters.bytes)};
+              sendto(udp_fd_, &report, sizeof(report), 0,
+                     reinterpret_cast<const sockaddr*>(&peers[i]), sizeof(sockaddr_in));
+            } else if (ntohl(header.type) == UDP_TYPE_DATA) {
+              counters.datagrams++;
+              counters.bytes += msgs[i].msg_len;
+              server_bytes_ += msgs[i].msg_len;
+            }
+          }
+        }
+      } else if (fd != wake_fd_) {
+        auto it = connections.find(fd);
+        if (it == connections.end()) {
+          continue;
+        }
+        while (true) {
+          ssize_t len = recv(fd, tcp_buffer.data(), tcp_buffer.size(), MSG_DONTWAIT);
+          if (len > 0) {
+            it->second += static_cast<uint64_t>(len);
+            server_bytes_ += static_cast<uint64_t>(len);
+            continue;
+          }
+          if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+          }
+          if (len == 0) {
+            // Client half-closed: report what we received
+            uint64_t report = htobe64(it->second);
+            ssize_t  ret    = send(fd, &report, sizeof(report), MSG_NOSIGNAL);
+            (void)ret;
+          }
+          epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+          close(fd);
+          connections.erase(it);
+          break;
+        }
+      }
+    }
+  }
+
+  for (const auto& connection : connections) {
+    close(connection.first);
+  }
+  close(epoll_fd);
+}
+
+ThroughputResult ThroughputEngine::run_client() {
+  ThroughputResult result;
+
+  sockaddr_in addr;
+  if (!resolve_ipv4(config_.host, config_.port, addr)) {
+    result.error_message = "Unable to resolve host " + config_.host;
+    return result;
+  }
+
+  bool   udp          = config_.protocol == TransportProtocol::UDP;
+  size_t message_size = config_.message_size;
+  if (message_size == 0) {
+    message_size = udp ? 1472 : 128 * 1024;
+  }
+  if (udp) {
+    message_size = std::min(std::max(message_size, sizeof(UdpHeader)), UDP_MAX_PAYLOAD);
+  }
+
+  uint32_t                  stream_count = std::max<uint32_t>(config_.streams, 1);
+  std::vector<StreamResult> streams(stream_count);
+  std::vector<std::thread>  threads;
+
+  double cpu_start = cpu_time_seconds();
+  auto   start     = std::chrono::steady_clock::now();
+  auto   deadline  = start + config_.duration;
+  for (uint32_t i = 0; i < stream_count; ++i) {
+    threads.emplace_back([&, i]() {
+      if (udp) {
+        run_udp_stream(config_, addr, message_size, deadline, streams[i]);
+      } else {
+        run_tcp_stream(config_, addr, message_size, deadline, streams[i]);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  result.cpu_seconds = cpu_time_seconds() - cpu_start;
+
+  auto finished = start;
+  for (const auto& stream : streams) {
+    result.bytes_sent += stream.bytes_sent;
+    result.bytes_received += stream.bytes_received;
+    result.datagrams_sent += stream.datagrams_sent;
+    result.datagrams_lost += stream.datagrams_lost;
+    result.retransmits += stream.retransmits;
+    result.zerocopy_used = result.zerocopy_used || stream.zerocopy_used;
+    finished             = std::max(finished, stream.finished);
+    if (result.error_message.empty() && !stream.error_message.empty()) {
+      result.error_message = stream.error_message;
+    }
+  }
+
+  result.elapsed_s = std::chrono::duration<double>(finished - start).count();
+  if (result.elapsed_s > 0) {
+    result.goodput_mbps = result.bytes_received * 8.0 / result.elapsed_s / 1e6;
+  }
+  double gbits = result.bytes_received * 8.0 / 1e9;
+  if (gbits > 0) {
+    result.cpu_s_per_gbit = result.cpu_seconds / gbits;
+  }
+  result.success = result.error_message.empty() && result.bytes_received > 0;
+  return result;
+}
+
+bool ThroughputEngine::is_loopback_host(const std::string& host) {
+  sockaddr_in addr;
+  if (!resolve_ipv4(host, 0, addr)) {
+    return false;
+  }
+  uint32_t address = ntohl(addr.sin_addr.s_addr);
+  return address == INADDR_ANY || (address >> 24) == IN_LOOPBACKNET;
+}
+
+ThroughputResult ThroughputEngine::run_loopback() {
+  ThroughputConfig saved = config_;
+  config_.host           = "127.0.0.1";
+  config_.port           = 0;
+
+  ThroughputResult result;
+  if (!start_server()) {
+    result.error_message = last_error_;
+    config_              = saved;
+    return result;
+  }
+
+  config_.port = server_port_;
+  result       = run_client();
+  stop_server();
+  config_ = saved;
+  return result;
+}
+
+}  // namespace imx93_peripheral_test
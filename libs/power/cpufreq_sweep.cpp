@@ -0,0 +1,243 @@
+/**
+ * @file cpufreq_sweep.cpp
+ * @brief Implementation of the cpufreq governor and frequency energy sweep.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "cpufreq_sweep.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+std::string read_line(const fs::path& path) {
+  std::ifstream file(path);
+  std::string   line;
+  std::getline(file, line);
+  return line;
+}
+
+std::vector<std::string> read_words(const fs::path& path) {
+  std::istringstream       stream(read_line(path));
+  std::vector<std::string> words;
+  for (std::string word; stream >> word;) {
+    words.push_back(word);
+  }
+  return words;
+}
+
+/**
+ * @brief Writes an existing sysfs attribute; never creates the file.
+ */
+bool write_attribute(const fs::path& path, const std::string& value) {
+  int fd = open(path.c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  ssize_t written = write(fd, value.data(), value.size());
+  close(fd);
+  return written == static_cast<ssize_t>(value.size());
+}
+
+/**
+ * @brief Records the governor and limits of every policy and puts them back on destruction.
+ */
+class CpufreqStateGuard {
+public:
+  explicit CpufreqStateGuard(const std::vector<fs::path>& policies) {
+    for (const auto& policy : policies) {
+      // Lower the floor first so restoring max below the current min is accepted
+      save(policy / "scaling_min_freq", read_line(policy / "cpuinfo_min_freq"));
+      save(policy / "scaling_max_freq", read_line(policy / "scaling_max_freq"));
+      save(policy / "scaling_min_freq", read_line(policy / "scaling_min_freq"));
+      save(policy / "scaling_governor", read_line(policy / "scaling_governor"));
+    }
+  }
+
+  ~CpufreqStateGuard() {
+    for (const auto& attribute : saved_) {
+      write_attribute(attribute.first, attribute.second);
+    }
+  }
+
+  CpufreqStateGuard(const CpufreqStateGuard&)            = delete;
+  CpufreqStateGuard& operator=(const CpufreqStateGuard&) = delete;
+
+private:
+  void save(const fs::path& path, const std::string& value) {
+    if (!value.empty()) {
+      saved_.emplace_back(path, value);
+    }
+  }
+
+  std::vector<std::pair<fs::path, std::string>> saved_; /**< Writes in restore order */
+};
+
+/**
+ * @brief Applies a governor, or pins a frequency, on every policy.
+ * @return Empty on success, otherwise the attribute that was rejected.
+ */
+std::string apply_setting(const std::vector<fs::path>& policies, const std::string& governor,
+                          uint32_t frequency_khz) {
+  for (const auto& policy : policies) {
+    std::string low  = read_line(policy / "cpuinfo_min_freq");
+    std::string high = read_line(policy / "cpuinfo_max_freq");
+    std::string pin  = std::to_string(frequency_khz);
+
+    // Open the range fully, then narrow it; avoids min > max at every step
+    if (!write_attribute(policy / "scaling_min_freq", low) ||
+        !write_attribute(policy / "scaling_max_freq", high) ||
+        !write_attribute(policy / "scaling_governor", governor)) {
+      return (policy / "scaling_governor").string() + " = " + governor;
+    }
+    if (frequency_khz > 0 && (!write_attribute(policy / "scaling_max_freq", pin) ||
+                              !write_attribute(policy / "scaling_min_freq", pin))) {
+      return (policy / "scaling_max_freq").string() + " = " + pin;
+    }
+  }
+  return "";
+}
+
+}  // namespace
+
+CpufreqSweep::CpufreqSweep(const CpufreqSweepConfig& config) : config_(config) {}
+
+CpufreqSweepResult CpufreqSweep::run() {
+  CpufreqSweepResult result;
+
+  std::vector<fs::path> policies;
+  std::error_code       ec;
+  for (const auto& entry : fs::directory_iterator(fs::path(config_.cpu_root) / "cpufreq", ec)) {
+    if (entry.path().filename().string().rfind("policy", 0) == 0 &&
+        fs::exists(entry.path() / "scaling_governor")) {
+      policies.push_back(entry.path());
+    }
+  }
+  std::sort(policies.begin(), policies.end());
+  if (policies.empty()) {
+    result.error_message = "No cpufreq policies under " + config_.cpu_root;
+    return result;
+  }
+  result.supported = true;
+  for (const auto& policy : policies) {
+    result.policies.push_back(policy.filename().string());
+  }
+
+  // The userspace governor only holds whatever speed was last set; pinned points cover it
+  std::vector<std::string> governors = config_.governors;
+  if (governors.empty()) {
+    for (const auto& governor : read_words(policies[0] / "scaling_available_governors")) {
+      if (governor != "userspace") {
+        governors.push_back(governor);
+      }
+    }
+  }
+  std::vector<uint32_t> frequencies = config_.frequencies_khz;
+  if (frequencies.empty()) {
+    for (const auto& word : read_words(policies[0] / "scaling_available_frequencies")) {
+      frequencies.push_back(static_cast<uint32_t>(std::stoul(word)));
+    }
+    if (frequencies.empty()) {
+      for (const char* bound : {"cpuinfo_min_freq", "cpuinfo_max_freq"}) {
+        std::string value = read_line(policies[0] / bound);
+        if (!value.empty()) {
+          frequencies.push_back(static_cast<uint32_t>(std::stoul(value)));
+        }
+      }
+    }
+    std::sort(frequencies.begin(), frequencies.end());
+    frequencies.erase(std::unique(frequencies.begin(), frequencies.end()), frequencies.end());
+  }
+  std::vector<std::string> available    = read_words(policies[0] / "scaling_available_governors");
+  std::string              pin_governor = read_line(policies[0] / "scaling_governor");
+  if (std::count(available.begin(), available.end(), "performance") > 0) {
+    pin_governor = "performance";
+  }
+
+  std::vector<CpufreqOperatingPoint> points;
+  for (const auto& governor : governors) {
+    CpufreqOperatingPoint point;
+    point.governor = governor;
+    points.push_back(point);
+  }
+  for (uint32_t frequency : frequencies) {
+    CpufreqOperatingPoint point;
+    point.governor      = pin_governor;
+    point.frequency_khz = frequency;
+    points.push_back(point);
+  }
+  if (points.empty()) {
+    result.error_message = "No governors or frequencies to sweep";
+    return result;
+  }
+
+  uint64_t              work     = config_.work_per_core;
+  EnergyMeter::Workload workload = config_.workload;
+  if (!workload) {
+    workload = [work]() { return EnergyMeter::cpu_work(work); };
+  }
+
+  {
+    CpufreqStateGuard guard(policies);
+    for (auto& point : points) {
+      if (config_.meter.cancel != nullptr && config_.meter.cancel->cancelled()) {
+        point.error_message = "Cancelled";
+        continue;
+      }
+      std::string rejected = apply_setting(policies, point.governor, point.frequency_khz);
+      if (!rejected.empty()) {
+        point.error_message = "Rejected " + rejected;
+        continue;
+      }
+      std::string name = point.frequency_khz > 0 ? std::to_string(point.frequency_khz) + " kHz"
+                                                 : point.governor;
+      EnergyMeasurement measurement = EnergyMeter(config_.meter).measure(name, workload);
+      if (!measurement.success) {
+        point.error_message = measurement.error_message;
+        continue;
+      }
+      point.success         = true;
+      point.time_s          = measurement.run_time_s;
+      point.energy_j        = measurement.energy_per_run_j;
+      point.average_power_w = measurement.average_power_w;
+    }
+  }
+
+  mark_pareto_front(points);
+  result.points  = points;
+  result.success = true;
+  for (const auto& point : points) {
+    if (!point.success && result.success) {
+      result.success       = false;
+      result.error_message = point.error_message;
+    }
+  }
+  return result;
+}
+
+void CpufreqSweep::mark_pareto_front(std::vector<CpufreqOperatingPoint>& points) {
+  for (auto& point : points) {
+    point.pareto = point.success;
+    for (const auto& other : points) {
+      if (point.pareto && other.success && other.time_s <= point.time_s &&
+          other.energy_j <= point.energy_j &&
+          (other.time_s < point.time_s || other.energy_j < point.energy_j)) {
+        point.pareto = false;
+      }
+    }
+  }
+}
+
+}  // namespace imx93_peripheral_test
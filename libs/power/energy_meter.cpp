@@ -0,0 +1,161 @@
+/**
+ * @file energy_meter.cpp
+ * @brief Implementation of the energy-per-workload meter.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "energy_meter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr uint64_t SPIN_BATCH = 4096;
+
+/**
+ * @brief Runs xorshift64 for the given number of rounds.
+ */
+uint64_t xorshift_rounds(uint64_t seed, uint64_t rounds) {
+  volatile uint64_t state = seed;
+  for (uint64_t k = 0; k < rounds; ++k) {
+    uint64_t x = state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    state = x;
+  }
+  return state;
+}
+
+/**
+ * @brief Runs body(seed) on one thread per online core and sums the results.
+ */
+template <typename Body>
+uint64_t run_on_all_cores(Body body) {
+  unsigned                 cores = std::max(1u, std::thread::hardware_concurrency());
+  std::atomic<uint64_t>    total(0);
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i < cores; ++i) {
+    workers.emplace_back([&total, &body, i]() { total.fetch_add(body(i + 1)); });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  return total.load();
+}
+
+}  // namespace
+
+EnergyMeter::EnergyMeter(const EnergyMeterConfig& config) : config_(config) {}
+
+EnergyMeasurement EnergyMeter::measure(const std::string& name, const Workload& workload) {
+  EnergyMeasurement result;
+  result.workload = name;
+
+  PowerSampler sampler(config_.sampler);
+  if (!sampler.discover() || sampler.rails().empty()) {
+    result.error_message = "No power rails found under " + config_.sampler.sysfs_root;
+    return result;
+  }
+  sampler.start();
+
+  // Idle baseline, which also picks the default rail
+  if (config_.cancel != nullptr) {
+    if (config_.cancel->wait_for(config_.idle_window)) {
+      sampler.stop();
+      result.error_message = "Cancelled";
+      return result;
+    }
+  } else {
+    std::this_thread::sleep_for(config_.idle_window);
+  }
+  std::vector<RailStats> idle = sampler.rail_stats();
+  size_t                 rail = idle.size();
+  for (size_t r = 0; r < idle.size(); ++r) {
+    if (config_.rail.empty() ? (rail == idle.size() || idle[r].average_w > idle[rail].average_w)
+                             : idle[r].name == config_.rail) {
+      rail = r;
+    }
+  }
+  if (rail == idle.size()) {
+    sampler.stop();
+    result.error_message = "Rail not found: " + config_.rail;
+    return result;
+  }
+  result.rail         = idle[rail].name;
+  result.idle_power_w = idle[rail].average_w;
+
+  double total_energy = 0.0;
+  double total_time   = 0.0;
+  for (uint32_t run = 0; run < config_.runs; ++run) {
+    if (config_.cancel != nullptr && config_.cancel->cancelled()) {
+      break;
+    }
+    sampler.reset_stats();
+    auto     start = std::chrono::steady_clock::now();
+    uint64_t ops   = workload();
+    double   elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    RailStats stats = sampler.rail_stats()[rail];
+    if (ops == 0) {
+      sampler.stop();
+      result.workload_failed = true;
+      result.error_message   = "Run " + std::to_string(run + 1) + " completed no operations";
+      return result;
+    }
+
+    double power = stats.samples > 0 ? stats.average_w : result.idle_power_w;
+    total_energy += power * elapsed;
+    total_time += elapsed;
+    result.peak_power_w = std::max({result.peak_power_w, stats.peak_w, power});
+    result.ops += ops;
+    ++result.runs;
+  }
+  sampler.stop();
+
+  if (result.runs < config_.runs) {
+    result.error_message = "Cancelled after " + std::to_string(result.runs) + " of " +
+                           std::to_string(config_.runs) + " runs";
+    return result;
+  }
+  if (result.runs == 0 || total_time <= 0.0) {
+    result.error_message = "Workload did not run";
+    return result;
+  }
+  result.run_time_s           = total_time / result.runs;
+  result.average_power_w      = total_energy / total_time;
+  result.energy_per_run_j     = total_energy / result.runs;
+  result.net_energy_per_run_j =
+      std::max(0.0, (result.average_power_w - result.idle_power_w) * result.run_time_s);
+  result.ops_per_joule = total_energy > 0.0 ? result.ops / total_energy : 0.0;
+  result.success       = true;
+  return result;
+}
+
+uint64_t EnergyMeter::cpu_spin(std::chrono::milliseconds duration) {
+  auto deadline = std::chrono::steady_clock::now() + duration;
+  return run_on_all_cores([deadline](uint64_t seed) {
+    uint64_t rounds = 0;
+    // Check the clock every SPIN_BATCH rounds to keep the loop ALU-bound
+    while (std::chrono::steady_clock::now() < deadline) {
+      seed = xorshift_rounds(seed, SPIN_BATCH);
+      rounds += SPIN_BATCH;
+    }
+    return rounds;
+  });
+}
+
+uint64_t EnergyMeter::cpu_work(uint64_t rounds_per_core) {
+  return run_on_all_cores([rounds_per_core](uint64_t seed) {
+    xorshift_rounds(seed, rounds_per_core);
+    return rounds_per_core;
+  });
+}
+
+}  // namespace imx93_peripheral_test
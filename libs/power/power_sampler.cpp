@@ -0,0 +1,394 @@
+/**
+ * @file power_sampler.cpp
+ * @brief Implementation of the high-rate power telemetry sampler.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "power_sampler.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+
+namespace fs = std::filesystem;
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr auto MIN_PERIOD = std::chrono::microseconds(1000);  // 1 kHz ceiling
+
+/**
+ * @brief Re-reads an open sysfs attribute as an integer.
+ */
+bool read_value(int fd, double& value) {
+  char    buffer[32];
+  ssize_t length = pread(fd, buffer, sizeof(buffer) - 1, 0);
+  if (length <= 0) {
+    return false;
+  }
+  buffer[length] = '\0';
+  char*     end = nullptr;
+  long long raw = strtoll(buffer, &end, 10);
+  if (end == buffer) {
+    return false;
+  }
+  value = static_cast<double>(raw);
+  return true;
+}
+
+std::string read_line(const fs::path& path) {
+  std::ifstream file(path);
+  std::string   line;
+  std::getline(file, line);
+  return line;
+}
+
+/**
+ * @brief Lists the entries of a sysfs class directory in name order.
+ */
+std::vector<fs::path> sorted_entries(const fs::path& directory) {
+  std::vector<fs::path> entries;
+  std::error_code       ec;
+  for (const auto& entry : fs::directory_iterator(directory, ec)) {
+    entries.push_back(entry.path());
+  }
+  std::sort(entries.begin(), entries.end());
+  return entries;
+}
+
+}  // namespace
+
+PowerSampler::PowerSampler(const PowerSamplerConfig& config)
+    : config_(config), stability_(config.brownout), running_(false), samples_taken_(0) {
+  config_.period        = std::max(config_.period, MIN_PERIOD);
+  config_.ring_capacity = std::max<size_t>(config_.ring_capacity, 1);
+}
+
+PowerSampler::~PowerSampler() {
+  stop();
+  for (int fd : fds_) {
+    close(fd);
+  }
+}
+
+int PowerSampler::add_channel(const std::string& source, const std::string& device,
+                              const std::string& label, const std::string& path,
+                              PowerQuantity quantity, double scale) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  double probe;
+  if (!read_value(fd, probe)) {
+    close(fd);
+    return -1;
+  }
+  channels_.push_back({source, device, label, path, quantity, scale});
+  fds_.push_back(fd);
+  return static_cast<int>(channels_.size()) - 1;
+}
+
+bool PowerSampler::discover() {
+  if (running_.load()) {
+    return false;
+  }
+  for (int fd : fds_) {
+    close(fd);
+  }
+  channels_.clear();
+  fds_.clear();
+  rails_.clear();
+
+  discover_power_supplies();
+  discover_hwmon();
+  discover_regulators();
+
+  ring_times_.assign(config_.ring_capacity, std::chrono::steady_clock::time_point());
+  ring_values_.assign(config_.ring_capacity * channels_.size(), 0.0);
+  ring_head_  = 0;
+  ring_count_ = 0;
+  reset_stats();
+  return !channels_.empty();
+}
+
+void PowerSampler::discover_power_supplies() {
+  for (const auto& supply : sorted_entries(fs::path(config_.sysfs_root) / "class/power_supply")) {
+    std::string name = supply.filename().string();
+    std::string base = supply.string() + "/";
+
+    PowerRail rail;
+    rail.name            = "power_supply/" + name;
+    rail.voltage_channel = add_channel("power_supply", name, "voltage_now", base + "voltage_now",
+                                       PowerQuantity::VOLTAGE, 1e-6);
+    rail.current_channel = add_channel("power_supply", name, "current_now", base + "current_now",
+                                       PowerQuantity::CURRENT, 1e-6);
+    rail.power_channel   = add_channel("power_supply", name, "power_now", base + "power_now",
+                                       PowerQuantity::POWER, 1e-6);
+    if (rail.power_channel >= 0 || (rail.voltage_channel >= 0 && rail.current_channel >= 0)) {
+      rails_.push_back(rail);
+    }
+  }
+}
+
+void PowerSampler::discover_hwmon() {
+  static const std::regex attribute("^(in|curr|power)([0-9]+)_input$");
+
+  for (const auto& chip : sorted_entries(fs::path(config_.sysfs_root) / "class/hwmon")) {
+    std::string device = read_line(chip / "name");
+    if (device.empty()) {
+      device = chip.filename().string();
+    }
+
+    // Channel index -> {voltage, current, power} channel indices
+    std::vector<std::pair<int, std::array<int, 3>>> by_index;
+    for (const auto& entry : sorted_entries(chip)) {
+      std::string filename = entry.filename().string();
+      std::smatch match;
+      if (!std::regex_match(filename, match, attribute)) {
+        continue;
+      }
+      std::string prefix = match[1].str();
+      int         index  = std::stoi(match[2].str());
+      std::string label  = read_line(chip / (prefix + match[2].str() + "_label"));
+      if (label.empty()) {
+        label = prefix + match[2].str();
+      }
+
+      PowerQuantity quantity = PowerQuantity::VOLTAGE;
+      double        scale    = 1e-3;  // in*: mV, curr*: mA
+      size_t        slot     = 0;
+      if (prefix == "curr") {
+        quantity = PowerQuantity::CURRENT;
+        slot     = 1;
+      } else if (prefix == "power") {
+        quantity = PowerQuantity::POWER;
+        scale    = 1e-6;  // power*: uW
+        slot     = 2;
+      }
+      int channel = add_channel("hwmon", device, label, entry.string(), quantity, scale);
+      if (channel < 0) {
+        continue;
+      }
+      auto it = std::find_if(by_index.begin(), by_index.end(),
+                             [index](const auto& item) { return item.first == index; });
+      if (it == by_index.end()) {
+        by_index.push_back({index, {-1, -1, -1}});
+        it = by_index.end() - 1;
+      }
+      it->second[slot] = channel;
+    }
+
+    // A power channel wins; otherwise pair inN with currN
+    for (const auto& item : by_index) {
+      const auto& slots = item.second;
+      PowerRail   rail;
+      rail.voltage_channel = slots[0];
+      rail.current_channel = slots[1];
+      rail.power_channel   = slots[2];
+      if (rail.power_channel < 0 && (rail.voltage_channel < 0 || rail.current_channel < 0)) {
+        continue;
+      }
+      int named = rail.power_channel >= 0 ? rail.power_channel : rail.current_channel;
+      rail.name = "hwmon/" + device + "/" + channels_[named].label;
+      rails_.push_back(rail);
+    }
+  }
+}
+
+void PowerSampler::discover_regulators() {
+  for (const auto& regulator : sorted_entries(fs::path(config_.sysfs_root) / "class/regulator")) {
+    std::string name = read_line(regulator / "name");
+    if (name.empty()) {
+      name = regulator.filename().string();
+    }
+    std::string base = regulator.string() + "/";
+
+    PowerRail rail;
+    rail.name            = "regulator/" + name;
+    rail.voltage_channel = add_channel("regulator", name, "microvolts", base + "microvolts",
+                                       PowerQuantity::VOLTAGE, 1e-6);
+    rail.current_channel = add_channel("regulator", name, "microamps", base + "microamps",
+                                       PowerQuantity::CURRENT, 1e-6);
+    if (rail.voltage_channel >= 0 && rail.current_channel >= 0) {
+      rails_.push_back(rail);
+    }
+  }
+}
+
+bool PowerSampler::read(PowerReading& reading) {
+  reading.timestamp = std::chrono::steady_clock::now();
+  reading.values.resize(channels_.size());
+  bool all_read = true;
+  for (size_t i = 0; i < fds_.size(); ++i) {
+    // A failed read keeps the last value; 0 would look like a brown-out
+    double raw = 0.0;
+    if (read_value(fds_[i], raw)) {
+      reading.values[i] = raw * channels_[i].scale;
+    } else {
+      all_read = false;
+    }
+  }
+  return all_read;
+}
+
+double PowerSampler::rail_power(const PowerRail& rail, const std::vector<double>& values) {
+  if (rail.power_channel >= 0) {
+    return std::fabs(values[rail.power_channel]);
+  }
+  // Battery drivers report discharge current as negative
+  return std::fabs(values[rail.voltage_channel] * values[rail.current_channel]);
+}
+
+bool PowerSampler::start() {
+  if (channels_.empty() || running_.load()) {
+    return false;
+  }
+  reset_stats();
+  samples_taken_.store(0);
+  started_ = std::chrono::steady_clock::now();
+  running_.store(true);
+  thread_ = std::thread(&PowerSampler::sample_loop, this);
+  return true;
+}
+
+void PowerSampler::stop() {
+  running_.store(false);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void PowerSampler::sample_loop() {
+  PowerReading reading;
+  auto         next = std::chrono::steady_clock::now();
+  while (running_.load()) {
+    read(reading);
+    record(reading);
+    samples_taken_.fetch_add(1);
+
+    // Absolute schedule; slots missed while a slow sysfs read blocked are dropped
+    next += config_.period;
+    auto now = std::chrono::steady_clock::now();
+    if (next < now) {
+      next = now;
+    }
+    std::this_thread::sleep_until(next);
+  }
+}
+
+void PowerSampler::record(const PowerReading& reading) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const size_t width      = channels_.size();
+  ring_times_[ring_head_] = reading.timestamp;
+  std::copy(reading.values.begin(), reading.values.end(),
+            ring_values_.begin() + ring_head_ * width);
+  ring_head_  = (ring_head_ + 1) % config_.ring_capacity;
+  ring_count_ = std::min(ring_count_ + 1, config_.ring_capacity);
+
+  double dt = std::chrono::duration<double>(reading.timestamp - last_time_).count();
+  for (size_t r = 0; r < rails_.size(); ++r) {
+    double     power = rail_power(rails_[r], reading.values);
+    RailStats& stats = stats_[r];
+    if (stats.samples == 0) {
+      stats.min_w  = power;
+      stats.peak_w = power;
+      stats_start_ = reading.timestamp;
+    } else {
+      stats.energy_j += 0.5 * (power + last_power_[r]) * dt;
+      stats.min_w  = std::min(stats.min_w, power);
+      stats.peak_w = std::max(stats.peak_w, power);
+    }
+    stats.last_w   = power;
+    last_power_[r] = power;
+    ++stats.samples;
+
+    const PowerRail& rail    = rails_[r];
+    double           voltage = NAN;
+    double           current = NAN;
+    if (rail.voltage_channel >= 0) {
+      voltage = reading.values[rail.voltage_channel];
+    }
+    if (rail.current_channel >= 0) {
+      current = std::fabs(reading.values[rail.current_channel]);
+    }
+    stability_.add(r, reading.timestamp, voltage, current, power);
+    series_.add(r, power, reading.timestamp);
+  }
+  last_time_ = reading.timestamp;
+}
+
+void PowerSampler::reset_stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.assign(rails_.size(), RailStats());
+  for (size_t r = 0; r < rails_.size(); ++r) {
+    stats_[r].name = rails_[r].name;
+  }
+  last_power_.assign(rails_.size(), 0.0);
+
+  std::vector<std::string> names;
+  for (const auto& rail : rails_) {
+    names.push_back(rail.name);
+  }
+  stability_.reset(names);
+
+  // 256 buckets per tier, x10 per tier: the top tier spans 30 days at 1 kHz
+  series_ = TimeSeriesStore(256, 10, 8);
+  series_.set_sink(config_.series_sink);
+  for (const auto& name : names) {
+    series_.add_series(name, "W");
+  }
+}
+
+std::vector<RailStats> PowerSampler::rail_stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<RailStats>      result = stats_;
+  double elapsed = std::chrono::duration<double>(last_time_ - stats_start_).count();
+  for (auto& stats : result) {
+    stats.average_w = elapsed > 0.0 ? stats.energy_j / elapsed : stats.last_w;
+  }
+  return result;
+}
+
+std::vector<RailStability> PowerSampler::rail_stability() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stability_.snapshot();
+}
+
+TimeSeriesStore PowerSampler::power_series() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return series_;
+}
+
+std::vector<PowerReading> PowerSampler::recent(size_t max_samples) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const size_t                width = channels_.size();
+  size_t                      count = std::min(max_samples, ring_count_);
+  size_t index = (ring_head_ + config_.ring_capacity - count) % config_.ring_capacity;
+
+  std::vector<PowerReading> readings(count);
+  for (auto& reading : readings) {
+    reading.timestamp = ring_times_[index];
+    reading.values.assign(ring_values_.begin() + index * width,
+                          ring_values_.begin() + (index + 1) * width);
+    index = (index + 1) % config_.ring_capacity;
+  }
+  return readings;
+}
+
+double PowerSampler::achieved_rate_hz() const {
+  double elapsed =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count();
+  return elapsed > 0.0 ? samples_taken_.load() / elapsed : 0.0;
+}
+
+}  // namespace imx93_peripheral_test
@@ -20,9 +20,13 @@
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <map>
 #include <sstream>
 #include <thread>
 #include <vector>
@@ -31,18 +35,53 @@ namespace fs = std::filesystem;
 
 namespace imx93_peripheral_test {
 
+namespace {
+
+/**
+ * @brief Formats a wall-clock time as local "YYYY-MM-DD HH:MM:SS.mmm" for
+ *        matching against other logs.
+ */
+std::string format_wall_time(std::chrono::system_clock::time_point time) {
+  std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+  auto        millis =
+      std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() %
+      1000;
+  std::tm local = {};
+  localtime_r(&seconds, &local);
+  char stamp[32];
+  std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+
+  std::stringstream out;
+  out << stamp << "." << std::setfill('0') << std::setw(3) << millis;
+  return out.str();
+}
+
+}  // namespace
+
 /**
- * @brief Constructs a power tester instance.
+ * @brief Constructs a power tester instance; discovery is left to prepare().
+ */
+PowerTester::PowerTester() : power_available_(false), consumption_{0.0, 0.0, 0.0, 0.0} {}
+
+/**
+ * @brief Returns true if power supply, regulator or SoC sysfs entries exist.
+ */
+bool PowerTester::probe() {
+  return fs::exists("/sys/class/power_supply") || fs::exists("/sys/class/regulator") ||
+         fs::exists("/sys/devices/platform/soc@0");
+}
+
+/**
+ * @brief Discovers the power peripheral.
  *
  * Initializes the power tester by detecting available power management
  * interfaces and battery/power supply monitoring capabilities.
  * For i.MX93, checks for PCA9451A PMIC and voltage rail monitoring.
  */
-PowerTester::PowerTester() : power_available_(false) {
+void PowerTester::discover() {
   // Check if power management is available on i.MX93
   // Look for PMIC interfaces and voltage regulators
-  power_available_ = fs::exists("/sys/class/power_supply") || fs::exists("/sys/class/regulator") ||
-                     fs::exists("/sys/devices/platform/soc@0");
+  power_available_ = probe();
 
   if (power_available_) {
     power_info_ = get_power_info();
@@ -102,16 +141,28 @@ TestReport PowerTester::short_test() {
   if (power_info_.battery_present) {
     details << "Battery: " << power_info_.battery_percentage << "%\n";
   }
+  if (power_info_.voltage_v > 0) {
+    add_metric("supply_voltage", power_info_.voltage_v, "V");
+  }
+  if (power_info_.current_ma > 0) {
+    add_metric("supply_current", power_info_.current_ma, "mA");
+  }
+  if (power_info_.power_w > 0) {
+    add_metric("supply_power", power_info_.power_w, "W");
+  }
+  if (power_info_.battery_present) {
+    add_metric("battery", power_info_.battery_percentage, "%");
+  }
 
   // Test power source detection
-  TestResult source_result = test_power_source();
+  TestResult source_result = add_check("power_source", test_power_source());
   details << "Power Source Detection: " << (source_result == TestResult::SUCCESS ? "PASS" : "FAIL")
           << "\n";
   if (source_result != TestResult::SUCCESS)
     all_passed = false;
 
   // Test power monitoring
-  TestResult monitor_result = test_power_monitoring();
+  TestResult monitor_result = add_check("power_monitoring", test_power_monitoring());
   details << "Power Monitoring: "
           << (monitor_result == TestResult::SUCCESS
                   ? "PASS"
@@ -121,7 +172,7 @@ TestReport PowerTester::short_test() {
     all_passed = false;
 
   // Test battery if present
-  TestResult battery_result = test_battery();
+  TestResult battery_result = add_check("battery", test_battery());
   details << "Battery Test: "
           << (battery_result == TestResult::SUCCESS
                   ? "PASS"
@@ -131,7 +182,7 @@ TestReport PowerTester::short_test() {
     all_passed = false;
 
   // Test power management
-  TestResult pm_result = test_power_management();
+  TestResult pm_result = add_check("power_management", test_power_management());
   details << "Power Management: " << (pm_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (pm_result != TestResult::SUCCESS)
     all_passed = false;
@@ -156,15 +207,207 @@ TestReport PowerTester::monitor_test(std::chrono::seconds duration) {
   auto end_time      = std::chrono::steady_clock::now();
   auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-  std::string details =
-      "Power monitoring completed for " + std::to_string(duration.count()) + " seconds";
-  return create_report(result, details, test_duration);
+  std::string details = "Power monitoring completed for " + std::to_string(duration.count()) +
+                        " seconds\n" + monitor_details_;
+  return create_monitor_report(result, details, test_duration);
 }
 
 bool PowerTester::is_available() const {
   return power_available_;
 }
 
+TestReport PowerTester::energy_test(const std::string& name, const EnergyMeter::Workload& workload,
+                                    const EnergyMeterConfig& config) {
+  auto start_time = std::chrono::steady_clock::now();
+
+  EnergyMeterConfig run = config;
+  run.cancel            = &cancellation_;
+  EnergyMeter       meter(run);
+  EnergyMeasurement result = meter.measure(name, workload);
+
+  auto end_time = std::chrono::steady_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+  if (!result.success) {
+    return create_report(result.workload_failed ? TestResult::FAILURE : TestResult::NOT_SUPPORTED,
+                         "Energy measurement: " + result.error_message, duration);
+  }
+
+  consumption_.idle_power_w = result.idle_power_w;
+  consumption_.load_power_w = result.average_power_w;
+  consumption_.max_power_w  = result.peak_power_w;
+
+  add_metric("idle_power", result.idle_power_w, "W");
+  add_metric("load_power", result.average_power_w, "W");
+  add_metric("peak_power", result.peak_power_w, "W");
+  add_metric("energy_per_run", result.energy_per_run_j, "J");
+  add_metric("net_energy_per_run", result.net_energy_per_run_j, "J");
+  add_metric("time_per_run", result.run_time_s, "s");
+  add_metric("ops_per_joule", result.ops_per_joule, "ops/J");
+
+  std::stringstream details;
+  details << "Workload: " << result.workload << " (" << result.runs << " runs)\n";
+  details << "Rail: " << result.rail << "\n";
+  details << "Idle power: " << result.idle_power_w << " W\n";
+  details << "Load power: avg " << result.average_power_w << " W, peak " << result.peak_power_w
+          << " W\n";
+  details << "Energy per run: " << result.energy_per_run_j << " J ("
+          << result.net_energy_per_run_j << " J above idle)\n";
+  details << "Time per run: " << result.run_time_s << " s\n";
+  details << "Ops per joule: " << result.ops_per_joule << "\n";
+
+  return create_report(TestResult::SUCCESS, details.str(), duration);
+}
+
+TestReport PowerTester::suspend_test(const SuspendLatencyConfig& config) {
+  auto start_time = std::chrono::steady_clock::now();
+
+  SuspendLatencyProbe  probe(config);
+  SuspendLatencyResult result = probe.run();
+
+  std::stringstream details;
+  details << "State: " << result.state << " (" << result.cycles.size() << " cycles)\n";
+
+  double                          resume_min = 0.0;
+  double                          resume_max = 0.0;
+  double                          resume_sum = 0.0;
+  size_t                          resumes    = 0;
+  std::map<std::string, double>   device_resume;
+  std::map<std::string, uint32_t> device_cycles;
+  for (size_t i = 0; i < result.cycles.size(); ++i) {
+    const SuspendCycle& cycle = result.cycles[i];
+    details << "Cycle " << i + 1 << ": total " << cycle.total_ms << " ms, suspended "
+            << cycle.suspended_ms << " ms, active " << cycle.active_ms << " ms";
+    add_check("cycle_" + std::to_string(i + 1),
+              cycle.success ? TestResult::SUCCESS : TestResult::FAILURE);
+    if (cycle.entry_ms >= 0.0) {
+      details << ", device suspend " << cycle.entry_ms << " ms";
+    }
+    if (cycle.resume_ms >= 0.0) {
+      details << ", device resume " << cycle.resume_ms << " ms";
+    }
+    if (cycle.hw_sleep_ms >= 0.0) {
+      details << ", HW sleep " << cycle.hw_sleep_ms << " ms";
+    }
+    if (!cycle.wakeup_sources.empty() || cycle.wakeup_irq >= 0) {
+      details << ", woken by";
+      for (const auto& source : cycle.wakeup_sources) {
+        details << " " << source;
+      }
+      if (cycle.wakeup_irq >= 0) {
+        details << " (IRQ " << cycle.wakeup_irq << ")";
+      }
+    }
+    details << "\n";
+
+    if (cycle.success && cycle.resume_ms >= 0.0) {
+      resume_min = resumes == 0 ? cycle.resume_ms : std::min(resume_min, cycle.resume_ms);
+      resume_max = std::max(resume_max, cycle.resume_ms);
+      resume_sum += cycle.resume_ms;
+      ++resumes;
+    }
+    for (const auto& device : cycle.devices) {
+      device_resume[device.device] += device.resume_ms;
+      device_cycles[device.device]++;
+    }
+  }
+
+  if (resumes > 0) {
+    details << "Device resume: min " << resume_min << " ms, mean " << resume_sum / resumes
+            << " ms, max " << resume_max << " ms\n";
+    add_metric("resume_min", resume_min, "ms");
+    add_metric("resume_mean", resume_sum / resumes, "ms");
+    add_metric("resume_max", resume_max, "ms");
+  } else if (!result.cycles.empty()) {
+    details << "Device resume: no PM timing in the kernel log (needs CONFIG_PM_SLEEP_DEBUG)\n";
+  }
+
+  // Mean resume time per device, slowest first
+  std::vector<std::pair<double, std::string>> slowest;
+  for (const auto& device : device_resume) {
+    slowest.push_back({device.second / device_cycles[device.first], device.first});
+  }
+  std::sort(slowest.rbegin(), slowest.rend());
+  for (size_t i = 0; i < slowest.size() && i < 5; ++i) {
+    details << "Slow resume: " << slowest[i].second << " " << slowest[i].first << " ms\n";
+  }
+
+  if (!result.error_message.empty()) {
+    details << "Error: " << result.error_message << "\n";
+  }
+
+  auto end_time = std::chrono::steady_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+  TestResult outcome = result.success     ? TestResult::SUCCESS
+                       : result.supported ? TestResult::FAILURE
+                                          : TestResult::NOT_SUPPORTED;
+  return create_report(outcome, details.str(), duration);
+}
+
+TestReport PowerTester::cpufreq_test(const CpufreqSweepConfig& config) {
+  auto start_time = std::chrono::steady_clock::now();
+
+  CpufreqSweepConfig run = config;
+  run.meter.cancel       = &cancellation_;
+  CpufreqSweep       sweep(run);
+  CpufreqSweepResult result = sweep.run();
+
+  auto label = [](const CpufreqOperatingPoint& point) {
+    return point.frequency_khz > 0 ? std::to_string(point.frequency_khz / 1000) + " MHz"
+                                   : point.governor;
+  };
+
+  std::stringstream details;
+  details << "Policies:";
+  for (const auto& policy : result.policies) {
+    details << " " << policy;
+  }
+  details << "\n";
+  for (const auto& point : result.points) {
+    details << label(point) << ": ";
+    if (point.success) {
+      details << point.time_s << " s, " << point.energy_j << " J, " << point.average_power_w
+              << " W" << (point.pareto ? " [Pareto]" : "") << "\n";
+      std::string name = point.frequency_khz > 0
+                             ? std::to_string(point.frequency_khz / 1000) + "mhz"
+                             : point.governor;
+      add_metric(name + "_time", point.time_s, "s");
+      add_metric(name + "_energy", point.energy_j, "J");
+      add_metric(name + "_power", point.average_power_w, "W");
+    } else {
+      details << "FAILED (" << point.error_message << ")\n";
+    }
+  }
+
+  // Front from fastest to most frugal
+  std::vector<CpufreqOperatingPoint> front;
+  std::copy_if(result.points.begin(), result.points.end(), std::back_inserter(front),
+               [](const CpufreqOperatingPoint& point) { return point.pareto; });
+  std::sort(front.begin(), front.end(),
+            [](const CpufreqOperatingPoint& a, const CpufreqOperatingPoint& b) {
+              return a.time_s < b.time_s;
+            });
+  if (!front.empty()) {
+    details << "Pareto front:";
+    for (size_t i = 0; i < front.size(); ++i) {
+      details << (i == 0 ? " " : " -> ") << label(front[i]);
+    }
+    details << "\n";
+  }
+  if (!result.error_message.empty()) {
+    details << "Error: " << result.error_message << "\n";
+  }
+
+  auto end_time = std::chrono::steady_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+  TestResult outcome = result.success     ? TestResult::SUCCESS
+                       : result.supported ? TestResult::FAILURE
+                                          : TestResult::NOT_SUPPORTED;
+  return create_report(outcome, details.str(), duration);
+}
+
 PowerInfo PowerTester::get_power_info() {
   PowerInfo info = {};  // Initialize all members to 0/false/empty
   info.source    = PowerSource::UNKNOWN;
@@ -282,41 +525,90 @@ TestResult PowerTester::test_power_management() {
 }
 
 TestResult PowerTester::monitor_power_consumption(std::chrono::seconds duration) {
-  auto start_time = std::chrono::steady_clock::now();
-  auto end_time   = start_time + duration;
-
-  bool      monitoring_stable = true;
-  PowerInfo initial_info      = get_power_info();
+  PowerInfo initial_info = get_power_info();
 
-  while (std::chrono::steady_clock::now() < end_time && monitoring_stable) {
-    PowerInfo current_info = get_power_info();
+  PowerSamplerConfig config = monitor_config_;
+  config.series_sink        = monitor_series_.sink();
+  PowerSampler sampler(config);
+  bool         sampling = sampler.discover() && sampler.start();
+  cancellation_.wait_for(duration);
+  sampler.stop();
 
-    // Check if power source changed unexpectedly
-    if (current_info.source != initial_info.source) {
-      // Source change is OK, just update
-      initial_info = current_info;
+  std::stringstream details;
+  uint64_t          brownouts = 0;
+  if (sampling) {
+    details << "Telemetry: " << sampler.channels().size() << " channels, "
+            << sampler.samples_taken() << " samples at " << sampler.achieved_rate_hz() << " Hz\n";
+    for (const auto& rail : sampler.rail_stats()) {
+      details << rail.name << ": avg " << rail.average_w << " W, peak " << rail.peak_w
+              << " W, min " << rail.min_w << " W, energy " << rail.energy_j << " J\n";
+      add_metric(rail.name + "_power_avg", rail.average_w, "W");
+      add_metric(rail.name + "_power_peak", rail.peak_w, "W");
+      add_metric(rail.name + "_energy", rail.energy_j, "J");
     }
-
-    // For battery systems, check if battery drains too fast
-    if (current_info.battery_present && initial_info.battery_present) {
-      int drain_rate = initial_info.battery_percentage - current_info.battery_percentage;
-      if (drain_rate > 50) {  // More than 50% drain during monitoring period
-        monitoring_stable = false;
+    for (const auto& rail : sampler.rail_stability()) {
+      if (rail.voltage.count() > 0) {
+        details << rail.name << ": " << rail.voltage.min() << "/" << rail.voltage.mean() << "/"
+                << rail.voltage.max() << " V min/mean/max, ripple "
+                << rail.voltage.stddev() * 1e3 << " mV RMS, "
+                << (rail.voltage.max() - rail.voltage.min()) * 1e3 << " mV p-p\n";
+        add_metric(rail.name + "_voltage_min", rail.voltage.min(), "V");
+        add_metric(rail.name + "_voltage_mean", rail.voltage.mean(), "V");
+        add_metric(rail.name + "_ripple_rms", rail.voltage.stddev() * 1e3, "mV");
+        add_metric(rail.name + "_ripple_pp", (rail.voltage.max() - rail.voltage.min()) * 1e3,
+                   "mV");
+        add_metric(rail.name + "_brownouts", static_cast<double>(rail.dip_count), "", NO_LIMIT,
+                   0.0);
+      }
+      if (rail.current.count() > 0) {
+        details << rail.name << ": " << rail.current.min() << "/" << rail.current.mean() << "/"
+                << rail.current.max() << " A min/mean/max\n";
+      }
+      if (rail.dip_count == 0) {
+        continue;
+      }
+      brownouts += rail.dip_count;
+      details << rail.name << ": " << rail.dip_count << " brown-outs, longest "
+              << rail.longest_dip_ms << " ms, total " << rail.total_dip_ms << " ms\n";
+      for (const auto& dip : rail.dips) {
+        details << "  dip at " << format_wall_time(dip.start) << ": " << dip.duration_ms
+                << " ms, min " << dip.min_voltage_v << " V (threshold " << dip.threshold_v
+                << " V)" << (dip.ongoing ? ", ongoing" : "") << "\n";
       }
     }
+    monitor_series_ = sampler.power_series();  // Carries the same sink
+  } else {
+    monitor_series_.clear();
+    details << "Telemetry: no voltage/current/power channels found\n";
+  }
+  monitor_details_ = details.str();
 
-    std::this_thread::sleep_for(std::chrono::seconds(5));
+  if (brownouts > 0) {
+    return TestResult::FAILURE;
   }
 
-  return monitoring_stable ? TestResult::SUCCESS : TestResult::FAILURE;
+  // For battery systems, check if battery drains too fast
+  PowerInfo final_info = get_power_info();
+  if (final_info.battery_present && initial_info.battery_present &&
+      initial_info.battery_percentage - final_info.battery_percentage > 50) {
+    return TestResult::FAILURE;
+  }
+  return TestResult::SUCCESS;
 }
 
 PowerConsumption PowerTester::measure_power_consumption() {
   PowerConsumption consumption = {0.0, 0.0, 0.0, 0.0};
 
-  // This would require specialized hardware to measure actual power consumption
-  // For now, return placeholder values
-
+  EnergyMeterConfig config;
+  config.runs            = 1;
+  EnergyMeasurement load = EnergyMeter(config).measure("cpu-spin", []() {
+    return EnergyMeter::cpu_spin(std::chrono::milliseconds(1000));
+  });
+  if (load.success) {
+    consumption.idle_power_w = load.idle_power_w;
+    consumption.load_power_w = load.average_power_w;
+    consumption.max_power_w  = load.peak_power_w;
+  }
   return consumption;
 }
 
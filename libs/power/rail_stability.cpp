@@ -0,0 +1,140 @@
+/**
+ * @file rail_stability.cpp
+ * @brief Implementation of the streaming rail ripple and brown-out tracker.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "rail_stability.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr uint64_t MIN_REFERENCE_SAMPLES = 8;  // Before a relative threshold is trusted
+
+}  // namespace
+
+void StreamingStats::add(double value) {
+  ++count_;
+  if (count_ == 1) {
+    min_ = value;
+    max_ = value;
+  } else {
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+  double delta = value - mean_;
+  mean_ += delta / count_;
+  m2_ += delta * (value - mean_);
+}
+
+void StreamingStats::reset() {
+  *this = StreamingStats();
+}
+
+double StreamingStats::variance() const {
+  return count_ > 1 ? m2_ / count_ : 0.0;
+}
+
+double StreamingStats::stddev() const {
+  return std::sqrt(variance());
+}
+
+RailStabilityTracker::RailStabilityTracker(const BrownoutConfig& config)
+    : config_(config),
+      wall_offset_(std::chrono::system_clock::now().time_since_epoch() -
+                   std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                       std::chrono::steady_clock::now().time_since_epoch())) {
+  config_.max_events = std::max<size_t>(config_.max_events, 1);
+}
+
+void RailStabilityTracker::reset(const std::vector<std::string>& rail_names) {
+  rails_.assign(rail_names.size(), RailState());
+  for (size_t r = 0; r < rail_names.size(); ++r) {
+    rails_[r].stats.name = rail_names[r];
+  }
+}
+
+double RailStabilityTracker::threshold(const RailState& state) const {
+  auto absolute = config_.absolute_threshold_v.find(state.stats.name);
+  if (absolute != config_.absolute_threshold_v.end()) {
+    return absolute->second;
+  }
+  if (config_.relative_threshold <= 0.0 ||
+      state.stats.voltage.count() < MIN_REFERENCE_SAMPLES) {
+    return 0.0;
+  }
+  return config_.relative_threshold * state.stats.voltage.mean();
+}
+
+void RailStabilityTracker::add(size_t rail, std::chrono::steady_clock::time_point timestamp,
+                               double voltage, double current, double power) {
+  if (rail >= rails_.size()) {
+    return;
+  }
+  RailState& state = rails_[rail];
+  state.stats.power.add(power);
+  if (!std::isnan(current)) {
+    state.stats.current.add(current);
+  }
+  state.last_sample = timestamp;
+  if (std::isnan(voltage)) {
+    return;
+  }
+
+  // Compare against the reference before this sample can drag the mean down
+  double limit = threshold(state);
+  if (voltage < limit) {
+    if (!state.in_dip) {
+      state.in_dip          = true;
+      state.dip_start       = timestamp;
+      state.dip_min_v       = voltage;
+      state.dip_threshold_v = limit;
+    }
+    state.dip_min_v = std::min(state.dip_min_v, voltage);
+  } else if (state.in_dip) {
+    close_dip(state, timestamp);
+  }
+  state.stats.voltage.add(voltage);
+}
+
+void RailStabilityTracker::close_dip(RailState&                             state,
+                                     std::chrono::steady_clock::time_point end) const {
+  BrownoutEvent event;
+  event.start = std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          state.dip_start.time_since_epoch()) +
+      wall_offset_);
+  event.duration_ms   = std::chrono::duration<double, std::milli>(end - state.dip_start).count();
+  event.min_voltage_v = state.dip_min_v;
+  event.threshold_v   = state.dip_threshold_v;
+
+  state.in_dip = false;
+  state.stats.dip_count++;
+  state.stats.total_dip_ms += event.duration_ms;
+  state.stats.longest_dip_ms = std::max(state.stats.longest_dip_ms, event.duration_ms);
+  state.dips.push_back(event);
+  if (state.dips.size() > config_.max_events) {
+    state.dips.pop_front();
+  }
+}
+
+std::vector<RailStability> RailStabilityTracker::snapshot() const {
+  std::vector<RailStability> result;
+  for (const auto& rail : rails_) {
+    RailState state = rail;
+    if (state.in_dip) {
+      close_dip(state, state.last_sample);
+      state.dips.back().ongoing = true;
+    }
+    state.stats.dips.assign(state.dips.begin(), state.dips.end());
+    result.push_back(state.stats);
+  }
+  return result;
+}
+
+}  // namespace imx93_peripheral_test
@@ -0,0 +1,336 @@
+/**
+ * @file suspend_latency.cpp
+ * @brief Implementation of the suspend/resume latency probe.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "suspend_latency.h"
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+std::string read_line(const fs::path& path) {
+  std::ifstream file(path);
+  std::string   line;
+  std::getline(file, line);
+  return line;
+}
+
+/**
+ * @brief Reads an integer attribute; -1 if it is missing or unreadable.
+ */
+long long read_counter(const fs::path& path) {
+  std::string line = read_line(path);
+  if (line.empty()) {
+    return -1;
+  }
+  char*     end   = nullptr;
+  long long value = strtoll(line.c_str(), &end, 10);
+  return end == line.c_str() ? -1 : value;
+}
+
+/**
+ * @brief Writes a sysfs attribute in one write(); errno is set on failure.
+ */
+bool write_attribute(const fs::path& path, const std::string& value) {
+  int fd = open(path.c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  ssize_t written = write(fd, value.data(), value.size());
+  int     saved   = errno;
+  close(fd);
+  errno = saved;
+  return written == static_cast<ssize_t>(value.size());
+}
+
+double elapsed_ms(const timespec& start, const timespec& end) {
+  return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+/**
+ * @brief Sets a sysfs attribute for the lifetime of the object.
+ *
+ * Selector attributes such as mem_sleep list every choice with the active
+ * one in brackets; only the bracketed word is saved for restoring.
+ */
+class ScopedAttribute {
+public:
+  ScopedAttribute(const fs::path& path, const std::string& value) : path_(path) {
+    std::string current = read_line(path);
+    size_t      open    = current.find('[');
+    size_t      close   = current.find(']');
+    if (open != std::string::npos && close != std::string::npos && close > open) {
+      current = current.substr(open + 1, close - open - 1);
+    }
+    if (!current.empty() && write_attribute(path, value)) {
+      previous_ = current;
+      applied_  = true;
+    }
+  }
+
+  ~ScopedAttribute() {
+    if (applied_) {
+      write_attribute(path_, previous_);
+    }
+  }
+
+  ScopedAttribute(const ScopedAttribute&)            = delete;
+  ScopedAttribute& operator=(const ScopedAttribute&) = delete;
+
+  bool applied() const {
+    return applied_;
+  }
+
+private:
+  fs::path    path_;
+  std::string previous_;
+  bool        applied_ = false;
+};
+
+/**
+ * @brief Returns wakeup_count of every wakeup source, keyed by name.
+ */
+std::map<std::string, long long> wakeup_counts(const fs::path& root) {
+  std::map<std::string, long long> counts;
+  std::error_code                  ec;
+  for (const auto& entry : fs::directory_iterator(root / "class/wakeup", ec)) {
+    std::string name = read_line(entry.path() / "name");
+    if (name.empty()) {
+      name = entry.path().filename().string();
+    }
+    counts[name] = read_counter(entry.path() / "wakeup_count");
+  }
+  return counts;
+}
+
+/**
+ * @brief Reads kernel log records appended since construction.
+ */
+class KmsgReader {
+public:
+  explicit KmsgReader(const std::string& path)
+      : fd_(open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC)) {
+    if (fd_ >= 0) {
+      lseek(fd_, 0, SEEK_END);
+    }
+  }
+
+  ~KmsgReader() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  KmsgReader(const KmsgReader&)            = delete;
+  KmsgReader& operator=(const KmsgReader&) = delete;
+
+  /**
+   * @brief Returns the messages of all new records, without the prefix.
+   */
+  std::vector<std::string> drain() {
+    std::vector<std::string> lines;
+    char                     record[8192];
+    while (fd_ >= 0) {
+      // /dev/kmsg returns one record per read(); EPIPE means records were overwritten
+      ssize_t length = read(fd_, record, sizeof(record) - 1);
+      if (length < 0 && errno == EPIPE) {
+        continue;
+      }
+      if (length <= 0) {
+        break;
+      }
+      std::string text(record, length);
+      size_t      start = text.find(';');
+      start             = start == std::string::npos ? 0 : start + 1;
+      lines.push_back(text.substr(start, text.find('\n', start) - start));
+    }
+    return lines;
+  }
+
+private:
+  int fd_;
+};
+
+}  // namespace
+
+SuspendLatencyProbe::SuspendLatencyProbe(const SuspendLatencyConfig& config) : config_(config) {}
+
+SuspendLatencyResult SuspendLatencyProbe::run() {
+  SuspendLatencyResult result;
+  result.state = config_.state;
+  fs::path root(config_.sysfs_root);
+
+  std::istringstream states(read_line(root / "power/state"));
+  std::string        available;
+  bool               listed = false;
+  for (std::string state; states >> state;) {
+    listed = listed || state == config_.state;
+    available += (available.empty() ? "" : " ") + state;
+  }
+  if (!listed) {
+    result.error_message = "State '" + config_.state + "' not supported (available: " +
+                           (available.empty() ? "none" : available) + ")";
+    return result;
+  }
+  if (!fs::exists(root / "class/rtc" / config_.rtc / "wakealarm")) {
+    result.error_message = "No RTC wake alarm for " + config_.rtc;
+    return result;
+  }
+  result.supported = true;
+  if (config_.cycles == 0) {
+    result.error_message = "No cycles requested";
+    return result;
+  }
+
+  // Per-phase and per-device timings in the kernel log; absent without CONFIG_PM_SLEEP_DEBUG
+  ScopedAttribute                  print_times(root / "power/pm_print_times", "1");
+  ScopedAttribute                  debug_messages(root / "power/pm_debug_messages", "1");
+  std::unique_ptr<ScopedAttribute> mem_sleep;
+  if (config_.state == "mem" && !config_.mem_sleep.empty()) {
+    mem_sleep = std::make_unique<ScopedAttribute>(root / "power/mem_sleep", config_.mem_sleep);
+    if (!mem_sleep->applied()) {
+      result.error_message = "Cannot select mem_sleep '" + config_.mem_sleep + "'";
+      return result;
+    }
+  }
+
+  for (uint32_t i = 0; i < config_.cycles; ++i) {
+    if (i > 0) {
+      std::this_thread::sleep_for(config_.settle);
+    }
+    SuspendCycle cycle;
+    run_cycle(cycle);
+    result.cycles.push_back(cycle);
+    if (!cycle.success) {
+      result.error_message = "Cycle " + std::to_string(i + 1) + ": " + cycle.error_message;
+      return result;
+    }
+  }
+  result.success = true;
+  return result;
+}
+
+void SuspendLatencyProbe::run_cycle(SuspendCycle& cycle) {
+  fs::path root(config_.sysfs_root);
+  fs::path stats = root / "power/suspend_stats";
+  fs::path alarm = root / "class/rtc" / config_.rtc / "wakealarm";
+
+  long long                        success_before = read_counter(stats / "success");
+  std::map<std::string, long long> wake_before    = wakeup_counts(root);
+  KmsgReader                       kmsg(config_.kmsg_path);
+
+  // An armed alarm must be cleared before a new one is accepted
+  if (!write_attribute(alarm, "0") ||
+      !write_attribute(alarm, "+" + std::to_string(config_.wake_after.count()))) {
+    cycle.error_message = std::string("Cannot arm RTC wake alarm: ") + strerror(errno);
+    return;
+  }
+
+  // The write blocks until the system has resumed
+  timespec boot_start, mono_start, mono_end, boot_end;
+  clock_gettime(CLOCK_BOOTTIME, &boot_start);
+  clock_gettime(CLOCK_MONOTONIC, &mono_start);
+  bool entered = write_attribute(root / "power/state", config_.state);
+  int  error   = errno;
+  clock_gettime(CLOCK_MONOTONIC, &mono_end);
+  clock_gettime(CLOCK_BOOTTIME, &boot_end);
+  write_attribute(alarm, "0");
+
+  cycle.total_ms     = elapsed_ms(boot_start, boot_end);
+  cycle.active_ms    = elapsed_ms(mono_start, mono_end);
+  cycle.suspended_ms = std::max(0.0, cycle.total_ms - cycle.active_ms);
+
+  long long hw_sleep_us = read_counter(stats / "last_hw_sleep");
+  if (hw_sleep_us >= 0) {
+    cycle.hw_sleep_ms = hw_sleep_us / 1e3;
+  }
+  cycle.wakeup_irq = static_cast<int>(read_counter(root / "power/pm_wakeup_irq"));
+  for (const auto& source : wakeup_counts(root)) {
+    auto before = wake_before.find(source.first);
+    if (before != wake_before.end() && source.second > before->second) {
+      cycle.wakeup_sources.push_back(source.first);
+    }
+  }
+  parse_pm_log(kmsg.drain(), cycle);
+
+  if (!entered) {
+    cycle.error_message = "Writing '" + config_.state + "' to power/state failed: " +
+                          strerror(error);
+  } else if (success_before >= 0 && read_counter(stats / "success") <= success_before) {
+    cycle.error_message = "suspend_stats reports no successful suspend";
+  }
+  if (!cycle.error_message.empty()) {
+    std::string failed_device = read_line(stats / "last_failed_dev");
+    if (!failed_device.empty()) {
+      cycle.error_message += " (last failed device: " + failed_device + ")";
+    }
+    return;
+  }
+  cycle.success = true;
+}
+
+void SuspendLatencyProbe::parse_pm_log(const std::vector<std::string>& lines,
+                                       SuspendCycle&                   cycle) {
+  // "PM: noirq resume of devices complete after 1.234 msecs" (pm_debug_messages)
+  static const std::regex phase(
+      "(?:noirq |late |early )?(suspend|resume) of devices (?:complete|aborted) after "
+      "([0-9]+(?:\\.[0-9]+)?) msecs");
+  // "<driver> <device>: pci_pm_resume+0x0/0xe0 returned 0 after 812 usecs" (pm_print_times)
+  static const std::regex callback("^(.*?): (\\S+) returned -?[0-9]+ after ([0-9]+) usecs");
+
+  cycle.entry_ms  = -1.0;
+  cycle.resume_ms = -1.0;
+  cycle.devices.clear();
+
+  for (const auto& line : lines) {
+    std::smatch match;
+    if (std::regex_search(line, match, phase)) {
+      double& total = match[1].str() == "resume" ? cycle.resume_ms : cycle.entry_ms;
+      total         = std::max(total, 0.0) + std::stod(match[2].str());
+    } else if (std::regex_search(line, match, callback)) {
+      std::string name = match[2].str();
+      bool        resume =
+          name.find("resume") != std::string::npos || name.find("restore") != std::string::npos ||
+          name.find("thaw") != std::string::npos || name.find("complete") != std::string::npos;
+      double ms = std::stod(match[3].str()) / 1e3;
+
+      auto device = std::find_if(
+          cycle.devices.begin(), cycle.devices.end(),
+          [&match](const DeviceSuspendTime& item) { return item.device == match[1].str(); });
+      if (device == cycle.devices.end()) {
+        cycle.devices.push_back({match[1].str(), 0.0, 0.0});
+        device = cycle.devices.end() - 1;
+      }
+      (resume ? device->resume_ms : device->suspend_ms) += ms;
+    }
+  }
+
+  // Slowest to resume first
+  std::stable_sort(cycle.devices.begin(), cycle.devices.end(),
+                   [](const DeviceSuspendTime& a, const DeviceSuspendTime& b) {
+                     return a.resume_ms > b.resume_ms;
+                   });
+}
+
+}  // namespace imx93_peripheral_test
@@ -14,6 +14,7 @@
 
 #include "storage_tester.h"
 
+#include <fcntl.h>
 #include <sys/statvfs.h>
 #include <unistd.h>
 
@@ -25,22 +26,34 @@
 #include <iostream>
 #include <sstream>
 #include <thread>
+#include <vector>
 
 namespace fs = std::filesystem;
 
 namespace imx93_peripheral_test {
 
 /**
- * @brief Constructs a Storage tester instance.
+ * @brief Constructs a Storage tester instance; discovery is left to prepare().
+ */
+StorageTester::StorageTester() : storage_available_(false) {}
+
+/**
+ * @brief Returns true if block device information exists.
+ */
+bool StorageTester::probe() {
+  return fs::exists("/dev") && (fs::exists("/sys/block") || fs::exists("/proc/diskstats"));
+}
+
+/**
+ * @brief Discovers the Storage peripheral.
  *
  * Initializes the Storage tester by checking for available storage devices
  * and enumerating all detected storage peripherals on the system.
  * For i.MX93, looks for eMMC, SD/MMC (uSDHC controllers), and optional PCIe storage.
  */
-StorageTester::StorageTester() : storage_available_(false) {
+void StorageTester::discover() {
   // Check if storage devices are available
-  storage_available_ =
-      fs::exists("/dev") && (fs::exists("/sys/block") || fs::exists("/proc/diskstats"));
+  storage_available_ = probe();
   if (storage_available_) {
     storage_devices_ = enumerate_storage_devices();
   }
@@ -73,6 +86,7 @@ TestReport StorageTester::short_test() {
   bool              all_passed = true;
 
   details << "Found " << storage_devices_.size() << " storage device(s)\n";
+  add_metric("storage_devices", static_cast<double>(storage_devices_.size()), "");
 
   for (const auto& device : storage_devices_) {
     details << "- " << device.device_path << " (" << device.size_gb << "GB";
@@ -83,7 +97,7 @@ TestReport StorageTester::short_test() {
   }
 
   // Test different storage types
-  TestResult emmc_result = test_emmc();
+  TestResult emmc_result = add_check("emmc", test_emmc());
   details << "eMMC: "
           << (emmc_result == TestResult::SUCCESS
                   ? "PASS"
@@ -92,7 +106,7 @@ TestReport StorageTester::short_test() {
   if (emmc_result != TestResult::SUCCESS && emmc_result != TestResult::NOT_SUPPORTED)
     all_passed = false;
 
-  TestResult sdcard_result = test_sdcard();
+  TestResult sdcard_result = add_check("sdcard", test_sdcard());
   details << "SD Card: "
           << (sdcard_result == TestResult::SUCCESS
                   ? "PASS"
@@ -101,7 +115,7 @@ TestReport StorageTester::short_test() {
   if (sdcard_result != TestResult::SUCCESS && sdcard_result != TestResult::NOT_SUPPORTED)
     all_passed = false;
 
-  TestResult nvme_result = test_nvme();
+  TestResult nvme_result = add_check("nvme", test_nvme());
   details << "NVMe: "
           << (nvme_result == TestResult::SUCCESS
                   ? "PASS"
@@ -110,7 +124,7 @@ TestReport StorageTester::short_test() {
   if (nvme_result != TestResult::SUCCESS && nvme_result != TestResult::NOT_SUPPORTED)
     all_passed = false;
 
-  TestResult pcie_result = test_pcie();
+  TestResult pcie_result = add_check("pcie", test_pcie());
   details << "PCIe: "
           << (pcie_result == TestResult::SUCCESS
                   ? "PASS"
@@ -119,7 +133,7 @@ TestReport StorageTester::short_test() {
   if (pcie_result != TestResult::SUCCESS && pcie_result != TestResult::NOT_SUPPORTED)
     all_passed = false;
 
-  TestResult m2_result = test_m2();
+  TestResult m2_result = add_check("m2", test_m2());
   details << "M.2: "
           << (m2_result == TestResult::SUCCESS
                   ? "PASS"
@@ -161,9 +175,9 @@ TestReport StorageTester::monitor_test(std::chrono::seconds duration) {
   auto end_time      = std::chrono::steady_clock::now();
   auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-  std::string details =
-      "Storage monitoring completed for " + std::to_string(duration.count()) + " seconds";
-  return create_report(result, details, test_duration);
+  std::string details = "Storage monitoring completed for " + std::to_string(duration.count()) +
+                        " seconds\n";
+  return create_monitor_report(result, details, test_duration);
 }
 
 /**
@@ -260,6 +274,8 @@ TestResult StorageTester::test_emmc() {
       emmc_found = true;
       // Check for expected 32GB FORESEE eMMC
       bool correct_size = (device.size_gb >= 28 && device.size_gb <= 36);  // Allow some variation
+      add_metric(fs::path(device.device_path).filename().string() + "_size",
+                 static_cast<double>(device.size_gb), "GB", 28, 36);
       if (!correct_size) {
         return TestResult::FAILURE;
       }
@@ -400,24 +416,34 @@ TestResult StorageTester::test_m2() {
  * @note Uses temporary files in /tmp for testing to avoid damaging devices.
  */
 TestResult StorageTester::test_storage_performance(const std::string& device_path) {
-  (void)device_path;  // Parameter not used in current implementation
-  // Simple storage performance test using dd
+  // Simple storage performance test using dd; the file lives in /tmp, the device names the metrics
   std::string test_file =
       "/tmp/storage_test_" +
       std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
 
+  const double TEST_MB = 10.0;
+  std::string  device  = fs::path(device_path).filename().string();
+
   // Write test
   std::string write_cmd =
       "timeout 10 dd if=/dev/zero of=" + test_file + " bs=1M count=10 2>/dev/null";
-  int write_result = system(write_cmd.c_str());
+  auto                          write_start  = std::chrono::steady_clock::now();
+  int                           write_result = system(write_cmd.c_str());
+  std::chrono::duration<double> write_time   = std::chrono::steady_clock::now() - write_start;
 
   if (write_result != 0) {
     return TestResult::FAILURE;
   }
+  add_metric(device + "_write_speed", TEST_MB / write_time.count(), "MB/s");
 
   // Read test
   std::string read_cmd    = "timeout 10 dd if=" + test_file + " of=/dev/null bs=1M 2>/dev/null";
+  auto        read_start  = std::chrono::steady_clock::now();
   int         read_result = system(read_cmd.c_str());
+  if (read_result == 0) {
+    std::chrono::duration<double> read_time = std::chrono::steady_clock::now() - read_start;
+    add_metric(device + "_read_speed", TEST_MB / read_time.count(), "MB/s");
+  }
 
   // Cleanup
   unlink(test_file.c_str());
@@ -442,7 +468,13 @@ TestResult StorageTester::monitor_storage_io(std::chrono::seconds duration) {
   auto start_time = std::chrono::steady_clock::now();
   auto end_time   = start_time + duration;
 
-  std::vector<uint64_t> read_counts, write_counts;
+  monitor_series_.clear();
+  size_t   read_rate    = monitor_series_.add_series("storage_reads", "ops/s");
+  size_t   write_rate   = monitor_series_.add_series("storage_writes", "ops/s");
+  size_t   samples      = 0;
+  uint64_t first_reads  = 0, first_writes = 0;
+  uint64_t last_reads   = 0, last_writes = 0;
+  auto     last_sampled = start_time;
 
   while (std::chrono::steady_clock::now() < end_time) {
     std::ifstream diskstats("/proc/diskstats");
@@ -461,20 +493,33 @@ TestResult StorageTester::monitor_storage_io(std::chrono::seconds duration) {
         total_writes += writes;
       }
 
-      read_counts.push_back(total_reads);
-      write_counts.push_back(total_writes);
+      auto now = std::chrono::steady_clock::now();
+      if (samples == 0) {
+        first_reads  = total_reads;
+        first_writes = total_writes;
+      } else {
+        double seconds = std::chrono::duration<double>(now - last_sampled).count();
+        monitor_series_.add(read_rate, (total_reads - last_reads) / seconds);
+        monitor_series_.add(write_rate, (total_writes - last_writes) / seconds);
+      }
+      last_reads   = total_reads;
+      last_writes  = total_writes;
+      last_sampled = now;
+      samples++;
     }
 
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+    if (cancellation_.wait_for(std::chrono::seconds(1))) {
+      break;
+    }
   }
 
-  if (read_counts.size() < 2) {
+  if (samples < 2) {
     return TestResult::FAILURE;
   }
 
   // Check for I/O activity (should be relatively stable)
-  uint64_t read_variation  = read_counts.back() - read_counts.front();
-  uint64_t write_variation = write_counts.back() - write_counts.front();
+  uint64_t read_variation  = last_reads - first_reads;
+  uint64_t write_variation = last_writes - first_writes;
 
   // Allow some I/O variation but not excessive
   return (read_variation < 10000 && write_variation < 10000) ? TestResult::SUCCESS
@@ -527,4 +572,79 @@ TestResult StorageTester::test_filesystem_integrity(const std::string& mount_poi
   return (content == "test data") ? TestResult::SUCCESS : TestResult::FAILURE;
 }
 
+/**
+ * @brief Keeps the storage stack busy with write/verify passes until stopped.
+ *
+ * Each pass rewrites the scratch file with 1 MB blocks stamped with the pass
+ * and block number, forces them to the medium with fdatasync(), drops them
+ * from the page cache and reads them back, so the verify really hits the
+ * device rather than RAM. The file is removed when the load ends.
+ *
+ * @note The page-cache drop is advisory; on filesystems that ignore it the
+ *       read-back half of each pass measures cache bandwidth.
+ */
+TestResult StorageTester::stress(uint32_t intensity, const std::atomic<bool>& stop,
+                                 StressCounters& counters) {
+  const size_t BLOCK_WORDS = 1024 * 1024 / sizeof(uint64_t);
+  const size_t BLOCK_BYTES = BLOCK_WORDS * sizeof(uint64_t);
+
+  size_t      blocks    = intensity > 0 ? intensity : 32;
+  std::string test_file = stress_path_ + "/.storage_stress_" + std::to_string(getpid());
+  int         fd        = open(test_file.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    return TestResult::NOT_SUPPORTED;
+  }
+
+  std::vector<uint64_t> block(BLOCK_WORDS);
+  std::vector<uint64_t> readback(BLOCK_WORDS);
+  bool                  io_ok = true;
+  auto stamp = [&block](uint64_t pass, size_t index) {
+    for (size_t i = 0; i < block.size(); ++i) {
+      block[i] = (pass << 40) ^ (static_cast<uint64_t>(index) << 20) ^ i;
+    }
+  };
+
+  for (uint64_t pass = 1; io_ok && !stop.load(std::memory_order_relaxed); ++pass) {
+    size_t written = 0;
+    for (; written < blocks && !stop.load(std::memory_order_relaxed); ++written) {
+      stamp(pass, written);
+      if (pwrite(fd, block.data(), BLOCK_BYTES, written * BLOCK_BYTES) !=
+          static_cast<ssize_t>(BLOCK_BYTES)) {
+        io_ok = false;
+        break;
+      }
+      counters.bytes += BLOCK_BYTES;
+    }
+    if (!io_ok || fdatasync(fd) != 0) {
+      io_ok = false;
+      break;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+
+    for (size_t index = 0; index < written; ++index) {
+      if (pread(fd, readback.data(), BLOCK_BYTES, index * BLOCK_BYTES) !=
+          static_cast<ssize_t>(BLOCK_BYTES)) {
+        io_ok = false;
+        break;
+      }
+      stamp(pass, index);
+      if (memcmp(block.data(), readback.data(), BLOCK_BYTES) != 0) {
+        counters.errors++;
+      }
+      counters.bytes += BLOCK_BYTES;
+    }
+    if (io_ok && written == blocks) {
+      counters.operations++;
+    }
+  }
+
+  close(fd);
+  unlink(test_file.c_str());
+  if (!io_ok) {
+    counters.errors++;
+    return TestResult::FAILURE;
+  }
+  return counters.errors.load() == 0 ? TestResult::SUCCESS : TestResult::FAILURE;
+}
+
 }  // namespace imx93_peripheral_test
\ No newline at end of file
@@ -0,0 +1,315 @@
+/**
+ * @file telemetry_reader.cpp
+ * @brief Implementation of the memory-mapped telemetry reader and exporters.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "telemetry_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "json_utils.h"
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr size_t OUTPUT_CHUNK = 1 << 16;  // Bytes buffered before each stream write
+
+/**
+ * @brief Appends a CSV field, quoting it if needed.
+ */
+void append_csv_field(std::string& out, const std::string& field) {
+  if (field.find_first_of(",\"\n") == std::string::npos) {
+    out += field;
+    return;
+  }
+  out += '"';
+  for (char c : field) {
+    if (c == '"') {
+      out += '"';
+    }
+    out += c;
+  }
+  out += '"';
+}
+
+/**
+ * @brief Appends a number the way both exporters print it.
+ */
+void append_number(std::string& out, double value) {
+  char buffer[32];
+  int  length = std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+  out.append(buffer, static_cast<size_t>(length));
+}
+
+}  // namespace
+
+TelemetryReader::~TelemetryReader() {
+  close();
+}
+
+bool TelemetryReader::open(const std::string& path) {
+  close();
+  error_.clear();
+
+  fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat status;
+  if (fd_ < 0 || fstat(fd_, &status) != 0) {
+    error_ = "Cannot open " + path + ": " + std::strerror(errno);
+    close();
+    return false;
+  }
+  size_ = static_cast<uint64_t>(status.st_size);
+  if (size_ < sizeof(TelemetryFileHeader)) {
+    error_ = path + " is not a telemetry recording";
+    close();
+    return false;
+  }
+  void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  if (map == MAP_FAILED) {
+    error_ = "Cannot map " + path + ": " + std::strerror(errno);
+    close();
+    return false;
+  }
+  data_ = static_cast<const uint8_t*>(map);
+
+  TelemetryFileHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+  if (std::memcmp(header.magic, TELEMETRY_MAGIC, sizeof(header.magic)) != 0) {
+    error_ = path + " is not a telemetry recording";
+    close();
+    return false;
+  }
+  if (header.version != TELEMETRY_VERSION || header.record_size != sizeof(TelemetryRecord)) {
+    error_ = path + ": unsupported recording version " + std::to_string(header.version);
+    close();
+    return false;
+  }
+  created_unix_ns_ = header.created_unix_ns;
+
+  // Only headers are read here; data payloads are left to the page cache until used
+  uint64_t offset   = sizeof(header);
+  uint64_t sequence = 0;
+  while (size_ - offset >= sizeof(TelemetryBlockHeader)) {
+    TelemetryBlockHeader block;
+    std::memcpy(&block, data_ + offset, sizeof(block));
+    uint64_t payload_offset = offset + sizeof(block);
+    if (block.magic != TELEMETRY_BLOCK_MAGIC || block.sequence != sequence ||
+        block.payload_size > size_ - payload_offset) {
+      break;
+    }
+    const uint8_t* payload = data_ + payload_offset;
+    auto           type    = static_cast<TelemetryBlockType>(block.type);
+    if (type == TelemetryBlockType::DATA) {
+      if (block.payload_size % sizeof(TelemetryRecord) != 0) {
+        break;
+      }
+      DataBlock data;
+      data.offset  = payload_offset;
+      data.records = block.payload_size / sizeof(TelemetryRecord);
+      data.crc32   = block.crc32;
+      blocks_.push_back(data);
+    } else if (type == TelemetryBlockType::SCHEMA || type == TelemetryBlockType::INDEX) {
+      if (telemetry_crc32(payload, block.payload_size) != block.crc32) {
+        break;
+      }
+      if (type == TelemetryBlockType::SCHEMA) {
+        parse_schema(payload, block.payload_size);
+      } else {
+        apply_index(payload, block.payload_size);
+      }
+    } else {
+      break;
+    }
+    offset = payload_offset + block.payload_size;
+    ++sequence;
+  }
+  valid_bytes_ = offset;
+  return true;
+}
+
+void TelemetryReader::close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+    data_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  size_            = 0;
+  valid_bytes_     = 0;
+  created_unix_ns_ = 0;
+  corrupt_blocks_  = 0;
+  metrics_.clear();
+  metric_index_.clear();
+  blocks_.clear();
+}
+
+uint64_t TelemetryReader::record_count() const {
+  uint64_t count = 0;
+  for (const auto& block : blocks_) {
+    count += block.records;
+  }
+  return count;
+}
+
+void TelemetryReader::parse_schema(const uint8_t* payload, size_t size) {
+  size_t position = 0;
+  while (size - position >= 8) {
+    uint32_t id;
+    uint16_t name_size;
+    uint16_t unit_size;
+    std::memcpy(&id, payload + position, sizeof(id));
+    std::memcpy(&name_size, payload + position + 4, sizeof(name_size));
+    std::memcpy(&unit_size, payload + position + 6, sizeof(unit_size));
+    position += 8;
+    if (size - position < static_cast<size_t>(name_size) + unit_size) {
+      return;
+    }
+    TelemetryMetric metric;
+    metric.id   = id;
+    metric.name = std::string(reinterpret_cast<const char*>(payload + position), name_size);
+    metric.unit = std::string(reinterpret_cast<const char*>(payload + position + name_size),
+                              unit_size);
+    position += name_size + unit_size;
+
+    if (id >= metric_index_.size()) {
+      metric_index_.resize(id + 1, -1);
+    }
+    if (metric_index_[id] >= 0) {
+      metrics_[metric_index_[id]] = metric;
+    } else {
+      metric_index_[id] = static_cast<int32_t>(metrics_.size());
+      metrics_.push_back(metric);
+    }
+  }
+}
+
+void TelemetryReader::apply_index(const uint8_t* payload, size_t size) {
+  for (size_t position = 0; size - position >= sizeof(TelemetryIndexEntry);
+       position += sizeof(TelemetryIndexEntry)) {
+    TelemetryIndexEntry entry;
+    std::memcpy(&entry, payload + position, sizeof(entry));
+    uint64_t payload_offset = entry.offset + sizeof(TelemetryBlockHeader);
+    auto     block          = std::lower_bound(
+        blocks_.begin(), blocks_.end(), payload_offset,
+        [](const DataBlock& candidate, uint64_t offset) { return candidate.offset < offset; });
+    if (block != blocks_.end() && block->offset == payload_offset) {
+      block->first_ns = entry.first_ns;
+      block->last_ns  = entry.last_ns;
+      block->indexed  = true;
+    }
+  }
+}
+
+std::vector<bool> TelemetryReader::metric_mask(const TelemetryRange& range) const {
+  std::vector<bool> mask(metric_index_.size(), false);
+  for (const auto& metric : metrics_) {
+    mask[metric.id] = range.metrics.empty() || std::find(range.metrics.begin(),
+                                                         range.metrics.end(),
+                                                         metric.name) != range.metrics.end();
+  }
+  return mask;
+}
+
+uint64_t TelemetryReader::for_each(const TelemetryRange&                             range,
+                                   const std::function<void(const TelemetryRecord&)>& callback) {
+  std::vector<bool> mask  = metric_mask(range);
+  uint64_t          count = 0;
+  for (auto& block : blocks_) {
+    if (block.indexed && (block.last_ns < range.from_ns || block.first_ns > range.to_ns)) {
+      continue;
+    }
+    const uint8_t* payload = data_ + block.offset;
+    size_t         size    = block.records * sizeof(TelemetryRecord);
+    if (!block.checked) {
+      block.checked = true;
+      block.corrupt = telemetry_crc32(payload, size) != block.crc32;
+      corrupt_blocks_ += block.corrupt ? 1 : 0;
+    }
+    if (block.corrupt) {
+      continue;
+    }
+    for (size_t i = 0; i < block.records; ++i) {
+      TelemetryRecord record;
+      std::memcpy(&record, payload + i * sizeof(record), sizeof(record));
+      if (record.time_ns < range.from_ns || record.time_ns > range.to_ns ||
+          record.metric >= mask.size() || !mask[record.metric]) {
+        continue;
+      }
+      callback(record);
+      ++count;
+    }
+  }
+  return count;
+}
+
+uint64_t TelemetryReader::export_csv(const TelemetryRange& range, std::ostream& out) {
+  std::string buffer = "timestamp_ns,metric,unit,value\n";
+  buffer.reserve(OUTPUT_CHUNK + 256);
+  char     timestamp[24];
+  uint64_t count = for_each(range, [&](const TelemetryRecord& record) {
+    const TelemetryMetric& metric = metrics_[metric_index_[record.metric]];
+    int length = std::snprintf(timestamp, sizeof(timestamp), "%" PRId64 ",", record.time_ns);
+    buffer.append(timestamp, static_cast<size_t>(length));
+    append_csv_field(buffer, metric.name);
+    buffer += ',';
+    append_csv_field(buffer, metric.unit);
+    buffer += ',';
+    append_number(buffer, record.value);
+    buffer += '\n';
+    if (buffer.size() >= OUTPUT_CHUNK) {
+      out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      buffer.clear();
+    }
+  });
+  out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  return count;
+}
+
+uint64_t TelemetryReader::export_json(const TelemetryRange& range, std::ostream& out) {
+  JsonStream json(out, OUTPUT_CHUNK);
+  json.begin_object().key("created_unix_ns").value(created_unix_ns_);
+  json.key("metrics").begin_array();
+  for (const auto& metric : metrics_) {
+    json.begin_object();
+    json.key("id").value(metric.id);
+    json.key("name").value(metric.name);
+    json.key("unit").value(metric.unit);
+    json.end_object();
+  }
+  json.end_array();
+
+  json.key("samples").begin_array();
+  uint64_t count = for_each(range, [&](const TelemetryRecord& record) {
+    json.begin_array().value(record.time_ns).value(record.metric).value(record.value).end_array();
+  });
+  json.end_array().end_object().raw("\n");
+  json.flush();
+  return count;
+}
+
+uint64_t TelemetryReader::replay(const TelemetryRange& range, TimeSeriesStore& store) {
+  std::vector<size_t> series(metric_index_.size(), 0);
+  for (const auto& metric : metrics_) {
+    series[metric.id] = store.add_series(metric.name, metric.unit);
+  }
+  return for_each(range, [&](const TelemetryRecord& record) {
+    store.add(series[record.metric], record.value,
+              static_cast<double>(record.time_ns - created_unix_ns_) / 1e9);
+  });
+}
+
+}  // namespace imx93_peripheral_test
@@ -0,0 +1,321 @@
+/**
+ * @file telemetry_recorder.cpp
+ * @brief Implementation of the binary telemetry recorder.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include "telemetry_recorder.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+namespace imx93_peripheral_test {
+
+namespace {
+
+constexpr uint32_t UNMAPPED = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief Records the series of one TimeSeriesStore as "prefix/name".
+ */
+class PrefixSink : public TimeSeriesSink {
+public:
+  PrefixSink(TelemetryRecorder& recorder, const std::string& prefix)
+      : recorder_(recorder), prefix_(prefix) {}
+
+  void series_added(size_t series, const std::string& name, const std::string& unit) override {
+    uint32_t id = recorder_.add_metric(prefix_.empty() ? name : prefix_ + "/" + name, unit);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (series >= ids_.size()) {
+      ids_.resize(series + 1, UNMAPPED);
+    }
+    ids_[series] = id;
+  }
+
+  void sample_added(size_t series, std::chrono::steady_clock::time_point at,
+                    double value) override {
+    uint32_t id = UNMAPPED;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (series < ids_.size()) {
+        id = ids_[series];
+      }
+    }
+    if (id != UNMAPPED) {
+      recorder_.record(id, at, value);
+    }
+  }
+
+private:
+  TelemetryRecorder&    recorder_;
+  std::string           prefix_;
+  std::mutex            mutex_;
+  std::vector<uint32_t> ids_; /**< Store series index to metric id */
+};
+
+/**
+ * @brief Appends the raw bytes of a value to a buffer.
+ */
+void append_bytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  out.insert(out.end(), bytes, bytes + size);
+}
+
+}  // namespace
+
+TelemetryRecorder::TelemetryRecorder(const TelemetryRecorderConfig& config)
+    : config_(config),
+      wall_offset_(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch() -
+          std::chrono::duration_cast<std::chrono::system_clock::duration>(
+              std::chrono::steady_clock::now().time_since_epoch()))) {
+  config_.records_per_block = std::max<size_t>(config_.records_per_block, 1);
+  config_.blocks_per_index  = std::max<size_t>(config_.blocks_per_index, 1);
+  config_.max_pending       = std::max<size_t>(config_.max_pending, 2);
+}
+
+TelemetryRecorder::~TelemetryRecorder() {
+  close();
+}
+
+bool TelemetryRecorder::open(const std::string& path) {
+  close();
+
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_ = "Cannot create " + path + ": " + std::strerror(errno);
+    return false;
+  }
+  fd_       = fd;
+  offset_   = 0;
+  sequence_ = 0;
+  failed_   = false;
+  unindexed_.clear();
+  records_written_ = 0;
+  records_dropped_ = 0;
+  bytes_written_   = 0;
+
+  TelemetryFileHeader header{};
+  std::memcpy(header.magic, TELEMETRY_MAGIC, sizeof(header.magic));
+  header.version         = TELEMETRY_VERSION;
+  header.record_size     = sizeof(TelemetryRecord);
+  header.created_unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::system_clock::now().time_since_epoch())
+                               .count();
+  std::vector<uint8_t> buffer;
+  append_bytes(buffer, &header, sizeof(header));
+  if (!write_all(buffer)) {
+    ::close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  offset_ = buffer.size();
+
+  {
+    // Metrics registered earlier, e.g. for a previous file, are described again
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_schema_.clear();
+    for (const auto& metric : metric_ids_) {
+      pending_schema_.push_back(metric.second);
+    }
+    std::sort(pending_schema_.begin(), pending_schema_.end(),
+              [](const TelemetryMetric& a, const TelemetryMetric& b) { return a.id < b.id; });
+    pending_.clear();
+    recording_ = true;
+    stopping_  = false;
+  }
+  thread_ = std::thread(&TelemetryRecorder::write_loop, this);
+  return true;
+}
+
+void TelemetryRecorder::close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    recording_ = false;
+    stopping_  = true;
+  }
+  wake_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+uint32_t TelemetryRecorder::add_metric(const std::string& name, const std::string& unit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto                        it = metric_ids_.find(name);
+  if (it != metric_ids_.end()) {
+    return it->second.id;
+  }
+  TelemetryMetric metric;
+  metric.id   = static_cast<uint32_t>(metric_ids_.size());
+  metric.name = name;
+  metric.unit = unit;
+  metric_ids_.emplace(name, metric);
+  pending_schema_.push_back(metric);
+  return metric.id;
+}
+
+void TelemetryRecorder::record(uint32_t metric, std::chrono::steady_clock::time_point at,
+                               double value) {
+  TelemetryRecord entry{};
+  entry.time_ns = (std::chrono::duration_cast<std::chrono::nanoseconds>(at.time_since_epoch()) +
+                   wall_offset_)
+                      .count();
+  entry.value  = value;
+  entry.metric = metric;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!recording_) {
+    return;
+  }
+  if (pending_.size() >= config_.max_pending) {
+    records_dropped_++;
+    return;
+  }
+  pending_.push_back(entry);
+  if (pending_.size() == config_.max_pending / 2) {
+    wake_.notify_one();  // Flush early rather than drop
+  }
+}
+
+std::shared_ptr<TimeSeriesSink> TelemetryRecorder::sink(const std::string& prefix) {
+  return std::make_shared<PrefixSink>(*this, prefix);
+}
+
+std::string TelemetryRecorder::last_error() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return error_;
+}
+
+void TelemetryRecorder::write_loop() {
+  std::vector<TelemetryMetric> schema;
+  std::vector<TelemetryRecord> records;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    wake_.wait_for(lock, config_.flush_interval, [this]() {
+      return stopping_ || pending_.size() >= config_.max_pending / 2;
+    });
+    // Swapping hands the producers the buffers emptied by the previous flush
+    schema.swap(pending_schema_);
+    records.swap(pending_);
+    bool final = stopping_;
+    lock.unlock();
+
+    flush(schema, records, final);
+    schema.clear();
+    records.clear();
+
+    lock.lock();
+    if (final) {
+      break;
+    }
+  }
+}
+
+void TelemetryRecorder::flush(const std::vector<TelemetryMetric>& schema,
+                              const std::vector<TelemetryRecord>& records, bool final) {
+  if (failed_) {
+    records_dropped_ += records.size();
+    return;
+  }
+
+  std::vector<uint8_t> buffer;
+  if (!schema.empty()) {
+    std::vector<uint8_t> payload;
+    for (const auto& metric : schema) {
+      uint16_t name_size = static_cast<uint16_t>(std::min<size_t>(metric.name.size(), 0xFFFF));
+      uint16_t unit_size = static_cast<uint16_t>(std::min<size_t>(metric.unit.size(), 0xFFFF));
+      append_bytes(payload, &metric.id, sizeof(metric.id));
+      append_bytes(payload, &name_size, sizeof(name_size));
+      append_bytes(payload, &unit_size, sizeof(unit_size));
+      append_bytes(payload, metric.name.data(), name_size);
+      append_bytes(payload, metric.unit.data(), unit_size);
+    }
+    append_block(buffer, TelemetryBlockType::SCHEMA, payload.data(), payload.size());
+  }
+
+  for (size_t first = 0; first < records.size(); first += config_.records_per_block) {
+    size_t              count = std::min(config_.records_per_block, records.size() - first);
+    TelemetryIndexEntry entry{};
+    entry.offset   = offset_ + buffer.size();
+    entry.records  = static_cast<uint32_t>(count);
+    entry.first_ns = std::numeric_limits<int64_t>::max();
+    entry.last_ns  = std::numeric_limits<int64_t>::min();
+    for (size_t i = first; i < first + count; ++i) {
+      entry.first_ns = std::min(entry.first_ns, records[i].time_ns);
+      entry.last_ns  = std::max(entry.last_ns, records[i].time_ns);
+    }
+    append_block(buffer, TelemetryBlockType::DATA, &records[first], count * sizeof(records[0]));
+    unindexed_.push_back(entry);
+
+    if (unindexed_.size() >= config_.blocks_per_index) {
+      append_block(buffer, TelemetryBlockType::INDEX, unindexed_.data(),
+                   unindexed_.size() * sizeof(unindexed_[0]));
+      unindexed_.clear();
+    }
+  }
+  if (final && !unindexed_.empty()) {
+    append_block(buffer, TelemetryBlockType::INDEX, unindexed_.data(),
+                 unindexed_.size() * sizeof(unindexed_[0]));
+    unindexed_.clear();
+  }
+  if (buffer.empty()) {
+    return;
+  }
+
+  if (!write_all(buffer)) {
+    // Later blocks would follow a torn one and be unreadable anyway
+    failed_ = true;
+    records_dropped_ += records.size();
+    return;
+  }
+  if (config_.sync) {
+    fdatasync(fd_);
+  }
+  offset_ += buffer.size();
+  records_written_ += records.size();
+}
+
+void TelemetryRecorder::append_block(std::vector<uint8_t>& out, TelemetryBlockType type,
+                                     const void* payload, size_t size) {
+  TelemetryBlockHeader header{};
+  header.magic        = TELEMETRY_BLOCK_MAGIC;
+  header.type         = static_cast<uint16_t>(type);
+  header.payload_size = static_cast<uint32_t>(size);
+  header.crc32        = telemetry_crc32(payload, size);
+  header.sequence     = sequence_++;
+  append_bytes(out, &header, sizeof(header));
+  append_bytes(out, payload, size);
+}
+
+bool TelemetryRecorder::write_all(const std::vector<uint8_t>& buffer) {
+  size_t done = 0;
+  while (done < buffer.size()) {
+    ssize_t written = ::write(fd_, buffer.data() + done, buffer.size() - done);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = std::string("Write failed: ") + std::strerror(errno);
+      return false;
+    }
+    done += static_cast<size_t>(written);
+  }
+  bytes_written_ += buffer.size();
+  return true;
+}
+
+}  // namespace imx93_peripheral_test
@@ -29,10 +29,16 @@ namespace fs = std::filesystem;
 
 namespace imx93_peripheral_test {
 
-USBTester::USBTester() : usb_available_(false) {
+USBTester::USBTester() : usb_available_(false) {}
+
+bool USBTester::probe() {
+  return fs::exists("/sys/bus/usb") || fs::exists("/proc/bus/usb");
+}
+
+void USBTester::discover() {
   // Check if USB is available on i.MX93
   // i.MX93 has dual USB 2.0 controllers
-  usb_available_ = fs::exists("/sys/bus/usb") || fs::exists("/proc/bus/usb");
+  usb_available_ = probe();
 
   if (usb_available_) {
     controllers_ = get_usb_controllers();
@@ -52,6 +58,7 @@ TestReport USBTester::short_test() {
   bool              all_passed = true;
 
   details << "Found " << controllers_.size() << " USB controller(s)\n";
+  add_metric("usb_controllers", static_cast<double>(controllers_.size()), "");
   for (const auto& controller : controllers_) {
     details << "- " << controller.controller_name << " (";
     switch (controller.max_version) {
@@ -78,6 +85,7 @@ TestReport USBTester::short_test() {
   }
 
   details << "Found " << devices_.size() << " USB device(s)\n";
+  add_metric("usb_devices", static_cast<double>(devices_.size()), "");
   for (const auto& device : devices_) {
     if (device.connected) {
       details << "- " << device.product_name << " (" << device.vendor_id << ":"
@@ -91,7 +99,7 @@ TestReport USBTester::short_test() {
   }
 
   // Test USB controllers
-  TestResult controller_result = test_usb_controllers();
+  TestResult controller_result = add_check("usb_controllers", test_usb_controllers());
   details << "USB Controllers: " << (controller_result == TestResult::SUCCESS ? "PASS" : "FAIL")
           << "\n";
   if (controller_result != TestResult::SUCCESS)
@@ -113,7 +121,7 @@ TestReport USBTester::short_test() {
     all_passed = false;
 
   // Test USB transfer
-  TestResult transfer_result = test_usb_transfer();
+  TestResult transfer_result = add_check("usb_transfer", test_usb_transfer());
   details << "USB Transfer: "
           << (transfer_result == TestResult::SUCCESS
                   ? "PASS"
@@ -123,7 +131,7 @@ TestReport USBTester::short_test() {
     all_passed = false;
 
   // Test USB power
-  TestResult power_result = test_usb_power();
+  TestResult power_result = add_check("usb_power", test_usb_power());
   details << "USB Power: " << (power_result == TestResult::SUCCESS ? "PASS" : "FAIL") << "\n";
   if (power_result != TestResult::SUCCESS)
     all_passed = false;
@@ -148,9 +156,9 @@ TestReport USBTester::monitor_test(std::chrono::seconds duration) {
   auto end_time      = std::chrono::steady_clock::now();
   auto test_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-  std::string details =
-      "USB monitoring completed for " + std::to_string(duration.count()) + " seconds";
-  return create_report(result, details, test_duration);
+  std::string details = "USB monitoring completed for " + std::to_string(duration.count()) +
+                        " seconds\n";
+  return create_monitor_report(result, details, test_duration);
 }
 
 bool USBTester::is_available() const {
@@ -302,8 +310,12 @@ TestResult USBTester::monitor_usb_devices(std::chrono::seconds duration) {
   auto initial_devices = enumerate_usb_devices();
   bool stable          = true;
 
+  monitor_series_.clear();
+  size_t device_count = monitor_series_.add_series("usb_devices", "count");
+
   while (std::chrono::steady_clock::now() < end_time && stable) {
     auto current_devices = enumerate_usb_devices();
+    monitor_series_.add(device_count, static_cast<double>(current_devices.size()));
 
     // Check if device count changed
     if (current_devices.size() != initial_devices.size()) {
@@ -326,7 +338,9 @@ TestResult USBTester::monitor_usb_devices(std::chrono::seconds duration) {
       }
     }
 
-    std::this_thread::sleep_for(std::chrono::seconds(2));
+    if (cancellation_.wait_for(std::chrono::seconds(2))) {
+      break;
+    }
   }
 
   return stable ? TestResult::SUCCESS : TestResult::FAILURE;
@@ -0,0 +1,175 @@
+/**
+ * @file test_baseline.cpp
+ * @brief Unit tests for baseline capture, storage and regression comparison.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "baseline.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @brief Returns a completed storage report with one write speed and one latency.
+ */
+static TestReport storage_report(double write_speed, double latency) {
+  TestReport report;
+  report.result          = TestResult::SUCCESS;
+  report.peripheral_name = "Storage";
+  report.metrics.push_back({"mmcblk0_write_speed", "MB/s", write_speed, NO_LIMIT, NO_LIMIT});
+  report.metrics.push_back({"latency", "ms", latency, NO_LIMIT, NO_LIMIT});
+  report.metrics.push_back({"storage_devices", "", 2, NO_LIMIT, NO_LIMIT});
+  return report;
+}
+
+static const BaselineComparison* find(const std::vector<BaselineComparison>& comparisons,
+                                      const std::string&                     key) {
+  for (const auto& comparison : comparisons) {
+    if (comparison.key == key) {
+      return &comparison;
+    }
+  }
+  return nullptr;
+}
+
+TEST(BaselineTest, DerivesGoalsFromUnits) {
+  EXPECT_EQ(metric_goal("MB/s"), MetricGoal::HIGHER);
+  EXPECT_EQ(metric_goal("Mbps"), MetricGoal::HIGHER);
+  EXPECT_EQ(metric_goal("pps"), MetricGoal::HIGHER);
+  EXPECT_EQ(metric_goal("ms"), MetricGoal::LOWER);
+  EXPECT_EQ(metric_goal("J"), MetricGoal::LOWER);
+  EXPECT_EQ(metric_goal("CPU-s/Gbit"), MetricGoal::LOWER);
+  EXPECT_EQ(metric_goal("C"), MetricGoal::NONE);
+  EXPECT_EQ(metric_goal(""), MetricGoal::NONE);
+}
+
+TEST(BaselineTest, ComputesRobustStatistics) {
+  SampleStats stats = SampleStats::of({10, 12, 11, 100, 9});
+  EXPECT_EQ(stats.samples, 5u);
+  EXPECT_DOUBLE_EQ(stats.median, 11);
+  EXPECT_DOUBLE_EQ(stats.mad, 1);
+
+  // Below six samples the interval spans them all
+  EXPECT_DOUBLE_EQ(stats.ci_low, 9);
+  EXPECT_DOUBLE_EQ(stats.ci_high, 100);
+
+  // For 20 samples the 95% interval of the median is [x_(6), x_(15)]
+  std::vector<double> values;
+  for (int i = 1; i <= 20; ++i) {
+    values.push_back(i);
+  }
+  stats = SampleStats::of(values);
+  EXPECT_DOUBLE_EQ(stats.median, 10.5);
+  EXPECT_DOUBLE_EQ(stats.mad, 5);
+  EXPECT_DOUBLE_EQ(stats.ci_low, 6);
+  EXPECT_DOUBLE_EQ(stats.ci_high, 15);
+
+  EXPECT_EQ(SampleStats::of({}).samples, 0u);
+}
+
+TEST(BaselineTest, MatchesTolerancesByLongestPrefix) {
+  BaselineTolerances tolerances;
+  EXPECT_TRUE(tolerances.parse("8"));
+  EXPECT_TRUE(tolerances.parse("Storage/=20"));
+  EXPECT_TRUE(tolerances.parse("Storage/latency=30"));
+  EXPECT_FALSE(tolerances.parse("CPU/=fast"));
+  EXPECT_FALSE(tolerances.parse("-1"));
+
+  EXPECT_DOUBLE_EQ(tolerances.for_key("CPU/benchmark_time"), 8);
+  EXPECT_DOUBLE_EQ(tolerances.for_key("Storage/mmcblk0_write_speed"), 20);
+  EXPECT_DOUBLE_EQ(tolerances.for_key("Storage/latency"), 30);
+}
+
+TEST(BaselineTest, SavesAndLoadsSamples) {
+  Baseline saved;
+  saved.add(storage_report(100.125, 2.5));
+  saved.add(storage_report(101.0 / 3.0, 2.0));
+  TestReport skipped = storage_report(1, 1);
+  skipped.result     = TestResult::TIMEOUT;
+  saved.add(skipped);
+  TestReport partial       = storage_report(1, 1);
+  partial.metrics[0].value = std::nan("");
+  partial.metrics.resize(1);
+  saved.add(partial);
+
+  std::string path = (std::filesystem::temp_directory_path() /
+                      ("baseline_" + std::to_string(getpid()) + ".tsv"))
+                         .string();
+  ASSERT_TRUE(saved.save(path)) << saved.last_error();
+
+  Baseline loaded;
+  ASSERT_TRUE(loaded.load(path)) << loaded.last_error();
+  ASSERT_EQ(loaded.metrics().size(), 3u);
+  const BaselineMetric& speed = loaded.metrics()[0];
+  EXPECT_EQ(speed.key(), "Storage/mmcblk0_write_speed");
+  EXPECT_EQ(speed.unit, "MB/s");
+  EXPECT_EQ(speed.goal, MetricGoal::HIGHER);
+  EXPECT_EQ(speed.values, (std::vector<double>{100.125, 101.0 / 3.0}));
+  EXPECT_EQ(loaded.metrics()[2].unit, "");
+
+  std::ofstream(path) << "not a baseline\n";
+  EXPECT_FALSE(loaded.load(path));
+  EXPECT_NE(loaded.last_error().find("is not a baseline file"), std::string::npos);
+  std::ofstream(path) << "# nxp-imx93-hw-vv-tool baseline 1\nCPU\tcores\t\tsideways\t4\n";
+  EXPECT_FALSE(loaded.load(path));
+  EXPECT_NE(loaded.last_error().find(":2: Unknown goal sideways"), std::string::npos);
+  std::filesystem::remove(path);
+}
+
+TEST(BaselineTest, FlagsOnlySignificantRegressions) {
+  Baseline before;
+  Baseline after;
+  for (double noise : {-1.0, 0.5, 0.0, 1.0, -0.5, 0.25}) {
+    before.add(storage_report(100 + noise, 2 + noise / 10));
+    // 15% less throughput; the same latency apart from one outlier
+    after.add(storage_report(85 + noise, noise == 1.0 ? 20 : 2 + noise / 10));
+  }
+  TestReport cpu;
+  cpu.result          = TestResult::SUCCESS;
+  cpu.peripheral_name = "CPU";
+  cpu.metrics.push_back({"benchmark_time", "ms", 10, NO_LIMIT, NO_LIMIT});
+  after.add(cpu);
+
+  BaselineTolerances              tolerances;
+  std::vector<BaselineComparison> comparisons = before.compare(after, tolerances);
+  ASSERT_EQ(comparisons.size(), 4u);
+
+  const BaselineComparison* speed = find(comparisons, "Storage/mmcblk0_write_speed");
+  ASSERT_NE(speed, nullptr);
+  EXPECT_EQ(speed->verdict, BaselineVerdict::REGRESSED);
+  EXPECT_NEAR(speed->change_percent, -15, 0.1);
+  EXPECT_EQ(find(comparisons, "Storage/latency")->verdict, BaselineVerdict::UNCHANGED);
+  EXPECT_EQ(find(comparisons, "Storage/storage_devices")->verdict, BaselineVerdict::UNCHANGED);
+  EXPECT_EQ(find(comparisons, "CPU/benchmark_time")->verdict, BaselineVerdict::NEW);
+
+  TestReport report = Baseline::comparison_report(comparisons);
+  EXPECT_EQ(report.peripheral_name, "Baseline");
+  EXPECT_EQ(report.result, TestResult::FAILURE);
+  EXPECT_NE(report.details.find("REGRESSED Storage/mmcblk0_write_speed"), std::string::npos)
+      << report.details;
+  ASSERT_EQ(report.metrics.size(), 3u);
+  EXPECT_EQ(report.metrics[0].name, "Storage/mmcblk0_write_speed_change");
+  EXPECT_FALSE(report.metrics[0].within_limits());
+
+  // A looser tolerance accepts the drop, and the reverse comparison is an improvement
+  EXPECT_TRUE(tolerances.parse("Storage/=20"));
+  comparisons = before.compare(after, tolerances);
+  EXPECT_EQ(find(comparisons, "Storage/mmcblk0_write_speed")->verdict,
+            BaselineVerdict::UNCHANGED);
+  EXPECT_EQ(Baseline::comparison_report(comparisons).result, TestResult::SUCCESS);
+  comparisons = after.compare(before, BaselineTolerances());
+  EXPECT_EQ(find(comparisons, "Storage/mmcblk0_write_speed")->verdict,
+            BaselineVerdict::IMPROVED);
+  EXPECT_EQ(find(comparisons, "CPU/benchmark_time")->verdict, BaselineVerdict::MISSING);
+}
+
+}  // namespace imx93_peripheral_test
@@ -0,0 +1,211 @@
+/**
+ * @file test_burnin_tester.cpp
+ * @brief Unit tests for the burn-in tester.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#include "burnin_tester.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @brief Stress load that counts one operation per millisecond.
+ */
+class FakeLoad : public PeripheralTester {
+public:
+  FakeLoad(TestResult outcome, uint64_t bytes_per_op, std::function<void()> on_start = nullptr)
+      : outcome_(outcome), bytes_per_op_(bytes_per_op), on_start_(on_start) {}
+
+  TestReport short_test() override {
+    return create_report(TestResult::SKIPPED, "", std::chrono::milliseconds(0));
+  }
+
+  TestReport monitor_test(std::chrono::seconds) override {
+    return short_test();
+  }
+
+  std::string get_peripheral_name() const override {
+    return "Fake";
+  }
+
+  bool is_available() const override {
+    return true;
+  }
+
+  TestResult stress(uint32_t, const std::atomic<bool>& stop, StressCounters& counters) override {
+    if (outcome_ == TestResult::NOT_SUPPORTED) {
+      return outcome_;
+    }
+    if (on_start_) {
+      on_start_();
+    }
+    while (!stop) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      counters.operations++;
+      counters.bytes += bytes_per_op_;
+    }
+    return outcome_;
+  }
+
+private:
+  TestResult            outcome_;
+  uint64_t              bytes_per_op_;
+  std::function<void()> on_start_;
+};
+
+class BurnInTesterTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    root_ = std::filesystem::temp_directory_path() /
+            ("burnin_test_" + std::to_string(getpid()));
+    write("class/thermal/thermal_zone0/temp", "45000");
+    write("class/thermal/thermal_zone1/temp", "52500");
+    write("devices/system/cpu/cpu0/cpufreq/scaling_cur_freq", "1700000");
+    write("devices/system/cpu/cpu1/cpufreq/scaling_cur_freq", "900000");
+    write("devices/system/edac/mc/mc0/ce_count", "0");
+    write("devices/system/edac/mc/mc0/ue_count", "0");
+    write("class/net/eth0/statistics/rx_errors", "3");
+    write("class/net/eth0/statistics/rx_dropped", "10");
+    write("class/power_supply/usb/voltage_now", "5000000");
+    write("class/power_supply/usb/current_now", "1000000");
+  }
+
+  void TearDown() override {
+    std::filesystem::remove_all(root_);
+  }
+
+  void write(const std::string& relative, const std::string& value) {
+    std::filesystem::path path = root_ / relative;
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream(path) << value << "\n";
+  }
+
+  BurnInConfig config() const {
+    BurnInConfig config;
+    config.sysfs_root      = root_.string();
+    config.sample_interval = std::chrono::milliseconds(100);
+    return config;
+  }
+
+  std::filesystem::path root_;
+};
+
+TEST_F(BurnInTesterTest, NoLoadsIsNotAvailable) {
+  BurnInTester burnin(config());
+  EXPECT_FALSE(burnin.is_available());
+  EXPECT_EQ(burnin.get_peripheral_name(), "BurnIn");
+}
+
+TEST_F(BurnInTesterTest, RunsLoadsConcurrentlyWithTelemetry) {
+  BurnInTester burnin(config());
+  burnin.add_load("data", std::make_unique<FakeLoad>(TestResult::SUCCESS, 1000000), 1);
+  burnin.add_load("ops", std::make_unique<FakeLoad>(TestResult::SUCCESS, 0), 2);
+  // Drops are reported but do not fail the run
+  burnin.add_load("dropper", std::make_unique<FakeLoad>(TestResult::SUCCESS, 0, [this]() {
+                    write("class/net/eth0/statistics/rx_dropped", "12");
+                  }),
+                  0);
+
+  TestReport report = burnin.monitor_test(std::chrono::seconds(1));
+  EXPECT_EQ(report.result, TestResult::SUCCESS) << report.details;
+
+  const BurnInResult& result = burnin.last_result();
+  EXPECT_TRUE(result.success);
+  EXPECT_GE(result.samples, 10u);
+  ASSERT_EQ(result.loads.size(), 3u);
+  EXPECT_EQ(result.loads[0].unit, "MB/s");
+  EXPECT_EQ(result.loads[1].unit, "ops/s");
+  EXPECT_EQ(result.loads[1].intensity, 2u);
+  for (const auto& load : result.loads) {
+    EXPECT_EQ(load.result, TestResult::SUCCESS);
+    EXPECT_GT(load.operations, 0u);
+    EXPECT_GT(load.average_rate, 0.0);
+  }
+  EXPECT_DOUBLE_EQ(result.max_temperature_c, 52.5);
+  EXPECT_DOUBLE_EQ(result.min_cpu_mhz, 1300.0);
+  EXPECT_EQ(result.power_rail, "power_supply/usb");
+  EXPECT_NEAR(result.average_power_w, 5.0, 1e-6);
+  EXPECT_EQ(result.counter_deltas.at("net/eth0/rx_dropped"), 2u);
+  EXPECT_EQ(result.counter_deltas.count("net/eth0/rx_errors"), 0u);
+
+  const std::vector<TimeSeries>& series = burnin.monitor_series().series();
+  auto named = [&series](const std::string& name) {
+    return std::find_if(series.begin(), series.end(),
+                        [&name](const TimeSeries& entry) { return entry.name() == name; });
+  };
+  ASSERT_NE(named("data_throughput"), series.end());
+  EXPECT_EQ(named("data_throughput")->unit(), "MB/s");
+  EXPECT_EQ(named("ops_throughput"), series.end());
+  ASSERT_NE(named("power_supply/usb"), series.end());
+  EXPECT_EQ(named("max_temperature")->summary().samples, result.samples);
+  EXPECT_NE(report.details.find("Series max_temperature [C]"), std::string::npos);
+
+  // The report carries the same series, downsampled, and their summaries as metrics
+  auto carried =
+      std::find_if(report.series.begin(), report.series.end(),
+                   [](const ReportSeries& entry) { return entry.name == "cpu_frequency"; });
+  ASSERT_NE(carried, report.series.end());
+  EXPECT_EQ(carried->unit, "MHz");
+  ASSERT_FALSE(carried->buckets.empty());
+  EXPECT_LE(carried->buckets.size(), 32u);
+  ASSERT_NE(report.metric("cpu_frequency_min"), nullptr);
+  EXPECT_DOUBLE_EQ(report.metric("cpu_frequency_min")->value, 1300.0);
+}
+
+TEST_F(BurnInTesterTest, FailsWhenErrorCountersGrow) {
+  BurnInTester burnin(config());
+  burnin.add_load("ecc", std::make_unique<FakeLoad>(TestResult::SUCCESS, 0, [this]() {
+                    write("devices/system/edac/mc/mc0/ce_count", "1");
+                  }),
+                  0);
+
+  TestReport report = burnin.monitor_test(std::chrono::seconds(1));
+  EXPECT_EQ(report.result, TestResult::FAILURE);
+  EXPECT_EQ(burnin.last_result().counter_deltas.at("edac/mc0/ce_count"), 1u);
+  EXPECT_NE(report.details.find("edac/mc0/ce_count"), std::string::npos);
+}
+
+TEST_F(BurnInTesterTest, FailedLoadFailsBurnIn) {
+  BurnInTester burnin(config());
+  burnin.add_load("good", std::make_unique<FakeLoad>(TestResult::SUCCESS, 0), 0);
+  burnin.add_load("bad", std::make_unique<FakeLoad>(TestResult::FAILURE, 0), 0);
+
+  TestReport report = burnin.monitor_test(std::chrono::seconds(1));
+  EXPECT_EQ(report.result, TestResult::FAILURE);
+  EXPECT_EQ(burnin.last_result().error_message, "Load bad failed");
+}
+
+TEST_F(BurnInTesterTest, OnlyUnsupportedLoadsIsNotSupported) {
+  BurnInTester burnin(config());
+  burnin.add_load("absent", std::make_unique<FakeLoad>(TestResult::NOT_SUPPORTED, 0), 0);
+
+  TestReport report = burnin.monitor_test(std::chrono::seconds(1));
+  EXPECT_EQ(report.result, TestResult::NOT_SUPPORTED);
+}
+
+TEST(BurnInRatesTest, DetectsDegradation) {
+  // 100 ops/s for the first half, 50 ops/s for the second
+  TimeSeries rate("load", "ops/s", 4, 2, 3);
+  for (int second = 1; second <= 8; ++second) {
+    rate.add(second, second <= 4 ? 100.0 : 50.0);
+  }
+
+  BurnInLoadResult summary;
+  BurnInTester::summarize_rates(rate, summary);
+  EXPECT_DOUBLE_EQ(summary.first_rate, 100.0);
+  EXPECT_DOUBLE_EQ(summary.last_rate, 50.0);
+  EXPECT_DOUBLE_EQ(summary.average_rate, 75.0);
+  EXPECT_DOUBLE_EQ(summary.degradation_pct, 50.0);
+}
+
+}  // namespace imx93_peripheral_test
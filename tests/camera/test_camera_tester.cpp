@@ -15,6 +15,7 @@ class CameraTesterTest : public ::testing::Test {
 protected:
   void SetUp() override {
     tester_ = std::make_unique<CameraTester>();
+    tester_->prepare();
   }
 
   void TearDown() override {
@@ -7,6 +7,9 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
+
 #include "cpu_tester.h"
 
 namespace imx93_peripheral_test {
@@ -15,6 +18,7 @@ class CPUTesterTest : public ::testing::Test {
 protected:
   void SetUp() override {
     tester_ = std::make_unique<CPUTester>();
+    tester_->prepare();
   }
 
   void TearDown() override {
@@ -34,6 +38,13 @@ TEST_F(CPUTesterTest, IsAvailable) {
   EXPECT_TRUE(available || !available);
 }
 
+TEST_F(CPUTesterTest, DiscoveryWaitsForPrepare) {
+  CPUTester tester;
+  EXPECT_FALSE(tester.is_available());
+  EXPECT_TRUE(!tester.prepare() || CPUTester::probe());
+  EXPECT_EQ(tester.prepare(), tester_->is_available());
+}
+
 TEST_F(CPUTesterTest, ShortTest) {
   if (!tester_->is_available()) {
     GTEST_SKIP() << "CPU not available on this system";
@@ -45,6 +56,28 @@ TEST_F(CPUTesterTest, ShortTest) {
   EXPECT_GE(report.duration.count(), 0);
 }
 
+TEST_F(CPUTesterTest, ShortTestReportsTypedMetrics) {
+  if (!tester_->is_available()) {
+    GTEST_SKIP() << "CPU not available on this system";
+  }
+
+  TestReport        report    = tester_->short_test();
+  const TestMetric* primes    = report.metric("benchmark_primes");
+  const TestMetric* benchmark = report.metric("benchmark_time");
+  ASSERT_NE(primes, nullptr);
+  ASSERT_NE(benchmark, nullptr);
+  EXPECT_DOUBLE_EQ(primes->value, 1229.0);
+  EXPECT_TRUE(primes->within_limits());
+  EXPECT_EQ(benchmark->unit, "ms");
+  EXPECT_EQ(report.check("benchmark"), TestResult::SUCCESS);
+  EXPECT_NE(report.check("multi_core"), TestResult::SKIPPED);
+
+  // Metrics belong to the report they were collected for
+  TestReport again = tester_->short_test();
+  EXPECT_EQ(again.metrics.size(), report.metrics.size());
+  EXPECT_EQ(again.checks.size(), report.checks.size());
+}
+
 TEST_F(CPUTesterTest, MonitorTest) {
   if (!tester_->is_available()) {
     GTEST_SKIP() << "CPU not available on this system";
@@ -56,4 +89,19 @@ TEST_F(CPUTesterTest, MonitorTest) {
   EXPECT_GE(report.duration.count(), 0);
 }
 
+TEST_F(CPUTesterTest, StressRunsUntilStopped) {
+  std::atomic<bool> stop(false);
+  StressCounters    counters;
+  std::thread       stopper([&stop]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    stop = true;
+  });
+  TestResult result = tester_->stress(2, stop, counters);
+  stopper.join();
+
+  EXPECT_EQ(result, TestResult::SUCCESS);
+  EXPECT_GT(counters.operations.load(), 0u);
+  EXPECT_EQ(counters.errors.load(), 0u);
+}
+
 }  // namespace imx93_peripheral_test
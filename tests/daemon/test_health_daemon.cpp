@@ -0,0 +1,287 @@
+/**
+ * @file test_health_daemon.cpp
+ * @brief Unit tests for the resident health daemon and its socket protocol.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "health_daemon.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @brief Tester that samples a counter every 10 ms and counts its short tests.
+ */
+class CountingTester : public PeripheralTester {
+public:
+  TestReport short_test() override {
+    add_check("count", TestResult::SUCCESS);
+    tests_++;
+    return create_report(TestResult::SUCCESS, "counted", std::chrono::milliseconds(0));
+  }
+
+  TestReport monitor_test(std::chrono::seconds duration) override {
+    monitor_series_.clear();
+    size_t level = monitor_series_.add_series("level", "count");
+    auto   end   = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {
+      monitor_series_.add(level, static_cast<double>(++samples_));
+      if (cancellation_.wait_for(std::chrono::milliseconds(10))) {
+        break;
+      }
+    }
+    return create_report(TestResult::SUCCESS, "sampled", std::chrono::milliseconds(0));
+  }
+
+  std::string get_peripheral_name() const override {
+    return "Counting";
+  }
+
+  bool is_available() const override {
+    return true;
+  }
+
+  std::atomic<int> tests_{0};
+  std::atomic<int> samples_{0};
+};
+
+/**
+ * @brief Tester whose short test ignores cancellation until released.
+ */
+class HangingTester : public PeripheralTester {
+public:
+  TestReport short_test() override {
+    int inside = ++inside_;
+    max_inside_ = std::max(max_inside_.load(), inside);
+    calls_++;
+    while (!released_) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    inside_--;
+    return create_report(TestResult::SUCCESS, "released", std::chrono::milliseconds(0));
+  }
+
+  TestReport monitor_test(std::chrono::seconds) override {
+    calls_++;
+    return create_report(TestResult::SUCCESS, "sampled", std::chrono::milliseconds(0));
+  }
+
+  std::string get_peripheral_name() const override {
+    return "Hanging";
+  }
+
+  bool is_available() const override {
+    return true;
+  }
+
+  std::atomic<int>  calls_{0};
+  std::atomic<int>  inside_{0};
+  std::atomic<int>  max_inside_{0};
+  std::atomic<bool> released_{false};
+};
+
+class HealthDaemonTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    config_.socket_path = (std::filesystem::temp_directory_path() /
+                           ("health_daemon_" + std::to_string(getpid()) + ".sock"))
+                              .string();
+    config_.sample_window = std::chrono::seconds(1);
+    config_.timeout       = std::chrono::seconds(10);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(config_.socket_path);
+  }
+
+  /**
+   * @brief Sends one request over the socket and returns the answer.
+   */
+  std::string query(const std::string& request) {
+    int         fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, config_.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    std::string response;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+      std::string line = request + "\n";
+      EXPECT_EQ(send(fd, line.data(), line.size(), MSG_NOSIGNAL),
+                static_cast<ssize_t>(line.size()));
+      char    buffer[4096];
+      ssize_t length;
+      while ((length = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(length));
+      }
+    }
+    close(fd);
+    return response;
+  }
+
+  /**
+   * @brief Polls until a condition holds or five seconds pass.
+   */
+  static bool eventually(const std::function<bool()>& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+  }
+
+  HealthDaemonConfig config_;
+};
+
+TEST_F(HealthDaemonTest, SamplesContinuouslyAndServesLatestState) {
+  auto         tester = std::make_shared<CountingTester>();
+  HealthDaemon daemon(config_);
+  daemon.add_tester("counter", tester);
+  ASSERT_TRUE(daemon.start()) << daemon.last_error();
+
+  // The first short test runs at startup, then windows follow back to back
+  ASSERT_TRUE(eventually([&]() { return tester->tests_ == 1; }));
+  ASSERT_TRUE(eventually(
+      [&]() { return query("status").find("\"windows\": 1") != std::string::npos; }));
+
+  std::string status = query("status");
+  EXPECT_EQ(status.rfind("{\"ok\": true", 0), 0u) << status;
+  EXPECT_EQ(status.back(), '\n');
+  EXPECT_NE(status.find("\"name\": \"counter\""), std::string::npos);
+  EXPECT_NE(status.find("\"last_test\": \"SUCCESS\""), std::string::npos);
+
+  std::string latest = query("latest counter");
+  EXPECT_NE(latest.find("\"name\": \"counter/level\",\"unit\": \"count\""), std::string::npos)
+      << latest;
+  EXPECT_NE(latest.find("\"details\": \"counted\""), std::string::npos);
+  EXPECT_NE(latest.find("\"last_window\": {"), std::string::npos);
+
+  std::string range = query("range counter/level -60 0 4");
+  EXPECT_NE(range.find("\"metric\": \"counter/level\""), std::string::npos) << range;
+  EXPECT_NE(range.find("\"buckets\": [["), std::string::npos);
+
+  daemon.stop();
+  EXPECT_FALSE(std::filesystem::exists(config_.socket_path));
+  EXPECT_GE(daemon.requests_served(), 4u);
+}
+
+TEST_F(HealthDaemonTest, TestRequestCutsTheWindowShort) {
+  config_.sample_window = std::chrono::seconds(60);
+  config_.test_interval = std::chrono::seconds(0);
+  auto         tester   = std::make_shared<CountingTester>();
+  HealthDaemon daemon(config_);
+  daemon.add_tester("counter", tester);
+  ASSERT_TRUE(daemon.start()) << daemon.last_error();
+
+  ASSERT_TRUE(eventually([&]() { return tester->samples_ > 0; }));
+  EXPECT_EQ(tester->tests_, 0);
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(query("test counter"), "{\"ok\": true,\"queued\": \"counter\"}\n");
+  ASSERT_TRUE(eventually([&]() { return tester->tests_ == 1; }));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  daemon.stop();
+}
+
+TEST_F(HealthDaemonTest, PublishesMetricsForPrometheus) {
+  config_.metrics_port = 0;
+  auto         tester  = std::make_shared<CountingTester>();
+  HealthDaemon daemon(config_);
+  daemon.add_tester("counter", tester);
+  ASSERT_TRUE(daemon.start()) << daemon.last_error();
+  EXPECT_NE(daemon.metrics_port(), 0);
+
+  auto rendered = [&]() {
+    std::string out;
+    daemon.metrics().render(out);
+    return out;
+  };
+  ASSERT_TRUE(eventually([&]() {
+    return rendered().find("imx93_monitor_windows_total{peripheral=\"counter\"} 1\n") !=
+           std::string::npos;
+  }));
+  std::string out = rendered();
+  EXPECT_NE(out.find("# TYPE imx93_short_tests_total counter\n"
+                     "imx93_short_tests_total{peripheral=\"counter\"} 1\n"),
+            std::string::npos)
+      << out;
+  EXPECT_NE(out.find("imx93_short_test_failures_total{peripheral=\"counter\"} 0\n"),
+            std::string::npos);
+  EXPECT_NE(out.find("imx93_short_test_passed{peripheral=\"counter\"} 1\n"), std::string::npos);
+  EXPECT_NE(out.find("# TYPE imx93_level gauge\nimx93_level{peripheral=\"counter\"} "),
+            std::string::npos);
+  daemon.stop();
+}
+
+TEST_F(HealthDaemonTest, RetiresTesterWhoseTestWasAbandoned) {
+  config_.timeout = std::chrono::seconds(1);
+  auto         tester = std::make_shared<HangingTester>();
+  HealthDaemon daemon(config_);
+  daemon.add_tester("hanging", tester);
+  ASSERT_TRUE(daemon.start()) << daemon.last_error();
+
+  // One second of timeout plus the watchdog's two second grace period
+  ASSERT_TRUE(eventually(
+      [&]() { return query("status").find("\"retired\": true") != std::string::npos; }));
+  EXPECT_NE(query("status").find("\"last_test\": \"TIMEOUT\""), std::string::npos);
+  EXPECT_EQ(query("test hanging"),
+            "{\"ok\": false,\"error\": \"hanging was retired after a test did not stop\"}\n");
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(tester->calls_, 1);
+
+  // The abandoned test finishes on its own; the tester was never entered twice
+  tester->released_ = true;
+  ASSERT_TRUE(eventually([&]() { return tester->inside_ == 0; }));
+  EXPECT_EQ(tester->calls_, 1);
+  EXPECT_EQ(tester->max_inside_, 1);
+  daemon.stop();
+}
+
+TEST_F(HealthDaemonTest, RejectsMalformedRequests) {
+  HealthDaemon daemon(config_);
+  daemon.add_tester("counter", std::make_shared<CountingTester>());
+
+  EXPECT_NE(daemon.handle_request("").find("\"ok\": false"), std::string::npos);
+  EXPECT_NE(daemon.handle_request("reboot now").find("\"error\": \"Expected status"),
+            std::string::npos);
+  EXPECT_EQ(daemon.handle_request("test camera"),
+            "{\"ok\": false,\"error\": \"Unknown peripheral: camera\"}");
+  EXPECT_NE(daemon.handle_request("latest camera").find("Unknown peripheral"), std::string::npos);
+  EXPECT_NE(daemon.handle_request("range counter/level yesterday 0").find("Unix times"),
+            std::string::npos);
+  EXPECT_EQ(daemon.handle_request("range counter/level -60 0"),
+            "{\"ok\": false,\"error\": \"Unknown metric: counter/level\"}");
+}
+
+TEST_F(HealthDaemonTest, OnlyReplacesStaleSockets) {
+  std::ofstream(config_.socket_path) << "not a socket";
+  HealthDaemon other(config_);
+  EXPECT_FALSE(other.start());
+  EXPECT_NE(other.last_error().find("is not a socket"), std::string::npos);
+  std::filesystem::remove(config_.socket_path);
+
+  HealthDaemon first(config_);
+  ASSERT_TRUE(first.start()) << first.last_error();
+  HealthDaemon second(config_);
+  EXPECT_FALSE(second.start());
+  EXPECT_NE(second.last_error().find("Another daemon"), std::string::npos);
+  first.stop();
+}
+
+}  // namespace imx93_peripheral_test
@@ -0,0 +1,153 @@
+/**
+ * @file test_metrics_exporter.cpp
+ * @brief Unit tests for the metric registry and the Prometheus /metrics endpoint.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "metrics_exporter.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @brief Sends a raw HTTP request to a local port and returns the whole response.
+ */
+static std::string http(uint16_t port, const std::string& request) {
+  int         fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  std::string response;
+  if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+    EXPECT_EQ(send(fd, request.data(), request.size(), MSG_NOSIGNAL),
+              static_cast<ssize_t>(request.size()));
+    char    buffer[4096];
+    ssize_t length;
+    while ((length = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+      response.append(buffer, static_cast<size_t>(length));
+    }
+  }
+  close(fd);
+  return response;
+}
+
+TEST(MetricRegistryTest, RendersFamiliesOnceWithEscapedLabels) {
+  MetricRegistry registry;
+  size_t         power = registry.add_family("power/rail", "Rail power\nin W", MetricType::GAUGE);
+  size_t         runs  = registry.add_family("runs_total", "Runs", MetricType::COUNTER);
+  size_t         vdd   = registry.add(power, "rail", "vdd \"soc\"");
+  size_t         arm   = registry.add(power, "rail", "arm\\a55");
+  size_t         total = registry.add(runs);
+  size_t         idle  = registry.add(runs, "peripheral", "idle");
+
+  EXPECT_EQ(registry.add_family("power/rail", "Other help", MetricType::COUNTER), power);
+  EXPECT_EQ(registry.add(power, "rail", "vdd \"soc\""), vdd);
+  EXPECT_EQ(registry.add(MetricRegistry::NO_SLOT), MetricRegistry::NO_SLOT);
+  EXPECT_EQ(registry.size(), 4u);
+
+  registry.set(vdd, 1.5);
+  registry.set(arm, std::numeric_limits<double>::infinity());
+  registry.set(total, 3);
+  registry.set(MetricRegistry::NO_SLOT, 1.0);
+
+  // The idle series has no value yet, so it is left out
+  std::string out;
+  registry.render(out);
+  EXPECT_EQ(out,
+            "# HELP power_rail Rail power\\nin W\n"
+            "# TYPE power_rail gauge\n"
+            "power_rail{rail=\"vdd \\\"soc\\\"\"} 1.5\n"
+            "power_rail{rail=\"arm\\\\a55\"} +Inf\n"
+            "# HELP runs_total Runs\n"
+            "# TYPE runs_total counter\n"
+            "runs_total 3\n");
+
+  registry.set(idle, std::nan(""));
+  out.clear();
+  registry.render(out);
+  EXPECT_NE(out.find("runs_total{peripheral=\"idle\"} NaN\n"), std::string::npos) << out;
+}
+
+TEST(MetricRegistryTest, SanitizesNamesAndStopsAtCapacity) {
+  EXPECT_EQ(MetricRegistry::sanitize("cpu/ops-per s"), "cpu_ops_per_s");
+  EXPECT_EQ(MetricRegistry::sanitize("5v_rail"), "_5v_rail");
+  EXPECT_EQ(MetricRegistry::sanitize(""), "_");
+
+  MetricRegistry registry(2, 1);
+  size_t         family = registry.add_family("a", "A", MetricType::GAUGE);
+  EXPECT_EQ(registry.add_family("b", "B", MetricType::GAUGE), MetricRegistry::NO_SLOT);
+  EXPECT_NE(registry.add(family, "n", "1"), MetricRegistry::NO_SLOT);
+  EXPECT_NE(registry.add(family, "n", "2"), MetricRegistry::NO_SLOT);
+  EXPECT_EQ(registry.add(family, "n", "3"), MetricRegistry::NO_SLOT);
+}
+
+TEST(MetricsExporterTest, ServesMetricsOverHttp) {
+  auto   registry = std::make_shared<MetricRegistry>();
+  size_t slot =
+      registry->add(registry->add_family("temperature", "Die temperature", MetricType::GAUGE));
+  registry->set(slot, 42.25);
+
+  MetricsExporterConfig config;
+  config.port = 0;
+  MetricsExporter exporter(registry, config);
+  ASSERT_TRUE(exporter.start()) << exporter.last_error();
+  ASSERT_NE(exporter.port(), 0);
+
+  std::string response = http(exporter.port(), "GET /metrics HTTP/1.1\r\nHost: x\r\n\r\n");
+  EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0u) << response;
+  EXPECT_NE(response.find("Content-Type: text/plain; version=0.0.4"), std::string::npos);
+  EXPECT_NE(response.find("\r\n\r\n# HELP temperature Die temperature\n"), std::string::npos);
+  EXPECT_NE(response.find("temperature 42.25\n"), std::string::npos);
+
+  // A scrape sees values set after the previous one
+  registry->set(slot, 43);
+  EXPECT_NE(http(exporter.port(), "GET / HTTP/1.0\r\n\r\n").find("temperature 43\n"),
+            std::string::npos);
+
+  std::string head = http(exporter.port(), "HEAD /metrics HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(head.rfind("HTTP/1.1 200 OK\r\n", 0), 0u);
+  EXPECT_EQ(head.find("# HELP"), std::string::npos);
+
+  EXPECT_EQ(http(exporter.port(), "GET /favicon.ico HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 404", 0),
+            0u);
+  EXPECT_EQ(http(exporter.port(), "POST /metrics HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 405", 0), 0u);
+  EXPECT_EQ(http(exporter.port(), std::string(2047, 'x')).rfind("HTTP/1.1 400", 0), 0u);
+  EXPECT_EQ(exporter.scrapes(), 3u);
+
+  exporter.stop();
+  EXPECT_EQ(http(exporter.port(), "GET /metrics HTTP/1.1\r\n\r\n"), "");
+}
+
+TEST(MetricsExporterTest, ReportsBindFailures) {
+  auto                  registry = std::make_shared<MetricRegistry>();
+  MetricsExporterConfig config;
+  config.port = 0;
+  MetricsExporter first(registry, config);
+  ASSERT_TRUE(first.start()) << first.last_error();
+
+  config.port = first.port();
+  MetricsExporter second(registry, config);
+  EXPECT_FALSE(second.start());
+  EXPECT_NE(second.last_error().find("Cannot listen on 127.0.0.1:"), std::string::npos);
+
+  config.address = "localhost";
+  MetricsExporter named(registry, config);
+  EXPECT_FALSE(named.start());
+  EXPECT_EQ(named.last_error(), "Invalid metrics address: localhost");
+}
+
+}  // namespace imx93_peripheral_test
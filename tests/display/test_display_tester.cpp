@@ -15,6 +15,7 @@ class DisplayTesterTest : public ::testing::Test {
 protected:
   void SetUp() override {
     tester_ = std::make_unique<DisplayTester>();
+    tester_->prepare();
   }
 
   void TearDown() override {
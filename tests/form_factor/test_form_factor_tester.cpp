@@ -15,6 +15,7 @@ class FormFactorTesterTest : public ::testing::Test {
 protected:
   void SetUp() override {
     tester_ = std::make_unique<FormFactorTester>();
+    tester_->prepare();
   }
 
   void TearDown() override {
@@ -18,6 +18,7 @@ class GPIOTesterTest : public ::testing::Test {
 protected:
   void SetUp() override {
     tester_ = std::make_unique<GPIOTester>();
+    tester_->prepare();
   }
 
   void TearDown() override {
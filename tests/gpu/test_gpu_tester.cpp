@@ -15,6 +15,7 @@ class GPUTesterTest : public ::testing::Test {
 protected:
   void SetUp() override {
     tester_ = std::make_unique<GPUTester>();
+    tester_->prepare();
   }
 
   void TearDown() override {
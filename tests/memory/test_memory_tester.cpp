@@ -7,6 +7,9 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
+
 #include "memory_tester.h"
 
 namespace imx93_peripheral_test {
@@ -15,6 +18,7 @@ class MemoryTesterTest : public ::testing::Test {
 protected:
   void SetUp() override {
     tester_ = std::make_unique<MemoryTester>();
+    tester_->prepare();
   }
 
   void TearDown() override {
@@ -56,4 +60,24 @@ TEST_F(MemoryTesterTest, MonitorTest) {
   EXPECT_GE(report.duration.count(), 0);
 }
 
+TEST_F(MemoryTesterTest, StressVerifiesPatterns) {
+  if (!tester_->is_available()) {
+    GTEST_SKIP() << "Memory information not available on this system";
+  }
+
+  std::atomic<bool> stop(false);
+  StressCounters    counters;
+  std::thread       stopper([&stop]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    stop = true;
+  });
+  TestResult result = tester_->stress(4, stop, counters);
+  stopper.join();
+
+  EXPECT_EQ(result, TestResult::SUCCESS);
+  EXPECT_GT(counters.operations.load(), 0u);
+  EXPECT_GE(counters.bytes.load(), counters.operations.load() * 8 * 1024 * 1024);
+  EXPECT_EQ(counters.errors.load(), 0u);
+}
+
 }  // namespace imx93_peripheral_test
@@ -7,7 +7,18 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+#include "dns_benchmark.h"
+#include "ethtool_interface.h"
+#include "latency_prober.h"
+#include "link_stats.h"
+#include "network_monitor.h"
 #include "networking_tester.h"
+#include "throughput_engine.h"
 
 namespace imx93_peripheral_test {
 
@@ -15,6 +26,7 @@ class NetworkingTesterTest : public ::testing::Test {
 protected:
   void SetUp() override {
     tester_ = std::make_unique<NetworkingTester>();
+    tester_->prepare();
   }
 
   void TearDown() override {
@@ -56,4 +68,416 @@ TEST_F(NetworkingTesterTest, MonitorTest) {
   EXPECT_GE(report.duration.count(), 0);
 }
 
+TEST_F(NetworkingTesterTest, StressTransfersOverLoopback) {
+  std::atomic<bool> stop(false);
+  StressCounters    counters;
+  std::thread       stopper([&stop]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    stop = true;
+  });
+  TestResult result = tester_->stress(1, stop, counters);
+  stopper.join();
+
+  EXPECT_EQ(result, TestResult::SUCCESS);
+  EXPECT_GT(counters.operations.load(), 0u);
+  EXPECT_GT(counters.bytes.load(), 0u);
+  EXPECT_EQ(counters.errors.load(), 0u);
+}
+
+TEST_F(NetworkingTesterTest, DnsBenchmarkNamesMetricsByServerIndex) {
+  DnsStubServer stub;
+  ASSERT_TRUE(stub.start());
+
+  DnsBenchmarkConfig config;
+  config.servers = {"127.0.0.1"};
+  config.port    = stub.port();
+  config.names   = {"board.example"};
+  TestReport report = tester_->dns_benchmark_test(config);
+
+  EXPECT_EQ(report.result, TestResult::SUCCESS) << report.details;
+  ASSERT_NE(report.metric("dns0_p99"), nullptr);
+  EXPECT_EQ(report.metric("dns0_p99")->unit, "ms");
+  EXPECT_NE(report.details.find("dns0 127.0.0.1: 1 resolved"), std::string::npos)
+      << report.details;
+  for (const auto& metric : report.metrics) {
+    EXPECT_EQ(metric.name.find("127.0.0.1"), std::string::npos) << metric.name;
+  }
+}
+
+TEST(LatencyProberTest, ProbesLocalhost) {
+  ProbeConfig config;
+  config.count    = 10;
+  config.interval = std::chrono::milliseconds(5);
+  LatencyProber prober(config);
+
+  LatencyStats stats = prober.probe("127.0.0.1");
+  if (!stats.error_message.empty()) {
+    GTEST_SKIP() << "ICMP sockets not permitted: " << stats.error_message;
+  }
+
+  EXPECT_EQ(stats.sent, 10u);
+  EXPECT_EQ(stats.received, 10u);
+  EXPECT_DOUBLE_EQ(stats.loss_percent, 0.0);
+  EXPECT_LE(stats.min_ms, stats.avg_ms);
+  EXPECT_LE(stats.avg_ms, stats.p99_ms);
+  EXPECT_LE(stats.p99_ms, stats.max_ms);
+  EXPECT_GE(stats.jitter_ms, 0.0);
+}
+
+TEST(LatencyProberTest, UnresolvableHost) {
+  LatencyProber prober;
+  auto          results = prober.probe(std::vector<std::string>{"256.256.256.256.invalid"});
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_FALSE(results[0].error_message.empty());
+  EXPECT_EQ(results[0].sent, 0u);
+  EXPECT_DOUBLE_EQ(results[0].loss_percent, 100.0);
+}
+
+TEST(ThroughputEngineTest, TcpLoopback) {
+  ThroughputConfig config;
+  config.streams  = 2;
+  config.duration = std::chrono::milliseconds(300);
+  ThroughputEngine engine(config);
+
+  ThroughputResult result = engine.run_loopback();
+  EXPECT_TRUE(result.success) << result.error_message;
+  EXPECT_GT(result.goodput_mbps, 0.0);
+  EXPECT_EQ(result.bytes_received, result.bytes_sent);
+}
+
+TEST(ThroughputEngineTest, UdpLoopback) {
+  ThroughputConfig config;
+  config.protocol     = TransportProtocol::UDP;
+  config.duration     = std::chrono::milliseconds(300);
+  config.bitrate_mbps = 50.0;
+  ThroughputEngine engine(config);
+
+  ThroughputResult result = engine.run_loopback();
+  EXPECT_TRUE(result.success) << result.error_message;
+  EXPECT_GT(result.datagrams_sent, 0u);
+  EXPECT_LE(result.datagrams_lost, result.datagrams_sent);
+  EXPECT_GT(result.bytes_received, 0u);
+}
+
+TEST(ThroughputEngineTest, ClientWithoutServerFails) {
+  ThroughputConfig config;
+  config.port     = 0;
+  config.duration = std::chrono::milliseconds(100);
+  ThroughputEngine probe_port(config);
+  ASSERT_TRUE(probe_port.start_server());
+  config.port = probe_port.server_port();
+  probe_port.stop_server();
+
+  ThroughputEngine client(config);
+  ThroughputResult result = client.run_client();
+  EXPECT_FALSE(result.success);
+  EXPECT_FALSE(result.error_message.empty());
+}
+
+TEST(LinkStatsCollectorTest, SamplesLoopback) {
+  LinkStatsCollector collector;
+  ASSERT_TRUE(collector.is_open());
+
+  LinkSnapshot snapshot;
+  ASSERT_TRUE(collector.sample(snapshot));
+  const LinkCounters* lo = snapshot.find("lo");
+  ASSERT_NE(lo, nullptr);
+  EXPECT_GT(lo->ifindex, 0);
+  EXPECT_TRUE(lo->is_up);
+}
+
+TEST(LinkStatsCollectorTest, RatesFollowTraffic) {
+  LinkStatsCollector collector;
+  LinkSnapshot       before;
+  ASSERT_TRUE(collector.sample(before));
+
+  ThroughputConfig config;
+  config.protocol     = TransportProtocol::UDP;
+  config.duration     = std::chrono::milliseconds(200);
+  config.bitrate_mbps = 20.0;
+  ThroughputEngine engine(config);
+  ASSERT_TRUE(engine.run_loopback().success);
+
+  LinkSnapshot after;
+  ASSERT_TRUE(collector.sample(after));
+  bool found = false;
+  for (const auto& rate : LinkStatsCollector::compute_rates(before, after)) {
+    if (rate.interface_name == "lo") {
+      found = true;
+      EXPECT_GT(rate.interval_s, 0.0);
+      EXPECT_GT(rate.rx_bps, 0.0);
+      EXPECT_GT(rate.tx_pps, 0.0);
+    }
+  }
+  EXPECT_TRUE(found);
+}
+
+TEST(NetworkMonitorTest, SamplesLoopbackUnderLoad) {
+  NetworkMonitorConfig config;
+  config.duration          = std::chrono::milliseconds(500);
+  config.sample_interval   = std::chrono::milliseconds(50);
+  config.interfaces        = {"lo"};
+  config.generate_load     = true;
+  config.load.protocol     = TransportProtocol::UDP;
+  config.load.bitrate_mbps = 20.0;
+  NetworkMonitor monitor(config);
+
+  NetworkMonitorResult result = monitor.run();
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_GE(result.sample_count, 5u);
+  ASSERT_EQ(result.interfaces.size(), 1u);
+  const InterfaceTimeSeries& lo = result.interfaces[0];
+  EXPECT_EQ(result.series.series()[lo.rx_series].summary().samples, result.sample_count);
+  EXPECT_EQ(result.series.series()[lo.drops_series].summary().samples, result.sample_count);
+  EXPECT_GT(lo.peak_rx_bps, 0.0);
+  EXPECT_TRUE(result.load_ran);
+  EXPECT_TRUE(result.load_result.success) << result.load_result.error_message;
+
+  std::stringstream csv;
+  NetworkMonitor::write_csv(result, csv);
+  std::string header;
+  std::getline(csv, header);
+  EXPECT_EQ(header, "interface,time_s,rx_mbps,tx_mbps,errors,drops");
+  std::string row;
+  std::getline(csv, row);
+  EXPECT_EQ(row.rfind("lo,", 0), 0u);
+}
+
+TEST(NetworkMonitorTest, ForwardsSamplesToTheSeriesSink) {
+  struct CountingSink : TimeSeriesSink {
+    void series_added(size_t, const std::string& name, const std::string&) override {
+      names.push_back(name);
+    }
+    void sample_added(size_t, std::chrono::steady_clock::time_point, double) override {
+      ++samples;
+    }
+    std::vector<std::string> names;
+    size_t                   samples = 0;
+  };
+
+  auto                 sink = std::make_shared<CountingSink>();
+  NetworkMonitorConfig config;
+  config.duration        = std::chrono::milliseconds(200);
+  config.sample_interval = std::chrono::milliseconds(50);
+  config.interfaces      = {"lo"};
+  config.series_sink     = sink;
+  NetworkMonitor monitor(config);
+
+  NetworkMonitorResult result = monitor.run();
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(sink->names, (std::vector<std::string>{"lo_rx", "lo_tx", "lo_errors", "lo_drops"}));
+  EXPECT_EQ(sink->samples, 4u * result.sample_count);
+}
+
+TEST(NetworkMonitorTest, CancelStopsTheLoad) {
+  CancellationToken    cancel;
+  NetworkMonitorConfig config;
+  config.duration        = std::chrono::seconds(30);
+  config.sample_interval = std::chrono::milliseconds(50);
+  config.interfaces      = {"lo"};
+  config.generate_load   = true;
+  config.cancel          = &cancel;
+  NetworkMonitor monitor(config);
+
+  auto        start = std::chrono::steady_clock::now();
+  std::thread canceller([&cancel]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    cancel.cancel();
+  });
+  NetworkMonitorResult result = monitor.run();
+  canceller.join();
+
+  // The load ends with the sample loop instead of running out its 30 s
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+  EXPECT_TRUE(result.load_ran);
+  EXPECT_GT(result.load_result.bytes_received, 0u) << result.load_result.error_message;
+  EXPECT_LT(result.load_result.elapsed_s, 2.0);
+}
+
+TEST(NetworkMonitorTest, UnknownInterfaceFails) {
+  NetworkMonitorConfig config;
+  config.duration   = std::chrono::milliseconds(100);
+  config.interfaces = {"does-not-exist0"};
+  NetworkMonitor monitor(config);
+
+  NetworkMonitorResult result = monitor.run();
+  EXPECT_FALSE(result.success);
+  EXPECT_FALSE(result.error_message.empty());
+}
+
+TEST(DnsBenchmarkTest, ResolvesAgainstStub) {
+  DnsStubServer stub;
+  ASSERT_TRUE(stub.start());
+
+  DnsBenchmarkConfig config;
+  config.servers = {"127.0.0.1"};
+  config.port    = stub.port();
+  config.names   = {"board.example", "missing.invalid"};
+  config.repeat  = 10;
+  DnsBenchmark benchmark(config);
+
+  DnsBenchmarkResult result = benchmark.run();
+  ASSERT_TRUE(result.success) << result.error_message;
+  ASSERT_EQ(result.servers.size(), 1u);
+  EXPECT_EQ(result.servers[0].queries, 20u);
+  EXPECT_EQ(result.servers[0].resolved, 10u);
+  EXPECT_EQ(result.servers[0].nxdomain, 10u);
+  EXPECT_EQ(result.servers[0].failure_rate, 0.0);
+  EXPECT_LE(result.servers[0].p50_ms, result.servers[0].p99_ms);
+  ASSERT_EQ(result.resolved_names.size(), 1u);
+  EXPECT_EQ(result.resolved_names[0], "board.example");
+  EXPECT_EQ(stub.queries_answered(), 20u);
+}
+
+TEST(DnsBenchmarkTest, DeadServerFailsFast) {
+  DnsStubServer stub;
+  ASSERT_TRUE(stub.start());
+  uint16_t closed_port = stub.port();
+  stub.stop();
+
+  DnsBenchmarkConfig config;
+  config.servers = {"127.0.0.1"};
+  config.port    = closed_port;
+  config.names   = {"a.example", "b.example", "c.example"};
+  config.timeout = std::chrono::milliseconds(500);
+  DnsBenchmark benchmark(config);
+
+  DnsBenchmarkResult result = benchmark.run();
+  EXPECT_FALSE(result.success);
+  ASSERT_EQ(result.servers.size(), 1u);
+  EXPECT_EQ(result.servers[0].failure_rate, 1.0);
+  EXPECT_LT(result.elapsed_s, 1.0);
+}
+
+TEST(DnsBenchmarkTest, RejectsInvalidNames) {
+  std::vector<uint8_t> packet;
+  EXPECT_TRUE(DnsBenchmark::encode_query(1, "example.com.", packet));
+  EXPECT_EQ(packet.size(), 12u + 13u + 4u);
+  EXPECT_FALSE(DnsBenchmark::encode_query(1, "bad..name", packet));
+  EXPECT_FALSE(DnsBenchmark::encode_query(1, std::string(64, 'a') + ".com", packet));
+}
+
+TEST(EthtoolInterfaceTest, ReadsLoopbackFeatures) {
+  EthtoolInterface ethtool("lo");
+
+  std::vector<EthtoolFeature> features;
+  ASSERT_TRUE(ethtool.get_features(features)) << ethtool.last_error();
+  auto gro = std::find_if(features.begin(), features.end(),
+                          [](const EthtoolFeature& f) { return f.name == "rx-gro"; });
+  EXPECT_NE(gro, features.end());
+}
+
+TEST_F(NetworkingTesterTest, EthtoolLoadNeedsPeer) {
+  EthtoolTestConfig config;
+  config.interface_name = "lo";
+  config.offload_ab     = true;
+  for (const char* host : {"", "127.0.0.1", "127.1.2.3", "localhost"}) {
+    config.load.host  = host;
+    TestReport report = tester_->ethtool_test(config);
+    EXPECT_EQ(report.result, TestResult::NOT_SUPPORTED) << host << ": " << report.details;
+    EXPECT_EQ(report.check("load"), TestResult::NOT_SUPPORTED);
+    EXPECT_NE(report.details.find("needs a peer --host"), std::string::npos) << report.details;
+    EXPECT_EQ(report.details.find("A/B"), std::string::npos);
+  }
+
+  EXPECT_FALSE(ThroughputEngine::is_loopback_host("192.168.1.100"));
+  EXPECT_FALSE(ThroughputEngine::is_loopback_host("does-not-resolve.invalid"));
+}
+
+TEST(EthtoolInterfaceTest, UnknownInterfaceFails) {
+  EthtoolInterface ethtool("does-not-exist0");
+
+  EthtoolLinkInfo link;
+  EXPECT_FALSE(ethtool.get_link_settings(link));
+  EXPECT_FALSE(ethtool.last_error().empty());
+}
+
+TEST(EthtoolInterfaceTest, ErrorCounterDeltas) {
+  EXPECT_TRUE(EthtoolInterface::is_error_counter("rx_crc_errors"));
+  EXPECT_TRUE(EthtoolInterface::is_error_counter("RX_FIFO_OVERFLOW"));
+  EXPECT_FALSE(EthtoolInterface::is_error_counter("rx_packets"));
+
+  std::vector<EthtoolStat> before = {{"rx_packets", 10}, {"rx_crc_errors", 1}, {"tx_dropped", 5}};
+  std::vector<EthtoolStat> after  = {{"rx_packets", 50}, {"rx_crc_errors", 4}, {"tx_dropped", 5}};
+
+  auto errors = EthtoolInterface::counter_deltas(before, after, true);
+  ASSERT_EQ(errors.size(), 1u);
+  EXPECT_EQ(errors[0].name, "rx_crc_errors");
+  EXPECT_EQ(errors[0].value, 3u);
+  EXPECT_EQ(EthtoolInterface::counter_deltas(before, after, false).size(), 2u);
+}
+
+
+TEST(PtpTimestampTest, DistributionFromSamples) {
+  TimingDistribution dist = TimingDistribution::from_samples({100.0, 300.0, 200.0, 400.0});
+  EXPECT_EQ(dist.count, 4u);
+  EXPECT_DOUBLE_EQ(dist.min_ns, 100.0);
+  EXPECT_DOUBLE_EQ(dist.max_ns, 400.0);
+  EXPECT_DOUBLE_EQ(dist.mean_ns, 250.0);
+  EXPECT_DOUBLE_EQ(dist.p50_ns, 200.0);
+  EXPECT_DOUBLE_EQ(dist.p99_ns, 400.0);
+  // |300-100| + |200-300| + |400-200| over 3 steps
+  EXPECT_DOUBLE_EQ(dist.jitter_ns, 500.0 / 3.0);
+  EXPECT_EQ(TimingDistribution::from_samples({}).count, 0u);
+}
+
+TEST(PtpTimestampTest, SoftwareTimestampsOverLoopback) {
+  PtpTimestampConfig config;
+  config.packets  = 20;
+  config.interval = std::chrono::milliseconds(1);
+
+  PtpTimestampProbe  probe(config);
+  PtpTimestampResult result = probe.run();
+  if (result.error_message.find("AF_PACKET") != std::string::npos) {
+    GTEST_SKIP() << "Packet sockets not permitted: " << result.error_message;
+  }
+
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_FALSE(result.hardware_timestamps);  // lo has no PHC
+  EXPECT_EQ(result.packets_sent, 20u);
+  EXPECT_GT(result.packets_timestamped, 0u);
+  EXPECT_GE(result.path_latency.min_ns, 0.0);
+}
+
+TEST(PtpTimestampTest, UnknownInterfaceFails) {
+  PtpTimestampConfig config;
+  config.tx_interface = "does-not-exist0";
+
+  PtpTimestampResult result = PtpTimestampProbe(config).run();
+  EXPECT_FALSE(result.success);
+  EXPECT_FALSE(result.error_message.empty());
+}
+
+
+TEST(PacketRateEngineTest, FloodsLoopback) {
+  PacketRateConfig config;
+  config.tx_interface = "lo";
+  config.duration     = std::chrono::milliseconds(300);
+  config.backend      = PacketTxBackend::TPACKET;
+
+  PacketRateResult result = PacketRateEngine(config).run();
+  if (result.error_message.find("socket") != std::string::npos) {
+    GTEST_SKIP() << "Packet sockets not permitted: " << result.error_message;
+  }
+
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.tx_backend, "TPACKET_V3");
+  EXPECT_GT(result.tx_pps, 0.0);
+  EXPECT_GT(result.frames_received, 0u);
+  EXPECT_LE(result.frames_received, result.frames_sent);
+  EXPECT_FALSE(result.cores.empty());
+}
+
+TEST(PacketRateEngineTest, RejectsInvalidConfig) {
+  PacketRateConfig config;
+  config.tx_interface = "does-not-exist0";
+  EXPECT_FALSE(PacketRateEngine(config).run().success);
+
+  config.tx_interface = "lo";
+  config.frame_size   = 32;
+  PacketRateResult result = PacketRateEngine(config).run();
+  EXPECT_FALSE(result.success);
+  EXPECT_EQ(result.frames_sent, 0u);
+}
+
 }  // namespace imx93_peripheral_test
@@ -6,8 +6,20 @@
  */
 
 #include <gtest/gtest.h>
+#include <unistd.h>
 
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "cpufreq_sweep.h"
+#include "energy_meter.h"
+#include "power_sampler.h"
 #include "power_tester.h"
+#include "rail_stability.h"
+#include "suspend_latency.h"
+#include "time_series.h"
 
 namespace imx93_peripheral_test {
 
@@ -15,6 +27,7 @@ class PowerTesterTest : public ::testing::Test {
 protected:
   void SetUp() override {
     tester_ = std::make_unique<PowerTester>();
+    tester_->prepare();
   }
 
   void TearDown() override {
@@ -56,4 +69,462 @@ TEST_F(PowerTesterTest, MonitorTest) {
   EXPECT_GE(report.duration.count(), 0);
 }
 
+
+/**
+ * @brief Fake sysfs tree with one supply, one INA219-style hwmon chip and two regulators.
+ */
+class PowerSamplerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    root_ = std::filesystem::temp_directory_path() /
+            ("power_sampler_test_" + std::to_string(getpid()));
+    write("class/power_supply/usb/voltage_now", "5000000");  // 5 V
+    write("class/power_supply/usb/current_now", "2000000");  // 2 A
+    write("class/hwmon/hwmon0/name", "ina219");
+    write("class/hwmon/hwmon0/in0_input", "10");  // Shunt voltage, no matching current
+    write("class/hwmon/hwmon0/in1_input", "3300");
+    write("class/hwmon/hwmon0/curr1_input", "500");
+    write("class/hwmon/hwmon0/power1_input", "1650000");
+    write("class/regulator/regulator.1/name", "VDD_SOC");
+    write("class/regulator/regulator.1/microvolts", "800000");
+    write("class/regulator/regulator.1/microamps", "1000000");
+    write("class/regulator/regulator.2/name", "NVCC_SD");
+    write("class/regulator/regulator.2/microvolts", "3300000");
+  }
+
+  void TearDown() override {
+    std::filesystem::remove_all(root_);
+  }
+
+  void write(const std::string& relative, const std::string& value) {
+    std::filesystem::path path = root_ / relative;
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream(path) << value << "\n";
+  }
+
+  PowerSamplerConfig config() const {
+    PowerSamplerConfig config;
+    config.sysfs_root = root_.string();
+    return config;
+  }
+
+  std::filesystem::path root_;
+};
+
+TEST_F(PowerSamplerTest, DiscoversChannelsAndRails) {
+  PowerSampler sampler(config());
+  ASSERT_TRUE(sampler.discover());
+  EXPECT_EQ(sampler.channels().size(), 9u);
+
+  const auto& rails = sampler.rails();
+  ASSERT_EQ(rails.size(), 3u);
+  EXPECT_EQ(rails[0].name, "power_supply/usb");
+  EXPECT_EQ(rails[1].name, "hwmon/ina219/power1");
+  EXPECT_EQ(rails[2].name, "regulator/VDD_SOC");
+
+  PowerReading reading;
+  ASSERT_TRUE(sampler.read(reading));
+  EXPECT_DOUBLE_EQ(PowerSampler::rail_power(rails[0], reading.values), 10.0);
+  EXPECT_DOUBLE_EQ(PowerSampler::rail_power(rails[1], reading.values), 1.65);
+  EXPECT_DOUBLE_EQ(PowerSampler::rail_power(rails[2], reading.values), 0.8);
+
+  // Channel files stay open and are re-read on every sample
+  write("class/power_supply/usb/current_now", "-3000000");
+  ASSERT_TRUE(sampler.read(reading));
+  EXPECT_DOUBLE_EQ(PowerSampler::rail_power(rails[0], reading.values), 15.0);
+}
+
+TEST_F(PowerSamplerTest, IntegratesEnergy) {
+  PowerSampler sampler(config());
+  ASSERT_TRUE(sampler.discover());
+  ASSERT_TRUE(sampler.start());
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  sampler.stop();
+
+  EXPECT_GT(sampler.samples_taken(), 20u);
+  auto stats = sampler.rail_stats();
+  ASSERT_EQ(stats.size(), 3u);
+  EXPECT_NEAR(stats[0].average_w, 10.0, 1e-6);
+  EXPECT_DOUBLE_EQ(stats[0].peak_w, 10.0);
+  EXPECT_GT(stats[0].energy_j, 1.0);  // ~2 J over 200 ms
+  EXPECT_LT(stats[0].energy_j, 3.0);
+
+  auto recent = sampler.recent(5);
+  ASSERT_EQ(recent.size(), 5u);
+  EXPECT_DOUBLE_EQ(recent[0].values[0], 5.0);
+  EXPECT_LE(recent[0].timestamp, recent[4].timestamp);
+
+  TimeSeriesStore series = sampler.power_series();
+  ASSERT_EQ(series.series().size(), 3u);
+  EXPECT_EQ(series.series()[0].name(), "power_supply/usb");
+  EXPECT_EQ(series.series()[0].unit(), "W");
+  EXPECT_EQ(series.series()[0].summary().samples, sampler.samples_taken());
+  EXPECT_DOUBLE_EQ(series.series()[0].summary().max, 10.0);
+}
+
+TEST(PowerSamplerEmptyTest, NoChannels) {
+  PowerSamplerConfig config;
+  config.sysfs_root = "/nonexistent";
+  PowerSampler sampler(config);
+  EXPECT_FALSE(sampler.discover());
+  EXPECT_FALSE(sampler.start());
+}
+
+TEST_F(PowerSamplerTest, MeasuresEnergyPerRun) {
+  EnergyMeterConfig config;
+  config.sampler     = this->config();
+  config.idle_window = std::chrono::milliseconds(100);
+  config.runs        = 2;
+
+  EnergyMeter       meter(config);
+  EnergyMeasurement result = meter.measure("sleep", []() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    return uint64_t(100);
+  });
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.rail, "power_supply/usb");  // Highest idle power
+  EXPECT_EQ(result.runs, 2u);
+  EXPECT_EQ(result.ops, 200u);
+  EXPECT_NEAR(result.idle_power_w, 10.0, 1e-6);
+  EXPECT_NEAR(result.average_power_w, 10.0, 1e-6);
+  EXPECT_NEAR(result.energy_per_run_j, 0.5, 0.1);  // 10 W x ~50 ms
+  EXPECT_NEAR(result.ops_per_joule, 200.0, 40.0);
+  EXPECT_NEAR(result.net_energy_per_run_j, 0.0, 1e-6);
+
+  config.rail = "regulator/VDD_SOC";
+  result      = EnergyMeter(config).measure("noop", []() { return uint64_t(0); });
+  EXPECT_FALSE(result.success);
+  EXPECT_TRUE(result.workload_failed);
+  EXPECT_NEAR(result.idle_power_w, 0.8, 1e-6);
+  EXPECT_EQ(result.runs, 0u);
+
+  config.rail = "missing";
+  EXPECT_FALSE(EnergyMeter(config).measure("noop", []() { return uint64_t(0); }).success);
+}
+
+TEST(SuspendLatencyTest, ParsesPmLog) {
+  std::vector<std::string> lines = {
+      "PM: suspend entry (s2idle)",
+      "PM: suspend of devices complete after 12.500 msecs",
+      "PM: late suspend of devices complete after 1.500 msecs",
+      "serial8250 serial8250: platform_pm_suspend+0x0/0x50 returned 0 after 300 usecs",
+      "e1000e 0000:00:19.0: pci_pm_resume+0x0/0xe0 returned 0 after 8000 usecs",
+      "serial8250 serial8250: platform_pm_resume+0x0/0x50 returned 0 after 1500 usecs",
+      "PM: early resume of devices complete after 2.000 msecs",
+      "PM: resume of devices complete after 20.250 msecs",
+      "PM: suspend exit"};
+  SuspendCycle cycle;
+  SuspendLatencyProbe::parse_pm_log(lines, cycle);
+
+  EXPECT_DOUBLE_EQ(cycle.entry_ms, 14.0);
+  EXPECT_DOUBLE_EQ(cycle.resume_ms, 22.25);
+  ASSERT_EQ(cycle.devices.size(), 2u);
+  EXPECT_EQ(cycle.devices[0].device, "e1000e 0000:00:19.0");  // Slowest to resume first
+  EXPECT_DOUBLE_EQ(cycle.devices[0].resume_ms, 8.0);
+  EXPECT_EQ(cycle.devices[1].device, "serial8250 serial8250");
+  EXPECT_DOUBLE_EQ(cycle.devices[1].suspend_ms, 0.3);
+  EXPECT_DOUBLE_EQ(cycle.devices[1].resume_ms, 1.5);
+
+  SuspendLatencyProbe::parse_pm_log({}, cycle);
+  EXPECT_DOUBLE_EQ(cycle.resume_ms, -1.0);
+  EXPECT_TRUE(cycle.devices.empty());
+}
+
+TEST_F(PowerSamplerTest, SuspendCyclesAgainstFakeSysfs) {
+  // Writes to the fake power/state return at once, so no real suspend happens
+  write("power/state", "freeze mem");
+  write("power/pm_print_times", "0");
+  write("class/rtc/rtc0/wakealarm", "");
+
+  SuspendLatencyConfig config;
+  config.sysfs_root = root_.string();
+  config.kmsg_path  = (root_ / "kmsg").string();
+  config.cycles     = 2;
+  config.wake_after = std::chrono::seconds(5);
+  config.settle     = std::chrono::milliseconds(0);
+
+  SuspendLatencyResult result = SuspendLatencyProbe(config).run();
+  ASSERT_TRUE(result.success) << result.error_message;
+  ASSERT_EQ(result.cycles.size(), 2u);
+  EXPECT_GE(result.cycles[0].total_ms, result.cycles[0].active_ms);
+  EXPECT_DOUBLE_EQ(result.cycles[0].resume_ms, -1.0);
+
+  std::string value;
+  std::ifstream(root_ / "power/state") >> value;
+  EXPECT_EQ(value, "freeze");
+  std::ifstream(root_ / "class/rtc/rtc0/wakealarm") >> value;
+  EXPECT_EQ(value, "0");  // Alarm cleared after resume
+  std::ifstream(root_ / "power/pm_print_times") >> value;
+  EXPECT_EQ(value, "0");  // Restored
+
+  config.state = "disk";
+  result       = SuspendLatencyProbe(config).run();
+  EXPECT_FALSE(result.supported);
+  EXPECT_FALSE(result.success);
+}
+
+TEST_F(PowerSamplerTest, SweepsCpufreqAndRestoresPolicy) {
+  const std::string policy = "cpu/cpufreq/policy0/";
+  write(policy + "scaling_available_governors", "performance powersave userspace");
+  write(policy + "scaling_available_frequencies", "900000 1700000");
+  write(policy + "scaling_governor", "powersave");
+  write(policy + "cpuinfo_min_freq", "900000");
+  write(policy + "cpuinfo_max_freq", "1700000");
+  write(policy + "scaling_min_freq", "1000000");
+  write(policy + "scaling_max_freq", "1500000");
+
+  CpufreqSweepConfig config;
+  config.cpu_root          = (root_ / "cpu").string();
+  config.meter.sampler     = this->config();
+  config.meter.idle_window = std::chrono::milliseconds(20);
+  config.meter.runs        = 1;
+  config.workload          = []() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return uint64_t(1);
+  };
+
+  CpufreqSweepResult result = CpufreqSweep(config).run();
+  ASSERT_TRUE(result.success) << result.error_message;
+  ASSERT_EQ(result.points.size(), 4u);  // performance, powersave, 900 MHz, 1700 MHz
+  EXPECT_EQ(result.points[0].governor, "performance");
+  EXPECT_EQ(result.points[2].frequency_khz, 900000u);
+  EXPECT_EQ(result.points[3].governor, "performance");
+  EXPECT_NEAR(result.points[0].average_power_w, 10.0, 1e-6);
+
+  auto read = [this](const std::string& relative) {
+    std::string value;
+    std::ifstream(root_ / relative) >> value;
+    return value;
+  };
+  EXPECT_EQ(read(policy + "scaling_governor"), "powersave");
+  EXPECT_EQ(read(policy + "scaling_min_freq"), "1000000");
+  EXPECT_EQ(read(policy + "scaling_max_freq"), "1500000");
+}
+
+TEST_F(PowerSamplerTest, CancelledCpufreqSweepRestoresPolicy) {
+  const std::string policy = "cpu/cpufreq/policy0/";
+  write(policy + "scaling_available_governors", "performance powersave");
+  write(policy + "scaling_available_frequencies", "900000 1700000");
+  write(policy + "scaling_governor", "powersave");
+  write(policy + "cpuinfo_min_freq", "900000");
+  write(policy + "cpuinfo_max_freq", "1700000");
+  write(policy + "scaling_min_freq", "1000000");
+  write(policy + "scaling_max_freq", "1500000");
+
+  CancellationToken  cancel;
+  CpufreqSweepConfig config;
+  config.cpu_root          = (root_ / "cpu").string();
+  config.meter.sampler     = this->config();
+  config.meter.idle_window = std::chrono::milliseconds(20);
+  config.meter.runs        = 1;
+  config.meter.cancel      = &cancel;
+  config.workload          = [&cancel]() {
+    cancel.cancel();
+    return uint64_t(1);
+  };
+
+  // The first point completes; the rest are skipped and the policy is put back
+  CpufreqSweepResult result = CpufreqSweep(config).run();
+  EXPECT_FALSE(result.success);
+  ASSERT_EQ(result.points.size(), 4u);
+  EXPECT_TRUE(result.points[0].success);
+  EXPECT_EQ(result.points[1].error_message, "Cancelled");
+  EXPECT_EQ(result.error_message, "Cancelled");
+
+  std::string value;
+  std::ifstream(root_ / (policy + "scaling_governor")) >> value;
+  EXPECT_EQ(value, "powersave");
+  std::ifstream(root_ / (policy + "scaling_max_freq")) >> value;
+  EXPECT_EQ(value, "1500000");
+}
+
+TEST(CpufreqSweepTest, MarksParetoFront) {
+  std::vector<CpufreqOperatingPoint> points(4);
+  points[0].time_s   = 1.0;  // Fast, expensive
+  points[0].energy_j = 5.0;
+  points[1].time_s   = 2.0;  // Slow, cheap
+  points[1].energy_j = 3.0;
+  points[2].time_s   = 2.0;  // Dominated by points[1]
+  points[2].energy_j = 4.0;
+  points[3].time_s   = 0.5;  // Failed points never count
+  points[3].energy_j = 1.0;
+  for (size_t i = 0; i < 3; ++i) {
+    points[i].success = true;
+  }
+
+  CpufreqSweep::mark_pareto_front(points);
+  EXPECT_TRUE(points[0].pareto);
+  EXPECT_TRUE(points[1].pareto);
+  EXPECT_FALSE(points[2].pareto);
+  EXPECT_FALSE(points[3].pareto);
+}
+
+TEST(CpufreqSweepTest, NoPolicies) {
+  CpufreqSweepConfig config;
+  config.cpu_root = "/nonexistent";
+  CpufreqSweepResult result = CpufreqSweep(config).run();
+  EXPECT_FALSE(result.supported);
+  EXPECT_FALSE(result.success);
+}
+
+TEST(RailStabilityTest, StreamingStatsMatchesBatch) {
+  StreamingStats stats;
+  for (double value : {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0}) {
+    stats.add(value);
+  }
+  EXPECT_EQ(stats.count(), 8u);
+  EXPECT_DOUBLE_EQ(stats.mean(), 5.0);
+  EXPECT_DOUBLE_EQ(stats.stddev(), 2.0);
+  EXPECT_DOUBLE_EQ(stats.min(), 2.0);
+  EXPECT_DOUBLE_EQ(stats.max(), 9.0);
+  stats.reset();
+  EXPECT_EQ(stats.count(), 0u);
+  EXPECT_DOUBLE_EQ(stats.variance(), 0.0);
+}
+
+TEST(RailStabilityTest, DetectsBrownouts) {
+  BrownoutConfig config;
+  config.absolute_threshold_v["vbus"] = 4.75;
+  config.max_events                   = 2;
+  RailStabilityTracker tracker(config);
+  tracker.reset({"vbus", "soc"});
+
+  // vbus: three dips of 2, 1 and 3 samples at 1 ms; soc: relative threshold only
+  auto        start = std::chrono::steady_clock::now();
+  const char* vbus  = "HLLHHLHLLLH";
+  for (int i = 0; vbus[i] != '\0'; ++i) {
+    auto time = start + std::chrono::milliseconds(i);
+    tracker.add(0, time, vbus[i] == 'L' ? 4.5 : 5.0, 1.0, 5.0);
+    tracker.add(1, time, 0.8, NAN, 0.8);
+  }
+  tracker.add(0, start + std::chrono::milliseconds(11), 4.6, 1.0, 4.6);  // Still low at the end
+
+  auto rails = tracker.snapshot();
+  ASSERT_EQ(rails.size(), 2u);
+  EXPECT_EQ(rails[0].dip_count, 4u);
+  EXPECT_DOUBLE_EQ(rails[0].longest_dip_ms, 3.0);
+  ASSERT_EQ(rails[0].dips.size(), 2u);  // Only the most recent are kept
+  EXPECT_DOUBLE_EQ(rails[0].dips[0].duration_ms, 3.0);
+  EXPECT_DOUBLE_EQ(rails[0].dips[0].min_voltage_v, 4.5);
+  EXPECT_TRUE(rails[0].dips[1].ongoing);
+  EXPECT_NEAR(rails[0].voltage.stddev(), 0.25, 0.01);
+  EXPECT_DOUBLE_EQ(rails[0].current.mean(), 1.0);
+
+  EXPECT_EQ(rails[1].dip_count, 0u);
+  EXPECT_EQ(rails[1].current.count(), 0u);
+  EXPECT_DOUBLE_EQ(rails[1].voltage.stddev(), 0.0);
+}
+
+TEST_F(PowerSamplerTest, ReportsRailBrownouts) {
+  PowerSamplerConfig config = this->config();
+
+  config.brownout.absolute_threshold_v["regulator/VDD_SOC"] = 0.75;
+  PowerSampler sampler(config);
+  ASSERT_TRUE(sampler.discover());
+  ASSERT_TRUE(sampler.start());
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  write("class/regulator/regulator.1/microvolts", "700000");
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  write("class/regulator/regulator.1/microvolts", "800000");
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  sampler.stop();
+
+  auto rails = sampler.rail_stability();
+  ASSERT_EQ(rails.size(), 3u);
+  EXPECT_EQ(rails[0].dip_count, 0u);  // 5 V USB supply stays at 90% of its mean
+  EXPECT_EQ(rails[2].name, "regulator/VDD_SOC");
+  ASSERT_EQ(rails[2].dip_count, 1u);
+  EXPECT_DOUBLE_EQ(rails[2].dips[0].min_voltage_v, 0.7);
+  EXPECT_GT(rails[2].dips[0].duration_ms, 20.0);
+  EXPECT_DOUBLE_EQ(rails[2].voltage.min(), 0.7);
+}
+
+TEST_F(PowerSamplerTest, FailedReadsAreNotBrownouts) {
+  PowerSampler sampler(config());
+  ASSERT_TRUE(sampler.discover());
+  ASSERT_TRUE(sampler.start());
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  write("class/power_supply/usb/voltage_now", "");  // Unparsable, like a torn sysfs read
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  write("class/power_supply/usb/voltage_now", "5000000");
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  sampler.stop();
+
+  auto rails = sampler.rail_stability();
+  ASSERT_FALSE(rails.empty());
+  EXPECT_EQ(rails[0].dip_count, 0u);
+  EXPECT_DOUBLE_EQ(rails[0].voltage.min(), 5.0);
+}
+
+TEST(TimeSeriesTest, DownsamplesIntoTiersAndKeepsPeaks) {
+  TimeSeries series("power", "W", 4, 2, 3);
+  for (int i = 0; i < 8; ++i) {
+    series.add(i, i == 5 ? 100.0 : 1.0);
+  }
+
+  // Raw tier keeps the last four samples, tier 1 pairs, tier 2 quadruples
+  auto raw = series.tier(0);
+  ASSERT_EQ(raw.size(), 4u);
+  EXPECT_DOUBLE_EQ(raw[0].start_s, 4.0);
+  EXPECT_DOUBLE_EQ(raw[1].max, 100.0);
+  auto pairs = series.tier(1);
+  ASSERT_EQ(pairs.size(), 4u);
+  EXPECT_EQ(pairs[2].samples, 2u);
+  EXPECT_DOUBLE_EQ(pairs[2].max, 100.0);
+  EXPECT_DOUBLE_EQ(pairs[2].mean, 50.5);
+  auto quads = series.tier(2);
+  ASSERT_EQ(quads.size(), 2u);
+  EXPECT_DOUBLE_EQ(quads[1].start_s, 4.0);
+  EXPECT_DOUBLE_EQ(quads[1].end_s, 7.0);
+  EXPECT_DOUBLE_EQ(quads[1].max, 100.0);
+  EXPECT_DOUBLE_EQ(quads[1].min, 1.0);
+
+  TimeSeriesBucket all = series.summary();
+  EXPECT_EQ(all.samples, 8u);
+  EXPECT_DOUBLE_EQ(all.max, 100.0);
+  EXPECT_DOUBLE_EQ(all.mean, 107.0 / 8);
+
+  // Raw tier has wrapped, so the finest tier covering the run is used
+  EXPECT_EQ(series.downsampled(8).size(), 4u);
+  EXPECT_DOUBLE_EQ(series.downsampled(8)[0].start_s, 0.0);
+  EXPECT_EQ(series.downsampled(2).size(), 2u);
+}
+
+TEST(TimeSeriesTest, OpenBucketsAreReadAndMemoryStaysBounded) {
+  TimeSeries series("temp", "C", 4, 2, 3);
+  for (int i = 0; i < 10000; ++i) {
+    series.add(i, i % 7);
+  }
+  series.add(10000, -1.0);
+
+  auto coarse = series.tier(2);
+  ASSERT_EQ(coarse.size(), 5u);  // Four closed buckets plus the open one
+  EXPECT_EQ(coarse.back().samples, 1u);
+  EXPECT_DOUBLE_EQ(coarse.back().min, -1.0);
+  EXPECT_EQ(series.tier(0).size(), 4u);
+  EXPECT_EQ(series.summary().samples, 10001u);
+  EXPECT_DOUBLE_EQ(series.summary().min, -1.0);
+  EXPECT_TRUE(series.tier(3).empty());
+}
+
+TEST(TimeSeriesTest, StoreReusesSeriesByName) {
+  TimeSeriesStore store;
+  size_t          a = store.add_series("a", "W");
+  size_t          b = store.add_series("b", "C");
+  EXPECT_EQ(store.add_series("a", "W"), a);
+  store.add(a, 1.0, 0.5);
+  store.add(a, 3.0, 1.5);
+  store.add(b + 1, 5.0);  // Unknown series is ignored
+  EXPECT_EQ(store.series()[a].summary().samples, 2u);
+  EXPECT_EQ(store.series()[b].summary().samples, 0u);
+
+  std::string text = store.format();
+  EXPECT_NE(text.find("Series a [W]: 2 samples, min 1, mean 2, max 3"), std::string::npos);
+  EXPECT_NE(text.find("  0.5-0.5 s: 1/1/1"), std::string::npos);
+  EXPECT_EQ(text.find("Series b"), std::string::npos);
+
+  store.clear();
+  EXPECT_TRUE(store.empty());
+}
+
 }  // namespace imx93_peripheral_test
@@ -6,6 +6,11 @@
  */
 
 #include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <filesystem>
+#include <thread>
 
 #include "storage_tester.h"
 
@@ -15,6 +20,7 @@ class StorageTesterTest : public ::testing::Test {
 protected:
   void SetUp() override {
     tester_ = std::make_unique<StorageTester>();
+    tester_->prepare();
   }
 
   void TearDown() override {
@@ -56,4 +62,33 @@ TEST_F(StorageTesterTest, MonitorTest) {
   EXPECT_GE(report.duration.count(), 0);
 }
 
+TEST_F(StorageTesterTest, StressVerifiesScratchFile) {
+  std::filesystem::path dir = std::filesystem::temp_directory_path() /
+                              ("storage_stress_test_" + std::to_string(getpid()));
+  std::filesystem::create_directories(dir);
+  tester_->set_stress_path(dir.string());
+
+  std::atomic<bool> stop(false);
+  StressCounters    counters;
+  std::thread       stopper([&stop]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    stop = true;
+  });
+  TestResult result = tester_->stress(2, stop, counters);
+  stopper.join();
+
+  EXPECT_EQ(result, TestResult::SUCCESS);
+  EXPECT_GT(counters.operations.load(), 0u);
+  EXPECT_EQ(counters.errors.load(), 0u);
+  EXPECT_TRUE(std::filesystem::is_empty(dir));  // Scratch file removed
+  std::filesystem::remove_all(dir);
+}
+
+TEST_F(StorageTesterTest, StressWithoutDirectoryIsNotSupported) {
+  tester_->set_stress_path("/nonexistent/storage_stress");
+  std::atomic<bool> stop(true);
+  StressCounters    counters;
+  EXPECT_EQ(tester_->stress(1, stop, counters), TestResult::NOT_SUPPORTED);
+}
+
 }  // namespace imx93_peripheral_test
@@ -0,0 +1,135 @@
+/**
+ * @file test_json_stream.cpp
+ * @brief Unit tests for JSON escaping and the streaming JSON writer.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <limits>
+
+#include "json_utils.h"
+#include "peripheral_tester.h"
+
+namespace imx93_peripheral_test {
+
+TEST(JsonStreamTest, EscapesAcrossWordBoundaries) {
+  EXPECT_EQ(JsonWriter::escape_string(""), "\"\"");
+  EXPECT_EQ(JsonWriter::escape_string("plain text of some length"),
+            "\"plain text of some length\"");
+  EXPECT_EQ(JsonWriter::escape_string("a\"b\\c\nd\te\rf\bg\fh"),
+            "\"a\\\"b\\\\c\\nd\\te\\rf\\bg\\fh\"");
+  EXPECT_EQ(JsonWriter::escape_string(std::string("x\x01y\x1f", 4)), "\"x\\u0001y\\u001f\"");
+  EXPECT_EQ(JsonWriter::escape_string("Temperatur 45 \xc2\xb0" "C \x7f"),
+            "\"Temperatur 45 \xc2\xb0" "C \x7f\"");
+
+  // A special character at every position of a word, and a clean tail after it
+  for (size_t position = 0; position < 20; ++position) {
+    std::string input(20, 'a');
+    input[position] = '"';
+    std::string expected(20, 'a');
+    expected.replace(position, 1, "\\\"");
+    EXPECT_EQ(JsonWriter::escape_string(input), "\"" + expected + "\"") << position;
+  }
+}
+
+TEST(JsonStreamTest, SeparatesMembersAndNestedContainers) {
+  JsonStream json;
+  json.begin_object();
+  json.key("name").value("eth0");
+  json.key("up").value(true);
+  json.key("count").value(uint64_t{18446744073709551615ULL});
+  json.key("offset").value(-42);
+  json.key("ratio").value(0.25);
+  json.key("missing").value(std::numeric_limits<double>::quiet_NaN());
+  json.key("list").begin_array().value(1).begin_array().end_array().null().end_array();
+  json.key("empty").begin_object().end_object();
+  json.end_object();
+  EXPECT_EQ(json.str(),
+            "{\"name\": \"eth0\",\"up\": true,\"count\": 18446744073709551615,"
+            "\"offset\": -42,\"ratio\": 0.25,\"missing\": null,\"list\": [1,[],null],"
+            "\"empty\": {}}");
+}
+
+TEST(JsonStreamTest, FlushesToDescriptorIncrementally) {
+  int pipe_fds[2];
+  ASSERT_EQ(pipe(pipe_fds), 0);
+  {
+    JsonStream json(pipe_fds[1], 64);
+    json.begin_array();
+    for (int i = 0; i < 40; ++i) {
+      json.value("sample");
+      EXPECT_LT(json.str().size(), 64u + 16u);  // Never holds more than one chunk
+    }
+    json.end_array();
+    EXPECT_TRUE(json.flush());
+  }
+  close(pipe_fds[1]);
+
+  std::string output;
+  char        buffer[256];
+  ssize_t     size;
+  while ((size = read(pipe_fds[0], buffer, sizeof(buffer))) > 0) {
+    output.append(buffer, static_cast<size_t>(size));
+  }
+  close(pipe_fds[0]);
+  EXPECT_EQ(output.size(), 2u + 40u * 8u + 39u);
+  EXPECT_EQ(output.substr(0, 19), "[\"sample\",\"sample\",");
+}
+
+TEST(JsonStreamTest, ReportsKeepTheirLayout) {
+  TestReport report;
+  report.peripheral_name = "USB";
+  report.result          = TestResult::SUCCESS;
+  report.duration        = std::chrono::milliseconds(12);
+  report.details         = "Port 1: \"ok\"";
+  std::string json       = report.to_json();
+  EXPECT_EQ(json.rfind("{\"peripheral\": \"USB\",\"result\": \"", 0), 0u);
+  EXPECT_NE(json.find("\"duration_ms\": 12,\"timestamp\": \""), std::string::npos);
+  EXPECT_NE(json.find("\"details\": \"Port 1: \\\"ok\\\"\","), std::string::npos);
+  EXPECT_NE(json.find("\"metrics\": [],\"checks\": []}"), std::string::npos);
+}
+
+TEST(JsonStreamTest, ReportsSerialiseTypedMetrics) {
+  TestReport report;
+  report.metrics.push_back({"write_speed", "MB/s", 42.5, 20.0, NO_LIMIT});
+  report.metrics.push_back({"errors", "", 3.0, NO_LIMIT, 0.0});
+  report.metrics.push_back({"temperature", "C", 51.0, NO_LIMIT, NO_LIMIT});
+  report.checks.push_back({"emmc", TestResult::SUCCESS});
+  report.checks.push_back({"nvme", TestResult::NOT_SUPPORTED});
+
+  EXPECT_TRUE(report.metrics[0].within_limits());
+  EXPECT_FALSE(report.metrics[1].within_limits());
+  EXPECT_FALSE(report.metrics[2].has_limits());
+  EXPECT_EQ(report.metric("errors"), &report.metrics[1]);
+  EXPECT_EQ(report.metric("missing"), nullptr);
+  EXPECT_EQ(report.check("nvme"), TestResult::NOT_SUPPORTED);
+  EXPECT_EQ(report.check("usb"), TestResult::SKIPPED);
+
+  std::string json = report.to_json();
+  EXPECT_NE(json.find("\"metrics\": [{\"name\": \"write_speed\",\"value\": 42.5,"
+                      "\"unit\": \"MB/s\",\"lower\": 20,\"pass\": true},"
+                      "{\"name\": \"errors\",\"value\": 3,\"unit\": \"\",\"upper\": 0,"
+                      "\"pass\": false},"
+                      "{\"name\": \"temperature\",\"value\": 51,\"unit\": \"C\"}]"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"checks\": [{\"name\": \"emmc\",\"result\": \"SUCCESS\"},"
+                      "{\"name\": \"nvme\",\"result\": \"NOT_SUPPORTED\"}]}"),
+            std::string::npos);
+}
+
+TEST(JsonStreamTest, ReportsSerialiseSeriesBuckets) {
+  TestReport report;
+  report.series.push_back({"temperature", "C", {{0.0, 0.5, 40.0, 42.0, 41.25, 3}}});
+
+  std::string json = report.to_json();
+  EXPECT_NE(json.find("\"checks\": [],\"series\": [{\"name\": \"temperature\",\"unit\": \"C\","
+                      "\"buckets\": [{\"start_s\": 0,\"end_s\": 0.5,\"min\": 40,"
+                      "\"mean\": 41.25,\"max\": 42,\"samples\": 3}]}]}"),
+            std::string::npos)
+      << json;
+}
+
+}  // namespace imx93_peripheral_test
@@ -0,0 +1,156 @@
+/**
+ * @file test_logger.cpp
+ * @brief Unit tests for the synchronous and asynchronous logger.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+
+namespace imx93_peripheral_test {
+
+class LoggerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path_ = std::filesystem::temp_directory_path() /
+            ("logger_test_" + std::to_string(getpid()) + ".log");
+    Logger::instance().set_console_output(false);
+    Logger::instance().set_log_file(path_.string());
+  }
+
+  void TearDown() override {
+    Logger::instance().set_async(false);
+    Logger::instance().set_log_file("/dev/null");
+    Logger::instance().set_console_output(true);
+    std::filesystem::remove(path_);
+  }
+
+  std::vector<std::string> read_lines() const {
+    std::ifstream            in(path_);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+  /**
+   * @brief Logs "worker <t> message <i>" from several threads at once.
+   */
+  static void log_from_threads(int threads, int messages) {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([t, messages]() {
+        for (int i = 0; i < messages; ++i) {
+          LOG_INFO("worker {} message {}", t, i);
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  std::filesystem::path path_;
+};
+
+TEST_F(LoggerTest, SynchronousEntriesAreFormattedAndFiltered) {
+  LOG_INFO("first");
+  LOG_DEBUG("hidden");
+  LOG_ERROR("second");
+
+  std::vector<std::string> lines = read_lines();
+  ASSERT_EQ(lines.size(), 2u);
+  std::regex entry(R"(\[\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2}\.\d{3}\] \[(INFO|ERROR)\] \w+)");
+  EXPECT_TRUE(std::regex_match(lines[0], entry)) << lines[0];
+  EXPECT_NE(lines[0].find("[INFO] first"), std::string::npos);
+  EXPECT_NE(lines[1].find("[ERROR] second"), std::string::npos);
+}
+
+TEST_F(LoggerTest, FormatStringsReplacePlaceholdersInOrder) {
+  std::string peripheral = "eth0";
+  LOG_INFO("{} on {}: {} packets, {} lost, link {}", "rate", peripheral, 1500u, -2, true);
+  LOG_WARN("{}% of {} with {} extra", 2.5, 'x');
+  LOG_ERROR("no placeholders");
+  LOG_INFO("sum {}", 0.1 + 0.2);
+
+  std::vector<std::string> lines = read_lines();
+  ASSERT_EQ(lines.size(), 4u);
+  EXPECT_NE(lines[0].find("[INFO] rate on eth0: 1500 packets, -2 lost, link true"),
+            std::string::npos)
+      << lines[0];
+  EXPECT_NE(lines[1].find("[WARN] 2.5% of x with {} extra"), std::string::npos) << lines[1];
+  EXPECT_NE(lines[2].find("[ERROR] no placeholders"), std::string::npos);
+  EXPECT_NE(lines[3].find("[INFO] sum 0.30000000000000004"), std::string::npos) << lines[3];
+}
+
+TEST_F(LoggerTest, FilteredLevelsDoNotEvaluateArguments) {
+  int  evaluated = 0;
+  auto argument  = [&evaluated]() {
+    ++evaluated;
+    return std::string("expensive");
+  };
+  Logger::instance().set_level(LogLevel::ERROR);
+  EXPECT_FALSE(Logger::instance().enabled(LogLevel::WARNING));
+  EXPECT_TRUE(Logger::instance().enabled(LogLevel::ERROR));
+  LOG_INFO("value: {}", argument());
+  LOG_WARN("value: {}", argument());
+  LOG_ERROR("value: {}", argument());
+  Logger::instance().set_level(LogLevel::INFO);
+
+  EXPECT_EQ(evaluated, 1);
+  std::vector<std::string> lines = read_lines();
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_NE(lines[0].find("[ERROR] value: expensive"), std::string::npos);
+}
+
+TEST_F(LoggerTest, AsynchronousModeKeepsEveryMessageInPerThreadOrder) {
+  Logger::instance().set_async(true, 1 << 16);
+  log_from_threads(4, 2000);
+  Logger::instance().flush();
+  EXPECT_EQ(Logger::instance().dropped(), 0u);
+
+  std::vector<std::string> lines = read_lines();
+  ASSERT_EQ(lines.size(), 8000u);
+  std::vector<int> next(4, 0);
+  for (const auto& line : lines) {
+    int worker  = 0;
+    int message = 0;
+    ASSERT_EQ(std::sscanf(line.c_str() + line.find("worker"), "worker %d message %d", &worker,
+                          &message),
+              2);
+    EXPECT_EQ(message, next[worker]++);
+  }
+}
+
+TEST_F(LoggerTest, FullQueueDropsAndCountsMessages) {
+  uint64_t before = Logger::instance().dropped();
+  Logger::instance().set_async(true, 4);
+  log_from_threads(4, 2000);
+  Logger::instance().set_async(false);
+
+  uint64_t dropped = Logger::instance().dropped() - before;
+  size_t   written = 0;
+  uint64_t noticed = 0;
+  for (const auto& line : read_lines()) {
+    size_t notice = line.find("log messages dropped");
+    if (notice == std::string::npos) {
+      ++written;
+    } else {
+      noticed += std::stoull(line.substr(line.find("] [WARN] ") + 9));
+    }
+  }
+  EXPECT_EQ(written + dropped, 8000u);
+  EXPECT_EQ(noticed, dropped);
+}
+
+}  // namespace imx93_peripheral_test
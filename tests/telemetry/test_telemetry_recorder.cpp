@@ -0,0 +1,205 @@
+/**
+ * @file test_telemetry_recorder.cpp
+ * @brief Unit tests for the binary telemetry recorder and reader.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "telemetry_reader.h"
+#include "telemetry_recorder.h"
+
+namespace imx93_peripheral_test {
+
+class TelemetryTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path_ = std::filesystem::temp_directory_path() /
+            ("telemetry_test_" + std::to_string(getpid()) + ".bin");
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(path_);
+  }
+
+  /**
+   * @brief Records 10 temperature and 10 power samples 1 ms apart through a store.
+   */
+  void record_session() {
+    TelemetryRecorderConfig config;
+    config.flush_interval    = std::chrono::milliseconds(5);
+    config.records_per_block = 4;
+    config.blocks_per_index  = 2;
+    config.sync              = false;
+    TelemetryRecorder recorder(config);
+    ASSERT_TRUE(recorder.open(path_.string())) << recorder.last_error();
+
+    TimeSeriesStore store;
+    store.set_sink(recorder.sink("cpu"));
+    size_t temperature = store.add_series("temperature", "C");
+    size_t power       = store.add_series("power", "W");
+    for (int i = 0; i < 10; ++i) {
+      store.add(temperature, 40.0 + i, start_ + std::chrono::milliseconds(i));
+      store.add(power, 0.5 * i, start_ + std::chrono::milliseconds(i));
+      if (i == 4) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));  // Split across flushes
+      }
+    }
+    recorder.close();
+    EXPECT_EQ(recorder.records_written(), 20u);
+    EXPECT_EQ(recorder.records_dropped(), 0u);
+    EXPECT_EQ(recorder.bytes_written(), std::filesystem::file_size(path_));
+  }
+
+  std::filesystem::path                 path_;
+  std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+};
+
+TEST_F(TelemetryTest, RecordsStoreSamplesAndReadsThemBack) {
+  record_session();
+
+  TelemetryReader reader;
+  ASSERT_TRUE(reader.open(path_.string())) << reader.last_error();
+  EXPECT_FALSE(reader.truncated());
+  ASSERT_EQ(reader.metrics().size(), 2u);
+  EXPECT_EQ(reader.metrics()[0].name, "cpu/temperature");
+  EXPECT_EQ(reader.metrics()[0].unit, "C");
+  EXPECT_EQ(reader.metrics()[1].name, "cpu/power");
+  EXPECT_EQ(reader.record_count(), 20u);
+  EXPECT_GE(reader.data_blocks(), 5u);
+
+  std::vector<TelemetryRecord> temperatures;
+  TelemetryRange               range;
+  range.metrics = {"cpu/temperature"};
+  EXPECT_EQ(reader.for_each(range, [&](const TelemetryRecord& r) { temperatures.push_back(r); }),
+            10u);
+  ASSERT_EQ(temperatures.size(), 10u);
+  for (size_t i = 0; i < temperatures.size(); ++i) {
+    EXPECT_DOUBLE_EQ(temperatures[i].value, 40.0 + i);
+    EXPECT_EQ(temperatures[i].time_ns - temperatures[0].time_ns,
+              static_cast<int64_t>(i) * 1000000);
+  }
+  int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+  EXPECT_NEAR(static_cast<double>(temperatures[0].time_ns), static_cast<double>(now_ns), 60e9);
+  EXPECT_EQ(reader.corrupt_blocks(), 0u);
+}
+
+TEST_F(TelemetryTest, ExportsTimeRangesAsCsvAndJson) {
+  record_session();
+
+  TelemetryReader reader;
+  ASSERT_TRUE(reader.open(path_.string()));
+  int64_t first_ns = 0;
+  reader.for_each(TelemetryRange(), [&](const TelemetryRecord& record) {
+    first_ns = first_ns == 0 ? record.time_ns : first_ns;
+  });
+
+  // Samples 2..5 of both metrics
+  TelemetryRange range;
+  range.from_ns = first_ns + 2000000;
+  range.to_ns   = first_ns + 5000000;
+  std::ostringstream csv;
+  EXPECT_EQ(reader.export_csv(range, csv), 8u);
+  std::string text = csv.str();
+  EXPECT_EQ(text.rfind("timestamp_ns,metric,unit,value\n", 0), 0u);
+  EXPECT_NE(text.find(",cpu/temperature,C,42\n"), std::string::npos);
+  EXPECT_NE(text.find(",cpu/power,W,2.5\n"), std::string::npos);
+  EXPECT_EQ(text.find(",cpu/temperature,C,46\n"), std::string::npos);
+
+  std::ostringstream json;
+  range.metrics = {"cpu/power"};
+  EXPECT_EQ(reader.export_json(range, json), 4u);
+  EXPECT_NE(json.str().find("{\"id\": 1,\"name\": \"cpu/power\",\"unit\": \"W\"}"),
+            std::string::npos);
+  EXPECT_NE(json.str().find(std::to_string(first_ns + 5000000) + ",1,2.5]]}"),
+            std::string::npos);
+}
+
+TEST_F(TelemetryTest, ReplaysIntoTimeSeriesStore) {
+  record_session();
+
+  TelemetryReader reader;
+  ASSERT_TRUE(reader.open(path_.string()));
+  TimeSeriesStore store;
+  EXPECT_EQ(reader.replay(TelemetryRange(), store), 20u);
+  ASSERT_EQ(store.series().size(), 2u);
+  TimeSeriesBucket temperature = store.series()[0].summary();
+  EXPECT_EQ(store.series()[0].name(), "cpu/temperature");
+  EXPECT_EQ(temperature.samples, 10u);
+  EXPECT_DOUBLE_EQ(temperature.max, 49.0);
+  EXPECT_NEAR(temperature.end_s - temperature.start_s, 0.009, 1e-9);
+}
+
+TEST_F(TelemetryTest, TornTailAndCorruptBlocksLeaveTheRestReadable) {
+  record_session();
+  uint64_t size = std::filesystem::file_size(path_);
+  {
+    // A power cut in the middle of the next block
+    std::ofstream out(path_, std::ios::binary | std::ios::app);
+    TelemetryBlockHeader header{};
+    header.magic        = TELEMETRY_BLOCK_MAGIC;
+    header.type         = static_cast<uint16_t>(TelemetryBlockType::DATA);
+    header.payload_size = 4096;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out << "partial";
+  }
+
+  TelemetryReader reader;
+  ASSERT_TRUE(reader.open(path_.string()));
+  EXPECT_TRUE(reader.truncated());
+  EXPECT_EQ(reader.valid_bytes(), size);
+  EXPECT_EQ(reader.for_each(TelemetryRange(), [](const TelemetryRecord&) {}), 20u);
+  reader.close();
+
+  uint64_t lost = 0;
+  {
+    // Flip a byte in the value of the first record of the first data block
+    std::fstream         file(path_, std::ios::binary | std::ios::in | std::ios::out);
+    TelemetryBlockHeader header{};
+    std::streamoff       offset = sizeof(TelemetryFileHeader);
+    for (;;) {
+      file.seekg(offset);
+      ASSERT_TRUE(file.read(reinterpret_cast<char*>(&header), sizeof(header)));
+      if (header.type == static_cast<uint16_t>(TelemetryBlockType::DATA)) {
+        break;
+      }
+      offset += sizeof(header) + header.payload_size;
+    }
+    file.seekp(offset + static_cast<std::streamoff>(sizeof(header)) + 8);
+    file.put('\x7f');
+    lost = header.payload_size / sizeof(TelemetryRecord);
+  }
+  ASSERT_TRUE(reader.open(path_.string()));
+  uint64_t records = reader.for_each(TelemetryRange(), [](const TelemetryRecord&) {});
+  EXPECT_EQ(reader.corrupt_blocks(), 1u);
+  EXPECT_GT(lost, 0u);
+  EXPECT_EQ(records, 20u - lost);
+}
+
+TEST_F(TelemetryTest, RejectsOtherFiles) {
+  std::ofstream(path_) << "timestamp,value\n1,2\n";
+  TelemetryReader reader;
+  EXPECT_FALSE(reader.open(path_.string()));
+  EXPECT_NE(reader.last_error().find("not a telemetry recording"), std::string::npos);
+  EXPECT_FALSE(reader.open((path_.string() + ".missing")));
+}
+
+TEST_F(TelemetryTest, RecorderReportsOpenFailure) {
+  TelemetryRecorder recorder;
+  EXPECT_FALSE(recorder.open("/nonexistent/dir/recording.bin"));
+  EXPECT_FALSE(recorder.is_open());
+  EXPECT_NE(recorder.last_error().find("Cannot create"), std::string::npos);
+  recorder.record(0, std::chrono::steady_clock::now(), 1.0);  // Ignored while closed
+  EXPECT_EQ(recorder.records_dropped(), 0u);
+}
+
+}  // namespace imx93_peripheral_test
@@ -0,0 +1,145 @@
+/**
+ * @file test_watchdog.cpp
+ * @brief Unit tests for the test watchdog and cancellation token.
+ * @author Sandesh Ghimire
+ * @copyright (C) Soccentric LLC. All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "test_watchdog.h"
+
+namespace imx93_peripheral_test {
+
+/**
+ * @brief Tester whose monitor either waits on its token or ignores it.
+ */
+class SlowTester : public PeripheralTester {
+public:
+  explicit SlowTester(bool cooperative) : cooperative_(cooperative) {}
+
+  TestReport short_test() override {
+    add_check("quick", TestResult::SUCCESS);
+    return create_report(TestResult::SUCCESS, "done", std::chrono::milliseconds(0));
+  }
+
+  TestReport monitor_test(std::chrono::seconds duration) override {
+    if (cooperative_) {
+      cancellation_.wait_for(duration);
+    } else {
+      while (!release_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+    finished_ = true;
+    return create_report(TestResult::SUCCESS, "sampled", std::chrono::milliseconds(0));
+  }
+
+  std::string get_peripheral_name() const override {
+    return "Slow";
+  }
+
+  bool is_available() const override {
+    return true;
+  }
+
+  std::atomic<bool> release_{false};  /**< Lets a non-cooperative monitor return */
+  std::atomic<bool> finished_{false};
+
+private:
+  bool cooperative_;
+};
+
+TestReport run_monitor(PeripheralTester& tester) {
+  return tester.monitor_test(std::chrono::seconds(60));
+}
+
+TEST(CancellationTokenTest, WaitReturnsEarlyWhenCancelled) {
+  CancellationToken token;
+  EXPECT_FALSE(token.wait_for(std::chrono::milliseconds(1)));
+
+  std::thread canceller([&token]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    token.cancel();
+  });
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(token.wait_for(std::chrono::seconds(30)));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  canceller.join();
+
+  token.reset();
+  EXPECT_FALSE(token.cancelled());
+}
+
+TEST(TestWatchdogTest, ReturnsReportsOfTestsThatFinishInTime) {
+  TestWatchdogConfig config;
+  config.timeout = std::chrono::seconds(30);
+  TestWatchdog watchdog(config);
+
+  auto       tester = std::make_shared<SlowTester>(true);
+  TestReport report = watchdog.run(tester, [](PeripheralTester& t) { return t.short_test(); });
+  EXPECT_EQ(report.result, TestResult::SUCCESS);
+  EXPECT_EQ(report.details, "done");
+  EXPECT_EQ(report.check("quick"), TestResult::SUCCESS);
+}
+
+TEST(TestWatchdogTest, CancelsOverrunningTestsAndKeepsTheirPartialResults) {
+  TestWatchdogConfig config;
+  config.timeout = std::chrono::milliseconds(50);
+  TestWatchdog watchdog(config);
+
+  auto       tester = std::make_shared<SlowTester>(true);
+  auto       start  = std::chrono::steady_clock::now();
+  TestReport report = watchdog.run(tester, run_monitor);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  EXPECT_EQ(report.result, TestResult::TIMEOUT);
+  EXPECT_EQ(report.details.rfind("Timed out after 50 ms", 0), 0u) << report.details;
+  EXPECT_NE(report.details.find("sampled"), std::string::npos);
+  EXPECT_TRUE(tester->finished_);
+  EXPECT_EQ(watchdog.abandoned(), 0u);
+}
+
+TEST(TestWatchdogTest, AbandonsTestsThatIgnoreCancellation) {
+  TestWatchdogConfig config;
+  config.timeout = std::chrono::milliseconds(20);
+  config.grace   = std::chrono::milliseconds(20);
+  TestWatchdog watchdog(config);
+
+  auto       tester = std::make_shared<SlowTester>(false);
+  TestReport report = watchdog.run(tester, run_monitor);
+  EXPECT_EQ(report.result, TestResult::TIMEOUT);
+  EXPECT_EQ(report.peripheral_name, "Slow");
+  EXPECT_NE(report.details.find("abandoned"), std::string::npos);
+  EXPECT_EQ(watchdog.abandoned(), 1u);
+
+  // The detached thread still owns the tester; let it finish
+  tester->release_ = true;
+  while (!tester->finished_) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+TEST(TestWatchdogTest, InterruptStopsTheRunningTestAndSkipsLaterOnes) {
+  TestWatchdog watchdog;
+  auto         tester = std::make_shared<SlowTester>(true);
+  std::thread  signal([&watchdog]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    watchdog.interrupt();
+  });
+  TestReport report = watchdog.run(tester, run_monitor);
+  signal.join();
+  EXPECT_EQ(report.result, TestResult::SKIPPED);
+  EXPECT_EQ(report.details.rfind("Interrupted", 0), 0u);
+  EXPECT_TRUE(watchdog.interrupted());
+
+  report = watchdog.run(tester, [](PeripheralTester& t) { return t.short_test(); });
+  EXPECT_EQ(report.result, TestResult::SKIPPED);
+  EXPECT_EQ(report.details, "Interrupted before start");
+}
+
+}  // namespace imx93_peripheral_test
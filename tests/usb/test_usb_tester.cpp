@@ -15,6 +15,7 @@ class USBTesterTest : public ::testing::Test {
 protected:
   void SetUp() override {
     tester_ = std::make_unique<USBTester>();
+    tester_->prepare();
   }
 
   void TearDown() override {